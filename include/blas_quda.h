@@ -444,6 +444,22 @@ namespace quda {
     */
     double4 quadrupleCGReduction(const ColorSpinorField &x, const ColorSpinorField &y, const ColorSpinorField &z);
 
+    /**
+       @brief Fused vector update and reduction for pipelined CG:
+       z = q + b * z, s = w + b * s, r -= a * s, w -= a * z, returning
+       ||r||^2 and the real-valued inner product (r, w) evaluated with
+       the updated vectors
+       @param[in] a scalar multiplier (alpha)
+       @param[in] b scalar multiplier (beta)
+       @param[in,out] r residual vector
+       @param[in,out] w A * r
+       @param[in,out] s A * p
+       @param[in,out] z A * s
+       @param[in] q A * w
+    */
+    double2 pipelinedCGUpdate(double a, double b, ColorSpinorField &r, ColorSpinorField &w, ColorSpinorField &s,
+                              ColorSpinorField &z, const ColorSpinorField &q);
+
     /**
        @brief Computes z = x, w = y, x += a * y, y -= a * v and ||y||^2
        @param[in] a scalar multiplier
@@ -1030,20 +1030,58 @@ namespace quda
 
   /**
      @brief Generate a random noise spinor.  This variant just
-     requires a seed and will create and destroy the random number state.
+     requires a seed and uses the stateless counter-based generator
+     (see counter_rng.h), so the noise at each site is independent of
+     the lattice partitioning and no random number state is allocated.
      @param src The colorspinorfield
      @param seed Seed
      @param type The type of noise to create (QUDA_NOISE_GAUSSIAN or QUDA_NOISE_UNIFORM)
   */
   void spinorNoise(ColorSpinorField &src, unsigned long long seed, QudaNoiseType type);
 
+  /**
+     @brief Return the number of members of the dilution set of a
+     source for a given dilution type
+     @param src The input source
+     @param type The type of dilution
+     @param block_size The block size for QUDA_DILUTION_BLOCK, which
+     must divide the global lattice
+     @param probe_size The number of probing vectors for
+     QUDA_DILUTION_HADAMARD_PROBING, a power of two
+  */
+  int dilutionSize(const ColorSpinorField &src, QudaDilutionType type, const lat_dim_t &block_size = {},
+                   int probe_size = 0);
+
   /**
      @brief Generate a set of diluted color spinors from a single source.
      @param v Diluted vector set
      @param src The input source
      @param type The type of dilution to apply (QUDA_DILUTION_SPIN_COLOR, etc.)
+     @param block_size The block size for QUDA_DILUTION_BLOCK
+     @param probe_size The number of probing vectors for QUDA_DILUTION_HADAMARD_PROBING
+  */
+  void spinorDilute(std::vector<ColorSpinorField> &v, const ColorSpinorField &src, QudaDilutionType type,
+                    const lat_dim_t &block_size = {}, int probe_size = 0);
+
+  /**
+     @brief Generate the members [offset, offset + v.size()) of the
+     dilution set of a single source, so that diluted sources can be
+     generated just in time rather than all at once.  Time-slice and
+     block dilution select the sites of a global time slice or
+     lattice block; Hadamard probing multiplies the source by the
+     signs of a Hadamard vector over a hierarchical coloring of the
+     lattice, so the leading 2^(4 l) vectors probe the 2^l-periodic
+     coloring.  For single-parity fields the probing vectors are
+     defined up to an overall sign.
+     @param v Diluted vectors
+     @param src The input source
+     @param type The type of dilution to apply
+     @param offset The index of the first member to generate
+     @param block_size The block size for QUDA_DILUTION_BLOCK
+     @param probe_size The number of probing vectors for QUDA_DILUTION_HADAMARD_PROBING
   */
-  void spinorDilute(std::vector<ColorSpinorField> &v, const ColorSpinorField &src, QudaDilutionType type);
+  void spinorDilute(cvector_ref<ColorSpinorField> &v, const ColorSpinorField &src, QudaDilutionType type, int offset,
+                    const lat_dim_t &block_size = {}, int probe_size = 0);
 
   /**
      @brief Helper function for determining if the preconditioning
@@ -218,6 +218,16 @@ namespace quda
   */
   void comm_gather_gpuid(int *gpuid_recv_buf);
 
+  /**
+     @brief Gather a fixed-size byte buffer from all processes
+     @param[out] recv_buf Buffer of length bytes*comm_size() that
+     will be filled with the send buffers of all processes (in rank
+     order)
+     @param[in] send_buf Buffer this process contributes
+     @param[in] bytes Size of each process's contribution in bytes
+  */
+  void comm_allgather(void *recv_buf, const void *send_buf, size_t bytes);
+
   /**
      Enabled peer-to-peer communication.
      @param hostname_buf Array that holds all process hostnames
@@ -395,6 +405,20 @@ namespace quda
   template <typename T> void comm_allreduce_max(T &v);
   template <typename T> void comm_allreduce_min(T &v);
 
+  /**
+     @brief Start a non-blocking sum all-reduce of a host array in
+     place.  Only one such all-reduce may be outstanding at a time.
+     @param[in,out] data The array we are reducing
+     @param[in] size The length of the array
+   */
+  void comm_allreduce_sum_array_start(double *data, size_t size);
+
+  /**
+     @brief Complete the outstanding non-blocking all-reduce started
+     with comm_allreduce_sum_array_start
+   */
+  void comm_allreduce_sum_array_wait();
+
   void comm_allreduce_int(int &data);
   void comm_allreduce_xor(uint64_t &data);
   void comm_broadcast(void *data, size_t nbytes);
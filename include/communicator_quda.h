@@ -661,6 +661,9 @@ namespace quda
 
 #if defined(QMP_COMMS) || defined(MPI_COMMS)
   MPI_Comm MPI_COMM_HANDLE;
+
+  /** Request handle for the outstanding non-blocking all-reduce */
+  MPI_Request allreduce_request = MPI_REQUEST_NULL;
 #endif
 
 #if defined(QMP_COMMS)
@@ -693,6 +696,8 @@ namespace quda
 
   void comm_gather_gpuid(int *gpuid_recv_buf);
 
+  void comm_allgather(void *recv_buf, const void *send_buf, size_t bytes);
+
   void comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data);
 
   int comm_rank(void);
@@ -753,6 +758,22 @@ namespace quda
 
   void comm_allreduce_sum_array(double *data, size_t size);
 
+  /**
+     @brief Start a non-blocking sum all-reduce of the array.  The
+     result is only valid after comm_allreduce_sum_array_wait has
+     been called, and at most one all-reduce may be in flight at a
+     time.  With deterministic reductions enabled this falls back to
+     the blocking all-reduce.
+     @param[in,out] data The array we are reducing in place
+     @param[in] size The length of the array
+   */
+  void comm_allreduce_sum_array_start(double *data, size_t size);
+
+  /**
+     @brief Wait for the outstanding non-blocking all-reduce to complete
+   */
+  void comm_allreduce_sum_array_wait();
+
   void comm_allreduce_max_array(double *data, size_t size);
 
   void comm_allreduce_max_array(deviation_t<double> *data, size_t size);
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace quda
+{
+
+  /**
+     @brief Compute a fast 64-bit (non-cryptographic) hash of a host
+     buffer.  The buffer is split into fixed-size blocks that are
+     hashed in parallel (when built with OpenMP) and then combined in
+     order, so the result does not depend on the thread count.  This
+     is intended for detecting changes in host fields, not for
+     validating data against adversarial modification.
+     @param[in] data The buffer we are hashing
+     @param[in] bytes The size of the buffer in bytes
+     @param[in] seed Seed value, which may be used to chain the
+     hashes of several buffers
+     @return The hash value
+   */
+  uint64_t content_hash(const void *data, size_t bytes, uint64_t seed = 0);
+
+  /**
+     @brief Compute the XOR of f(begin, end) evaluated over
+     contiguous chunks covering the range [0, n).  The chunks are
+     evaluated in parallel across host threads (when built with
+     OpenMP).
+     @param[in] n The length of the range
+     @param[in] f Functor returning the XOR over the chunk [begin, end)
+     @return The XOR over the entire range
+   */
+  uint64_t parallel_xor(size_t n, const std::function<uint64_t(size_t, size_t)> &f);
+
+  /**
+     @brief Incremental SHA-256 message digest (FIPS 180-4), used
+     where a cryptographic-strength digest is required, e.g., for
+     provenance records.
+   */
+  class SHA256
+  {
+    uint32_t state[8];
+    uint64_t length = 0;
+    unsigned char block[64];
+    size_t fill = 0;
+
+    void compress(const unsigned char *chunk);
+
+  public:
+    SHA256();
+
+    /**
+       @brief Append data to the message
+       @param[in] data The data we are appending
+       @param[in] bytes The size of the data in bytes
+     */
+    void update(const void *data, size_t bytes);
+
+    /**
+       @brief Finalize the message and return its digest.  The
+       object should not be updated after this is called.
+       @return The 32-byte digest
+     */
+    std::array<unsigned char, 32> digest();
+
+    /**
+       @brief Convert a digest to a hexadecimal string
+       @param[in] digest The digest we are converting
+       @return The hexadecimal string
+     */
+    static std::string hex(const std::array<unsigned char, 32> &digest);
+  };
+
+} // namespace quda
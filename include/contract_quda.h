@@ -6,4 +6,42 @@
 namespace quda
 {
   void contractQuda(const ColorSpinorField &x, const ColorSpinorField &y, void *result, QudaContractType cType);
+
+  /**
+     @brief Contract each pair of spinors (x_i, y_i), project onto a set
+     of spatial momenta and sum over each time slice, accumulating
+     over the pairs.  The phase multiplication and time-slice
+     reduction are fused into the contraction kernel, so only the
+     correlators are returned.
+     @param[in] x The set of bra spinors (conjugated)
+     @param[in] y The set of ket spinors
+     @param[in,out] result The correlators are added to this, with
+     layout [t][mom][16] where t is the global time slice and the 16
+     components are given by the contraction type
+     @param[in] cType The contraction type (open or Degrand-Rossi)
+     @param[in] mom The spatial momenta, three integers per momentum in units of 2 pi / L
+     @param[in] source_position The source position, relative to which the phase is computed
+  */
+  void contractSummedQuda(cvector_ref<const ColorSpinorField> &x, cvector_ref<const ColorSpinorField> &y,
+                          std::vector<Complex> &result, const QudaContractType cType, const std::vector<int> &mom,
+                          const int source_position[4]);
+
+  /**
+     @brief Compute the meson field
+     M_ij(t, p, Gamma) = sum_x exp(-i p.x) w_i^dag(x, t) Gamma v_j(x, t)
+     for all pairs of vectors from the two sets, e.g., the low modes
+     of an eigensolve.  The pairs are computed in tiles, with each
+     thread forming every pair of a tile from a single load of its
+     vectors.  The fields may be device or host fields, the latter
+     computed on the host for verification.
+     @param[in] w The set of bra vectors (conjugated)
+     @param[in] v The set of ket vectors
+     @param[out] result The meson field with layout [t][mom][gamma][i][j]
+     where t is the global time slice
+     @param[in] mom The spatial momenta, three integers per momentum in units of 2 pi / L
+     @param[in] gamma The Degrand-Rossi gamma insertions, indexed as in
+     enum_quda.h
+  */
+  void mesonFieldQuda(cvector_ref<const ColorSpinorField> &w, cvector_ref<const ColorSpinorField> &v,
+                      std::vector<Complex> &result, const std::vector<int> &mom, const std::vector<int> &gamma);
 } // namespace quda
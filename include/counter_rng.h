@@ -0,0 +1,204 @@
+#pragma once
+
+#include <cstdint>
+#include <lattice_field.h>
+#include <index_helper.cuh>
+#include <comm_quda.h>
+#include <random_helper.h>
+
+/**
+   @file counter_rng.h
+
+   Counter-based random number generation using Philox4x32-10
+   (Salmon et al, "Parallel random numbers: as easy as 1, 2, 3",
+   SC11).  Each random number is a pure function of the key (the
+   seed) and a counter made from the global lattice site, a stream
+   index and a draw index, so no generator state is stored and the
+   numbers drawn at a given site do not depend on the local volume
+   or on how the lattice is partitioned.  The same integer arithmetic
+   is used on all targets and on the host.
+ */
+
+namespace quda
+{
+
+  namespace philox
+  {
+
+    constexpr uint32_t M0 = 0xD2511F53u;
+    constexpr uint32_t M1 = 0xCD9E8D57u;
+    constexpr uint32_t W0 = 0x9E3779B9u;
+    constexpr uint32_t W1 = 0xBB67AE85u;
+    constexpr int rounds = 10;
+
+    constexpr void mulhilo(uint32_t a, uint32_t b, uint32_t &hi, uint32_t &lo)
+    {
+      uint64_t product = static_cast<uint64_t>(a) * static_cast<uint64_t>(b);
+      hi = static_cast<uint32_t>(product >> 32);
+      lo = static_cast<uint32_t>(product);
+    }
+
+    /**
+       @brief Apply the Philox4x32-10 bijection
+       @param[out] out The four 32-bit random words
+       @param[in] ctr The 128-bit counter
+       @param[in] key The 64-bit key
+     */
+    constexpr void generate(uint32_t out[4], const uint32_t ctr[4], const uint32_t key[2])
+    {
+      uint32_t c[4] = {ctr[0], ctr[1], ctr[2], ctr[3]};
+      uint32_t k[2] = {key[0], key[1]};
+      for (int r = 0; r < rounds; r++) {
+        uint32_t hi0 = 0, lo0 = 0, hi1 = 0, lo1 = 0;
+        mulhilo(M0, c[0], hi0, lo0);
+        mulhilo(M1, c[2], hi1, lo1);
+        c[0] = hi1 ^ c[1] ^ k[0];
+        c[1] = lo1;
+        c[2] = hi0 ^ c[3] ^ k[1];
+        c[3] = lo0;
+        k[0] += W0;
+        k[1] += W1;
+      }
+      for (int i = 0; i < 4; i++) out[i] = c[i];
+    }
+
+    constexpr bool known_answer(const uint32_t ctr[4], const uint32_t key[2], const uint32_t expected[4])
+    {
+      uint32_t out[4] = {};
+      generate(out, ctr, key);
+      return out[0] == expected[0] && out[1] == expected[1] && out[2] == expected[2] && out[3] == expected[3];
+    }
+
+    // known-answer tests from the Random123 distribution
+    constexpr uint32_t kat_ctr0[4] = {0u, 0u, 0u, 0u};
+    constexpr uint32_t kat_key0[2] = {0u, 0u};
+    constexpr uint32_t kat_out0[4] = {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u};
+    static_assert(known_answer(kat_ctr0, kat_key0, kat_out0), "Philox4x32-10 known-answer test failed");
+
+    constexpr uint32_t kat_ctr1[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+    constexpr uint32_t kat_key1[2] = {0xa4093822u, 0x299f31d0u};
+    constexpr uint32_t kat_out1[4] = {0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u};
+    static_assert(known_answer(kat_ctr1, kat_key1, kat_out1), "Philox4x32-10 known-answer test failed");
+
+  } // namespace philox
+
+  /**
+     @brief Stateless random number generator for a given (seed,
+     site, stream).  The object only lives in registers for the
+     duration of a kernel; successive draws advance the draw index.
+     Streams allow independent sequences at the same site, e.g., one
+     per link direction.
+   */
+  class CounterRNG
+  {
+    uint32_t key[2];
+    uint32_t ctr[4];
+    uint32_t buf[4] = {};
+    int idx = 4;
+
+    constexpr uint32_t next()
+    {
+      if (idx == 4) {
+        philox::generate(buf, ctr, key);
+        ctr[3]++;
+        idx = 0;
+      }
+      return buf[idx++];
+    }
+
+  public:
+    /**
+       @brief Constructor for the generator
+       @param[in] seed The seed (key)
+       @param[in] site The global lattice site index
+       @param[in] stream The stream index
+       @param[in] offset The offset of the first draw, in blocks of four 32-bit words
+     */
+    constexpr CounterRNG(uint64_t seed, uint64_t site, uint32_t stream, uint32_t offset = 0) :
+      key {static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+      ctr {static_cast<uint32_t>(site), static_cast<uint32_t>(site >> 32), stream, offset}
+    {
+    }
+
+    /**
+       @return A uniform deviate in (0, 1]
+     */
+    template <typename real> constexpr real uniform()
+    {
+      if constexpr (sizeof(real) == sizeof(float)) {
+        return static_cast<real>((next() >> 8) + 1u) * static_cast<real>(1.0 / (1u << 24));
+      } else {
+        uint64_t hi = next();
+        uint64_t lo = next();
+        uint64_t v = ((hi << 32) | lo) >> 11;
+        return static_cast<real>(v + 1u) * static_cast<real>(1.0 / (1ull << 53));
+      }
+    }
+
+    /**
+       @return A uniform deviate in (a, b]
+     */
+    template <typename real> constexpr real uniform(real a, real b) { return a + (b - a) * uniform<real>(); }
+  };
+
+  /**
+     @brief Metadata required to map a checkerboard site of a local
+     lattice field to its global lattice site index, which is the key
+     of the counter-based generator.
+   */
+  struct CounterRNGParam {
+    uint64_t seed;
+    int X[4];        // local (non-extended) dimensions
+    int X_global[4]; // global dimensions
+    int offset[4];   // global coordinate of the local origin
+    int parity;      // parity of the sites of a single-parity field, else zero
+
+    /**
+       @brief Constructor for the generator metadata
+       @param[in] seed The seed (key)
+       @param[in] meta The field we are filling
+       @param[in] parity The parity of the sites of a single-parity
+       field (an unset parity is treated as even).  Ignored for
+       full fields.
+     */
+    CounterRNGParam(uint64_t seed, const LatticeField &meta, QudaParity parity = QUDA_INVALID_PARITY) :
+      seed(seed), parity(meta.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity == QUDA_ODD_PARITY ? 1 : 0)
+    {
+      for (int i = 0; i < 4; i++) {
+        X[i] = meta.LocalX()[i];
+        if (i == 0 && meta.SiteSubset() == QUDA_PARITY_SITE_SUBSET) X[i] *= 2;
+        X_global[i] = X[i] * comm_dim(i);
+        offset[i] = X[i] * comm_coord(i);
+      }
+    }
+
+    /**
+       @brief Return the generator for a given local site and stream
+       @param[in] x_cb Local checkerboard site index
+       @param[in] parity Parity index of the field (always zero for a single-parity field)
+       @param[in] stream Stream index
+     */
+    __device__ __host__ inline CounterRNG operator()(int x_cb, int parity, uint32_t stream = 0) const
+    {
+      int x[4];
+      getCoords(x, x_cb, X, parity ^ this->parity);
+      uint64_t site = 0;
+      for (int i = 3; i >= 0; i--) site = site * X_global[i] + (x[i] + offset[i]);
+      return CounterRNG(seed, site, stream);
+    }
+  };
+
+  /**
+     @brief Return a uniform deviate in (0, 1] from a stateful generator
+   */
+  template <typename real> __device__ __host__ inline real rand_uniform(RNGState &state)
+  {
+    return uniform<real>::rand(state);
+  }
+
+  /**
+     @brief Return a uniform deviate in (0, 1] from a counter-based generator
+   */
+  template <typename real> constexpr real rand_uniform(CounterRNG &state) { return state.template uniform<real>(); }
+
+} // namespace quda
@@ -6,6 +6,7 @@
 #include <dirac_quda.h>
 #include <color_spinor_field.h>
 #include <eigen_helper.h>
+#include <memory>
 
 namespace quda
 {
@@ -13,6 +14,75 @@ namespace quda
   // Local enum for the LU axpy block type
   enum blockType { PENCIL, LOWER_TRI, UPPER_TRI };
 
+  class Transfer;
+
+  /**
+     @brief Locally coherent compressed representation of a deflation
+     space.  The leading n_basis eigenvectors are block orthogonalized
+     over the geometric aggregates of a multigrid transfer operator,
+     and every eigenvector is stored as its restriction onto this
+     block-local basis, v_i ~ P R v_i.  The coarse coefficients are
+     stored in low precision, and the eigenvectors are never expanded
+     individually: deflation is applied as P (sum_i c_i c_i^dag / lambda_i) R.
+  */
+  class CompressedDeflationSpace
+  {
+    /** Profile for the transfer operator, which is applied within the solver compute region */
+    TimeProfile profile;
+    /** Single-precision full-field copies of the basis vectors, referenced by the transfer operator */
+    std::vector<ColorSpinorField> B;
+    std::vector<ColorSpinorField *> B_ptr;
+    /** The transfer operator defined by the basis */
+    std::unique_ptr<Transfer> transfer;
+    /** The coarse coefficients of each eigenvector */
+    std::vector<ColorSpinorField> coeff;
+    /** Single-precision temporaries on the fine and coarse grids */
+    mutable ColorSpinorField fine;
+    mutable ColorSpinorField coarse;
+
+  public:
+    /**
+       @brief Compress a set of eigenvectors
+       @param[in] evecs The eigenvectors to compress
+       @param[in] n_basis The number of leading eigenvectors used to form the block-local basis
+       @param[in] block_size The geometric block size of the aggregates
+       @param[in] prec The precision in which the coarse coefficients are stored
+       @param[in] parity The parity of the eigenvectors if single parity
+    */
+    CompressedDeflationSpace(const std::vector<ColorSpinorField> &evecs, int n_basis, const int *block_size,
+                             QudaPrecision prec, QudaParity parity);
+
+    ~CompressedDeflationSpace();
+
+    /**
+       @return The number of compressed eigenvectors
+    */
+    int size() const { return coeff.size(); }
+
+    /**
+       @return The device memory footprint of the compressed space in bytes
+    */
+    size_t Bytes() const;
+
+    /**
+       @brief Reconstruct an eigenvector from its coarse coefficients
+       @param[out] v The reconstructed eigenvector
+       @param[in] i The index of the eigenvector
+    */
+    void expand(ColorSpinorField &v, int i) const;
+
+    /**
+       @brief Deflate a set of source vectors with the compressed space
+       @param[in,out] sol The resulting deflated vector set
+       @param[in] src The source vector set we are deflating
+       @param[in] evals The eigenvalues to use in deflation
+       @param[in] n_defl The number of eigenpairs to deflate with
+       @param[in] accumulate Whether to preserve the sol vector content prior to accumulating
+    */
+    void deflate(cvector_ref<ColorSpinorField> &sol, cvector_ref<const ColorSpinorField> &src,
+                 const std::vector<Complex> &evals, int n_defl, bool accumulate) const;
+  };
+
   class EigenSolver
   {
     using range = std::pair<int, int>;
@@ -57,6 +127,9 @@ namespace quda
 
     QudaPrecision save_prec;
 
+    /** If set, the compressed deflation space used in place of the eigenvectors */
+    std::unique_ptr<CompressedDeflationSpace> compressed_space;
+
   public:
     /**
        @brief Constructor for base Eigensolver class
@@ -152,12 +225,14 @@ namespace quda
     double estimateChebyOpMax(ColorSpinorField &out, ColorSpinorField &in);
 
     /**
-       @brief Orthogonalise input vectors r against
-       vector space v using block-BLAS
+       @brief Orthogonalise input vectors r against vector space v
+       using block classical Gram-Schmidt.  The projections and the
+       Gram matrix of r are computed with a single multi-reduction,
+       and a second pass (CGS2) is made only if a vector of r has lost
+       more than half of its norm (the DGKS criterion).
        @param[in] v Vector space
        @param[in] r Vectors to be orthogonalised
        @param[in] j Use vectors v[0:j]
-       @param[in] s array of
     */
     void blockOrthogonalize(std::vector<ColorSpinorField> &v, std::vector<ColorSpinorField> &r, int j);
 
@@ -169,7 +244,23 @@ namespace quda
     void orthonormalizeMGS(std::vector<ColorSpinorField> &v, int j);
 
     /**
-       @brief Check orthonormality of input vector space v
+       @brief Orthonormalise input vector space v using Cholesky QR:
+       the Gram matrix is computed with a single multi-reduction and
+       its Cholesky factor R is applied in place, v <- v R^{-1}.  One
+       pass leaves an orthogonality error of order eps * cond(v)^2,
+       so it should be repeated until orthoCheck passes (CholQR2).  If
+       the Gram matrix is numerically singular it is shifted before
+       factorization.
+       @param[in,out] v Vector space
+       @param[in] j Use vectors v[0:j-1]
+       @param[out] R The upper-triangular factor with v_in = v_out R
+    */
+    void orthonormalizeCholQR(std::vector<ColorSpinorField> &v, int j, MatrixXcd &R);
+
+    /**
+       @brief Check orthonormality of input vector space v.  The
+       largest deviation of v^dag v from the identity is reported at
+       verbose level.
        @param[out] bool If all vectors are orthonormal to 1e-16 returns true,
        else false.
        @param[in] v Vector space
@@ -253,6 +344,15 @@ namespace quda
                     cvector_ref<const ColorSpinorField> &evecs, const std::vector<Complex> &evals,
                     bool accumulate = false) const;
 
+    /**
+       @brief Replace a set of eigenvectors with its locally coherent
+       compression (see CompressedDeflationSpace).  On exit evecs is
+       empty, and subsequent calls to deflate use the compressed space
+       regardless of the eigenvectors passed.
+       @param[in,out] evecs The eigenvectors to compress
+    */
+    void compressDeflationSpace(std::vector<ColorSpinorField> &evecs);
+
     /**
        @brief Computes Left/Right SVD from pre computed Right/Left
        @param[in] evecs Computed eigenvectors of NormOp
@@ -543,6 +643,65 @@ namespace quda
                  const QudaEigSpectrumType spec_type);
   };
 
+  /**
+     @brief Chebyshev-filtered subspace iteration.  A subspace of n_ev
+     vectors is repeatedly filtered with the Chebyshev polynomial of
+     the operator, orthonormalized and rotated onto its Ritz vectors.
+     Since each sweep needs nothing but the current subspace, the
+     solver can be warm started from eigenvectors of a nearby
+     operator, e.g., those of the previous gauge field in a trajectory.
+  */
+  class ChFSI : public EigenSolver
+  {
+
+  public:
+    /** Ritz values of the current subspace */
+    std::vector<double> ritz;
+
+    /**
+       @brief Constructor for the Chebyshev-filtered subspace iteration class
+       @param eig_param The eigensolver parameters
+       @param mat The operator to solve
+       @param profile Time Profile
+    */
+    ChFSI(const DiracMatrix &mat, QudaEigParam *eig_param, TimeProfile &profile);
+
+    /**
+       @return Whether the solver is only for Hermitian systems
+    */
+    virtual bool hermitian() { return true; } /** ChFSI is only for Hermitian systems */
+
+    /**
+       @brief Compute eigenpairs
+       @param[in] kSpace Subspace vectors, used as an initial guess where non-zero
+       @param[in] evals Computed eigenvalues
+    */
+    void operator()(std::vector<ColorSpinorField> &kSpace, std::vector<Complex> &evals);
+
+    /**
+       @brief Apply the Chebyshev filter to the unlocked vectors of
+       the subspace, in batches of block_size using multi-RHS
+       operator applications
+       @param[in,out] kSpace The subspace
+    */
+    void filter(std::vector<ColorSpinorField> &kSpace);
+
+    /**
+       @brief Orthonormalize the unlocked vectors of the subspace,
+       against the locked vectors and amongst themselves
+       @param[in,out] kSpace The subspace
+    */
+    void orthonormalize(std::vector<ColorSpinorField> &kSpace);
+
+    /**
+       @brief Rayleigh-Ritz projection of the operator onto the
+       unlocked vectors of the subspace, rotating these onto the Ritz
+       vectors and computing their residua
+       @param[in,out] kSpace The subspace
+    */
+    void rayleighRitz(std::vector<ColorSpinorField> &kSpace);
+  };
+
   /**
      arpack_solve()
 
@@ -48,6 +48,7 @@ typedef enum QudaGaugeFieldOrder_s {
   QUDA_BQCD_GAUGE_ORDER,        // expect *gauge, mu, even-odd, spacetime+halos, column-row order
   QUDA_TIFR_GAUGE_ORDER,        // expect *gauge, mu, even-odd, spacetime, column-row order
   QUDA_TIFR_PADDED_GAUGE_ORDER, // expect *gauge, mu, parity, t, z+halo, y, x/2, column-row order
+  QUDA_ILDG_GAUGE_ORDER,        // expect *gauge, global lexicographic spacetime, mu, row-column, big endian (read only)
   QUDA_INVALID_GAUGE_ORDER = QUDA_INVALID_ENUM
 } QudaGaugeFieldOrder;
 
@@ -126,6 +127,9 @@ typedef enum QudaInverterType_s {
   QUDA_CA_CGNE_INVERTER,
   QUDA_CA_CGNR_INVERTER,
   QUDA_CA_GCR_INVERTER,
+  QUDA_PIPELINED_CG_INVERTER,
+  QUDA_BLOCK_CG_INVERTER,
+  QUDA_GCRODR_INVERTER,
   QUDA_INVALID_INVERTER = QUDA_INVALID_ENUM
 } QudaInverterType;
 
@@ -134,6 +138,7 @@ typedef enum QudaEigType_s {
   QUDA_EIG_BLK_TR_LANCZOS, // Block Thick restarted lanczos solver
   QUDA_EIG_IR_ARNOLDI,     // Implicitly Restarted Arnoldi solver
   QUDA_EIG_BLK_IR_ARNOLDI, // Block Implicitly Restarted Arnoldi solver
+  QUDA_EIG_CHFSI,          // Chebyshev-filtered subspace iteration
   QUDA_EIG_INVALID = QUDA_INVALID_ENUM
 } QudaEigType;
 
@@ -394,6 +399,9 @@ typedef enum QudaDilutionType_s {
   QUDA_DILUTION_COLOR,
   QUDA_DILUTION_SPIN_COLOR,
   QUDA_DILUTION_SPIN_COLOR_EVEN_ODD,
+  QUDA_DILUTION_TIME_SLICE,        // one source per global time slice
+  QUDA_DILUTION_BLOCK,             // one source per lattice block
+  QUDA_DILUTION_HADAMARD_PROBING,  // hierarchical probing with Hadamard vectors
   QUDA_DILUTION_INVALID = QUDA_INVALID_ENUM
 } QudaDilutionType;
 
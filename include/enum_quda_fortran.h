@@ -51,6 +51,7 @@
 #define QUDA_BQCD_GAUGE_ORDER 15 // expect *gauge mu even-odd spacetime+halos row-column order
 #define QUDA_TIFR_GAUGE_ORDER 16
 #define QUDA_TIFR_PADDED_GAUGE_ORDER 17
+#define QUDA_ILDG_GAUGE_ORDER 18 // expect *gauge global lexicographic spacetime mu row-column big endian (read only)
 #define QUDA_INVALID_GAUGE_ORDER QUDA_INVALID_ENUM
 
 #define QudaTboundary integer(4)
@@ -121,6 +122,9 @@
 #define QUDA_CA_CGNE_INVERTER 20
 #define QUDA_CA_CGNR_INVERTER 21
 #define QUDA_CA_GCR_INVERTER 22
+#define QUDA_PIPELINED_CG_INVERTER 23
+#define QUDA_BLOCK_CG_INVERTER 24
+#define QUDA_GCRODR_INVERTER 25
 #define QUDA_INVALID_INVERTER QUDA_INVALID_ENUM
 
 #define QudaEigType integer(4)
@@ -128,6 +132,7 @@
 #define QUDA_EIG_BLK_IR_LANCZOS 1 // Block Thick Restarted Lanczos Solver
 #define QUDA_EIG_IR_ARNOLDI 2 // Implicitly restarted Arnoldi solver
 #define QUDA_EIG_BLK_IR_ARNOLDI 3 // Block Implicitly restarted Arnoldi solver (not yet implemented)
+#define QUDA_EIG_CHFSI 4 // Chebyshev-filtered subspace iteration
 #define QUDA_EIG_INVALID QUDA_INVALID_ENUM
 
 #define QudaEigSpectrumType integer(4)
@@ -366,6 +371,9 @@
 #define QUDA_DILUTION_COLOR 1
 #define QUDA_DILUTION_SPIN_COLOR 2
 #define QUDA_DILUTION_SPIN_COLOR_EVEN_ODD 3
+#define QUDA_DILUTION_TIME_SLICE 4
+#define QUDA_DILUTION_BLOCK 5
+#define QUDA_DILUTION_HADAMARD_PROBING 6
 #define QUDA_DILUTION_INVALID QUDA_INVALID_ENUM
 
 #define QudaProjectionType integer(4)
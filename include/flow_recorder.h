@@ -0,0 +1,79 @@
+#pragma once
+
+#include <fstream>
+#include <quda.h>
+
+namespace quda
+{
+
+  /**
+     @brief Records the observables measured along the gradient flow
+     and extracts the scales t0 and w0 on the fly.  The scale t0 is
+     defined by t^2 E(t) = t0_ref at t = t0, and w0 by
+     W(t) = t d/dt t^2 E(t) = w0_ref at t = w0^2, with both found by
+     linear interpolation between successive measurements.  If a
+     record file is given, each measurement is appended to it as a
+     JSON object on its own line, preceded by a header line with the
+     flow parameters and followed by a summary line with the scales.
+     Only rank 0 writes to the file.
+   */
+  class FlowRecorder
+  {
+    std::ofstream stream; /** The record stream (if any) */
+    const double t0_ref;  /** The reference value of t^2 E defining t0 (not computed if zero) */
+    const double w0_ref;  /** The reference value of W defining w0 (not computed if zero) */
+    const bool stop;      /** Whether the flow should stop once the requested scales are found */
+
+    int n_meas = 0;          /** The number of measurements recorded */
+    double t_prev = 0.0;     /** The flow time of the previous measurement */
+    double t2E_prev = 0.0;   /** t^2 E at the previous measurement */
+    double t_W_prev = 0.0;   /** The flow time of the previous W evaluation */
+    double W_prev = 0.0;     /** The previous W evaluation */
+    double t0_ = -1.0;       /** The extracted t0 / a^2, negative if not yet bracketed */
+    double w0_ = -1.0;       /** The extracted w0 / a, negative if not yet bracketed */
+
+  public:
+    /**
+       @brief Constructor for the flow recorder
+       @param[in] param The flow parameters
+     */
+    FlowRecorder(const QudaGaugeSmearParam &param);
+
+    /**
+       @brief Destructor, writes the summary line to the record stream
+     */
+    ~FlowRecorder();
+
+    FlowRecorder(const FlowRecorder &) = delete;
+    FlowRecorder &operator=(const FlowRecorder &) = delete;
+
+    /**
+       @brief Record the observables measured at a given flow time.
+       Measurements must be recorded in order of increasing flow time.
+       @param[in] t The flow time
+       @param[in] obs The observables measured at time t
+     */
+    void record(double t, const QudaGaugeObservableParam &obs);
+
+    /**
+       @return The extracted t0 / a^2, negative if not bracketed
+     */
+    double t0() const { return t0_; }
+
+    /**
+       @return The extracted w0 / a, negative if not bracketed
+     */
+    double w0() const { return w0_; }
+
+    /**
+       @return Whether early stopping was requested and all of the
+       requested scales have been bracketed
+     */
+    bool done() const
+    {
+      return stop && (t0_ref > 0.0 || w0_ref > 0.0) && (t0_ref <= 0.0 || t0_ >= 0.0)
+        && (w0_ref <= 0.0 || w0_ >= 0.0);
+    }
+  };
+
+} // namespace quda
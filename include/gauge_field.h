@@ -423,6 +423,14 @@ namespace quda {
      */
     uint64_t checksum(bool mini = false) const;
 
+    /**
+       @brief Compute a cryptographic (SHA-256) digest of this gauge
+       field, e.g., for provenance records.  This is considerably
+       more expensive than checksum().  See Digest().
+       @return Hexadecimal digest string
+     */
+    std::string digest() const;
+
     /**
        @brief Create the gauge field, with meta data specified in the
        parameter struct.
@@ -822,6 +830,12 @@ namespace quda {
   /**
      Compute XOR-based checksum of this gauge field: each gauge field entry is
      converted to type uint64_t, and compute the cummulative XOR of these values.
+     Host-order fields are checksummed across host threads and
+     native-order device fields are checksummed on the device, with
+     the per-process values combined with an XOR all-reduce.  Since
+     the checksum is computed on the reconstructed links, fields that
+     hold identical links give identical checksums regardless of
+     order or location.
      @param[in] mini Whether to compute a mini checksum or global checksum.
      A mini checksum only computes over a subset of the lattice
      sites and is to be used for online comparisons, e.g., checking
@@ -830,6 +844,23 @@ namespace quda {
   */
   uint64_t Checksum(const GaugeField &u, bool mini=false);
 
+  /**
+     Compute a SHA-256 digest of this gauge field.  The field is
+     first converted to a canonical (double-precision, uncompressed,
+     unpadded) representation, each process digests its local
+     sub-volume, and the final digest is taken over the per-process
+     digests in rank order.  The result is thus independent of the
+     field order, location and padding, but depends on the process
+     decomposition.  Compressed fields (reconstruct 12/8/13/9) are
+     digested through their reconstructed links, so the digest is
+     independent of the order for a given reconstruct type, but a
+     compressed copy will in general not digest to the same value as
+     the uncompressed field it was made from.
+     @param[in] u The field we are digesting
+     @return Hexadecimal digest string
+  */
+  std::string Digest(const GaugeField &u);
+
   /**
      @brief Helper function for determining if the reconstruct of the fields is the same.
      @param[in] a Input field
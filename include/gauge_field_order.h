@@ -2315,6 +2315,89 @@ namespace quda {
       size_t Bytes() const { return Nc * Nc * 2 * sizeof(Float); }
     };
 
+    /**
+       @brief Accessor for the binary payload of an ILDG (or SciDAC
+       single-file) gauge configuration, typically memory mapped
+       directly from disk.  The payload covers the global lattice in
+       lexicographic order (x fastest), with each site storing the
+       four links [mu][row][column] as big-endian reals.  Each process
+       reads only its local sub-volume, so no data are redistributed.
+       This accessor is read only.
+     */
+    template <typename Float, int length> struct ILDGOrder : LegacyOrder<Float, length> {
+      using Accessor = ILDGOrder<Float, length>;
+      using real = typename mapper<Float>::type;
+      using complex = complex<real>;
+      const Float *gauge;
+      const int volumeCB;
+      static constexpr int Nc = 3;
+      int dim[4];
+      int global_dim[4];
+      int offset[4];
+      ILDGOrder(const GaugeField &u, Float *gauge_ = 0, Float **ghost_ = 0) :
+        LegacyOrder<Float, length>(u, ghost_),
+        gauge(gauge_ ? gauge_ : (Float *)u.Gauge_p()),
+        volumeCB(u.VolumeCB())
+      {
+        if constexpr (length != 18) errorQuda("Gauge length %d not supported", length);
+        if (u.Geometry() != QUDA_VECTOR_GEOMETRY) errorQuda("Geometry %d not supported", u.Geometry());
+        for (int i = 0; i < 4; i++) {
+          dim[i] = u.X()[i];
+          global_dim[i] = comm_dim(i) * dim[i];
+          offset[i] = comm_coord(i) * dim[i];
+        }
+      }
+
+      /**
+         @brief Load a big-endian real from the payload, assuming a
+         little-endian host
+      */
+      __device__ __host__ inline real load_be(const Float *in) const
+      {
+        char b[sizeof(Float)];
+        memcpy(b, in, sizeof(Float));
+#pragma unroll
+        for (unsigned int i = 0; i < sizeof(Float) / 2; i++) {
+          char tmp = b[i];
+          b[i] = b[sizeof(Float) - 1 - i];
+          b[sizeof(Float) - 1 - i] = tmp;
+        }
+        Float f;
+        memcpy(&f, b, sizeof(Float));
+        return f;
+      }
+
+      __device__ __host__ inline void load(complex v[9], int x, int dir, int parity, real = 1.0) const
+      {
+        int coord[4];
+        getCoords(coord, x, dim, parity);
+
+        size_t site = 0;
+        for (int d = 3; d >= 0; d--) site = site * global_dim[d] + coord[d] + offset[d];
+        auto in = &gauge[(site * 4 + dir) * length];
+
+#pragma unroll
+        for (int i = 0; i < length / 2; i++) v[i] = complex(load_be(in + 2 * i), load_be(in + 2 * i + 1));
+      }
+
+      /**
+         @brief This accessor routine returns a gauge_wrapper to this object,
+         allowing us to overload various operators for manipulating at
+         the site level interms of matrix operations.
+         @param[in] dir Which dimension are we requesting
+         @param[in] x_cb Checkerboarded space-time index we are requesting
+         @param[in] parity Parity we are requesting
+         @return Instance of a gauge_wrapper that curries in access to
+         this field at the above coordinates.
+       */
+      __device__ __host__ inline auto operator()(int dim, int x_cb, int parity) const
+      {
+        return gauge_wrapper<real, Accessor>(const_cast<Accessor &>(*this), dim, x_cb, parity);
+      }
+
+      size_t Bytes() const { return Nc * Nc * 2 * sizeof(Float); }
+    };
+
   } // namespace gauge
 
   template <typename real_out_t, typename store_out_t, typename real_in_t, typename store_in_t, bool block_float, typename norm_t>
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <quda_internal.h>
+
+namespace quda
+{
+
+  /**
+     @brief Memory map the binary payload of a gauge configuration
+     stored in ILDG or SciDAC (QIO single-file) LIME format.  The file
+     is mapped read only and shared, so processes on the same node
+     share the page cache and only touch the pages holding their own
+     sub-volume.  The LIME records are parsed once per file: repeated
+     calls for the same, unmodified file return the existing mapping.
+     The returned payload can be wrapped in a QUDA_ILDG_GAUGE_ORDER
+     reference field and reordered with copyGenericGauge.
+     @param[in] filename The file we are mapping
+     @param[out] precision The precision of the payload
+     @param[out] X The global lattice dimensions of the payload
+     @return Pointer to the start of the binary payload
+   */
+  const void *mapGaugeFile(const char *filename, QudaPrecision &precision, lat_dim_t &X);
+
+  /**
+     @brief Release a mapping previously returned by mapGaugeFile.
+     The file is unmapped once all references have been released.
+     @param[in] payload The payload pointer returned by mapGaugeFile
+   */
+  void unmapGaugeFile(const void *payload);
+
+} // namespace quda
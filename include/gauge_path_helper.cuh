@@ -4,6 +4,9 @@
 #include <quda_matrix.h>
 #include <index_helper.cuh>
 #include <kernel.h>
+#include <array>
+#include <map>
+#include <vector>
 
 namespace quda {
 
@@ -72,6 +75,245 @@ namespace quda {
   constexpr int flipDir(int dir) { return (7-dir); }
   constexpr bool isForwards(int dir) { return (dir <= 3); }
 
+  /**
+     @brief Maximum number of partial products saved while walking a
+     path trie; tries that need more are evaluated path by path
+   */
+  constexpr int max_path_stack() { return 6; }
+
+  /**
+     @brief Whether gauge paths are evaluated from a path trie, as
+     set by setPathTrie (default true)
+   */
+  bool pathTrieEnabled();
+
+  /**
+     @brief A node of a path trie.  Each node is a distinct path
+     prefix, whose product is that of its parent prefix times one
+     link.  The nodes of each tree are stored in depth-first order, so
+     the product of the parent is the running product, except for the
+     later children of a node with several children, for which it is
+     restored from the saved products.
+   */
+  struct path_node {
+    static constexpr int none = -1;     // continue from the running product / do not save
+    static constexpr int identity = -2; // restart from the identity (later children of the root)
+    int dir;        // link direction
+    int forwards;   // whether the link is traversed forwards (U) or backwards (U^dagger)
+    int offset[4];  // displacement of the link site from the origin of the path
+    int parity;     // parity of the displacement
+    int restore;    // saved product to restore before multiplying by the link
+    int save;       // slot to save the product in, if the node has several children
+    int term_begin; // range of the paths ending at this node in the term list
+    int term_end;
+    double coeff;   // sum of the coefficients of the paths ending at this node
+  };
+
+  /**
+     @brief A path ending at a node of a path trie
+   */
+  struct path_term {
+    int path;     // index of the path in the input
+    int slot;     // output slot of the path in its tree
+    double coeff; // path coefficient
+  };
+
+  /**
+     @brief Input path for the trie compiler
+   */
+  struct path_entry {
+    const int *step; // the path directions, 0-3 forwards and 4-7 backwards
+    int length;
+    double coeff;
+    int path;        // index of the path in the input
+    int slot;        // output slot of the path in its tree
+  };
+
+  /**
+     @brief A set of paths compiled into one trie per tree (e.g., per
+     force direction, or per batch of loops).  Shared prefixes are
+     evaluated once per site, and the displacement and parity of every
+     link are computed once on the host.  Paths with zero coefficient
+     are dropped.  If a path is empty, the walk would need more than
+     max_path_stack() saved products, or the trie has been switched off
+     with setPathTrie, the trie is disabled and callers
+     fall back to evaluating each path in turn, using the term list for
+     the paths of each tree.
+   */
+  struct path_trie {
+    int num_trees = 0;
+    int num_nodes = 0;
+    int num_terms = 0;
+    int stack_depth = 0;  // number of saved products needed
+    bool enabled = false; // whether the trie can be walked
+    const int *tree;      // node range of each tree, tree[t] to tree[t + 1]
+    const int *tree_term; // term range of each tree, tree_term[t] to tree_term[t + 1]
+    const path_node *node;
+    const path_term *term;
+    void *buffer = nullptr;
+    int *tree_host = nullptr; // host copy of the node range of each tree
+
+  private:
+    struct host_node {
+      path_node node;
+      std::map<int, int> child; // child node for each step direction
+      std::vector<path_term> term;
+    };
+
+    /**
+       @brief Emit the subtree of node i in depth-first order, and
+       return the stack depth it needs
+     */
+    static int emit(std::vector<host_node> &trie, int i, int restore, int slot, std::vector<path_node> &node,
+                    std::vector<path_term> &term)
+    {
+      auto &n = trie[i];
+      bool branch = n.child.size() > 1;
+      int depth = 0;
+      if (i != 0) {
+        n.node.restore = restore;
+        n.node.save = branch ? slot : path_node::none;
+        n.node.term_begin = term.size();
+        for (auto &t : n.term) term.push_back(t);
+        n.node.term_end = term.size();
+        node.push_back(n.node);
+        if (branch) depth = slot + 1;
+      }
+
+      // the first child continues from this node, the others restore its product
+      int child_slot = (i != 0 && branch) ? slot + 1 : slot;
+      int saved = i == 0 ? path_node::identity : (branch ? slot : path_node::none);
+      bool first = true;
+      for (auto &c : n.child) {
+        depth = std::max(depth, emit(trie, c.second, first ? path_node::none : saved, child_slot, node, term));
+        first = false;
+      }
+      return depth;
+    }
+
+  public:
+    path_trie() = default;
+
+    /**
+       @brief Compile the paths of each tree
+       @param[in] paths The paths of each tree
+       @param[in] origin The displacement of the origin of the paths of each tree
+     */
+    path_trie(const std::vector<std::vector<path_entry>> &paths, const std::vector<std::array<int, 4>> &origin) :
+      num_trees(paths.size())
+    {
+      if (origin.size() != paths.size()) errorQuda("Origin size %lu != number of trees %lu", origin.size(), paths.size());
+
+      std::vector<int> tree_h(1, 0);
+      std::vector<int> tree_term_h(1, 0);
+      std::vector<path_node> node_h;
+      std::vector<path_term> term_h;
+      bool empty = false;
+
+      for (auto t = 0u; t < paths.size(); t++) {
+        std::vector<host_node> trie(1);
+        std::vector<path_term> root_term;
+        for (auto &p : paths[t]) {
+          path_term term = {p.path, p.slot, p.coeff};
+          if (p.coeff == 0.0) continue;
+          if (p.length == 0) {
+            root_term.push_back(term);
+            empty = true;
+            continue;
+          }
+
+          std::array<int, 4> x = origin[t];
+          int i = 0;
+          for (int j = 0; j < p.length; j++) {
+            int step = p.step[j];
+            bool forwards = isForwards(step);
+            int dir = forwards ? step : flipDir(step);
+            if (!forwards) x[dir]--; // if we are going backwards the link is on the adjacent site
+            auto c = trie[i].child.find(step);
+            if (c == trie[i].child.end()) {
+              host_node n = {};
+              n.node.dir = dir;
+              n.node.forwards = forwards;
+              for (int d = 0; d < 4; d++) n.node.offset[d] = x[d];
+              n.node.parity = (x[0] + x[1] + x[2] + x[3]) & 1;
+              trie[i].child[step] = trie.size();
+              i = trie.size();
+              trie.push_back(n);
+            } else {
+              i = c->second;
+            }
+            if (forwards) x[dir]++;
+          }
+          trie[i].term.push_back(term);
+          trie[i].node.coeff += p.coeff;
+        }
+
+        for (auto &r : root_term) term_h.push_back(r);
+        stack_depth = std::max(stack_depth, emit(trie, 0, path_node::none, 0, node_h, term_h));
+        tree_h.push_back(node_h.size());
+        tree_term_h.push_back(term_h.size());
+      }
+
+      num_nodes = node_h.size();
+      num_terms = term_h.size();
+      enabled = pathTrieEnabled() && !empty && stack_depth <= max_path_stack();
+
+      // create the trie in a single allocation
+      size_t tree_bytes = 2 * (num_trees + 1) * sizeof(int);
+      tree_bytes = ((tree_bytes + sizeof(double) - 1) / sizeof(double)) * sizeof(double);
+      size_t node_bytes = num_nodes * sizeof(path_node);
+      size_t term_bytes = num_terms * sizeof(path_term);
+      size_t bytes = tree_bytes + node_bytes + term_bytes;
+
+      buffer = pool_device_malloc(bytes);
+      char *trie_h = static_cast<char *>(safe_malloc(bytes));
+      memcpy(trie_h, tree_h.data(), (num_trees + 1) * sizeof(int));
+      memcpy(trie_h + (num_trees + 1) * sizeof(int), tree_term_h.data(), (num_trees + 1) * sizeof(int));
+      if (num_nodes) memcpy(trie_h + tree_bytes, node_h.data(), node_bytes);
+      if (num_terms) memcpy(trie_h + tree_bytes + node_bytes, term_h.data(), term_bytes);
+      qudaMemcpy(buffer, trie_h, bytes, qudaMemcpyHostToDevice);
+      host_free(trie_h);
+
+      tree_host = static_cast<int *>(safe_malloc((num_trees + 1) * sizeof(int)));
+      memcpy(tree_host, tree_h.data(), (num_trees + 1) * sizeof(int));
+
+      auto b = static_cast<char *>(buffer);
+      tree = reinterpret_cast<const int *>(b);
+      tree_term = tree + num_trees + 1;
+      node = reinterpret_cast<const path_node *>(b + tree_bytes);
+      term = reinterpret_cast<const path_term *>(b + tree_bytes + node_bytes);
+    }
+
+    /**
+       @brief The number of nodes of a tree, i.e., the number of links
+       loaded per site when walking it
+       @param[in] t The tree
+     */
+    int tree_nodes(int t) const { return tree_host[t + 1] - tree_host[t]; }
+
+    void free()
+    {
+      if (buffer) pool_device_free(buffer);
+      if (tree_host) host_free(tree_host);
+      buffer = nullptr;
+      tree_host = nullptr;
+    }
+  };
+
+  /**
+     @brief Return the trie compiled from the given paths.  Compiled
+     tries are cached on the paths, coefficients, output slots and
+     origins (and on whether the trie is enabled), so repeated calls
+     with the same path set, e.g., the gauge force of every HMC step,
+     reuse the uploaded trie.  The trie is owned by the cache and is
+     freed by freePathTrieCache.
+     @param[in] paths The paths of each tree
+     @param[in] origin The displacement of the origin of the paths of each tree
+     @return The compiled trie
+   */
+  const path_trie &getPathTrie(const std::vector<std::vector<path_entry>> &paths,
+                               const std::vector<std::array<int, 4>> &origin);
+
   /**
      @brief Calculates an arbitary gauge path, returning the product matrix
 
@@ -117,5 +359,46 @@ namespace quda {
     return linkA;
   }
 
+
+  /**
+     @brief Walk one tree of a path trie at a given site, calling f(node,
+     product) at every node where a path ends
+
+     @param[in] arg Kernel argument
+     @param[in] trie The path trie
+     @param[in] tree The tree to walk
+     @param[in] x Full index array
+     @param[in] parity Parity index of x
+     @param[in] f The function applied at each path end
+  */
+  template <typename Arg, typename F>
+  __device__ __host__ inline void walkPathTrie(const Arg &arg, const path_trie &trie, int tree, const int x[4],
+                                               int parity, F &&f)
+  {
+    using Link = typename Arg::Link;
+
+    // prod: running product of the current prefix
+    // stack: saved products of the prefixes with several children
+    Link prod, stack[max_path_stack()];
+    setIdentity(&prod);
+
+    for (int i = trie.tree[tree]; i < trie.tree[tree + 1]; i++) {
+      const path_node &n = trie.node[i];
+      // the stack is only indexed with compile-time indices so that it stays in registers
+      if (n.restore == path_node::identity) setIdentity(&prod);
+#pragma unroll
+      for (int s = 0; s < max_path_stack(); s++)
+        if (s == n.restore) prod = stack[s];
+
+      Link link = arg.u(n.dir, linkIndexShift(x, n.offset, arg.E), parity ^ n.parity);
+      prod = n.forwards ? prod * link : prod * conj(link);
+
+#pragma unroll
+      for (int s = 0; s < max_path_stack(); s++)
+        if (s == n.save) stack[s] = prod;
+      if (n.term_begin < n.term_end) f(n, prod);
+    }
+  }
+
 }
 
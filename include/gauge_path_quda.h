@@ -46,4 +46,19 @@ namespace quda
                       std::vector<int **> &input_path, std::vector<int> &length, std::vector<double> &path_coeff_h,
                       int num_paths, int path_max_length);
 
+  /**
+     @brief Set whether gaugeForce, gaugePath and gaugeLoopTrace
+     evaluate their paths from a shared-prefix path trie (the
+     default), or one path at a time.  The latter is used to verify
+     the trie.
+     @param[in] enable Whether to use the path trie
+   */
+  void setPathTrie(bool enable);
+
+  /**
+     @brief Free the path tries cached by gaugeForce, gaugePath and
+     gaugeLoopTrace
+   */
+  void freePathTrieCache();
+
 } // namespace quda
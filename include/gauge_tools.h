@@ -60,6 +60,11 @@ namespace quda
      distribution (sigma = 0 results in a free field, and sigma = 1 has
      maximum disorder).
 
+     This variant uses the stateless counter-based generator (see
+     counter_rng.h), with an independent stream for each link
+     direction, so the field generated is independent of the lattice
+     partitioning and no random number state is allocated.
+
      @param[out] U The GaugeField
      @param[in] seed The seed used for the RNG
      @param[in] sigma Wdith of the Gaussian distribution
@@ -132,6 +137,27 @@ namespace quda
   */
   void WFlowStep(GaugeField &out, GaugeField &temp, GaugeField &in, double epsilon, QudaGaugeSmearType smear_type);
 
+  /**
+     @brief Apply a Wilson Flow step with an error estimate for
+     adaptive step size control.  The third-order steps W1, W2, Vt are
+     as in WFlowStep, with the embedded second-order solution
+     exp(2 Z1 - 5/4 Z0) W1 formed alongside.  Unlike WFlowStep, the
+     input field is left unchanged so that a rejected step can be
+     retried.  The fields are assumed extended, with the input field
+     being exchanged prior to calling this function.
+     @param[out] out Output smeared field
+     @param[out] stage Extended field holding the intermediate stage
+     @param[in] temp Temp space
+     @param[in] err Temp space for the error estimate, must not use reconstruct
+     @param[in] in Input gauge field
+     @param[in] epsilon Step size
+     @param[in] smear_type Wilson (1x1) or Symanzik improved (2x1) staples, else error
+     @return The local error estimate, the maximum absolute difference
+     between the third- and second-order solutions
+  */
+  double WFlowStepAdaptive(GaugeField &out, GaugeField &stage, GaugeField &temp, GaugeField &err,
+                           const GaugeField &in, double epsilon, QudaGaugeSmearType smear_type);
+
   /**
    * @brief Gauge fixing with overrelaxation with support for single and multi GPU.
    * @param[in,out] data, quda gauge field
@@ -160,9 +186,18 @@ namespace quda
    * value is zero then the method stops when iteration reachs the
    * maximum number of steps defined by Nsteps
    * @param[in] stopWtheta, 0 for MILC criterion and 1 to use the theta value
+   * @param[in] cg, use the Polak-Ribiere conjugate gradient method
+   * with a line search, where alpha is the initial step and is
+   * adapted every iteration (autotune is then ignored).  Device
+   * fields use the cuFFT / hipFFT plans, and QDP ordered host fields
+   * the host FFT.
+   * @param[out] quality, if non-null, the functional and theta of
+   * the last step are returned here
+   * @return The number of iterations performed
    */
-  void gaugeFixingFFT(GaugeField &data, const int gauge_dir, const int Nsteps, const int verbose_interval,
-                      const double alpha, const int autotune, const double tolerance, const int stopWtheta);
+  int gaugeFixingFFT(GaugeField &data, const int gauge_dir, const int Nsteps, const int verbose_interval,
+                     const double alpha, const int autotune, const double tolerance, const int stopWtheta,
+                     const bool cg = false, double *quality = nullptr);
 
   /**
      @brief Compute the Fmunu tensor
@@ -191,6 +226,23 @@ namespace quda
   */
   void computeQChargeDensity(double energy[3], double &qcharge, void *qdensity, const GaugeField &Fmunu);
 
+  /**
+     @brief Compute the plaquette, field energy and topological charge
+     (and optionally its density) in a single pass over the gauge
+     field.  The clover field strength is formed on the fly, so no
+     field-strength tensor is allocated.  Both native-ordered device
+     fields and QDP-ordered host fields are supported, the latter
+     allowing the device result to be validated on the host.
+     @param[in] u The gauge field, which must be extended in any partitioned dimension
+     @param[out] plaq The average, spatial and temporal plaquette
+     @param[out] energy The total, spatial, and temporal field energy
+     @param[out] qcharge The total topological charge
+     @param[out] qdensity The topological charge at each lattice site
+     (in the location of u), not computed if nullptr
+  */
+  void gaugeObservablesFused(const GaugeField &u, double plaq[3], double energy[3], double &qcharge,
+                             void *qdensity = nullptr);
+
   /**
    * @brief Compute the trace of the Polyakov loop in a given dimension
    * @param[out] ploop The real and imaginary parts of the Polyakov loop
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <quda_internal.h>
+#include <complex_quda.h>
+
+/**
+   @file host_fft.h
+
+   Host implementation of the batched 2-d complex-to-complex FFT plans
+   used by the FFT gauge fixing.  The interface mirrors FFT_Plans.h, so
+   the same algorithm can be instantiated with either the device plan
+   (cuFFT / hipFFT) or this host plan.  Transforms are unnormalized,
+   with the forward transform having exponent sign -1 as for FFT_FORWARD.
+   Any transform length is supported using a mixed-radix Cooley-Tukey
+   decomposition.
+ */
+
+namespace quda
+{
+
+  /**
+     @brief Plan for a 1-d transform of a given length
+   */
+  struct HostFFTPlan1D {
+    int n = 0;                              /** Transform length */
+    std::vector<int> factors;               /** Radices of the decomposition */
+    std::vector<std::complex<double>> root; /** The n-th roots of unity exp(-2 pi i k / n) */
+  };
+
+  /**
+     @brief Plan for batched 2-d transforms of contiguous n[0] x n[1]
+     arrays with n[1] running fastest, matching cufftPlanMany with
+     default strides
+   */
+  struct HostFFTPlan {
+    HostFFTPlan1D plan[2]; /** The plans of the outer and inner dimensions */
+    int batch = 0;         /** Number of 2-d arrays */
+    QudaPrecision precision = QUDA_INVALID_PRECISION;
+  };
+
+  /**
+   * @brief Creates a host plan supporting 4D (2D+2D) data layouts for complex-to-complex
+   * @param[out] plan, host plan
+   * @param[in] size, int4 with lattice size dimensions, (.x,.y,.z,.w) -> (Nx, Ny, Nz, Nt)
+   * @param[in] dim, 0 for 2D plan in Z-T planes with batch size Nx*Ny, 1 for 2D plan in X-Y planes with batch size Nz*Nt
+   * @param[in] precision The precision of the computation
+   */
+  void SetPlanFFT2DMany(HostFFTPlan &plan, int4 size, int dim, QudaPrecision precision);
+
+  /**
+   * @brief Perform a single-precision complex-to-complex transform on the host
+   * @param[in] plan, host plan
+   * @param[in] data_in, pointer to the complex input data (in host memory) to transform
+   * @param[out] data_out, pointer to the complex output data (in host memory), may alias data_in
+   * @param[in] direction, the transform direction: FFT_FORWARD or FFT_INVERSE
+   */
+  void ApplyFFT(HostFFTPlan &plan, complex<float> *data_in, complex<float> *data_out, int direction);
+
+  /**
+   * @brief Perform a double-precision complex-to-complex transform on the host
+   * @param[in] plan, host plan
+   * @param[in] data_in, pointer to the complex input data (in host memory) to transform
+   * @param[out] data_out, pointer to the complex output data (in host memory), may alias data_in
+   * @param[in] direction, the transform direction: FFT_FORWARD or FFT_INVERSE
+   */
+  void ApplyFFT(HostFFTPlan &plan, complex<double> *data_in, complex<double> *data_out, int direction);
+
+  /**
+   * @brief Release a host plan
+   */
+  void FFTDestroyPlan(HostFFTPlan &plan);
+
+} // namespace quda
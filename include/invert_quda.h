@@ -40,6 +40,16 @@ namespace quda {
      */
     void *deflation_op;
 
+    /**
+     * Recycle space preserved by GCRO-DR between solves
+     */
+    void *recycle_space;
+
+    /**
+     * Whether GCRO-DR preserves its recycle space at the end of the solve
+     */
+    bool preserve_recycle;
+
     /**
      * Whether to use the L2 relative residual, L2 absolute residual
      * or Fermilab heavy-quark residual, or combinations therein to
@@ -210,6 +220,9 @@ namespace quda {
     /** Maximum eigenvalue for Chebyshev CA basis */
     double ca_lambda_max; // -1 -> power iter generate
 
+    /** Whether to adapt the CA basis length and type, and estimate the Chebyshev bounds, on the fly */
+    bool ca_adaptive;
+
     /** Basis for CA algorithms in a preconditioner */
     QudaCABasis ca_basis_precondition;
 
@@ -288,6 +301,8 @@ namespace quda {
       inv_type_precondition(param.inv_type_precondition),
       preconditioner(param.preconditioner),
       deflation_op(param.deflation_op),
+      recycle_space(param.recycle_space),
+      preserve_recycle(param.preserve_recycle == QUDA_BOOLEAN_TRUE),
       residual_type(param.residual_type),
       deflate(param.eig_param != 0),
       use_init_guess(param.use_init_guess),
@@ -328,6 +343,7 @@ namespace quda {
       ca_basis(param.ca_basis),
       ca_lambda_min(param.ca_lambda_min),
       ca_lambda_max(param.ca_lambda_max),
+      ca_adaptive(param.ca_adaptive == QUDA_BOOLEAN_TRUE),
       ca_basis_precondition(param.ca_basis_precondition),
       ca_lambda_min_precondition(param.ca_lambda_min_precondition),
       ca_lambda_max_precondition(param.ca_lambda_max_precondition),
@@ -379,6 +395,8 @@ namespace quda {
       inv_type_precondition(param.inv_type_precondition),
       preconditioner(param.preconditioner),
       deflation_op(param.deflation_op),
+      recycle_space(param.recycle_space),
+      preserve_recycle(param.preserve_recycle),
       residual_type(param.residual_type),
       deflate(param.deflate),
       eig_param(param.eig_param),
@@ -417,6 +435,7 @@ namespace quda {
       ca_basis(param.ca_basis),
       ca_lambda_min(param.ca_lambda_min),
       ca_lambda_max(param.ca_lambda_max),
+      ca_adaptive(param.ca_adaptive),
       ca_basis_precondition(param.ca_basis_precondition),
       ca_lambda_min_precondition(param.ca_lambda_min_precondition),
       ca_lambda_max_precondition(param.ca_lambda_max_precondition),
@@ -489,6 +508,8 @@ namespace quda {
       param.ca_lambda_min_precondition = ca_lambda_min_precondition;
       param.ca_lambda_max_precondition = ca_lambda_max_precondition;
 
+      param.recycle_space = recycle_space;
+
       if (deflate) *static_cast<QudaEigParam *>(param.eig_param) = eig_param;
     }
 
@@ -528,6 +549,17 @@ namespace quda {
 
     virtual void blocksolve(ColorSpinorField &out, ColorSpinorField &in);
 
+    /**
+       @brief Solve the linear systems for a set of right-hand sides.
+       The default implementation solves each system in turn, while
+       block solvers override this to share the operator application
+       and the Krylov space between the systems.  The true residual
+       of each system is returned in param.true_res_offset.
+       @param[out] out Solution vectors
+       @param[in] in Source vectors
+    */
+    virtual void solve_multi_src(cvector_ref<ColorSpinorField> &out, cvector_ref<ColorSpinorField> &in);
+
     /**
        @return Return the residual vector from the prior solve
     */
@@ -666,6 +698,26 @@ namespace quda {
     */
     void destroyDeflationSpace();
 
+    /**
+       @brief Prepares a newly computed deflation space for use,
+       demoting it to the deflation precision and compressing it if
+       requested
+    */
+    void prepareDeflationSpace();
+
+    /**
+       @brief Recompute the eigenvalues (and singular values if
+       requested) from the current deflation space.  A compressed
+       deflation space no longer holds the eigenvectors, and it cannot
+       be preserved between solves, so its eigenvalues are those just
+       computed by the eigensolver and are retained.  A demoted
+       deflation space is temporarily promoted to the eigensolver
+       precision, so the eigenvalues are computed with the operator
+       precision.
+       @param[in] svd Whether to also compute the singular values
+    */
+    void recomputeDeflationEvals(bool svd = false);
+
     /**
        @brief Extends the deflation space to twice its size for SVD deflation
     */
@@ -1167,6 +1219,80 @@ namespace quda {
     virtual bool hermitian() { return false; } /** GCR is for any linear system */
   };
 
+  /**
+     @brief GCRO-DR: GCR with deflated restarting and subspace
+     recycling (Parks et al., SIAM J. Sci. Comput. 28, 1651 (2006)).
+     Each restart cycle builds a GMRES Krylov space for the operator
+     projected orthogonal to C = A U, where U spans approximate
+     eigenvectors for the smallest harmonic Ritz values of the
+     previous cycles.  The recycle space U outlives the solver when
+     param.preserve_recycle is set, so that a sequence of slowly
+     changing systems (e.g., successive molecular dynamics steps)
+     starts each solve with the slow modes already removed.  Only U
+     is kept between solves: C is recomputed against the current
+     operator on entry, so that a change of gauge field costs one
+     batched application of the sloppy operator.
+  */
+  class GCRODR : public Solver {
+
+  private:
+    int n_krylov; /** Dimension of the search space per cycle, including the recycle space */
+    int n_recycle; /** Dimension of the recycle space */
+
+    /**
+       Solver uses lazy allocation: this flag to determine whether we have allocated.
+     */
+    bool init = false;
+
+    bool recycle = false; /** Whether U and C hold a valid recycle space */
+
+    ColorSpinorField r;        //! residual vector
+    ColorSpinorField r_sloppy; //! sloppy residual vector
+    ColorSpinorField e;        //! sloppy correction accumulated over a cycle
+
+    std::vector<ColorSpinorField> V; /** Arnoldi basis */
+    std::vector<ColorSpinorField> U; /** Recycle space */
+    std::vector<ColorSpinorField> C; /** C = A U, with orthonormal columns */
+    std::vector<ColorSpinorField> U_tmp; /** Workspace used to update U */
+    std::vector<ColorSpinorField> C_tmp; /** Workspace used to update C */
+
+    /**
+       @brief Initiate the fields needed by the solver
+       @param[in] x Solution vector
+       @param[in] b Source vector
+    */
+    void create(ColorSpinorField &x, const ColorSpinorField &b);
+
+    /**
+       @brief Adopt the recycle space preserved by a prior solve, if
+       any, and compute C = A U for the current operator
+       @return Whether a valid recycle space was restored
+    */
+    bool restoreRecycleSpace();
+
+    /**
+       @brief Orthonormalize C by Cholesky QR, applying the same
+       transformation to U so that A U = C is retained
+       @return Whether the factorization succeeded
+    */
+    bool orthonormalizeRecycleSpace();
+
+    /**
+       @brief Store the recycle space in param.recycle_space for a
+       subsequent solve
+    */
+    void preserveRecycleSpace();
+
+  public:
+    GCRODR(const DiracMatrix &mat, const DiracMatrix &matSloppy, const DiracMatrix &matPrecon,
+           const DiracMatrix &matEig, SolverParam &param, TimeProfile &profile);
+    virtual ~GCRODR();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+
+    virtual bool hermitian() { return false; } /** GCRO-DR is for any linear system */
+  };
+
   class MR : public Solver {
 
   private:
@@ -1212,6 +1338,9 @@ namespace quda {
     bool lambda_init;
     QudaCABasis basis;
 
+    double ritz_min; // smallest Ritz value seen, used for the adaptive Chebyshev bounds
+    double ritz_max; // largest Ritz value seen, used for the adaptive Chebyshev bounds
+
     std::vector<double> Q_AQandg; // Fused inner product matrix
     std::vector<double> Q_AS;     // inner product matrix
     std::vector<double> alpha;    // QAQ^{-1} g
@@ -1236,10 +1365,23 @@ namespace quda {
     */
     void create(ColorSpinorField &x, const ColorSpinorField &b);
 
+    /**
+       @return Whether the basis length and type are adapted on the fly
+    */
+    bool adaptive() const { return param.ca_adaptive && !param.is_preconditioner; }
+
+    /**
+       @brief Resize the s-step basis, used when adapting the basis length
+       @param[in] n The new basis length
+    */
+    void resize_basis(int n);
+
     /**
        @brief Compute the alpha coefficients
+       @return Whether the projected matrix Q_AQ was numerically
+       well conditioned, i.e., whether the basis remained stable
     */
-    void compute_alpha();
+    bool compute_alpha();
 
     /**
        @brief Compute the beta coefficients
@@ -1330,6 +1472,102 @@ namespace quda {
     virtual bool hermitian() { return false; } /** CGNE is for any linear system */
   };
 
+  /**
+     @brief Pipelined conjugate gradient solver (Ghysels and Vanroose,
+     https://doi.org/10.1016/j.parco.2013.06.001).  The recurrences
+     are rearranged so that each iteration requires a single fused
+     reduction, whose global all-reduce is overlapped with the
+     application of the sloppy operator.  Reliable updates are
+     performed using residual replacement, after which the auxiliary
+     vectors are recomputed explicitly.
+   */
+  class PipelinedCG : public Solver
+  {
+
+  private:
+    bool init = false;
+
+    ColorSpinorField r; // high-precision residual vector
+    ColorSpinorField y; // high-precision solution accumulator
+    ColorSpinorField rSloppy;
+    ColorSpinorField xSloppy;
+    ColorSpinorField p; // search direction
+    ColorSpinorField w; // A * r
+    ColorSpinorField s; // A * p
+    ColorSpinorField z; // A * s
+    ColorSpinorField q; // A * w
+
+    /**
+       @brief Initiate the fields needed by the solver
+       @param[in] x Solution vector
+       @param[in] b Source vector
+    */
+    void create(ColorSpinorField &x, const ColorSpinorField &b);
+
+  public:
+    PipelinedCG(const DiracMatrix &mat, const DiracMatrix &matSloppy, const DiracMatrix &matPrecon,
+                const DiracMatrix &matEig, SolverParam &param, TimeProfile &profile);
+    virtual ~PipelinedCG();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+
+    /**
+       @return Return the residual vector from the prior solve
+    */
+    ColorSpinorField &get_residual();
+
+    virtual bool hermitian() { return true; } /** CG is only for Hermitian systems */
+  };
+
+  /**
+     @brief Block conjugate gradient solver for multiple right-hand
+     sides (O'Leary, https://doi.org/10.1016/0024-3795(80)90247-5).
+     The operator is applied to the whole block of search directions
+     at once, and the search directions are orthonormalized using a
+     rank-revealing eigen-decomposition of their Gram matrix, so that
+     linearly dependent directions are dropped rather than causing a
+     breakdown.  Systems are removed from the block once their true
+     residual, computed at a reliable update, has converged.
+   */
+  class BlockCG : public Solver
+  {
+
+  private:
+    std::vector<ColorSpinorField> r;       // high-precision residual vectors
+    std::vector<ColorSpinorField> y;       // high-precision solution accumulators
+    std::vector<ColorSpinorField> rSloppy; // sloppy residual vectors
+    std::vector<ColorSpinorField> xSloppy; // sloppy solution accumulators
+    std::vector<ColorSpinorField> p;       // search directions
+    std::vector<ColorSpinorField> q;       // A * p
+    std::vector<ColorSpinorField> w;       // unorthogonalized search directions
+
+    /**
+       @brief Initiate the fields needed by the solver
+       @param[in] x Solution vectors
+       @param[in] b Source vectors
+    */
+    void create(cvector_ref<ColorSpinorField> &x, cvector_ref<ColorSpinorField> &b);
+
+    /**
+       @brief Orthonormalize the vectors w into p, dropping directions
+       whose Gram-matrix eigenvalue falls below the rank tolerance
+       @param[in] m The number of vectors in w
+       @return The number of search directions in p
+    */
+    int orthonormalize(int m);
+
+  public:
+    BlockCG(const DiracMatrix &mat, const DiracMatrix &matSloppy, const DiracMatrix &matPrecon,
+            const DiracMatrix &matEig, SolverParam &param, TimeProfile &profile);
+    virtual ~BlockCG();
+
+    void operator()(ColorSpinorField &out, ColorSpinorField &in);
+
+    void solve_multi_src(cvector_ref<ColorSpinorField> &out, cvector_ref<ColorSpinorField> &in);
+
+    virtual bool hermitian() { return true; } /** CG is only for Hermitian systems */
+  };
+
   /**
      @brief Communication-avoiding GCR solver.  This solver does
      un-preconditioned GCR, first building up a polynomial in the
@@ -1492,6 +1730,17 @@ public:
 
     void create(std::vector<ColorSpinorField> &x, const ColorSpinorField &b, std::vector<ColorSpinorField> &p);
 
+    /**
+       @brief Retire a converged shift: its partial solution is
+       accumulated into x[j] and its sloppy search direction and
+       accumulator are freed.  Must only be called once the shift has
+       received its final update.
+       @param[in,out] x Solution vectors
+       @param[in,out] p Search directions
+       @param[in] j The shift to retire (j > 0)
+     */
+    void retireShift(std::vector<ColorSpinorField> &x, std::vector<ColorSpinorField> &p, int j);
+
   public:
     MultiShiftCG(const DiracMatrix &mat, const DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
 
@@ -1521,6 +1770,44 @@ public:
     }
   };
 
+  /**
+     @brief Batched refinement of a set of shifted systems (A + sigma_i) x_i = b.
+     The true residuals are computed in high precision and the
+     correction equations solved in sloppy precision, with the CG
+     iterations of all the shifts run in lock-step so that the
+     operator is applied to every unconverged shift at once.  The
+     operator does not include the shift: sigma_i = offset[i] for
+     Wilson-type operators, and offset[i] - offset[0] for staggered
+     operators, matching the convention of MultiShiftCG.
+   */
+  class BatchedShiftCG : public MultiShiftSolver
+  {
+
+  public:
+    BatchedShiftCG(const DiracMatrix &mat, const DiracMatrix &matSloppy, SolverParam &param, TimeProfile &profile);
+
+    /**
+       @brief Refine a subset of the shifted systems concurrently,
+       using x as the initial guess and with tolerances param.tol_offset
+       @param[in,out] x Solution vectors for all the shifts
+       @param[in] b Right-hand side
+       @param[in] shifts The shifts to refine
+     */
+    void operator()(std::vector<ColorSpinorField> &x, ColorSpinorField &b, const std::vector<int> &shifts);
+
+    /**
+       @brief Refine all the shifted systems concurrently
+       @param[in,out] x Solution vectors for all the shifts
+       @param[in] b Right-hand side
+     */
+    void operator()(std::vector<ColorSpinorField> &x, ColorSpinorField &b)
+    {
+      std::vector<int> shifts(x.size());
+      for (auto i = 0u; i < x.size(); i++) shifts[i] = i;
+      (*this)(x, b, shifts);
+    }
+  };
+
 
   /**
      @brief This computes the optimum guess for the system Ax=b in the L2
@@ -1555,6 +1842,15 @@ public:
     void solve(std::vector<Complex> &psi_, std::vector<ColorSpinorField> &p, std::vector<ColorSpinorField> &q,
                const ColorSpinorField &b, bool hermitian);
 
+    /**
+       @brief Solve the N x N linear system A psi = phi using Eigen's
+       LDLT decomposition
+       @param[out] psi Array of coefficients
+       @param[in] A Row-major matrix (Gram matrix of the basis)
+       @param[in] phi Right hand side vector
+    */
+    void solve(std::vector<Complex> &psi, const std::vector<Complex> &A, const std::vector<Complex> &phi);
+
   public:
     /**
        @param mat The operator for the linear system we wish to solve
@@ -1572,6 +1868,24 @@ public:
     */
     void operator()(ColorSpinorField &x, const ColorSpinorField &b, std::vector<ColorSpinorField> &p,
                     std::vector<ColorSpinorField> &q);
+
+    /**
+       @brief Incremental variant for a persistent basis.  Basis
+       vectors that are not marked stale are assumed to be
+       orthonormal (if orthogonal is set), to have q = A p, and to
+       have current rows and columns in the Gram matrix.  The stale
+       vectors are orthonormalized against the current ones, their
+       Gram matrix entries computed, and they are then marked current.
+       @param x The optimum for the solution vector.
+       @param b The source vector in the equation to be solved.
+       @param p The basis vectors in which we are building the guess
+       @param q The basis vectors multiplied by A (if apply_mat is
+       false this must hold A p on input for the stale vectors too)
+       @param gram The N x N row-major Gram matrix, updated in place
+       @param stale Which basis vectors are stale, updated in place
+    */
+    void operator()(ColorSpinorField &x, const ColorSpinorField &b, std::vector<ColorSpinorField> &p,
+                    std::vector<ColorSpinorField> &q, std::vector<Complex> &gram, std::vector<bool> &stale);
   };
 
   using ColorSpinorFieldSet = ColorSpinorField;
@@ -1683,6 +1997,14 @@ public:
    std::vector<Complex> evals;          /** The eigenvalues */
  };
 
+ /**
+    @brief This is an object that captures the recycle space of the
+    GCRO-DR solver preserved between solves.
+ */
+ struct recycle_space : public Object {
+   std::vector<ColorSpinorField> U; /** The recycled subspace */
+ };
+
  /**
    @brief Returns if a solver is CA or not
    @return true if CA, false otherwise
@@ -5,6 +5,12 @@
 #include <quda_matrix.h>
 #include <matrix_field.h>
 #include <kernel.h>
+#include <array.h>
+#include <math_helper.cuh>
+#include <block_reduce_helper.h>
+#include <block_reduction_kernel.h>
+#include <atomic_helper.h>
+#include <comm_quda.h>
 
 namespace quda
 {
@@ -35,6 +41,194 @@ namespace quda
     }
   };
 
+  /**
+     @brief Color contract two spinors at a site, giving the open spin
+     matrix A(mu, nu) = <x_mu | y_nu> stored with index 4 * mu + nu
+     @param[out] A The 16 spin components
+     @param[in] x The bra spinor (conjugated)
+     @param[in] y The ket spinor
+   */
+  template <typename real, int nColor, int nSpin>
+  __device__ __host__ inline void contractColor(complex<real> A[nSpin * nSpin],
+                                                const ColorSpinor<real, nColor, nSpin> &x,
+                                                const ColorSpinor<real, nColor, nSpin> &y)
+  {
+#pragma unroll
+    for (int mu = 0; mu < nSpin; mu++) {
+#pragma unroll
+      for (int nu = 0; nu < nSpin; nu++) {
+        // Color inner product: <\phi(x)_{\mu} | \phi(y)_{\nu}>
+        // The Bra is conjugated
+        A[nSpin * mu + nu] = innerProduct(x, y, mu, nu);
+      }
+    }
+  }
+
+  /**
+     @brief Color and spin contract two spinors at a site with the 16
+     Degrand-Rossi gamma matrix insertions
+     @param[out] A The 16 gamma insertions, ordered as in enum_quda.h
+     @param[in] x The bra spinor (conjugated)
+     @param[in] y The ket spinor
+   */
+  template <typename real, int nColor, int nSpin>
+  __device__ __host__ inline void contractDegrandRossi(complex<real> A[nSpin * nSpin],
+                                                       const ColorSpinor<real, nColor, nSpin> &x,
+                                                       const ColorSpinor<real, nColor, nSpin> &y)
+  {
+    complex<real> I(0.0, 1.0);
+    complex<real> spin_elem[nSpin][nSpin];
+    complex<real> result_local(0.0, 0.0);
+
+    // Color contract: <\phi(x)_{\mu} | \phi(y)_{\nu}>
+    // The Bra is conjugated
+    for (int mu = 0; mu < nSpin; mu++) {
+      for (int nu = 0; nu < nSpin; nu++) { spin_elem[mu][nu] = innerProduct(x, y, mu, nu); }
+    }
+
+    // Spin contract: <\phi(x)_{\mu} \Gamma_{mu,nu}^{rho,tau} \phi(y)_{\nu}>
+    // The rho index runs slowest.
+    // Layout is defined in enum_quda.h: G_idx = 4*rho + tau
+    // DMH: Hardcoded to Degrand-Rossi. Need a template on Gamma basis.
+
+    int G_idx = 0;
+
+    // SCALAR
+    // G_idx = 0: I
+    result_local = 0.0;
+    result_local += spin_elem[0][0];
+    result_local += spin_elem[1][1];
+    result_local += spin_elem[2][2];
+    result_local += spin_elem[3][3];
+    A[G_idx++] = result_local;
+
+    // VECTORS
+    // G_idx = 1: \gamma_1
+    result_local = 0.0;
+    result_local += I * spin_elem[0][3];
+    result_local += I * spin_elem[1][2];
+    result_local -= I * spin_elem[2][1];
+    result_local -= I * spin_elem[3][0];
+    A[G_idx++] = result_local;
+
+    // G_idx = 2: \gamma_2
+    result_local = 0.0;
+    result_local -= spin_elem[0][3];
+    result_local += spin_elem[1][2];
+    result_local += spin_elem[2][1];
+    result_local -= spin_elem[3][0];
+    A[G_idx++] = result_local;
+
+    // G_idx = 3: \gamma_3
+    result_local = 0.0;
+    result_local += I * spin_elem[0][2];
+    result_local -= I * spin_elem[1][3];
+    result_local -= I * spin_elem[2][0];
+    result_local += I * spin_elem[3][1];
+    A[G_idx++] = result_local;
+
+    // G_idx = 4: \gamma_4
+    result_local = 0.0;
+    result_local += spin_elem[0][2];
+    result_local += spin_elem[1][3];
+    result_local += spin_elem[2][0];
+    result_local += spin_elem[3][1];
+    A[G_idx++] = result_local;
+
+    // PSEUDO-SCALAR
+    // G_idx = 5: \gamma_5
+    result_local = 0.0;
+    result_local += spin_elem[0][0];
+    result_local += spin_elem[1][1];
+    result_local -= spin_elem[2][2];
+    result_local -= spin_elem[3][3];
+    A[G_idx++] = result_local;
+
+    // PSEUDO-VECTORS
+    // DMH: Careful here... we may wish to use  \gamma_1,2,3,4\gamma_5 for pseudovectors
+    // G_idx = 6: \gamma_5\gamma_1
+    result_local = 0.0;
+    result_local += I * spin_elem[0][3];
+    result_local += I * spin_elem[1][2];
+    result_local += I * spin_elem[2][1];
+    result_local += I * spin_elem[3][0];
+    A[G_idx++] = result_local;
+
+    // G_idx = 7: \gamma_5\gamma_2
+    result_local = 0.0;
+    result_local -= spin_elem[0][3];
+    result_local += spin_elem[1][2];
+    result_local -= spin_elem[2][1];
+    result_local += spin_elem[3][0];
+    A[G_idx++] = result_local;
+
+    // G_idx = 8: \gamma_5\gamma_3
+    result_local = 0.0;
+    result_local += I * spin_elem[0][2];
+    result_local -= I * spin_elem[1][3];
+    result_local += I * spin_elem[2][0];
+    result_local -= I * spin_elem[3][1];
+    A[G_idx++] = result_local;
+
+    // G_idx = 9: \gamma_5\gamma_4
+    result_local = 0.0;
+    result_local += spin_elem[0][2];
+    result_local += spin_elem[1][3];
+    result_local -= spin_elem[2][0];
+    result_local -= spin_elem[3][1];
+    A[G_idx++] = result_local;
+
+    // TENSORS
+    // G_idx = 10: (i/2) * [\gamma_1, \gamma_2]
+    result_local = 0.0;
+    result_local += spin_elem[0][0];
+    result_local -= spin_elem[1][1];
+    result_local += spin_elem[2][2];
+    result_local -= spin_elem[3][3];
+    A[G_idx++] = result_local;
+
+    // G_idx = 11: (i/2) * [\gamma_1, \gamma_3]
+    result_local = 0.0;
+    result_local -= I * spin_elem[0][2];
+    result_local -= I * spin_elem[1][3];
+    result_local += I * spin_elem[2][0];
+    result_local += I * spin_elem[3][1];
+    A[G_idx++] = result_local;
+
+    // G_idx = 12: (i/2) * [\gamma_1, \gamma_4]
+    result_local = 0.0;
+    result_local -= spin_elem[0][1];
+    result_local -= spin_elem[1][0];
+    result_local += spin_elem[2][3];
+    result_local += spin_elem[3][2];
+    A[G_idx++] = result_local;
+
+    // G_idx = 13: (i/2) * [\gamma_2, \gamma_3]
+    result_local = 0.0;
+    result_local += spin_elem[0][1];
+    result_local += spin_elem[1][0];
+    result_local += spin_elem[2][3];
+    result_local += spin_elem[3][2];
+    A[G_idx++] = result_local;
+
+    // G_idx = 14: (i/2) * [\gamma_2, \gamma_4]
+    result_local = 0.0;
+    result_local -= I * spin_elem[0][1];
+    result_local += I * spin_elem[1][0];
+    result_local += I * spin_elem[2][3];
+    result_local -= I * spin_elem[3][2];
+    A[G_idx++] = result_local;
+
+    // G_idx = 15: (i/2) * [\gamma_3, \gamma_4]
+    result_local = 0.0;
+    result_local -= spin_elem[0][0];
+    result_local -= spin_elem[1][1];
+    result_local += spin_elem[2][2];
+    result_local += spin_elem[3][3];
+    A[G_idx++] = result_local;
+
+  }
+
   template <typename Arg> struct ColorContract {
     const Arg &arg;
     constexpr ColorContract(const Arg &arg) : arg(arg) {}
@@ -50,15 +244,7 @@ namespace quda
       Vector y = arg.y(x_cb, parity);
 
       Matrix<complex<real>, nSpin> A;
-#pragma unroll
-      for (int mu = 0; mu < nSpin; mu++) {
-#pragma unroll
-        for (int nu = 0; nu < nSpin; nu++) {
-          // Color inner product: <\phi(x)_{\mu} | \phi(y)_{\nu}>
-          // The Bra is conjugated
-          A(mu, nu) = innerProduct(x, y, mu, nu);
-        }
-      }
+      contractColor(A.data, x, y);
 
       arg.s.save(A, x_cb, parity);
     }
@@ -79,161 +265,153 @@ namespace quda
       Vector x = arg.x(x_cb, parity);
       Vector y = arg.y(x_cb, parity);
 
-      complex<real> I(0.0, 1.0);
-      complex<real> spin_elem[nSpin][nSpin];
-      complex<real> result_local(0.0, 0.0);
+      Matrix<complex<real>, nSpin> A;
+      contractDegrandRossi(A.data, x, y);
+
+      arg.s.save(A, x_cb, parity);
+    }
+  };
+
+  /**
+     @brief Maximum number of momenta projected in a single summed contraction kernel
+   */
+  constexpr int max_n_mom_contract() { return 32; }
 
-      // Color contract: <\phi(x)_{\mu} | \phi(y)_{\nu}>
-      // The Bra is conjugated
-      for (int mu = 0; mu < nSpin; mu++) {
-        for (int nu = 0; nu < nSpin; nu++) { spin_elem[mu][nu] = innerProduct(x, y, mu, nu); }
+  /**
+     @brief Maximum number of spinor pairs contracted in a single summed contraction kernel
+   */
+  constexpr int max_n_pair_contract() { return 8; }
+
+  template <typename Float, int nColor_, QudaContractType cType_> struct ContractionSummedArg : kernel_param<> {
+    using real = typename mapper<Float>::type;
+    using reduce_t = array<double, 32>;
+    static constexpr int nSpin = 4;
+    static constexpr int nColor = nColor_;
+    static constexpr QudaContractType cType = cType_;
+    static constexpr int max_n_pair = max_n_pair_contract();
+    static constexpr int max_n_mom = max_n_mom_contract();
+    // disable ghost to reduce arg size
+    using F = typename colorspinor::FieldOrderCB<real, nSpin, nColor, 1, colorspinor::getNative<Float>(nSpin), Float,
+                                                 Float, true>;
+
+    F x[max_n_pair];
+    F y[max_n_pair];
+    int n_pair;            // number of pairs contracted
+    int X[4];              // local grid dimensions
+    int offset[3];         // global coordinates of the local origin, less the source position
+    int L[3];              // global spatial dimensions
+    int volume_s_cb;       // local checkerboarded spatial volume
+    int n_mom;             // number of momenta
+    int mom[max_n_mom][3]; // the spatial momenta in units of 2 pi / L
+    reduce_t *result;      // device buffer of local time-slice correlators, layout [t][mom]
+
+    static constexpr bool swizzle = false;
+    int swizzle_factor;
+    static constexpr bool launch_bounds = false;
+    dim3 grid_dim;
+    dim3 block_dim;
+
+    ContractionSummedArg(cvector_ref<const ColorSpinorField> &x, cvector_ref<const ColorSpinorField> &y,
+                         const int *mom_, int n_mom, const int source_position[4], reduce_t *result) :
+      kernel_param(dim3(x[0].Volume() / x[0].X()[3], 1, x[0].X()[3])),
+      n_pair(x.size()),
+      volume_s_cb(x[0].VolumeCB() / x[0].X()[3]),
+      n_mom(n_mom),
+      result(result),
+      swizzle_factor(1)
+    {
+      for (int i = 0; i < n_pair; i++) {
+        this->x[i] = x[i];
+        this->y[i] = y[i];
       }
+      for (int dir = 0; dir < 4; dir++) X[dir] = x[0].X()[dir];
+      for (int dir = 0; dir < 3; dir++) {
+        offset[dir] = comm_coord(dir) * X[dir] - source_position[dir];
+        L[dir] = comm_dim(dir) * X[dir];
+      }
+      for (int m = 0; m < n_mom; m++)
+        for (int dir = 0; dir < 3; dir++) mom[m][dir] = mom_[3 * m + dir];
+    }
+  };
+
+  /**
+     Contracts each pair (x_i, y_i) at every site and sums over the
+     pairs, then multiplies by the momentum phase exp(-i p.(x - x_src))
+     and sums over each local time slice, so only the time-slice
+     correlators leave the kernel.  Each thread block covers a segment
+     of one time slice (block.z), with one site (both parities) per
+     thread.  The spinors are loaded and contracted once per site and
+     the momenta are applied in an inner loop, with each momentum
+     block-reduced and then atomically added to the time-slice result,
+     since a single reduction over all momenta would far exceed the
+     32-word limit of the reduction kernels.
+   */
+  template <typename Arg> struct ContractionSummed {
+    using reduce_t = typename Arg::reduce_t;
+    const Arg &arg;
+    constexpr ContractionSummed(const Arg &arg) : arg(arg) {}
+    static constexpr const char *filename() { return KERNEL_FILE; }
 
-      Matrix<complex<real>, nSpin> A_;
-      auto A = A_.data;
-
-      // Spin contract: <\phi(x)_{\mu} \Gamma_{mu,nu}^{rho,tau} \phi(y)_{\nu}>
-      // The rho index runs slowest.
-      // Layout is defined in enum_quda.h: G_idx = 4*rho + tau
-      // DMH: Hardcoded to Degrand-Rossi. Need a template on Gamma basis.
-
-      int G_idx = 0;
-
-      // SCALAR
-      // G_idx = 0: I
-      result_local = 0.0;
-      result_local += spin_elem[0][0];
-      result_local += spin_elem[1][1];
-      result_local += spin_elem[2][2];
-      result_local += spin_elem[3][3];
-      A[G_idx++] = result_local;
-
-      // VECTORS
-      // G_idx = 1: \gamma_1
-      result_local = 0.0;
-      result_local += I * spin_elem[0][3];
-      result_local += I * spin_elem[1][2];
-      result_local -= I * spin_elem[2][1];
-      result_local -= I * spin_elem[3][0];
-      A[G_idx++] = result_local;
-
-      // G_idx = 2: \gamma_2
-      result_local = 0.0;
-      result_local -= spin_elem[0][3];
-      result_local += spin_elem[1][2];
-      result_local += spin_elem[2][1];
-      result_local -= spin_elem[3][0];
-      A[G_idx++] = result_local;
-
-      // G_idx = 3: \gamma_3
-      result_local = 0.0;
-      result_local += I * spin_elem[0][2];
-      result_local -= I * spin_elem[1][3];
-      result_local -= I * spin_elem[2][0];
-      result_local += I * spin_elem[3][1];
-      A[G_idx++] = result_local;
-
-      // G_idx = 4: \gamma_4
-      result_local = 0.0;
-      result_local += spin_elem[0][2];
-      result_local += spin_elem[1][3];
-      result_local += spin_elem[2][0];
-      result_local += spin_elem[3][1];
-      A[G_idx++] = result_local;
-
-      // PSEUDO-SCALAR
-      // G_idx = 5: \gamma_5
-      result_local = 0.0;
-      result_local += spin_elem[0][0];
-      result_local += spin_elem[1][1];
-      result_local -= spin_elem[2][2];
-      result_local -= spin_elem[3][3];
-      A[G_idx++] = result_local;
-
-      // PSEUDO-VECTORS
-      // DMH: Careful here... we may wish to use  \gamma_1,2,3,4\gamma_5 for pseudovectors
-      // G_idx = 6: \gamma_5\gamma_1
-      result_local = 0.0;
-      result_local += I * spin_elem[0][3];
-      result_local += I * spin_elem[1][2];
-      result_local += I * spin_elem[2][1];
-      result_local += I * spin_elem[3][0];
-      A[G_idx++] = result_local;
-
-      // G_idx = 7: \gamma_5\gamma_2
-      result_local = 0.0;
-      result_local -= spin_elem[0][3];
-      result_local += spin_elem[1][2];
-      result_local -= spin_elem[2][1];
-      result_local += spin_elem[3][0];
-      A[G_idx++] = result_local;
-
-      // G_idx = 8: \gamma_5\gamma_3
-      result_local = 0.0;
-      result_local += I * spin_elem[0][2];
-      result_local -= I * spin_elem[1][3];
-      result_local += I * spin_elem[2][0];
-      result_local -= I * spin_elem[3][1];
-      A[G_idx++] = result_local;
-
-      // G_idx = 9: \gamma_5\gamma_4
-      result_local = 0.0;
-      result_local += spin_elem[0][2];
-      result_local += spin_elem[1][3];
-      result_local -= spin_elem[2][0];
-      result_local -= spin_elem[3][1];
-      A[G_idx++] = result_local;
-
-      // TENSORS
-      // G_idx = 10: (i/2) * [\gamma_1, \gamma_2]
-      result_local = 0.0;
-      result_local += spin_elem[0][0];
-      result_local -= spin_elem[1][1];
-      result_local += spin_elem[2][2];
-      result_local -= spin_elem[3][3];
-      A[G_idx++] = result_local;
-
-      // G_idx = 11: (i/2) * [\gamma_1, \gamma_3]
-      result_local = 0.0;
-      result_local -= I * spin_elem[0][2];
-      result_local -= I * spin_elem[1][3];
-      result_local += I * spin_elem[2][0];
-      result_local += I * spin_elem[3][1];
-      A[G_idx++] = result_local;
-
-      // G_idx = 12: (i/2) * [\gamma_1, \gamma_4]
-      result_local = 0.0;
-      result_local -= spin_elem[0][1];
-      result_local -= spin_elem[1][0];
-      result_local += spin_elem[2][3];
-      result_local += spin_elem[3][2];
-      A[G_idx++] = result_local;
-
-      // G_idx = 13: (i/2) * [\gamma_2, \gamma_3]
-      result_local = 0.0;
-      result_local += spin_elem[0][1];
-      result_local += spin_elem[1][0];
-      result_local += spin_elem[2][3];
-      result_local += spin_elem[3][2];
-      A[G_idx++] = result_local;
-
-      // G_idx = 14: (i/2) * [\gamma_2, \gamma_4]
-      result_local = 0.0;
-      result_local -= I * spin_elem[0][1];
-      result_local += I * spin_elem[1][0];
-      result_local += I * spin_elem[2][3];
-      result_local -= I * spin_elem[3][2];
-      A[G_idx++] = result_local;
-
-      // G_idx = 15: (i/2) * [\gamma_3, \gamma_4]
-      result_local = 0.0;
-      result_local -= spin_elem[0][0];
-      result_local -= spin_elem[1][1];
-      result_local += spin_elem[2][2];
-      result_local += spin_elem[3][3];
-      A[G_idx++] = result_local;
-
-      arg.s.save(A_, x_cb, parity);
+    __device__ __host__ inline void operator()(dim3 block, dim3 thread)
+    {
+      constexpr int nSpin = Arg::nSpin;
+      using real = typename Arg::real;
+      using Vector = ColorSpinor<real, Arg::nColor, nSpin>;
+
+      const int t = block.z * arg.block_dim.z + thread.z;
+      const int xs = block.x * arg.block_dim.x + thread.x;
+      const bool active = xs < 2 * arg.volume_s_cb;
+      const int parity = xs / arg.volume_s_cb;
+
+      complex<real> A[nSpin * nSpin] = {};
+      int coord[4] = {};
+      if (active) {
+        // sites are ordered with time running slowest
+        const int x_cb = t * arg.volume_s_cb + xs % arg.volume_s_cb;
+        for (int i = 0; i < arg.n_pair; i++) {
+          Vector x, y;
+#pragma unroll
+          for (int s = 0; s < nSpin; s++)
+#pragma unroll
+            for (int c = 0; c < Arg::nColor; c++) {
+              x(s, c) = arg.x[i](parity, x_cb, s, c);
+              y(s, c) = arg.y[i](parity, x_cb, s, c);
+            }
+
+          complex<real> Ai[nSpin * nSpin];
+          if constexpr (Arg::cType == QUDA_CONTRACT_TYPE_DR)
+            contractDegrandRossi(Ai, x, y);
+          else
+            contractColor(Ai, x, y);
+#pragma unroll
+          for (int g = 0; g < nSpin * nSpin; g++) A[g] += Ai[g];
+        }
+        getCoords(coord, x_cb, arg.X, parity);
+      }
+
+      for (int m = 0; m < arg.n_mom; m++) {
+        reduce_t value = {};
+        if (active) {
+          double phase = 0.0;
+#pragma unroll
+          for (int dir = 0; dir < 3; dir++)
+            phase += static_cast<double>(arg.mom[m][dir] * (coord[dir] + arg.offset[dir])) / arg.L[dir];
+          real s, c;
+          quda::sincospi(static_cast<real>(-2.0 * (phase - floor(phase))), &s, &c);
+          complex<real> e(c, s);
+
+#pragma unroll
+          for (int g = 0; g < nSpin * nSpin; g++) {
+            auto r = e * A[g];
+            value[2 * g + 0] = r.real();
+            value[2 * g + 1] = r.imag();
+          }
+        }
+
+        // synchronous since the shared storage is reused for every momentum
+        value = BlockReduce<reduce_t, 1>().template Sum<false>(value);
+        if (target::thread_idx().x == 0) atomic_fetch_add(&arg.result[t * arg.n_mom + m], value);
+      }
     }
   };
 } // namespace quda
@@ -35,20 +35,24 @@ namespace quda
     }
   };
 
+  /**
+     @brief Compute the clover-leaf field strength F_{mu,nu} at a
+     site of an extended gauge field.
+     @param[in] arg Kernel argument, where arg.u is the gauge field
+     @param[in] x Extended site coordinates
+     @param[in] X Extended lattice dimensions
+     @param[in] parity Site parity
+     @param[in] mu First direction
+     @param[in] nu Second direction
+     @param[out] plaq The real trace of the plaquette U_{mu,nu}(x), the first of the four leaves
+     @return The field strength F_{mu,nu}
+  */
   template <typename Arg>
-  __device__ __host__ inline void computeFmunuCore(const Arg &arg, int idx, int parity, int mu, int nu)
+  __device__ __host__ inline auto computeFmunuSite(const Arg &arg, const int x[4], const int X[4], int parity, int mu,
+                                                   int nu, double &plaq)
   {
     using Link = Matrix<complex<typename Arg::Float>, 3>;
 
-    int x[4];
-    int X[4];
-
-    getCoords(x, idx, arg.X, parity);
-    for (int dir = 0; dir < 4; ++dir) {
-      x[dir] += arg.border[dir];
-      X[dir] = arg.X[dir] + 2 * arg.border[dir];
-    }
-
     Link F;
     { // U(x,mu) U(x+mu,nu) U[dagger](x+nu,mu) U[dagger](x,nu)
 
@@ -71,6 +75,7 @@ namespace quda
 
       // compute plaquette
       F = U1 * U2 * conj(U3) * conj(U4);
+      plaq = getTrace(F).real();
     }
 
     { // U(x,nu) U[dagger](x+nu-mu,mu) U[dagger](x-mu,nu) U(x-mu, mu)
@@ -169,7 +174,25 @@ namespace quda
       F *= static_cast<typename Arg::Float>(0.125); // 18 real multiplications
       // 36 floating point operations here
     }
-    
+
+    return F;
+  }
+
+  template <typename Arg>
+  __device__ __host__ inline void computeFmunuCore(const Arg &arg, int idx, int parity, int mu, int nu)
+  {
+    int x[4];
+    int X[4];
+
+    getCoords(x, idx, arg.X, parity);
+    for (int dir = 0; dir < 4; ++dir) {
+      x[dir] += arg.border[dir];
+      X[dir] = arg.X[dir] + 2 * arg.border[dir];
+    }
+
+    double plaq;
+    auto F = computeFmunuSite(arg, x, X, parity, mu, nu, plaq);
+
     int munu_idx = (mu * (mu - 1)) / 2 + nu; // lower-triangular indexing
     arg.f(munu_idx, idx, parity) = F;
   }
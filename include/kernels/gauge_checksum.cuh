@@ -0,0 +1,47 @@
+#pragma once
+
+#include <gauge_field_order.h>
+#include <quda_matrix.h>
+#include <array.h>
+#include <reduction_kernel.h>
+
+namespace quda
+{
+
+  template <typename Float, int nColor_, QudaReconstructType recon>
+  struct GaugeChecksumArg : ReduceArg<array<double, 2>> {
+    using real = typename mapper<Float>::type;
+    static constexpr int nColor = nColor_;
+    using Gauge = typename gauge_mapper<Float, recon>::type;
+
+    const Gauge U;
+    const int geometry;
+
+    GaugeChecksumArg(const GaugeField &U, bool mini) :
+      ReduceArg<reduce_t>(dim3(mini ? 1 : U.VolumeCB(), 2, 1)), U(U), geometry(U.Geometry())
+    {
+    }
+  };
+
+  template <typename Arg> struct GaugeChecksum : bit_xor<typename Arg::reduce_t> {
+    using reduce_t = typename Arg::reduce_t;
+    using bit_xor<reduce_t>::operator();
+    using bit_xor<reduce_t>::split;
+    static constexpr int reduce_block_dim = 2; // x_cb in x, parity in y
+    const Arg &arg;
+    constexpr GaugeChecksum(const Arg &arg) : arg(arg) { }
+    static constexpr const char *filename() { return KERNEL_FILE; }
+
+    // return the checksum of site (x_cb, parity) xor-ed into value
+    __device__ __host__ inline reduce_t operator()(reduce_t &value, int x_cb, int parity)
+    {
+      uint64_t checksum = 0;
+      for (int d = 0; d < arg.geometry; d++) {
+        const Matrix<complex<typename Arg::real>, Arg::nColor> u = arg.U(d, x_cb, parity);
+        checksum ^= u.checksum();
+      }
+      return operator()(split(checksum), value);
+    }
+  };
+
+} // namespace quda
@@ -70,40 +70,69 @@ namespace quda {
     }
   };
 
-  template <typename store_t, QudaReconstructType recon>
+  /**
+     @tparam native Whether the gauge field is native ordered (device)
+     or QDP ordered (host).  The work arrays are allocated in the
+     memory space of the field.
+   */
+  template <typename store_t, QudaReconstructType recon, bool native_ = true>
   struct GaugeFixArg : kernel_param<> {
     using Float = typename mapper<store_t>::type;
-    using Gauge = typename gauge_mapper<store_t, recon>::type;
+    static constexpr bool native = native_;
+    using Gauge = std::conditional_t<native, typename gauge_mapper<store_t, recon>::type,
+                                     typename gauge_order_mapper<store_t, QUDA_QDP_GAUGE_ORDER, 3>::type>;
     static constexpr int elems = recon / 2;
     Gauge data;
     int_fastdiv X[4];     // grid dimensions
     Float *invpsq;
     complex<Float> *delta;
     complex<Float> *gx;
+    complex<Float> *pgrad; // preconditioned gradient of the previous iteration (conjugate gradient only)
+    complex<Float> *dir;   // search direction of the previous iteration (conjugate gradient only)
     Float alpha;
+    Float beta;            // conjugate gradient coefficient
     int volume;
 
-    GaugeFixArg(GaugeField &data, double alpha) :
+    static void *alloc(size_t bytes) { return native ? device_malloc(bytes) : safe_malloc(bytes); }
+    static void release(void *ptr)
+    {
+      if (!ptr) return;
+      if constexpr (native)
+        device_free(ptr);
+      else
+        host_free(ptr);
+    }
+
+    GaugeFixArg(GaugeField &data, double alpha, bool cg = false) :
       kernel_param(dim3(data.VolumeCB(), 2, 1)),
       data(data),
+      pgrad(nullptr),
+      dir(nullptr),
       alpha(static_cast<Float>(alpha)),
+      beta(0.0),
       volume(data.Volume())
     {
-      for (int dir = 0; dir < 4; ++dir ) X[dir] = data.X()[dir];
-      invpsq = (Float*)device_malloc(sizeof(Float) * volume);
-      delta = (complex<Float>*)device_malloc(sizeof(complex<Float>) * volume * 6);
+      for (int d = 0; d < 4; d++) X[d] = data.X()[d];
+      invpsq = (Float*)alloc(sizeof(Float) * volume);
+      delta = (complex<Float>*)alloc(sizeof(complex<Float>) * volume * 6);
 #ifdef GAUGEFIXING_DONT_USE_GX
-      gx = (complex<Float>*)device_malloc(sizeof(complex<Float>) * volume);
+      gx = (complex<Float>*)alloc(sizeof(complex<Float>) * volume);
 #else
-      gx = (complex<Float>*)device_malloc(sizeof(complex<Float>) * volume * elems);
+      gx = (complex<Float>*)alloc(sizeof(complex<Float>) * volume * elems);
 #endif
+      if (cg) {
+        pgrad = (complex<Float>*)alloc(sizeof(complex<Float>) * volume * 6);
+        dir = (complex<Float>*)alloc(sizeof(complex<Float>) * volume * 6);
+      }
     }
 
     void free()
     {
-      device_free(invpsq);
-      device_free(delta);
-      device_free(gx);
+      release(invpsq);
+      release(delta);
+      release(gx);
+      release(pgrad);
+      release(dir);
     }
   };
 
@@ -146,14 +175,83 @@ namespace quda {
     }
   };
 
+  /**
+     @brief Form the conjugate gradient search direction
+     s_n = P Delta_n + beta s_{n-1}, where delta holds the
+     preconditioned gradient P Delta_n and dir the previous direction.
+     The result is written to pgrad, so the kernel can be re-launched.
+   */
+  template <typename Arg> struct cg_direction
+  {
+    const Arg &arg;
+    constexpr cg_direction(const Arg &arg) : arg(arg) {}
+    static constexpr const char* filename() { return KERNEL_FILE; }
+    __device__ __host__ inline void operator()(int x_cb, int parity)
+    {
+      int id = parity * arg.threads.x + x_cb;
+#pragma unroll
+      for (int i = 0; i < 6; i++) {
+        auto s = arg.delta[id + i * arg.volume];
+        if (arg.beta != static_cast<typename Arg::Float>(0.0)) s += arg.beta * arg.dir[id + i * arg.volume];
+        arg.pgrad[id + i * arg.volume] = s;
+      }
+    }
+  };
+
+  /**
+     @brief Argument for the real inner product of two fields of
+     traceless anti-hermitian matrices stored as the six elements
+     (00, 01, 02, 11, 12, 22) with stride volume
+   */
+  template <typename Float> struct GaugeFixDotArg : public ReduceArg<double> {
+    int volume;
+    const complex<Float> *a;
+    const complex<Float> *b;
+
+    GaugeFixDotArg(const GaugeField &data, const complex<Float> *a, const complex<Float> *b) :
+      ReduceArg<double>(dim3(data.VolumeCB(), 2, 1)),
+      volume(data.Volume()),
+      a(a),
+      b(b)
+    {
+    }
+  };
+
+  template <typename Arg> struct GaugeFixDot : plus<typename Arg::reduce_t> {
+    using reduce_t = typename Arg::reduce_t;
+    using plus<reduce_t>::operator();
+    static constexpr int reduce_block_dim = 2; // x_cb in x, parity in y
+    const Arg &arg;
+    static constexpr const char *filename() { return KERNEL_FILE; }
+    constexpr GaugeFixDot(const Arg &arg) : arg(arg) {}
+
+    /**
+       @brief Re tr(A^dagger B), with the off-diagonal elements counted twice
+     */
+    __device__ __host__ inline reduce_t operator()(reduce_t &value, int x_cb, int parity)
+    {
+      int id = parity * arg.threads.x + x_cb;
+      reduce_t sum = 0.0;
+#pragma unroll
+      for (int i = 0; i < 6; i++) {
+        auto a = arg.a[id + i * arg.volume];
+        auto b = arg.b[id + i * arg.volume];
+        reduce_t ab = static_cast<reduce_t>(a.real()) * b.real() + static_cast<reduce_t>(a.imag()) * b.imag();
+        sum += (i == 0 || i == 3 || i == 5) ? ab : 2.0 * ab;
+      }
+      return operator()(sum, value);
+    }
+  };
+
   /**
    * @brief container to pass parameters for the gauge fixing quality kernel
    */
-  template <typename store_t, QudaReconstructType recon_, int gauge_dir_>
+  template <typename store_t, QudaReconstructType recon_, int gauge_dir_, bool native = true>
   struct GaugeFixQualityFFTArg : public ReduceArg<array<double, 2>> {
     using real = typename mapper<store_t>::type;
     static constexpr QudaReconstructType recon = recon_;
-    using Gauge = typename gauge_mapper<store_t, recon>::type;
+    using Gauge = std::conditional_t<native, typename gauge_mapper<store_t, recon>::type,
+                                     typename gauge_order_mapper<store_t, QUDA_QDP_GAUGE_ORDER, 3>::type>;
     static constexpr int gauge_dir = gauge_dir_;
 
     int_fastdiv X[4];     // grid dimensions
@@ -427,4 +525,24 @@ namespace quda {
     }
   };
 
+  /**
+     @brief Reunitarize the links of a host field, projecting each
+     onto SU(3) with reunit_link
+   */
+  template <typename Arg> struct reunit_gauge {
+    const Arg &arg;
+    constexpr reunit_gauge(const Arg &arg) : arg(arg) {}
+    static constexpr const char* filename() { return KERNEL_FILE; }
+
+    __device__ __host__ inline void operator()(int x_cb, int parity)
+    {
+      using matrix = Matrix<complex<typename Arg::Float>, 3>;
+      for (int mu = 0; mu < 4; mu++) {
+        matrix U = arg.data(mu, x_cb, parity);
+        reunit_link<typename Arg::Float>(U);
+        arg.data(mu, x_cb, parity) = U;
+      }
+    }
+  };
+
 }
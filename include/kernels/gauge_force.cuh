@@ -28,13 +28,15 @@ namespace quda {
 
     real epsilon; // stepsize and any other overall scaling factor
     const paths<4> p;
+    const path_trie trie; // the paths of each direction compiled into a trie
 
-    GaugeForceArg(GaugeField &mom, const GaugeField &u, double epsilon, const paths<4> &p) :
+    GaugeForceArg(GaugeField &mom, const GaugeField &u, double epsilon, const paths<4> &p, const path_trie &trie) :
       kernel_param(dim3(mom.VolumeCB(), 2, 4)),
       mom(mom),
       u(u),
       epsilon(epsilon),
-      p(p)
+      p(p),
+      trie(trie)
     {
       for (int i=0; i<4; i++) {
         X[i] = mom.X()[i];
@@ -64,21 +66,27 @@ namespace quda {
       Link link_prod, accum;
       thread_array<int, 4> dx{0};
 
-      for (int i=0; i<arg.p.num_paths; i++) {
-        real coeff = arg.p.path_coeff[i];
-        if (coeff == 0) continue;
+      if (arg.trie.enabled) {
+        // the paths start pre-shifted, which is included in the link displacements of the trie
+        walkPathTrie(arg, arg.trie, dir, x, parity,
+                     [&](const path_node &n, const Link &prod) { accum = accum + static_cast<real>(n.coeff) * prod; });
+      } else {
+        for (int i=0; i<arg.p.num_paths; i++) {
+          real coeff = arg.p.path_coeff[i];
+          if (coeff == 0) continue;
 
-        const int* path = arg.p.input_path[dir] + i*arg.p.max_length;
+          const int* path = arg.p.input_path[dir] + i*arg.p.max_length;
 
-        // the gauge path starts pre-shifted, so we need to do the shift + update the parity
-        dx[dir]++;
-        int nbr_oddbit = (parity ^ 1);
+          // the gauge path starts pre-shifted, so we need to do the shift + update the parity
+          dx[dir]++;
+          int nbr_oddbit = (parity ^ 1);
 
-        // compute the path
-        link_prod = computeGaugePath(arg, x, nbr_oddbit, path, arg.p.length[i], dx);
+          // compute the path
+          link_prod = computeGaugePath(arg, x, nbr_oddbit, path, arg.p.length[i], dx);
 
-        accum = accum + coeff * link_prod;
-      } //i
+          accum = accum + coeff * link_prod;
+        } //i
+      }
 
       // multiply by U(x)
       link_prod = arg.u(dir, linkIndex(x,arg.E), parity);
@@ -2,7 +2,7 @@
 #include <gauge_field_order.h>
 #include <index_helper.cuh>
 #include <atomic_helper.h>
-#include <random_helper.h>
+#include <counter_rng.h>
 #include <kernel.h>
 
 namespace quda {
@@ -72,17 +72,17 @@ namespace quda {
     @brief Generate full SU(2) matrix (four real numbers instead of 2x2 complex matrix) and update link matrix.
     Get from MILC code.
     @param al weight
-    @param localstate CURAND rng state
+    @param localstate rng state, either the CURAND state or a counter-based generator
  */
-  template <class T>
-  __device__ inline Matrix<T,2> generate_su2_matrix_milc(T al, RNGState& localState)
+  template <class T, typename State>
+  __device__ __host__ inline Matrix<T,2> generate_su2_matrix_milc(T al, State& localState)
   {
-    T xr1 = uniform<T>::rand(localState);
+    T xr1 = rand_uniform<T>(localState);
     xr1 = (log((xr1 + static_cast<T>(1.e-10))));
-    T xr2 = uniform<T>::rand(localState);
+    T xr2 = rand_uniform<T>(localState);
     xr2 = (log((xr2 + static_cast<T>(1.e-10))));
-    T xr3 = uniform<T>::rand(localState);
-    T xr4 = uniform<T>::rand(localState);
+    T xr3 = rand_uniform<T>(localState);
+    T xr4 = rand_uniform<T>(localState);
     xr3 = cospi(static_cast<T>(2.0) * xr3);
     T d = -(xr2 + xr1 * xr3 * xr3 ) / al;
     //now  beat each  site into submission
@@ -92,12 +92,12 @@ namespace quda {
 #pragma unroll
       for (int k = 0; k < 20; k++) {
         //get four random numbers (add a small increment to prevent taking log(0.)
-        xr1 = uniform<T>::rand(localState);
+        xr1 = rand_uniform<T>(localState);
         xr1 = (log((xr1 + 1.e-10)));
-        xr2 = uniform<T>::rand(localState);
+        xr2 = rand_uniform<T>(localState);
         xr2 = (log((xr2 + 1.e-10)));
-        xr3 = uniform<T>::rand(localState);
-        xr4 = uniform<T>::rand(localState);
+        xr3 = rand_uniform<T>(localState);
+        xr4 = rand_uniform<T>(localState);
         xr3 = cospi(static_cast<T>(2.0) * xr3);
         d = -(xr2 + xr1 * xr3 * xr3) / al;
         if ((1.00 - 0.5 * d) > xr4 * xr4 ) break;
@@ -111,8 +111,8 @@ namespace quda {
 #pragma unroll
       for (int k = 0; k < 20; k++) {
         //get two random numbers
-        xr1 = uniform<T>::rand(localState);
-        xr2 = uniform<T>::rand(localState);
+        xr1 = rand_uniform<T>(localState);
+        xr2 = rand_uniform<T>(localState);
         r = xr3 + xr4 * xr1;
         a(0,0) = 1.00 + log(r) / al;
         if ((1.0 - a(0,0) * a(0,0)) > xr2 * xr2) break;
@@ -127,13 +127,13 @@ namespace quda {
     xr3 = abs(xr3);
     r = sqrt(xr3);
     //compute a3
-    a(1,1) = (2.0 * uniform<T>::rand(localState) - 1.0) * r;
+    a(1,1) = (2.0 * rand_uniform<T>(localState) - 1.0) * r;
     //compute a1 and a2
     xr1 = xr3 - a(1,1) * a(1,1);
     xr1 = abs(xr1);
     xr1 = sqrt(xr1);
     //xr2 is a random number between 0 and 2*pi
-    xr2 = static_cast<T>(2.0) * uniform<T>::rand(localState);
+    xr2 = static_cast<T>(2.0) * rand_uniform<T>(localState);
     T tmp[2];
     sincospi(xr2, &tmp[1], &tmp[0]);
     a(0,1) = xr1 * tmp[0];
@@ -292,11 +292,11 @@ namespace quda {
     @brief Link update by pseudo-heatbath
     @param U link to be updated
     @param F staple
-    @param localstate CURAND rng state
+    @param localstate rng state, either the CURAND state or a counter-based generator
   */
-  template <class Float, int nColor>
-  __device__ inline void heatBathSUN( Matrix<complex<Float>,nColor>& U, Matrix<complex<Float>,nColor> F,
-                                      RNGState& localState, Float BetaOverNc )
+  template <class Float, int nColor, typename State>
+  __device__ __host__ inline void heatBathSUN( Matrix<complex<Float>,nColor>& U, Matrix<complex<Float>,nColor> F,
+                                               State& localState, Float BetaOverNc )
   {
     if (nColor == 3) {
       //////////////////////////////////////////////////////////////////
@@ -432,7 +432,7 @@ namespace quda {
      @param F staple
    */
   template <class Float, int nColor>
-  __device__ inline void overrelaxationSUN( Matrix<complex<Float>,nColor>& U, Matrix<complex<Float>,nColor> F )
+  __device__ __host__ inline void overrelaxationSUN( Matrix<complex<Float>,nColor>& U, Matrix<complex<Float>,nColor> F )
   {
     if (nColor == 3) {
       //////////////////////////////////////////////////////////////////
@@ -572,11 +572,61 @@ namespace quda {
     }
   }
 
-  template <typename Float_, int nColor_, QudaReconstructType recon, bool heatbath_>
+  /**
+     @brief The set of sites of a given parity updated by a heatbath
+     or overrelaxation kernel.  The staples of the interior sites do
+     not touch the halo, so on a partitioned lattice these can be
+     updated while the halo exchange of the previous update is in
+     flight, with the boundary sites updated once it has completed.
+   */
+  enum class MonteRegion { all, interior, boundary };
+
+  /**
+     @brief Compute the interior region of the local lattice, i.e.,
+     the sites at least one site away from the faces of the
+     partitioned dimensions
+     @param[in] U Gauge field
+     @param[out] lo Origin of the interior region
+     @param[out] box Dimensions of the interior region
+     @return The checkerboarded volume of the interior region
+   */
+  inline int monteInterior(const GaugeField &U, int lo[4], int box[4])
+  {
+    int volume = 1;
+    for (int d = 0; d < 4; d++) {
+      lo[d] = commDimPartitioned(d) ? 1 : 0;
+      box[d] = std::max(U.LocalX()[d] - 2 * lo[d], 0);
+      volume *= box[d];
+    }
+    return volume / 2;
+  }
+
+  /**
+     @brief The number of threads of a region update.  The interior
+     threads are mapped onto the interior region, while the boundary
+     update is launched over all sites and skips the interior ones.
+   */
+  inline int monteThreads(const GaugeField &U, MonteRegion region)
+  {
+    int lo[4], box[4];
+    return region == MonteRegion::interior ? monteInterior(U, lo, box) : U.LocalVolumeCB();
+  }
+
+  /**
+     @tparam native Whether the gauge field is native ordered (device)
+     or QDP ordered (host)
+     @tparam counter Whether to use the counter-based generator (the
+     host path always does)
+   */
+  template <typename Float_, int nColor_, QudaReconstructType recon, bool heatbath_, bool native_ = true,
+            bool counter_ = false>
   struct MonteArg : kernel_param<> {
     using Float = Float_;
     static constexpr int nColor = nColor_;
-    using Gauge = typename gauge_mapper<Float, recon>::type;
+    static constexpr bool native = native_;
+    static constexpr bool counter = counter_;
+    using Gauge = std::conditional_t<native, typename gauge_mapper<Float, recon>::type,
+                                     typename gauge_order_mapper<Float, QUDA_QDP_GAUGE_ORDER, nColor>::type>;
     static constexpr bool heatbath = heatbath_;
 
     int X[4];       // grid dimensions
@@ -584,20 +634,35 @@ namespace quda {
     Gauge dataOr;
     Float BetaOverNc;
     RNGState *rng;
+    CounterRNGParam philox;
+    uint32_t stream; // counter-based generator stream of this update
     int mu;
     int parity;
-    MonteArg(GaugeField &data, Float Beta, RNGState *rng, int mu, int parity) :
-      kernel_param(dim3(data.LocalVolumeCB(), 1, 1)),
+    int n_hit;      // number of updates of each link with the same staple
+    MonteRegion region;
+    int lo[4];      // origin of the interior region
+    int box[4];     // dimensions of the interior region
+    int box_parity; // parity of the origin of the interior region
+
+    MonteArg(GaugeField &data, Float Beta, RNGState *rng, unsigned long long seed, uint32_t stream, int mu,
+             int parity, int n_hit, MonteRegion region) :
+      kernel_param(dim3(monteThreads(data, region), 1, 1)),
       dataOr(data),
       rng(rng),
+      philox(seed, data),
+      stream(stream),
       mu(mu),
-      parity(parity)
+      parity(parity),
+      n_hit(n_hit),
+      region(region)
     {
       BetaOverNc = Beta / (Float)nColor;
       for (int dir = 0; dir < 4; dir++) {
         border[dir] = data.R()[dir];
         X[dir] = data.X()[dir] - border[dir] * 2;
-      } 
+      }
+      monteInterior(data, lo, box);
+      box_parity = (lo[0] + lo[1] + lo[2] + lo[3]) & 1;
     }
   };
 
@@ -607,7 +672,7 @@ namespace quda {
     constexpr HB(const Arg &arg) : arg(arg) {}
     static constexpr const char *filename() { return KERNEL_FILE; }
 
-    __device__ __host__ void operator()(int x_cb)
+    __device__ __host__ void operator()(int idx)
     {
       using Link = Matrix<complex<typename Arg::Float>, Arg::nColor>;
       auto mu = arg.mu;
@@ -618,7 +683,23 @@ namespace quda {
       for (int dr = 0; dr < 4; ++dr) X[dr] = arg.X[dr];
 
       int x[4];
-      getCoords(x, x_cb, X, parity);
+      int x_cb = idx;
+      if (arg.region == MonteRegion::interior) {
+        // the interior threads are mapped onto the interior region only
+        getCoords(x, idx, arg.box, parity ^ arg.box_parity);
+#pragma unroll
+        for (int dr = 0; dr < 4; ++dr) x[dr] += arg.lo[dr];
+        x_cb = linkIndex(x, X);
+      } else {
+        getCoords(x, x_cb, X, parity);
+        if (arg.region == MonteRegion::boundary) {
+          bool interior = true;
+#pragma unroll
+          for (int dr = 0; dr < 4; ++dr) interior = interior && x[dr] >= arg.lo[dr] && x[dr] < arg.lo[dr] + arg.box[dr];
+          if (interior) return;
+        }
+      }
+
 #pragma unroll
       for (int dr = 0; dr < 4; ++dr) {
         x[dr] += arg.border[dr];
@@ -652,13 +733,21 @@ namespace quda {
           link *= U;
           staple += link;
         }
+
+      // the staple does not depend on the link, so it is reused for each hit
+      const Link F = conj(staple);
       U = arg.dataOr(mu, e_cb, parity);
-      if (Arg::heatbath) {
-        RNGState localState = arg.rng[x_cb];
-        heatBathSUN( U, conj(staple), localState, arg.BetaOverNc );
-        arg.rng[x_cb] = localState;
+      if constexpr (Arg::heatbath) {
+        if constexpr (Arg::counter) {
+          CounterRNG localState = arg.philox(x_cb, parity, arg.stream);
+          for (int hit = 0; hit < arg.n_hit; hit++) heatBathSUN(U, F, localState, arg.BetaOverNc);
+        } else {
+          RNGState localState = arg.rng[x_cb];
+          for (int hit = 0; hit < arg.n_hit; hit++) heatBathSUN(U, F, localState, arg.BetaOverNc);
+          arg.rng[x_cb] = localState;
+        }
       } else {
-        overrelaxationSUN( U, conj(staple) );
+        for (int hit = 0; hit < arg.n_hit; hit++) overrelaxationSUN(U, F);
       }
       arg.dataOr(mu, e_cb, parity) = U;
     }
@@ -12,16 +12,35 @@
 
 namespace quda {
 
+  /**
+    @brief Maximum number of loops reduced by a thread block, i.e.,
+    the number of loop traces (of two doubles each) every thread
+    carries through the block reduction.
+  */
+  constexpr int max_loop_trace_block() { return 8; }
+
+  /**
+    @brief Number of loops traced per batch index.  The loops are
+    sorted so that each batch holds loops with long common prefixes,
+    and each batch is compiled into one tree of a path trie.  A batch
+    fills the block limit, so sharing prefixes does not grow the
+    per-thread reduction state beyond that of batching the loops
+    across the block.
+  */
+  constexpr int loop_trace_group() { return max_loop_trace_block(); }
+
   /**
     @brief Return the batch block size used for multi reductions.
   */
-  constexpr unsigned int max_n_batch_block_loop_trace() { return 8; }
+  constexpr unsigned int max_n_batch_block_loop_trace() { return max_loop_trace_block() / loop_trace_group(); }
 
   template <typename store_t, int nColor_, QudaReconstructType recon_>
-  struct GaugeLoopTraceArg : public ReduceArg<array<double, 2>>  {
+  struct GaugeLoopTraceArg : public ReduceArg<array<double, 2 * loop_trace_group()>>  {
     using real = typename mapper<store_t>::type;
-    using reduce_t = array<double, 2>;
+    using reduce_t = array<double, 2 * loop_trace_group()>;
     static constexpr unsigned int max_n_batch_block = max_n_batch_block_loop_trace();
+    static_assert(max_n_batch_block * loop_trace_group() <= max_loop_trace_block(),
+                  "Loops per block exceed the block limit");
     static constexpr int nColor = nColor_;
     static constexpr QudaReconstructType recon = recon_;
     using Link = Matrix<complex<real>, nColor>;
@@ -37,12 +56,14 @@ namespace quda {
     int border[4]; // radius of border
 
     const paths<1> p;
+    const path_trie trie; // one tree per batch of loops
 
-    GaugeLoopTraceArg(const GaugeField &u, double factor, const paths<1> &p) :
-      ReduceArg<reduce_t>(dim3(u.LocalVolumeCB(), 2, p.num_paths), p.num_paths),
+    GaugeLoopTraceArg(const GaugeField &u, double factor, const paths<1> &p, const path_trie &trie) :
+      ReduceArg<reduce_t>(dim3(u.LocalVolumeCB(), 2, trie.num_trees), trie.num_trees),
       u(u),
       factor(factor),
-      p(p)
+      p(p),
+      trie(trie)
     {
       for (int dir = 0; dir < 4; dir++) {
         border[dir] = u.R()[dir];
@@ -61,31 +82,42 @@ namespace quda {
     constexpr GaugeLoop(const Arg &arg) : arg(arg) {}
     static constexpr const char *filename() { return KERNEL_FILE; }
 
-    __device__ __host__ inline reduce_t operator()(reduce_t &value, int x_cb, int parity, int path_id)
+    __device__ __host__ inline reduce_t operator()(reduce_t &value, int x_cb, int parity, int batch)
     {
       using Link = typename Arg::Link;
 
-      reduce_t loop_trace{0, 0};
+      reduce_t loop_trace{};
 
       int x[4] = {0, 0, 0, 0};
       getCoords(x, x_cb, arg.X, parity);
       for (int dr=0; dr<4; ++dr) x[dr] += arg.border[dr]; // extended grid coordinates
 
-      thread_array<int, 4> dx{0};
-
-      double coeff_loop = arg.factor * arg.p.path_coeff[path_id];
-      if (coeff_loop == 0) return operator()(loop_trace, value);
-
-      const int* path = arg.p.input_path[0] + path_id * arg.p.max_length;
-
-      // compute the path
-      Link link_prod = computeGaugePath(arg, x, parity, path, arg.p.length[path_id], dx);
-
-      // compute trace
-      auto trace = getTrace(link_prod);
-
-      loop_trace[0] = coeff_loop * trace.real();
-      loop_trace[1] = coeff_loop * trace.imag();
+      if (arg.trie.enabled) {
+        walkPathTrie(arg, arg.trie, batch, x, parity, [&](const path_node &n, const Link &prod) {
+          auto trace = getTrace(prod);
+          for (int t = n.term_begin; t < n.term_end; t++) {
+            const path_term &term = arg.trie.term[t];
+            loop_trace[2 * term.slot + 0] = arg.factor * term.coeff * trace.real();
+            loop_trace[2 * term.slot + 1] = arg.factor * term.coeff * trace.imag();
+          }
+        });
+      } else {
+        thread_array<int, 4> dx{0};
+        for (int t = arg.trie.tree_term[batch]; t < arg.trie.tree_term[batch + 1]; t++) {
+          const path_term &term = arg.trie.term[t];
+          const int* path = arg.p.input_path[0] + term.path * arg.p.max_length;
+          for (int d = 0; d < 4; d++) dx[d] = 0;
+
+          // compute the path
+          Link link_prod = computeGaugePath(arg, x, parity, path, arg.p.length[term.path], dx);
+
+          // compute trace
+          auto trace = getTrace(link_prod);
+
+          loop_trace[2 * term.slot + 0] = arg.factor * term.coeff * trace.real();
+          loop_trace[2 * term.slot + 1] = arg.factor * term.coeff * trace.imag();
+        }
+      }
 
       return operator()(loop_trace, value);
     }
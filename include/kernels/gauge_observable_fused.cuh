@@ -0,0 +1,111 @@
+#pragma once
+
+#include <gauge_field_order.h>
+#include <index_helper.cuh>
+#include <quda_matrix.h>
+#include <array.h>
+#include <reduction_kernel.h>
+#include <kernels/field_strength_tensor.cuh>
+
+namespace quda
+{
+
+  /**
+     @brief Argument for the fused gauge observables kernel.  The
+     reduction is ordered {spatial plaquette, temporal plaquette,
+     spatial energy, temporal energy, topological charge}.
+     @tparam density Whether to store the topological charge density
+     @tparam native Whether the gauge field is native ordered (device)
+     or QDP ordered (host)
+   */
+  template <typename Float_, int nColor_, QudaReconstructType recon_, bool density_, bool native_>
+  struct GaugeObservablesArg : public ReduceArg<array<double, 5>> {
+    using Float = Float_;
+    static constexpr int nColor = nColor_;
+    static_assert(nColor == 3, "Only nColor=3 enabled at this time");
+    static constexpr QudaReconstructType recon = recon_;
+    static constexpr bool density = density_;
+    static constexpr bool native = native_;
+    using Gauge = std::conditional_t<native, typename gauge_mapper<Float, recon>::type,
+                                     typename gauge_order_mapper<Float, QUDA_QDP_GAUGE_ORDER, nColor>::type>;
+
+    Gauge u;
+    int E[4]; // extended grid dimensions
+    int X[4]; // true grid dimensions
+    int border[4];
+    Float *qDensity;
+
+    GaugeObservablesArg(const GaugeField &u, Float *qDensity = nullptr) :
+      ReduceArg<reduce_t>(dim3(u.LocalVolumeCB(), 2, 1)), u(u), qDensity(qDensity)
+    {
+      for (int dir = 0; dir < 4; ++dir) {
+        border[dir] = u.R()[dir];
+        E[dir] = u.X()[dir];
+        X[dir] = u.X()[dir] - border[dir] * 2;
+      }
+    }
+  };
+
+  /**
+     Computes the plaquette, the clover field energy and the
+     topological charge in a single pass over the gauge field, forming
+     each field-strength component in registers rather than storing
+     the field-strength tensor.
+   */
+  template <typename Arg> struct GaugeObservables : plus<typename Arg::reduce_t> {
+    using reduce_t = typename Arg::reduce_t;
+    using plus<reduce_t>::operator();
+    static constexpr int reduce_block_dim = 2; // x_cb in x, parity in y
+    const Arg &arg;
+    constexpr GaugeObservables(const Arg &arg) : arg(arg) {}
+    static constexpr const char *filename() { return KERNEL_FILE; }
+
+    __device__ __host__ inline reduce_t operator()(reduce_t &value, int x_cb, int parity)
+    {
+      using real = typename Arg::Float;
+      using Link = Matrix<complex<real>, Arg::nColor>;
+      constexpr real q_norm = static_cast<real>(-1.0 / (4 * M_PI * M_PI));
+      constexpr real n_inv = static_cast<real>(1.0 / Arg::nColor);
+
+      reduce_t obs{0, 0, 0, 0, 0};
+
+      int x[4];
+      getCoords(x, x_cb, arg.X, parity);
+      for (int dr = 0; dr < 4; ++dr) x[dr] += arg.border[dr]; // extended grid coordinates
+
+      // same ordering as the field-strength tensor
+      // F0 = F[Y,X], F1 = F[Z,X], F2 = F[Z,Y],
+      // F3 = F[T,X], F4 = F[T,Y], F5 = F[T,Z]
+      constexpr int mu[] = {1, 2, 2, 3, 3, 3};
+      constexpr int nu[] = {0, 0, 1, 0, 1, 2};
+
+      Link iden;
+      setIdentity(&iden);
+
+      Link F[6];
+#pragma unroll
+      for (int i = 0; i < 6; i++) {
+        double plaq;
+        F[i] = computeFmunuSite(arg, x, arg.E, parity, mu[i], nu[i], plaq);
+        obs[i < 3 ? 0 : 1] += plaq;
+
+        // make traceless and accumulate the energy
+        auto tmp = F[i] - n_inv * getTrace(F[i]) * iden;
+        obs[i < 3 ? 2 : 3] -= getTrace(tmp * tmp).real();
+      }
+
+      // apply the levi-civita symbol for the topological charge
+      double Q = 0.0;
+#pragma unroll
+      for (int i = 0; i < 3; i++) {
+        double Qi = getTrace(F[i] * F[5 - i]).real();
+        i % 2 == 0 ? Q += Qi : Q -= Qi;
+      }
+      obs[4] = Q * q_norm;
+      if (Arg::density) arg.qDensity[x_cb + parity * arg.threads.x] = obs[4];
+
+      return operator()(value, obs);
+    }
+  };
+
+} // namespace quda
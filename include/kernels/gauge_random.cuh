@@ -1,18 +1,19 @@
 #include <quda_matrix.h>
 #include <gauge_field_order.h>
 #include <index_helper.cuh>
-#include <random_helper.h>
+#include <counter_rng.h>
 #include <kernel.h>
 
 namespace quda {
 
-  template <typename Float_, int nColor_, QudaReconstructType recon_, bool group_>
+  template <typename Float_, int nColor_, QudaReconstructType recon_, bool group_, bool counter_ = false>
   struct GaugeGaussArg : kernel_param<> {
     using Float = Float_;
     using real = typename mapper<Float>::type;
     static constexpr int nColor = nColor_;
     static constexpr QudaReconstructType recon = recon_;
     static constexpr bool group = group_;
+    static constexpr bool counter = counter_; // whether to use the counter-based generator
 
     using Gauge = typename gauge_mapper<Float, recon>::type;
 
@@ -21,12 +22,14 @@ namespace quda {
     int border[4];
     Gauge U;
     RNGState *rng;
+    CounterRNGParam philox;
     real sigma; // where U = exp(sigma * H)
 
-    GaugeGaussArg(const GaugeField &U, RNGState *rng, double sigma) :
+    GaugeGaussArg(const GaugeField &U, RNGState *rng, double sigma, unsigned long long seed = 0) :
       kernel_param(dim3(U.LocalVolumeCB(), 2, 1)),
       U(U),
       rng(rng),
+      philox(seed, U),
       sigma(sigma)
     {
       for (int dir = 0; dir < 4; ++dir) {
@@ -37,14 +40,14 @@ namespace quda {
     }
   };
 
-  template <typename real, typename Link> __device__ __host__ Link gauss_su3(RNGState &localState)
+  template <typename real, typename Link, typename State> __device__ __host__ Link gauss_su3(State &localState)
   {
     Link ret;
     real rand1[4], rand2[4], phi[4], radius[4], temp1[4], temp2[4];
 
     for (int i = 0; i < 4; ++i) {
-      rand1[i] = uniform<real>::rand(localState);
-      rand2[i] = uniform<real>::rand(localState);
+      rand1[i] = rand_uniform<real>(localState);
+      rand2[i] = rand_uniform<real>(localState);
       phi[i] = 2.0 * rand1[i];
       radius[i] = sqrt(-log(rand2[i]));
       quda::sincospi(phi[i], &temp2[i], &temp1[i]);
@@ -94,16 +97,22 @@ namespace quda {
         for (int mu = 0; mu < 4; mu++) arg.U(mu, linkIndex(x, arg.E), parity) = O;
       } else {
         for (int mu = 0; mu < 4; mu++) {
-          RNGState localState = arg.rng[parity * arg.threads.x + x_cb];
-
           // generate Gaussian distributed su(n) field
-          Link u = arg.sigma * gauss_su3<real, Link>(localState);
+          Link u;
+          if constexpr (Arg::counter) {
+            // each direction is an independent stream
+            auto localState = arg.philox(x_cb, parity, mu);
+            u = arg.sigma * gauss_su3<real, Link>(localState);
+          } else {
+            RNGState localState = arg.rng[parity * arg.threads.x + x_cb];
+            u = arg.sigma * gauss_su3<real, Link>(localState);
+            arg.rng[parity * arg.threads.x + x_cb] = localState;
+          }
+
           if constexpr (Arg::group) {
             expsu3<real>(u);
           }
           arg.U(mu, linkIndex(x, arg.E), parity) = u;
-
-          arg.rng[parity * arg.threads.x + x_cb] = localState;
         }
       }
     }
@@ -29,6 +29,7 @@ namespace quda
 
     Gauge out;
     Matrix temp;
+    Matrix err; // second-order solution, and then the error estimate, for the adaptive flow
     const Gauge in;
 
     int_fastdiv X[4];    // grid dimensions
@@ -37,15 +38,18 @@ namespace quda
     const real epsilon;
     const real coeff1x1;
     const real coeff2x1;
+    const bool adaptive;
 
-    GaugeWFlowArg(GaugeField &out, GaugeField &temp, const GaugeField &in, const real epsilon) :
+    GaugeWFlowArg(GaugeField &out, GaugeField &temp, const GaugeField &in, const real epsilon, GaugeField *err) :
       kernel_param(dim3(in.LocalVolumeCB(), 2, wflow_dim)),
       out(out),
       temp(temp),
+      err(err ? *err : temp),
       in(in),
       epsilon(epsilon),
       coeff1x1(5.0/3.0),
-      coeff2x1(-1.0/12.0)
+      coeff2x1(-1.0/12.0),
+      adaptive(err != nullptr)
     {
       for (int dir = 0; dir < 4; ++dir) {
         border[dir] = in.R()[dir];
@@ -101,6 +105,16 @@ namespace quda
 
     // Retrieve Z0, (8/9 Z1 - 17/36 Z0) stored in temp
     Link Z0 = arg.temp(dir, x_cb, parity);
+
+    if (arg.adaptive) {
+      // Embedded second-order solution exp(2 Z1 - 5/4 Z0) W1, used for the error estimate
+      Link Z = static_cast<typename Arg::real>(9.0 / 4.0) * Z1 - static_cast<typename Arg::real>(5.0 / 4.0) * Z0;
+      Z *= arg.epsilon;
+      makeAntiHerm(Z);
+      Z = complex<typename Arg::real>(0.0, -1.0) * Z;
+      arg.err(dir, x_cb, parity) = exponentiate_iQ(Z) * U;
+    }
+
     Z0 *= static_cast<typename Arg::real>(17.0 / 36.0);
     Z1 = Z1 - Z0;
     arg.temp(dir, x_cb, parity) = Z1;
@@ -153,6 +167,12 @@ namespace quda
       Z = im * Z;
       U = exponentiate_iQ(Z) * U;
       arg.out(dir, linkIndex(x, arg.E), parity) = U;
+
+      // The local error estimate is the difference between the third- and second-order solutions
+      if (Arg::step_type == WFLOW_STEP_VT && arg.adaptive) {
+        Link W = arg.err(dir, x_cb, parity);
+        arg.err(dir, x_cb, parity) = U - W;
+      }
     }
   };
 
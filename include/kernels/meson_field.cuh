@@ -0,0 +1,202 @@
+#pragma once
+
+#include <color_spinor_field_order.h>
+#include <index_helper.cuh>
+#include <array.h>
+#include <math_helper.cuh>
+#include <block_reduce_helper.h>
+#include <block_reduction_kernel.h>
+#include <atomic_helper.h>
+#include <comm_quda.h>
+
+namespace quda
+{
+
+  /**
+     @brief Size of the square tile of (w, v) vector pairs computed by
+     each thread of the meson field kernel
+   */
+  constexpr int meson_field_tile() { return 4; }
+
+  /**
+     @brief Maximum number of (momentum, gamma) insertions computed in a
+     single meson field kernel
+   */
+  constexpr int max_n_insertion_meson() { return 32; }
+
+  /**
+     @brief An insertion is a spatial momentum and a Degrand-Rossi
+     gamma matrix.  The 16 gamma matrices (ordered as in enum_quda.h)
+     each have a single non-zero element per row, so Gamma is stored
+     as the column index and phase (a power of i) of each row.
+   */
+  struct MesonFieldInsertion {
+    int mom[3];   // spatial momentum in units of 2 pi / L
+    int col[4];   // column of the non-zero element of each row of Gamma
+    int phase[4]; // the non-zero element of each row of Gamma is i^phase
+  };
+
+  /**
+     @brief Argument for the meson field kernel.  The result buffer
+     holds a tile of complex meson field elements with index (i * tile
+     + j) for each local time slice and insertion.
+     @tparam native Whether the fields are native ordered (device) or
+     space-spin-color ordered (host)
+   */
+  template <typename Float, int nColor_, bool native_> struct MesonFieldArg : kernel_param<> {
+    using reduce_t = array<double, 2 * meson_field_tile() * meson_field_tile()>;
+    using real = typename mapper<Float>::type;
+    static constexpr int nSpin = 4;
+    static constexpr int nColor = nColor_;
+    static constexpr bool native = native_;
+    static constexpr int tile = meson_field_tile();
+    static_assert(sizeof(Float) >= sizeof(float), "Meson fields only supported in single and double precision");
+    static constexpr QudaFieldOrder order
+      = native ? colorspinor::getNative<Float>(nSpin) : QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+    // disable ghost to reduce arg size
+    using F = typename colorspinor::FieldOrderCB<real, nSpin, nColor, 1, order, Float, Float, true>;
+
+    F w[tile];
+    F v[tile];
+    int n_w;           // number of w vectors in this tile
+    int n_v;           // number of v vectors in this tile
+    int X[4];          // local grid dimensions
+    int offset[3];     // global coordinates of the local origin
+    int L[3];          // global spatial dimensions
+    int volume_s_cb;   // local checkerboarded spatial volume
+    int n_insertion;   // number of insertions
+    MesonFieldInsertion insertion[max_n_insertion_meson()];
+    reduce_t *result;  // local time-slice results, layout [t][insertion]
+
+    static constexpr bool swizzle = false;
+    int swizzle_factor;
+    static constexpr bool launch_bounds = false;
+    dim3 grid_dim;
+    dim3 block_dim;
+
+    MesonFieldArg(cvector_ref<const ColorSpinorField> &w, cvector_ref<const ColorSpinorField> &v,
+                  const MesonFieldInsertion *insertion_, int n_insertion, reduce_t *result) :
+      kernel_param(dim3(w[0].Volume(), 1, 1)),
+      n_w(w.size()),
+      n_v(v.size()),
+      volume_s_cb(w[0].VolumeCB() / w[0].X()[3]),
+      n_insertion(n_insertion),
+      result(result),
+      swizzle_factor(1)
+    {
+      for (int i = 0; i < n_w; i++) this->w[i] = w[i];
+      for (int j = 0; j < n_v; j++) this->v[j] = v[j];
+      for (int dir = 0; dir < 4; dir++) X[dir] = w[0].X()[dir];
+      for (int dir = 0; dir < 3; dir++) {
+        offset[dir] = comm_coord(dir) * X[dir];
+        L[dir] = comm_dim(dir) * X[dir];
+      }
+      for (int k = 0; k < n_insertion; k++) insertion[k] = insertion_[k];
+    }
+  };
+
+  /**
+     @brief Load the spinor at a given site from a field accessor
+   */
+  template <typename Vector, typename F>
+  __device__ __host__ inline Vector load_meson_vector(const F &f, int x_cb, int parity)
+  {
+    Vector v;
+#pragma unroll
+    for (int s = 0; s < F::nSpin; s++)
+#pragma unroll
+      for (int c = 0; c < F::nColor; c++) v(s, c) = f(parity, x_cb, s, c);
+    return v;
+  }
+
+  /**
+     Computes a tile of meson field elements
+     M_ij(t) = sum_x exp(-i p.x) w_i^dag(x, t) Gamma v_j(x, t)
+     for every insertion.  The thread blocks are aligned to the time
+     slices, with the time slice running slowest over the blocks, and
+     each thread covers one site (both parities).  Each thread loads
+     the tile of w and v vectors at its site into registers once and
+     loops over the insertions, block-reducing the tile for each
+     insertion and atomically adding it to the time-slice result.
+   */
+  template <typename Arg> struct MesonField {
+    using reduce_t = typename Arg::reduce_t;
+    const Arg &arg;
+    constexpr MesonField(const Arg &arg) : arg(arg) {}
+    static constexpr const char *filename() { return KERNEL_FILE; }
+
+    __device__ __host__ inline void operator()(dim3 block, dim3 thread)
+    {
+      constexpr int nSpin = Arg::nSpin;
+      constexpr int tile = Arg::tile;
+      using real = typename Arg::real;
+      using Vector = ColorSpinor<real, Arg::nColor, nSpin>;
+
+      const int n_block_slice = arg.grid_dim.x / arg.X[3];
+      const int t = block.x / n_block_slice;
+      const int xs = (block.x % n_block_slice) * arg.block_dim.x + thread.x;
+      const bool active = xs < 2 * arg.volume_s_cb;
+      const int parity = xs / arg.volume_s_cb;
+      // sites are ordered with time running slowest
+      const int x_cb = t * arg.volume_s_cb + xs % arg.volume_s_cb;
+
+      Vector w[tile];
+      Vector v[tile];
+      int coord[4] = {};
+      if (active) {
+#pragma unroll
+        for (int i = 0; i < tile; i++)
+          if (i < arg.n_w) w[i] = load_meson_vector<Vector>(arg.w[i], x_cb, parity);
+#pragma unroll
+        for (int j = 0; j < tile; j++)
+          if (j < arg.n_v) v[j] = load_meson_vector<Vector>(arg.v[j], x_cb, parity);
+        getCoords(coord, x_cb, arg.X, parity);
+      }
+
+      for (int k = 0; k < arg.n_insertion; k++) {
+        const auto &ins = arg.insertion[k];
+        reduce_t value {};
+
+        if (active) {
+          double phase = 0.0;
+#pragma unroll
+          for (int dir = 0; dir < 3; dir++)
+            phase += static_cast<double>(ins.mom[dir] * (coord[dir] + arg.offset[dir])) / arg.L[dir];
+          real s, c;
+          quda::sincospi(static_cast<real>(-2.0 * (phase - floor(phase))), &s, &c);
+
+          // fold the momentum phase into the gamma matrix elements
+          complex<real> g[nSpin];
+#pragma unroll
+          for (int mu = 0; mu < nSpin; mu++) {
+            switch (ins.phase[mu]) {
+            case 0: g[mu] = complex<real>(c, s); break;
+            case 1: g[mu] = complex<real>(-s, c); break;
+            case 2: g[mu] = complex<real>(-c, -s); break;
+            default: g[mu] = complex<real>(s, -c); break;
+            }
+          }
+
+#pragma unroll
+          for (int i = 0; i < tile; i++) {
+            if (i >= arg.n_w) break;
+#pragma unroll
+            for (int j = 0; j < tile; j++) {
+              if (j >= arg.n_v) break;
+              complex<real> m = 0.0;
+#pragma unroll
+              for (int mu = 0; mu < nSpin; mu++) m += g[mu] * innerProduct(w[i], v[j], mu, ins.col[mu]);
+              value[2 * (i * tile + j) + 0] = m.real();
+              value[2 * (i * tile + j) + 1] = m.imag();
+            }
+          }
+        }
+
+        // synchronous since the shared storage is reused for every insertion
+        value = BlockReduce<reduce_t, 1>().template Sum<false>(value);
+        if (target::thread_idx().x == 0) atomic_fetch_add(&arg.result[t * arg.n_insertion + k], value);
+      }
+    }
+  };
+
+} // namespace quda
@@ -596,6 +596,38 @@ namespace quda
       constexpr int flops() const { return 8; }   //! flops per element
     };
 
+    /**
+       double2 pipelinedCGUpdate(d a, d b, V x, V y, V z, V w, V v){}
+        w = v + b*w;
+        z = y + b*z;
+        x -= a*z;
+        y -= a*w;
+        norm2(x);
+        dotProduct(x,y);
+    */
+    template <typename real_reduce_t, typename real>
+    struct pipelinedCGUpdate_ : public ReduceFunctor<array<real_reduce_t, 2>> {
+      using reduce_t = array<real_reduce_t, 2>;
+      static constexpr memory_access<1, 1, 1, 1, 1> read{ };
+      static constexpr memory_access<1, 1, 1, 1> write{ };
+      const real a;
+      const real b;
+      pipelinedCGUpdate_(const real &a, const real &b) : a(a), b(b) { ; }
+      template <typename T> __device__ __host__ void operator()(reduce_t &sum, T &x, T &y, T &z, T &w, T &v) const
+      {
+#pragma unroll
+        for (int i = 0; i < x.size(); i++) {
+          w[i] = v[i] + b * w[i];
+          z[i] = y[i] + b * z[i];
+          x[i] -= a * z[i];
+          y[i] -= a * w[i];
+          norm2_<real_reduce_t, real>(sum[0], x[i]);
+          dot_<real_reduce_t, real>(sum[1], x[i], y[i]);
+        }
+      }
+      constexpr int flops() const { return 12; }   //! flops per element
+    };
+
     /**
        double quadrupleCG3InitNorm(d a, d b, V x, V y, V z, V w, V v){}
         z = x;
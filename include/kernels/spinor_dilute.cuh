@@ -1,5 +1,7 @@
 #include <color_spinor_field_order.h>
 #include <constant_kernel_arg.h>
+#include <index_helper.cuh>
+#include <comm_quda.h>
 #include <kernel.h>
 
 namespace quda {
@@ -93,4 +95,131 @@ namespace quda {
 
   };
 
+  /**
+     @brief Argument for generating a single member of a dilution set,
+     with the dilution type and member index given at run time, so
+     that diluted sources can be generated one at a time.
+   */
+  template <typename store_t, int nSpin_, int nColor_> struct SpinorDiluteIndexArg : kernel_param<> {
+    using real = typename mapper<store_t>::type;
+    static constexpr int nSpin = nSpin_;
+    static constexpr int nColor = nColor_;
+    using V = typename colorspinor_mapper<store_t, nSpin, nColor>::type;
+    V v;
+    V src;
+    const QudaDilutionType type;
+    const int index;   // which member of the dilution set to generate
+    int X[4];          // local dimensions (with full x dimension for single-parity fields)
+    int offset[4];     // global coordinates of the local origin
+    int block[4];      // block size for block dilution
+    int n_block[4];    // global number of blocks in each dimension
+    int probe_bits;    // log2 of the number of probing vectors
+
+    /**
+       @brief Constructor for the dilution arg
+       @param v The output diluted source
+       @param src The source vector we are diluting
+       @param type The dilution type
+       @param index The member of the dilution set to generate
+       @param block_size The block size for block dilution
+       @param probe_size The number of probing vectors for Hadamard probing
+     */
+    SpinorDiluteIndexArg(ColorSpinorField &v, const ColorSpinorField &src, QudaDilutionType type, int index,
+                         const lat_dim_t &block_size, int probe_size) :
+      kernel_param(dim3(src.VolumeCB(), src.SiteSubset(), 1)), v(v), src(src), type(type), index(index), probe_bits(0)
+    {
+      for (int d = 0; d < 4; d++) {
+        X[d] = src.X(d) * (d == 0 && src.SiteSubset() == QUDA_PARITY_SITE_SUBSET ? 2 : 1);
+        offset[d] = comm_coord(d) * X[d];
+        block[d] = block_size[d] > 0 ? block_size[d] : 1;
+        n_block[d] = comm_dim(d) * X[d] / block[d];
+      }
+      while ((1 << probe_bits) < probe_size) probe_bits++;
+    }
+  };
+
+  /**
+     Functor for generating a single member of a dilution set.  Site
+     dilutions (time slice, block and probing) multiply the source at
+     each site by a weight, while the spin and color dilutions select
+     components.
+   */
+  template <typename Arg> struct DiluteSpinorIndex {
+    const Arg &arg;
+    constexpr DiluteSpinorIndex(const Arg &arg) : arg(arg) {}
+    static constexpr const char *filename() { return KERNEL_FILE; }
+
+    /**
+       @brief Return the weight of the source at a given site
+       @param[in] x Global site coordinates
+     */
+    __device__ __host__ int site_weight(const int x[4]) const
+    {
+      switch (arg.type) {
+      case QUDA_DILUTION_TIME_SLICE: return x[3] == arg.index ? 1 : 0;
+      case QUDA_DILUTION_BLOCK: {
+        int b = 0;
+        for (int d = 3; d >= 0; d--) b = b * arg.n_block[d] + x[d] / arg.block[d];
+        return b == arg.index ? 1 : 0;
+      }
+      case QUDA_DILUTION_HADAMARD_PROBING: {
+        // the color of a site interleaves the bits of its coordinates,
+        // level by level, so the leading 2^(4 l) vectors probe the
+        // 2^l-periodic coloring; the lowest x bit is replaced by the
+        // site parity, which gives the same coloring but does not
+        // depend on which parity a single-parity field holds
+        int color = 0;
+        for (int b = 0; b < arg.probe_bits; b++) {
+          int level = b / 4, d = b % 4;
+          int bit = (level == 0 && d == 0) ? (x[0] + x[1] + x[2] + x[3]) & 1 : (x[d] >> level) & 1;
+          color |= bit << b;
+        }
+        int sign = 0;
+        for (int c = arg.index & color; c; c >>= 1) sign ^= c & 1;
+        return sign ? -1 : 1;
+      }
+      default: return 1;
+      }
+    }
+
+    /**
+       @brief Return whether a given component is part of this member
+       of the dilution set
+       @param[in] s Spin index
+       @param[in] c Color index
+       @param[in] parity Site parity
+     */
+    __device__ __host__ bool component(int s, int c, int parity) const
+    {
+      switch (arg.type) {
+      case QUDA_DILUTION_SPIN: return s == arg.index;
+      case QUDA_DILUTION_COLOR: return c == arg.index;
+      case QUDA_DILUTION_SPIN_COLOR: return (s * Arg::nColor + c) == arg.index;
+      case QUDA_DILUTION_SPIN_COLOR_EVEN_ODD: return ((parity * Arg::nSpin + s) * Arg::nColor + c) == arg.index;
+      default: return true;
+      }
+    }
+
+    __device__ __host__ void operator()(int x_cb, int parity)
+    {
+      using real = typename Arg::real;
+      using vector = ColorSpinor<real, Arg::nColor, Arg::nSpin>;
+      vector src = arg.src(x_cb, parity);
+
+      int x[4];
+      getCoords(x, x_cb, arg.X, parity);
+      for (int d = 0; d < 4; d++) x[d] += arg.offset[d];
+      real w = site_weight(x);
+
+      vector v;
+      for (int s = 0; s < Arg::nSpin; s++) {
+        for (int c = 0; c < Arg::nColor; c++) {
+          v(s, c) = component(s, c, parity) ? w * src(s, c) : complex<real>(0.0, 0.0);
+        }
+      }
+
+      arg.v(x_cb, parity) = v;
+    }
+  };
+
 }
@@ -1,42 +1,45 @@
 #include <math_helper.cuh>
 #include <color_spinor_field_order.h>
-#include <random_helper.h>
+#include <counter_rng.h>
 #include <kernel.h>
 
 namespace quda {
 
   using namespace colorspinor;
 
-  template <typename real_, int nSpin_, int nColor_, QudaNoiseType noise_>
+  template <typename real_, int nSpin_, int nColor_, QudaNoiseType noise_, bool counter_ = false>
   struct SpinorNoiseArg : kernel_param<> {
     using real = real_;
     static constexpr int nSpin = nSpin_;
     static constexpr int nColor = nColor_;
     static constexpr QudaFieldOrder order = colorspinor::getNative<real>(nSpin);
     static constexpr QudaNoiseType noise = noise_;
+    static constexpr bool counter = counter_; // whether to use the counter-based generator
     using V = typename colorspinor::FieldOrderCB<real, nSpin, nColor, 1, order>;
     V v;
     RNGState *rng;
-    SpinorNoiseArg(ColorSpinorField &v, RNGState *rng) :
+    CounterRNGParam philox;
+    SpinorNoiseArg(ColorSpinorField &v, RNGState *rng, unsigned long long seed = 0) :
       kernel_param(dim3(v.VolumeCB(), v.SiteSubset(), 1)),
       v(v),
-      rng(rng) { }
+      rng(rng),
+      philox(seed, v, v.SuggestedParity()) { }
   };
 
-  template<typename real, typename Arg> // Gauss
-  __device__ __host__ inline void genGauss(Arg &arg, RNGState& localState, int parity, int x_cb, int s, int c) {
-    real phi = 2.0 * uniform<real>::rand(localState);
-    real radius = uniform<real>::rand(localState);
+  template<typename real, typename Arg, typename State> // Gauss
+  __device__ __host__ inline void genGauss(Arg &arg, State& localState, int parity, int x_cb, int s, int c) {
+    real phi = 2.0 * rand_uniform<real>(localState);
+    real radius = rand_uniform<real>(localState);
     radius = sqrt(-log(radius));
     real phi_sin, phi_cos;
     quda::sincospi(phi, &phi_sin, &phi_cos);
     arg.v(parity, x_cb, s, c) = radius * complex<real>(phi_cos, phi_sin);
   }
 
-  template<typename real, typename Arg> // Uniform
-  __device__ __host__ inline void genUniform(Arg &arg, RNGState& localState, int parity, int x_cb, int s, int c) {
-    real x = uniform<real>::rand(localState);
-    real y = uniform<real>::rand(localState);
+  template<typename real, typename Arg, typename State> // Uniform
+  __device__ __host__ inline void genUniform(Arg &arg, State& localState, int parity, int x_cb, int s, int c) {
+    real x = rand_uniform<real>(localState);
+    real y = rand_uniform<real>(localState);
     arg.v(parity, x_cb, s, c) = complex<real>(x, y);
   }
 
@@ -45,16 +48,26 @@ namespace quda {
     constexpr NoiseSpinor(const Arg &arg) : arg(arg) {}
     static constexpr const char* filename() { return KERNEL_FILE; }
 
-    __device__ __host__ void operator()(int x_cb, int parity)
+    template <typename State> __device__ __host__ void generate(State &localState, int x_cb, int parity)
     {
-      RNGState localState = arg.rng[parity * arg.threads.x + x_cb];
       for (int s=0; s<Arg::nSpin; s++) {
         for (int c=0; c<Arg::nColor; c++) {
           if (Arg::noise == QUDA_NOISE_GAUSS) genGauss<typename Arg::real>(arg, localState, parity, x_cb, s, c);
           else if (Arg::noise == QUDA_NOISE_UNIFORM) genUniform<typename Arg::real>(arg, localState, parity, x_cb, s, c);
         }
       }
-      arg.rng[parity * arg.threads.x + x_cb] = localState;
+    }
+
+    __device__ __host__ void operator()(int x_cb, int parity)
+    {
+      if constexpr (Arg::counter) {
+        auto localState = arg.philox(x_cb, parity);
+        generate(localState, x_cb, parity);
+      } else {
+        RNGState localState = arg.rng[parity * arg.threads.x + x_cb];
+        generate(localState, x_cb, parity);
+        arg.rng[parity * arg.threads.x + x_cb] = localState;
+      }
     }
   };
 
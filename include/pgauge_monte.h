@@ -7,14 +7,35 @@ namespace quda {
 
   /**
    * @brief Perform heatbath and overrelaxation. Performs nhb heatbath steps followed by nover overrelaxation steps.
+   * On a partitioned lattice the overlapped schedule updates the interior sites of each direction and parity
+   * while the boundary exchange of the previous update is in flight.
    *
    * @param[in,out] data Gauge field
    * @param[in,out] rngstate state of the CURAND random number generator
    * @param[in] Beta inverse of the gauge coupling, beta = 2 Nc / g_0^2
    * @param[in] nhb number of heatbath steps
    * @param[in] nover number of overrelaxation steps
+   * @param[in] nhit number of updates of each link per step, reusing its staple
+   * @param[in] overlap whether to overlap the boundary exchange with the interior updates
    */
-  void Monte(GaugeField &data, RNG &rngstate, double Beta, int nhb, int nover);
+  void Monte(GaugeField &data, RNG &rngstate, double Beta, int nhb, int nover, int nhit = 1, bool overlap = true);
+
+  /**
+   * @brief Perform heatbath and overrelaxation using the counter-based generator, which needs no state and so
+   * also supports host (QDP ordered) fields on an unpartitioned lattice.  The random numbers of heatbath step i
+   * are drawn from stream (sweep + i), so successive calls should advance sweep by nhb.
+   *
+   * @param[in,out] data Gauge field
+   * @param[in] seed Seed of the counter-based generator
+   * @param[in] sweep Index of the first heatbath step
+   * @param[in] Beta inverse of the gauge coupling, beta = 2 Nc / g_0^2
+   * @param[in] nhb number of heatbath steps
+   * @param[in] nover number of overrelaxation steps
+   * @param[in] nhit number of updates of each link per step, reusing its staple
+   * @param[in] overlap whether to overlap the boundary exchange with the interior updates
+   */
+  void Monte(GaugeField &data, unsigned long long seed, int sweep, double Beta, int nhb, int nover, int nhit = 1,
+             bool overlap = true);
 
   /**
    * @brief Perform a cold start to the gauge field, identity SU(3)
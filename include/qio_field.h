@@ -6,8 +6,19 @@ void read_gauge_field(const char *filename, void *gauge[], QudaPrecision prec, c
 void write_gauge_field(const char *filename, void *gauge[], QudaPrecision prec, const int *X, int argc, char *argv[]);
 void read_spinor_field(const char *filename, void *V[], QudaPrecision precision, const int *X, QudaSiteSubset subset,
                        QudaParity parity, int nColor, int nSpin, int Nvec, int argc, char *argv[]);
-void write_spinor_field(const char *filename, const void *V[], QudaPrecision precision, const int *X, QudaSiteSubset subset,
-                        QudaParity parity, int nColor, int nSpin, int Nvec, int argc, char *argv[]);
+/**
+   @brief Write a set of spinor fields to file
+   @param[in] precision The precision of the host fields
+   @param[in] file_prec The precision used in the file.  Half and
+   quarter precision select a block-scaled fixed-point encoding with a
+   per-site norm.  Defaults to the host field precision.
+   @param[in] abort_on_error Whether a failed write is a fatal error,
+   else the QIO status is returned
+   @return The QIO status of the write (zero on success)
+*/
+int write_spinor_field(const char *filename, const void *V[], QudaPrecision precision, const int *X, QudaSiteSubset subset,
+                       QudaParity parity, int nColor, int nSpin, int Nvec, int argc, char *argv[],
+                       QudaPrecision file_prec = QUDA_INVALID_PRECISION, bool abort_on_error = true);
 #else
 inline void read_gauge_field(const char *, void *[], QudaPrecision, const int *, int, char *[])
 {
@@ -25,8 +36,8 @@ inline void read_spinor_field(const char *, void *[], QudaPrecision, const int *
   printf("QIO support has not been enabled\n");
   exit(-1);
 }
-inline void write_spinor_field(const char *, const void *[], QudaPrecision, const int *, QudaSiteSubset, QudaParity, int, int,
-                               int, int, char *[])
+inline int write_spinor_field(const char *, const void *[], QudaPrecision, const int *, QudaSiteSubset, QudaParity, int, int,
+                              int, int, char *[], QudaPrecision = QUDA_INVALID_PRECISION, bool = true)
 {
   printf("QIO support has not been enabled\n");
   exit(-1);
@@ -147,6 +147,8 @@ extern "C" {
     int maxiter; /**< Maximum number of iterations in the linear solver */
     double reliable_delta; /**< Reliable update tolerance */
     double reliable_delta_refinement; /**< Reliable update tolerance used in post multi-shift solver refinement */
+    int multishift_refine_batch; /**< Maximum number of shifts refined concurrently after the multi-shift solver
+                                    (1 = refine each shift sequentially) */
     int use_alternative_reliable; /**< Whether to use alternative reliable updates */
     int use_sloppy_partial_accumulator; /**< Whether to keep the partial solution accumuator in sloppy precision */
 
@@ -196,6 +198,21 @@ extern "C" {
       split_grid[0] * split_grid[1] * split_grid[2] * split_grid[3] * num_src_per_sub_partition == num_src. **/
     int split_grid[QUDA_MAX_DIM];
 
+    /** If set, invertMultiSrcQuda dilutes the single source _hp_b[0]
+        and solves for each of the num_src members of the dilution set,
+        generating the diluted sources on the device a batch at a time
+        rather than all at once (QUDA_DILUTION_INVALID disables) */
+    QudaDilutionType dilution_type;
+
+    /** Block size for QUDA_DILUTION_BLOCK */
+    int dilution_block_size[4];
+
+    /** Number of probing vectors for QUDA_DILUTION_HADAMARD_PROBING, a power of two */
+    int dilution_probe_size;
+
+    /** Number of diluted sources generated and solved together */
+    int dilution_batch_size;
+
     int overlap; /**< Width of domain overlaps */
 
     /** Offsets for multi-shift solver */
@@ -330,6 +347,11 @@ extern "C" {
     /** Maximum eigenvalue for Chebyshev CA basis */
     double ca_lambda_max;
 
+    /** Whether to adapt the CA basis length (up to gcrNkrylov) and
+        basis type on the fly, estimating the Chebyshev bounds from the
+        Ritz values of the Krylov space */
+    QudaBoolean ca_adaptive;
+
     /** Basis for CA algorithms in a preconditioned solver */
     QudaCABasis ca_basis_precondition;
 
@@ -414,6 +436,14 @@ extern "C" {
     /** initCG tuning parameter:  tolerance for cg refinement corrections in the deflation stage */
     double inc_tol;
 
+    /** GCRO-DR: recycle space preserved from a previous solve (the
+        recycle space dimension is n_ev) */
+    void *recycle_space;
+
+    /** GCRO-DR: whether to preserve the recycle space in recycle_space
+        for subsequent solves, else it is released at the end of the solve */
+    QudaBoolean preserve_recycle;
+
     /** Whether to make the solution vector(s) after the solve */
     int make_resident_solution;
 
@@ -524,6 +554,18 @@ extern "C" {
     int n_conv;
     /** Number of requested converged eigenvectors to use in deflation **/
     int n_ev_deflate;
+    /** Number of leading eigenvectors used to construct the block-local
+        basis of a compressed deflation space.  If zero the deflation
+        space is stored uncompressed **/
+    int compress_n_basis;
+    /** Geometric block size of the aggregates of the compressed deflation space **/
+    int compress_block_size[4];
+    /** Precision of the coarse coefficients of the compressed deflation space **/
+    QudaPrecision compress_prec;
+    /** Precision in which the deflation space is stored, if lower
+        than that of the eigensolver.  The deflated vectors are
+        accumulated at their own precision **/
+    QudaPrecision deflation_prec;
     /** Tolerance on the least well known eigenvalue's residual **/
     double tol;
     /** Tolerance on the QR iteration **/
@@ -835,6 +877,18 @@ extern "C" {
     double rho; /**< Serves as one of the coefficients used in Over Improved Stout smearing, or as the single coefficient used in Stout */
     unsigned int meas_interval;    /**< Perform the requested measurements on the gauge field at this interval */
     QudaGaugeSmearType smear_type; /**< The smearing type to perform */
+    QudaBoolean adaptive; /**< Wilson/Symanzik flow only: adapt the step size with an embedded second-order error
+                             estimate, with epsilon the initial step size and n_steps * epsilon the final flow time */
+    double tolerance;     /**< Wilson/Symanzik flow only: the maximum local error allowed per adaptive step */
+    char flow_record_file[256]; /**< Wilson/Symanzik flow only: if non-empty, append the measured observables to
+                                   this file as JSON lines */
+    double t0_ref;              /**< Wilson/Symanzik flow only: the value of t^2 E(t) defining the scale t0, which is
+                                   not computed if zero (typically 0.3) */
+    double w0_ref; /**< Wilson/Symanzik flow only: the value of t d/dt t^2 E(t) defining the scale w0, which is not
+                      computed if zero (typically 0.3) */
+    QudaBoolean stop_at_scale; /**< Wilson/Symanzik flow only: stop the flow once the requested scales are found */
+    double t0;                 /**< Output: the scale t0/a^2, negative if not reached */
+    double w0;                 /**< Output: the scale w0/a, negative if not reached */
   } QudaGaugeSmearParam;
 
   typedef struct QudaBLASParam_s {
@@ -1092,12 +1146,36 @@ extern "C" {
   void printQudaBLASParam(QudaBLASParam *param);
 
   /**
-   * Load the gauge field from the host.
+   * Load the gauge field from the host.  If neither the host field
+   * nor the parameters have changed since the previous load of this
+   * link type, the resident fields are reused.  This change detection
+   * can be disabled by setting QUDA_ENABLE_LOAD_CACHE=0.
    * @param h_gauge Base pointer to host gauge field (regardless of dimensionality)
    * @param param   Contains all metadata regarding host and device storage
    */
   void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param);
 
+  /**
+   * Memory map a gauge configuration stored in ILDG or SciDAC (QIO
+   * single-file) format for read-only access.  The returned pointer
+   * can be passed directly to loadGaugeQuda, with each process
+   * reading only its local sub-volume from the mapped file.  The
+   * file is parsed once, and repeated calls for an unmodified file
+   * reuse the existing mapping.
+   * @param filename The gauge configuration file
+   * @param param    On input X must hold the local lattice dimensions;
+   *                 on return cpu_prec and gauge_order are set to
+   *                 describe the mapped field
+   * @return Pointer to the mapped gauge field
+   */
+  void *mapGaugeQuda(const char *filename, QudaGaugeParam *param);
+
+  /**
+   * Release a gauge field mapped with mapGaugeQuda.
+   * @param h_gauge Pointer returned by mapGaugeQuda
+   */
+  void unmapGaugeQuda(void *h_gauge);
+
   /**
    * Free QUDA's internal copy of the gauge field.
    */
@@ -1152,6 +1230,19 @@ extern "C" {
    */
   void eigensolveQuda(void **h_evecs, double_complex *h_evals, QudaEigParam *param);
 
+  /**
+   * Benchmark the deflation of a block of sources against the
+   * deflation space preserved by a prior deflated solve (see
+   * QudaEigParam::preserve_deflation).  The preserved space is
+   * released on return unless preserve_deflation is still set.
+   * @param param The invert param of the deflated solve, whose
+   *        eig_param holds the preserved deflation space
+   * @param n_src Number of sources deflated together
+   * @param niter Number of times the deflation is repeated
+   * @return The achieved bandwidth in GB/s against the eigenvector footprint
+   */
+  double deflationBenchmarkQuda(QudaInvertParam *param, int n_src, int niter);
+
   /**
    * Perform the solve, according to the parameters set in param.  It
    * is assumed that the gauge field has already been loaded via
@@ -1561,7 +1652,8 @@ extern "C" {
      field and exponentiate it, e.g., U = exp(sigma * H), where H is
      the distributed su(n) field and sigma is the width of the
      distribution (sigma = 0 results in a free field, and sigma = 1 has
-     maximum disorder).
+     maximum disorder).  A counter-based generator is used, so for a
+     given seed the field is independent of the process grid.
 
      @param seed The seed used for the RNG
      @param sigma Width of Gaussian distrubution
@@ -1573,7 +1665,9 @@ extern "C" {
    * resident momentum field. We create a Gaussian-distributed su(n)
    * field, e.g., sigma * H, where H is the distributed su(n) field
    * and sigma is the width of the distribution (sigma = 0 results
-   * in a free field, and sigma = 1 has maximum disorder).
+   * in a free field, and sigma = 1 has maximum disorder).  A
+   * counter-based generator is used, so for a given seed the field
+   * is independent of the process grid.
    *
    * @param seed The seed used for the RNG
    * @param sigma Width of Gaussian distrubution
@@ -1639,6 +1733,19 @@ extern "C" {
    */
   void gaugeObservablesQuda(QudaGaugeObservableParam *param);
 
+  /**
+   * @brief Calculates the plaquette, field energy and topological
+   * charge (and optionally its density) of a QDP-ordered host gauge
+   * field on the host, using the same fused kernel as
+   * gaugeObservablesQuda.  Intended for validating the device
+   * computation; only supported when no dimension is partitioned.
+   * @param[in] h_gauge Base pointer to host gauge field
+   * @param[in] gauge_param Contains all metadata regarding host gauge field
+   * @param[in,out] param Parameter struct that defines which
+   * observables we are making and the resulting observables.
+   */
+  void gaugeObservablesHostQuda(void *h_gauge, QudaGaugeParam *gauge_param, QudaGaugeObservableParam *param);
+
   /**
    * Public function to perform color contractions of the host spinors x and y.
    * @param[in] x pointer to host data
@@ -1651,6 +1758,52 @@ extern "C" {
   void contractQuda(const void *x, const void *y, void *result, const QudaContractType cType, QudaInvertParam *param,
                     const int *X);
 
+  /**
+   * Public function to compute momentum-projected, time-slice summed
+   * contractions of a batch of host propagator pairs.  The phase
+   * multiplication and the time-slice sum are fused into the
+   * contraction on the device, so only the correlators are returned
+   * to the host.
+   * @param[in] x Array of n_prop pointers to host data (conjugated)
+   * @param[in] y Array of n_prop pointers to host data
+   * @param[in] n_prop Number of propagator pairs, the correlators are summed over the pairs
+   * @param[out] result Complex correlators with layout [t][mom][gamma], where t is the global time slice
+   * @param[in] cType Which type of contraction (open or degrand-rossi)
+   * @param[in] param meta data for construction of ColorSpinorFields.
+   * @param[in] X spacetime data for construction of ColorSpinorFields.
+   * @param[in] n_mom Number of momenta
+   * @param[in] mom Spatial momenta in units of 2 pi / L, three integers per momentum
+   * @param[in] source_position Global source position relative to which the phase is computed
+   * @param[in] n_gamma Number of insertions to return
+   * @param[in] gamma Indices of the insertions to return, each in [0, 16)
+   */
+  void contractSummedQuda(void **x, void **y, int n_prop, double *result, const QudaContractType cType,
+                          QudaInvertParam *param, const int *X, int n_mom, const int *mom, const int *source_position,
+                          int n_gamma, const int *gamma);
+
+  /**
+   * Public function to compute the meson fields
+   * M_ij(t, p, Gamma) = sum_x exp(-i p.x) w_i^dag(x, t) Gamma v_j(x, t)
+   * between two sets of host vectors, e.g., the eigenvectors
+   * returned by eigensolveQuda.  If both sets are the same only one
+   * copy is made.
+   * @param[in] w Array of n_w pointers to host data (conjugated)
+   * @param[in] n_w Number of w vectors
+   * @param[in] v Array of n_v pointers to host data
+   * @param[in] n_v Number of v vectors
+   * @param[out] result Complex meson fields with layout [t][mom][gamma][i][j], where t is the global time slice
+   * @param[in] param meta data for construction of ColorSpinorFields.
+   * @param[in] X spacetime data for construction of ColorSpinorFields.
+   * @param[in] n_mom Number of momenta
+   * @param[in] mom Spatial momenta in units of 2 pi / L, three integers per momentum
+   * @param[in] n_gamma Number of gamma insertions
+   * @param[in] gamma Degrand-Rossi gamma insertions, each in [0, 16) ordered as contractQuda
+   * @param[in] location Where to compute the meson fields: QUDA_CUDA_FIELD_LOCATION, or
+   * QUDA_CPU_FIELD_LOCATION for verification, which requires Degrand-Rossi host vectors
+   */
+  void mesonFieldQuda(void **w, int n_w, void **v, int n_v, double *result, QudaInvertParam *param, const int *X,
+                      int n_mom, const int *mom, int n_gamma, const int *gamma, QudaFieldLocation location);
+
   /**
    * @brief Gauge fixing with overrelaxation with support for single and multi GPU.
    * @param[in,out] gauge, gauge field to be fixed
@@ -1689,6 +1842,24 @@ extern "C" {
                                 const double tolerance, const unsigned int stopWtheta, QudaGaugeParam *param,
                                 double *timeinfo);
 
+  /**
+   * @brief Gauge fixing with the Polak-Ribiere conjugate gradient method with FFTs and a line search, with
+   * support for single GPU only.
+   * @param[in,out] gauge, gauge field to be fixed
+   * @param[in] gauge_dir, 3 for Coulomb gauge fixing, other for Landau gauge fixing
+   * @param[in] Nsteps, maximum number of steps to perform gauge fixing
+   * @param[in] verbose_interval, print gauge fixing info when iteration count is a multiple of this
+   * @param[in] alpha, initial step of the line search, which is then adapted every iteration
+   * @param[in] tolerance, torelance value to stop the method, if this value is zero then the method stops when
+   * iteration reachs the maximum number of steps defined by Nsteps
+   * @param[in] stopWtheta, 0 for MILC criterion and 1 to use the theta value
+   * @param[in] param The parameters of the external fields and the computation settings
+   * @param[out] timeinfo
+   */
+  int computeGaugeFixingFFTCGQuda(void *gauge, const unsigned int gauge_dir, const unsigned int Nsteps,
+                                  const unsigned int verbose_interval, const double alpha, const double tolerance,
+                                  const unsigned int stopWtheta, QudaGaugeParam *param, double *timeinfo);
+
   /**
    * @brief Strided Batched GEMM
    * @param[in] arrayA The array containing the A matrix data
@@ -1714,6 +1885,16 @@ extern "C" {
    */
   void flushChronoQuda(int index);
 
+  /**
+   * @brief Block until all outstanding asynchronous vector saves and
+   * prefetches (e.g., of eigenvectors or multigrid null-space vectors)
+   * have completed.  A file saved asynchronously is only guaranteed to
+   * be complete once this has returned.
+   * @return The number of asynchronous saves that failed since the
+   * last flush (zero on success)
+   */
+  int flushVectorIOQuda(void);
+
 
   /**
   * Create deflation solver resources.
@@ -235,12 +235,51 @@ extern "C" {
    */
   void plaq_quda_(double plaq[3]);
 
+  /**
+   * @brief Gauge fixing with the steepest descent method with FFTs (see computeGaugeFixingFFTQuda)
+   * @param[in,out] gauge Gauge field to be fixed
+   * @param[in] gauge_dir 3 for Coulomb gauge fixing, other for Landau gauge fixing
+   * @param[in] n_steps Maximum number of steps to perform gauge fixing
+   * @param[in] verbose_interval Print gauge fixing info when iteration count is a multiple of this
+   * @param[in] alpha Gauge fixing parameter of the method
+   * @param[in] autotune 1 to decrease alpha if the functional inverts its tendency
+   * @param[in] tolerance Tolerance value to stop the method
+   * @param[in] stop_w_theta 0 for MILC criterion and 1 to use the theta value
+   * @param[in] param The parameters of the external fields and the computation settings
+   * @param[out] timeinfo The host to device, compute and device to host times
+   */
+  void compute_gauge_fixing_fft_quda_(void *gauge, int *gauge_dir, int *n_steps, int *verbose_interval, double *alpha,
+                                      int *autotune, double *tolerance, int *stop_w_theta, QudaGaugeParam *param,
+                                      double timeinfo[3]);
+
+  /**
+   * @brief Gauge fixing with the conjugate gradient method with FFTs (see computeGaugeFixingFFTCGQuda)
+   * @param[in,out] gauge Gauge field to be fixed
+   * @param[in] gauge_dir 3 for Coulomb gauge fixing, other for Landau gauge fixing
+   * @param[in] n_steps Maximum number of steps to perform gauge fixing
+   * @param[in] verbose_interval Print gauge fixing info when iteration count is a multiple of this
+   * @param[in] alpha Initial step of the line search
+   * @param[in] tolerance Tolerance value to stop the method
+   * @param[in] stop_w_theta 0 for MILC criterion and 1 to use the theta value
+   * @param[in] param The parameters of the external fields and the computation settings
+   * @param[out] timeinfo The host to device, compute and device to host times
+   */
+  void compute_gauge_fixing_fft_cg_quda_(void *gauge, int *gauge_dir, int *n_steps, int *verbose_interval,
+                                         double *alpha, double *tolerance, int *stop_w_theta, QudaGaugeParam *param,
+                                         double timeinfo[3]);
+
   /**
    * @brief Flush the chronological history for the given index
    * @param[in] index Index for which we are flushing
    */
   void flush_chrono_quda_(int *index);
 
+  /**
+   * @brief Block until all outstanding asynchronous vector I/O has completed
+   * @param[out] n_failed The number of asynchronous saves that failed since the last flush
+   */
+  void flush_vector_io_quda_(int *n_failed);
+
   /**
    * @brief Pinned a pre-existing memory allocation
    * @param[in] ptr Pointer to buffer to be pinned
@@ -115,6 +115,44 @@ namespace quda
     __device__ __host__ inline T operator()(T a, T b) const { return apply(a, b); }
   };
 
+  /**
+     bitwise-xor reducer, used for checksum reductions of 64-bit
+     words.  The reduction buffers transport floating-point words
+     (with -infinity reserved as the completion sentinel), so each
+     64-bit word is carried as its two 32-bit halves, each of which
+     is exactly representable as a double.  Use split() and join()
+     to convert between the word and its reduction representation.
+   */
+  template <typename T> struct bit_xor {
+    static_assert(std::is_same_v<T, array<double, 2>>, "bit_xor reducer requires array<double, 2>");
+    static constexpr bool do_sum = false;
+    using reduce_t = T;
+    using reducer_t = bit_xor<T>;
+
+    __device__ __host__ static inline T split(uint64_t a)
+    {
+      return {static_cast<double>(static_cast<uint32_t>(a)), static_cast<double>(static_cast<uint32_t>(a >> 32))};
+    }
+
+    __device__ __host__ static inline uint64_t join(const T &a)
+    {
+      return static_cast<uint64_t>(static_cast<uint32_t>(a[0])) | (static_cast<uint64_t>(static_cast<uint32_t>(a[1])) << 32);
+    }
+
+    template <typename U> static inline void comm_reduce(std::vector<U> &a)
+    {
+      for (auto &ai : a) {
+        auto word = join(ai);
+        comm_allreduce_xor(word);
+        ai = split(word);
+      }
+    }
+
+    __device__ __host__ static inline T init() { return zero<T>(); }
+    __device__ __host__ static inline T apply(T a, T b) { return split(join(a) ^ join(b)); }
+    __device__ __host__ inline T operator()(T a, T b) const { return apply(a, b); }
+  };
+
   /**
      square transformer, return the L2 norm squared of the input
    */
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <initializer_list>
+#include <vector>
 #include <enum_quda.h>
 #include <util_quda.h>
 
@@ -301,4 +302,19 @@ namespace quda
     return out;
   }
 
+  /**
+     @brief Create a vector_ref over a subset of a set of fields
+     @tparam T The (possibly const) field type of the subset
+     @param[in] v The set of fields
+     @param[in] idx The indices of the fields to include
+     @return The vector_ref to the subset
+   */
+  template <class T, class V> vector_ref<T> make_subset(V &v, const std::vector<int> &idx)
+  {
+    vector_ref<T> subset;
+    subset.reserve(idx.size());
+    for (auto i : idx) subset.push_back(v[i]);
+    return subset;
+  }
+
 } // namespace quda
@@ -7,14 +7,28 @@
 namespace quda
 {
 
+  class TimeProfile;
+
   /**
      @brief VectorIO is a simple wrapper class for loading and saving
-     sets of vector fields using QIO.
+     sets of vector fields using QIO.  Optionally, the file I/O can be
+     performed asynchronously on a dedicated host thread, in which
+     case saves return as soon as the vectors have been staged to the
+     host, and loads can be prefetched ahead of time.
    */
   class VectorIO
   {
     const std::string filename;
     bool parity_inflate;
+    bool async;
+
+    /**
+       @brief Read vectors from filename into host buffers
+       @param[in] buffer The host buffers we are reading into
+       @param[in] param Parameters describing the vectors we are
+       ultimately loading into (prior to any parity inflation)
+    */
+    void read(cvector_ref<ColorSpinorField> &buffer, const ColorSpinorParam &param) const;
 
   public:
     /**
@@ -22,19 +36,62 @@ namespace quda
        @param[in] filename The filename associated with this IO object
        @param[in] parity_inflate Whether to inflate single_parity
        field to dual parity fields for I/O
+       @param[in] async Whether to perform the file I/O
+       asynchronously (ignored if asyncEnabled() is false)
+    */
+    VectorIO(const std::string &filename, bool parity_inflate = false, bool async = false);
+
+    /**
+       @brief Whether asynchronous I/O is available.  This requires
+       that the communications layer be thread safe, and can be
+       disabled by setting the environment variable
+       QUDA_ENABLE_ASYNC_IO=0.
+    */
+    static bool asyncEnabled();
+
+    /**
+       @brief Block until all outstanding asynchronous saves and
+       prefetches have completed, and release their host staging
+       buffers.  On return the files of all successful saves are
+       complete.
+       @param[in] profile Time spent waiting is recorded under
+       QUDA_PROFILE_IO
+       @return The number of asynchronous saves that failed since
+       the last flush, each of which is reported with a warning
+    */
+    static int flush(TimeProfile &profile);
+
+    /**
+       @brief Start reading vectors from filename into host staging
+       buffers in the background.  A subsequent call to load with a
+       matching set of vectors completes the load.  This is a no-op
+       if this instance is not asynchronous.
+       @param[in] vecs The set of vectors that will be loaded
+       (used only for their meta data)
     */
-    VectorIO(const std::string &filename, bool parity_inflate = false);
+    void prefetch(cvector_ref<const ColorSpinorField> &vecs);
 
     /**
-       @brief Load vectors from filename
+       @brief Load vectors from filename.  If a matching prefetch has
+       been issued, this waits for it to complete and copies out the
+       prefetched vectors, else any outstanding asynchronous I/O is
+       completed before the vectors are read.
        @param[in] vecs The set of vectors to load
     */
     void load(cvector_ref<ColorSpinorField> &vecs);
 
     /**
-       @brief Save vectors to filename
+       @brief Save vectors to filename.  If asynchronous, the vectors
+       are staged into one of two host buffers and the file write
+       completes in the background; if both buffers are in use this
+       blocks until the oldest save completes.  The file is only
+       guaranteed to be complete, and any write error reported, once
+       flush has returned.
        @param[in] vecs The set of vectors to save
-       @param[in] prec Optional change of precision when saving
+       @param[in] prec Optional change of precision when saving.
+       Half and quarter precision store a block-scaled fixed-point
+       encoding with a per-site norm, which can be loaded directly
+       into fields of any precision.
        @param[in] size Optional cap to number of vectors saved
     */
     void save(cvector_ref<const ColorSpinorField> &vecs, QudaPrecision prec = QUDA_INVALID_PRECISION, uint32_t size = 0);
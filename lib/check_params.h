@@ -184,6 +184,10 @@ void printQudaEigParam(QudaEigParam *param) {
   P(n_kr, 0);
   P(n_conv, 0);
   P(n_ev_deflate, -1);
+  P(compress_n_basis, 0);
+  for (int i = 0; i < 4; i++) P(compress_block_size[i], 4);
+  P(compress_prec, QUDA_SINGLE_PRECISION);
+  P(deflation_prec, QUDA_INVALID_PRECISION);
   P(batched_rotate, 0);
   P(tol, 0.0);
   P(qr_tol, 0.0);
@@ -211,6 +215,9 @@ void printQudaEigParam(QudaEigParam *param) {
   P(n_kr, INVALID_INT);
   P(n_conv, INVALID_INT);
   P(n_ev_deflate, INVALID_INT);
+  P(compress_n_basis, INVALID_INT);
+  for (int i = 0; i < 4; i++) P(compress_block_size[i], INVALID_INT);
+  P(compress_prec, QUDA_INVALID_PRECISION);
   P(batched_rotate, INVALID_INT);
   P(tol, INVALID_DOUBLE);
   P(qr_tol, INVALID_DOUBLE);
@@ -226,7 +233,7 @@ void printQudaEigParam(QudaEigParam *param) {
 
   // only need to enfore block size checking if doing a block eigen solve
 #ifdef CHECK__PARAM
-  if (param->eig_type == QUDA_EIG_BLK_TR_LANCZOS)
+  if (param->eig_type == QUDA_EIG_BLK_TR_LANCZOS || param->eig_type == QUDA_EIG_CHFSI)
 #endif
     P(block_size, INVALID_INT);
 
@@ -414,6 +421,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(max_hq_res_increase, 1);     /**< Default is to allow one consecutive heavy-quark residual increase */
   P(max_hq_res_restart_total, 10); /**< Default is to allow ten heavy-quark restarts */
   P(heavy_quark_check, 10); /**< Default is to update heavy quark residual after 10 iterations */
+  P(multishift_refine_batch, 1); /**< Default is to refine the shifts sequentially */
  #else
   P(use_alternative_reliable, INVALID_INT);
   P(use_sloppy_partial_accumulator, INVALID_INT);
@@ -423,6 +431,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(max_hq_res_increase, INVALID_INT);
   P(max_hq_res_restart_total, INVALID_INT);
   P(heavy_quark_check, INVALID_INT);
+  P(multishift_refine_batch, INVALID_INT);
 #endif
 
 #ifndef CHECK_PARAM
@@ -440,6 +449,25 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(num_src_per_sub_partition, INVALID_INT);                     /**< Number of sources per sub-partitions */
 #endif
 
+#ifdef INIT_PARAM
+  P(dilution_type, QUDA_DILUTION_INVALID);
+  for (int d = 0; d < 4; d++) { P(dilution_block_size[d], 0); }
+  P(dilution_probe_size, 0);
+  P(dilution_batch_size, 1);
+#elif defined CHECK_PARAM
+  // QUDA_DILUTION_INVALID disables dilution, so only check the dilution parameters when it is enabled
+  if (param->dilution_type != QUDA_DILUTION_INVALID) {
+    for (int d = 0; d < 4; d++) { P(dilution_block_size[d], INVALID_INT); }
+    P(dilution_probe_size, INVALID_INT);
+    P(dilution_batch_size, INVALID_INT);
+  }
+#else
+  P(dilution_type, INVALID_INT);
+  for (int d = 0; d < 4; d++) { P(dilution_block_size[d], INVALID_INT); }
+  P(dilution_probe_size, INVALID_INT);
+  P(dilution_batch_size, INVALID_INT);
+#endif
+
 #ifdef INIT_PARAM
   P(compute_action, 0);
   P(compute_true_res, 1);
@@ -532,7 +560,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(gcrNkrylov, INVALID_INT);
 #else
   if (param->inv_type == QUDA_GCR_INVERTER || param->inv_type == QUDA_BICGSTABL_INVERTER
-      || quda::is_ca_solver(param->inv_type)) {
+      || param->inv_type == QUDA_GCRODR_INVERTER || quda::is_ca_solver(param->inv_type)) {
     P(gcrNkrylov, INVALID_INT);
   }
 #endif
@@ -607,10 +635,12 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(ca_basis, QUDA_POWER_BASIS);
   P(ca_lambda_min, 0.0);
   P(ca_lambda_max, -1.0);
+  P(ca_adaptive, QUDA_BOOLEAN_FALSE);
 #else
   if (quda::is_ca_solver(param->inv_type)) {
     P(ca_basis, QUDA_INVALID_BASIS);
-    if (param->ca_basis == QUDA_CHEBYSHEV_BASIS) {
+    P(ca_adaptive, QUDA_BOOLEAN_INVALID);
+    if (param->ca_basis == QUDA_CHEBYSHEV_BASIS && param->ca_adaptive == QUDA_BOOLEAN_FALSE) {
       P(ca_lambda_min, INVALID_DOUBLE);
       P(ca_lambda_max, INVALID_DOUBLE);
     }
@@ -656,6 +686,8 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(tol_restart,5e-5);
   P(inc_tol, 1e-2);
   P(eigenval_tol, 1e-1);
+  P(recycle_space, 0);
+  P(preserve_recycle, QUDA_BOOLEAN_FALSE);
 #else
   P(cuda_prec_ritz, QUDA_INVALID_PRECISION);
   P(n_ev, INVALID_INT);
@@ -667,6 +699,7 @@ void printQudaInvertParam(QudaInvertParam *param) {
   P(tol_restart,INVALID_DOUBLE);
   P(inc_tol, INVALID_DOUBLE);
   P(eigenval_tol, INVALID_DOUBLE);
+  P(preserve_recycle, QUDA_BOOLEAN_INVALID);
 #endif
 
 #if defined INIT_PARAM
@@ -1087,12 +1120,23 @@ void printQudaGaugeSmearParam(QudaGaugeSmearParam *param)
   P(alpha, 0.0);
   P(rho, 0.0);
   P(epsilon, 0.0);
+  P(adaptive, QUDA_BOOLEAN_FALSE);
+  P(tolerance, 1e-5);
+  P(flow_record_file[0], '\0');
+  P(t0_ref, 0.0);
+  P(w0_ref, 0.0);
+  P(stop_at_scale, QUDA_BOOLEAN_FALSE);
 #else
   P(n_steps, (unsigned int)INVALID_INT);
   P(meas_interval, (unsigned int)INVALID_INT);
   P(alpha, INVALID_DOUBLE);
   P(rho, INVALID_DOUBLE);
   P(epsilon, INVALID_DOUBLE);
+  P(adaptive, QUDA_BOOLEAN_INVALID);
+  if (param->adaptive == QUDA_BOOLEAN_TRUE) P(tolerance, INVALID_DOUBLE);
+  P(t0_ref, INVALID_DOUBLE);
+  P(w0_ref, INVALID_DOUBLE);
+  P(stop_at_scale, QUDA_BOOLEAN_INVALID);
 #endif
 
 #ifdef INIT_PARAM
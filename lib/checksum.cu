@@ -1,4 +1,8 @@
 #include <gauge_field_order.h>
+#include <tunable_reduction.h>
+#include <instantiate.h>
+#include <content_hash.h>
+#include <kernels/gauge_checksum.cuh>
 
 namespace quda {
 
@@ -18,17 +22,58 @@ namespace quda {
     return u.checksum(); 
   }
 
+  /**
+     Host checksum: the sites are split into chunks that are
+     checksummed concurrently across host threads
+   */
   template <typename Arg>
   uint64_t ChecksumCPU(const Arg &arg)
   {
-    uint64_t checksum_ = 0;
-    for (int parity=0; parity<2; parity++)
-      for (int x_cb=0; x_cb<arg.volumeCB; x_cb++)
-	for (int d=0; d<arg.U.geometry; d++)
-	  checksum_ ^= siteChecksum(arg, d, parity, x_cb);
-    return checksum_;
+    return parallel_xor(2 * arg.volumeCB, [&](size_t begin, size_t end) {
+      uint64_t checksum_ = 0;
+      for (size_t i = begin; i < end; i++) {
+        int parity = i / arg.volumeCB;
+        int x_cb = i % arg.volumeCB;
+        for (int d = 0; d < arg.U.geometry; d++) checksum_ ^= siteChecksum(arg, d, parity, x_cb);
+      }
+      return checksum_;
+    });
   }
 
+  /**
+     Device checksum for native-order fields: each thread computes
+     the checksum of a site, and these are xor-reduced on the device
+     so only a single word is returned.  Since XOR is associative and
+     commutative the result is identical to that computed for the
+     host orders.
+   */
+  template <typename Float, int nColor, QudaReconstructType recon>
+  class ChecksumNative : TunableReduction2D {
+    const GaugeField &u;
+    const bool mini;
+    uint64_t &checksum;
+
+  public:
+    ChecksumNative(const GaugeField &u, bool mini, uint64_t &checksum) :
+      TunableReduction2D(u), u(u), mini(mini), checksum(checksum)
+    {
+      if (mini) strcat(aux, ",mini");
+      apply(device::get_default_stream());
+    }
+
+    void apply(const qudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      GaugeChecksumArg<Float, nColor, recon> arg(u, mini);
+      array<double, 2> result;
+      launch<GaugeChecksum>(result, tp, stream, arg);
+      checksum = bit_xor<array<double, 2>>::join(result);
+    }
+
+    long long flops() const { return 0; }
+    long long bytes() const { return mini ? 2 * u.Geometry() * u.Reconstruct() * u.Precision() : u.Bytes(); }
+  };
+
   template <typename T, int Nc>
   uint64_t Checksum(const GaugeField &u, bool mini)
   {
@@ -72,15 +117,52 @@ namespace quda {
   uint64_t Checksum(const GaugeField &u, bool mini)
   {
     uint64_t checksum = 0;
-    switch (u.Precision()) {
-    case QUDA_DOUBLE_PRECISION: checksum = Checksum<double>(u,mini); break;
-    case QUDA_SINGLE_PRECISION: checksum = Checksum<float>(u,mini); break;
-    default: errorQuda("Unsupported precision = %d", u.Precision());
+    if (u.isNative() && u.Location() == QUDA_CUDA_FIELD_LOCATION) {
+      // the reduction kernel performs the inter-process xor
+      commGlobalReductionPush(true);
+      instantiate<ChecksumNative, ReconstructFull>(u, mini, checksum);
+      commGlobalReductionPop();
+    } else {
+      switch (u.Precision()) {
+      case QUDA_DOUBLE_PRECISION: checksum = Checksum<double>(u,mini); break;
+      case QUDA_SINGLE_PRECISION: checksum = Checksum<float>(u,mini); break;
+      default: errorQuda("Unsupported precision = %d", u.Precision());
+      }
+      comm_allreduce_xor(checksum);
     }
 
-    comm_allreduce_xor(checksum);
-
     return checksum;
   }
 
+  std::string Digest(const GaugeField &u)
+  {
+    // canonical representation: uncompressed double-precision
+    // native order without padding or ghost zones
+    GaugeFieldParam param(u);
+    param.location = QUDA_CUDA_FIELD_LOCATION;
+    param.create = QUDA_NULL_FIELD_CREATE;
+    param.setPrecision(QUDA_DOUBLE_PRECISION, true);
+    param.reconstruct = u.Reconstruct() == QUDA_RECONSTRUCT_10 ? QUDA_RECONSTRUCT_10 : QUDA_RECONSTRUCT_NO;
+    param.pad = 0;
+    param.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    cudaGaugeField canonical(param);
+    canonical.copy(u);
+
+    std::vector<char> buffer(canonical.Bytes());
+    qudaMemcpy(buffer.data(), canonical.Gauge_p(), buffer.size(), qudaMemcpyDeviceToHost);
+
+    SHA256 local;
+    local.update(buffer.data(), buffer.size());
+    auto local_digest = local.digest();
+
+    // gather the rank-local digests in rank order and digest these
+    std::vector<unsigned char> digests(local_digest.size() * comm_size());
+    comm_allgather(digests.data(), local_digest.data(), local_digest.size());
+
+    SHA256 global;
+    global.update(digests.data(), digests.size());
+
+    return SHA256::hex(global.digest());
+  }
+
 }
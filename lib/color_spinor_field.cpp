@@ -202,8 +202,10 @@ namespace quda
       param.composite_dim = 0;
       param.is_component = composite_descr.is_component;
       param.component_id = composite_descr.id;
+      param.suggested_parity = QUDA_EVEN_PARITY;
       even = new ColorSpinorField(param);
       param.v = static_cast<char *>(v) + bytes / 2;
+      param.suggested_parity = QUDA_ODD_PARITY;
       odd = new ColorSpinorField(param);
     }
 
@@ -102,6 +102,11 @@ namespace quda
     MPI_CHECK(MPI_Allgather(&gpuid, 1, MPI_INT, gpuid_recv_buf, 1, MPI_INT, MPI_COMM_HANDLE));
   }
 
+  void Communicator::comm_allgather(void *recv_buf, const void *send_buf, size_t bytes)
+  {
+    MPI_CHECK(MPI_Allgather(send_buf, bytes, MPI_BYTE, recv_buf, bytes, MPI_BYTE, MPI_COMM_HANDLE));
+  }
+
   void Communicator::comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data)
   {
     int initialized;
@@ -291,6 +296,21 @@ namespace quda
     }
   }
 
+  void Communicator::comm_allreduce_sum_array_start(double *data, size_t size)
+  {
+    if (allreduce_request != MPI_REQUEST_NULL) errorQuda("Non-blocking all-reduce already in flight");
+    if (!comm_deterministic_reduce()) {
+      MPI_CHECK(MPI_Iallreduce(MPI_IN_PLACE, data, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_HANDLE, &allreduce_request));
+    } else {
+      comm_allreduce_sum_array(data, size);
+    }
+  }
+
+  void Communicator::comm_allreduce_sum_array_wait()
+  {
+    if (allreduce_request != MPI_REQUEST_NULL) MPI_CHECK(MPI_Wait(&allreduce_request, MPI_STATUS_IGNORE));
+  }
+
   void Communicator::comm_allreduce_max_array(deviation_t<double> *data, size_t size)
   {
     size_t n = comm_size();
@@ -154,6 +154,22 @@ void Communicator::comm_gather_gpuid(int *gpuid_recv_buf)
 #endif
 }
 
+void Communicator::comm_allgather(void *recv_buf, const void *send_buf, size_t bytes)
+{
+#ifdef USE_MPI_GATHER
+  MPI_CHECK(MPI_Allgather(send_buf, bytes, MPI_BYTE, recv_buf, bytes, MPI_BYTE, MPI_COMM_HANDLE));
+#else
+  // Emulate all-gather with an xor reduction: each process writes
+  // its contribution into its own slot of a zeroed buffer, so the
+  // xor over all processes is the gathered result
+  const size_t n_word = (comm_size() * bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  std::vector<uint64_t> buffer(n_word, 0);
+  memcpy(reinterpret_cast<char *>(buffer.data()) + comm_rank() * bytes, send_buf, bytes);
+  for (auto &word : buffer) comm_allreduce_xor(word);
+  memcpy(recv_buf, buffer.data(), comm_size() * bytes);
+#endif
+}
+
 void Communicator::comm_init(int ndim, const int *dims, QudaCommsMap rank_from_coords, void *map_data)
 {
   if (QMP_is_initialized() != QMP_TRUE) { errorQuda("QMP has not been initialized"); }
@@ -318,6 +334,22 @@ void Communicator::comm_allreduce_sum_array(double *data, size_t size)
   }
 }
 
+void Communicator::comm_allreduce_sum_array_start(double *data, size_t size)
+{
+  if (allreduce_request != MPI_REQUEST_NULL) errorQuda("Non-blocking all-reduce already in flight");
+  if (!comm_deterministic_reduce()) {
+    // QMP has no non-blocking reductions so we break out to MPI
+    MPI_CHECK(MPI_Iallreduce(MPI_IN_PLACE, data, size, MPI_DOUBLE, MPI_SUM, MPI_COMM_HANDLE, &allreduce_request));
+  } else {
+    comm_allreduce_sum_array(data, size);
+  }
+}
+
+void Communicator::comm_allreduce_sum_array_wait()
+{
+  if (allreduce_request != MPI_REQUEST_NULL) MPI_CHECK(MPI_Wait(&allreduce_request, MPI_STATUS_IGNORE));
+}
+
 void Communicator::comm_allreduce_max_array(deviation_t<double> *data, size_t size)
 {
   size_t n = comm_size();
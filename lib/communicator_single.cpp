@@ -55,6 +55,11 @@ namespace quda
 
   void Communicator::comm_gather_gpuid(int *gpuid_recv_buf) { gpuid_recv_buf[0] = comm_gpuid(); }
 
+  void Communicator::comm_allgather(void *recv_buf, const void *send_buf, size_t bytes)
+  {
+    memcpy(recv_buf, send_buf, bytes);
+  }
+
   MsgHandle *Communicator::comm_declare_send_rank(void *, int, int, size_t) { return nullptr; }
 
   MsgHandle *Communicator::comm_declare_recv_rank(void *, int, int, size_t) { return nullptr; }
@@ -83,6 +88,10 @@ namespace quda
 
   void Communicator::comm_allreduce_sum_array(double *, size_t) { }
 
+  void Communicator::comm_allreduce_sum_array_start(double *, size_t) { }
+
+  void Communicator::comm_allreduce_sum_array_wait() { }
+
   void Communicator::comm_allreduce_max_array(deviation_t<double> *, size_t) { }
 
   void Communicator::comm_allreduce_max_array(double *, size_t) { }
@@ -111,6 +111,11 @@ namespace quda
 
   void comm_gather_gpuid(int *gpuid_recv_buf) { get_current_communicator().comm_gather_gpuid(gpuid_recv_buf); }
 
+  void comm_allgather(void *recv_buf, const void *send_buf, size_t bytes)
+  {
+    get_current_communicator().comm_allgather(recv_buf, send_buf, bytes);
+  }
+
   void comm_peer2peer_init(const char *hostname_recv_buf)
   {
     get_current_communicator().comm_peer2peer_init(hostname_recv_buf);
@@ -184,6 +189,13 @@ namespace quda
     get_current_communicator().comm_allreduce_sum_array(data, size);
   }
 
+  void comm_allreduce_sum_array_start(double *data, size_t size)
+  {
+    get_current_communicator().comm_allreduce_sum_array_start(data, size);
+  }
+
+  void comm_allreduce_sum_array_wait() { get_current_communicator().comm_allreduce_sum_array_wait(); }
+
   template <> void comm_allreduce_sum<std::vector<double>>(std::vector<double> &a)
   {
     comm_allreduce_sum_array(a.data(), a.size());
@@ -214,6 +226,11 @@ namespace quda
     comm_allreduce_sum_array(reinterpret_cast<double *>(a.data()), 4 * a.size());
   }
 
+  template <> void comm_allreduce_sum<std::vector<array<double, 5>>>(std::vector<array<double, 5>> &a)
+  {
+    comm_allreduce_sum_array(reinterpret_cast<double *>(a.data()), 5 * a.size());
+  }
+
   template <> void comm_allreduce_sum<double>(double &a) { comm_allreduce_sum_array(&a, 1); }
 
   void comm_allreduce_max_array(double *data, size_t size)
@@ -0,0 +1,199 @@
+#include <vector>
+#include <algorithm>
+
+#include <quda_internal.h>
+#include <eigensolve_quda.h>
+#include <transfer.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <util_quda.h>
+
+/**
+   @file compressed_deflation.cpp
+
+   Locally coherent compression of a deflation space.  The low modes
+   of the Dirac operator are locally coherent: on a small enough
+   aggregate, a few of them span the remainder to good accuracy.  We
+   use the multigrid transfer operator to block orthogonalize the
+   leading modes over the aggregates, and store every mode by its
+   coarse coefficients.  Based on the description here:
+   https://arxiv.org/abs/1710.06884
+*/
+
+namespace quda
+{
+
+  CompressedDeflationSpace::CompressedDeflationSpace(const std::vector<ColorSpinorField> &evecs, int n_basis,
+                                                     const int *block_size, QudaPrecision prec, QudaParity parity) :
+    profile("CompressedDeflationSpace", false)
+  {
+    if (evecs.size() == 0) errorQuda("Cannot compress an empty deflation space");
+    if (n_basis <= 0 || n_basis > (int)evecs.size())
+      errorQuda("Invalid basis size %d for a deflation space of %lu vectors", n_basis, evecs.size());
+    if (evecs[0].Nspin() != 4 && evecs[0].Nspin() != 2)
+      errorQuda("Compressed deflation is not supported for nSpin = %d fields", evecs[0].Nspin());
+    if (evecs[0].Ndim() != 4) errorQuda("Compressed deflation is not supported for %d-d fields", evecs[0].Ndim());
+    if (prec != QUDA_SINGLE_PRECISION && prec != QUDA_HALF_PRECISION)
+      errorQuda("Unsupported compressed deflation precision %d", prec);
+
+    const bool single_parity = evecs[0].SiteSubset() == QUDA_PARITY_SITE_SUBSET;
+    const int spin_bs = evecs[0].Nspin() / 2; // coarse spin is chirality
+
+    int geo_bs[4];
+    int block_volume = 1;
+    for (int d = 0; d < 4; d++) {
+      geo_bs[d] = block_size[d];
+      block_volume *= geo_bs[d];
+    }
+    // for single-parity vectors each aggregate holds half the sites
+    int aggregate_size = (single_parity ? block_volume / 2 : block_volume) * evecs[0].Ncolor() * spin_bs;
+    if (n_basis > aggregate_size)
+      errorQuda("Basis size %d larger than the single-chirality aggregate size %d", n_basis, aggregate_size);
+
+    // The restrictor and prolongator require single precision
+    ColorSpinorParam param(evecs[0]);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    param.setPrecision(QUDA_SINGLE_PRECISION, QUDA_INVALID_PRECISION, true);
+    fine = ColorSpinorField(param);
+
+    // The transfer operator is defined on full fields, so single-parity
+    // vectors are embedded with zero on the other parity.  Block
+    // orthogonalization then never mixes the parities, and restricted
+    // to the vector parity V remains orthonormal.
+    param.create = QUDA_ZERO_FIELD_CREATE;
+    if (single_parity) {
+      if (parity != QUDA_EVEN_PARITY && parity != QUDA_ODD_PARITY) errorQuda("Undefined parity %d", parity);
+      param.siteSubset = QUDA_FULL_SITE_SUBSET;
+      param.x[0] *= 2;
+    }
+
+    B.resize(n_basis);
+    B_ptr.resize(n_basis);
+    for (int i = 0; i < n_basis; i++) {
+      B[i] = ColorSpinorField(param);
+      if (single_parity)
+        (parity == QUDA_EVEN_PARITY ? B[i].Even() : B[i].Odd()) = evecs[i];
+      else
+        B[i] = evecs[i];
+      B_ptr[i] = &B[i];
+    }
+
+    transfer = std::make_unique<Transfer>(B_ptr, n_basis, 1, true, geo_bs, spin_bs, QUDA_SINGLE_PRECISION,
+                                          QUDA_TRANSFER_AGGREGATE, profile);
+    if (single_parity) transfer->setSiteSubset(QUDA_PARITY_SITE_SUBSET, parity);
+
+    std::unique_ptr<ColorSpinorField> coarse_meta(B[0].CreateCoarse(transfer->Geo_bs(), spin_bs, n_basis));
+    ColorSpinorParam coarse_param(*coarse_meta);
+    coarse_param.create = QUDA_NULL_FIELD_CREATE;
+    coarse = ColorSpinorField(coarse_param);
+
+    // Once V has been formed the transfer operator only references
+    // the first basis vector for its meta data, so release the rest
+    B.resize(1);
+    B_ptr.resize(1);
+
+    // Restrict every eigenvector onto the block basis
+    coarse_param.setPrecision(prec, QUDA_INVALID_PRECISION, true);
+    coeff.resize(evecs.size());
+    for (auto i = 0u; i < evecs.size(); i++) {
+      fine = evecs[i];
+      transfer->R(coarse, fine);
+      coeff[i] = ColorSpinorField(coarse_param);
+      coeff[i] = coarse;
+    }
+
+    if (getVerbosity() >= QUDA_VERBOSE) {
+      // Measure the fidelity of the compression, max_i ||v_i - P R v_i|| / ||v_i||
+      ColorSpinorField v(fine);
+      double max_err = 0.0;
+      for (auto i = 0u; i < evecs.size(); i++) {
+        v = evecs[i];
+        expand(fine, i);
+        max_err = std::max(max_err, sqrt(blas::xmyNorm(v, fine) / blas::norm2(v)));
+      }
+      printfQuda("Compressed deflation space maximum relative reconstruction error %e\n", max_err);
+    }
+
+    size_t uncompressed = 0;
+    for (auto &v : evecs) uncompressed += v.Bytes();
+    logQuda(QUDA_SUMMARIZE, "Compressed %lu vectors with a %d vector basis from %.3f GiB to %.3f GiB\n", evecs.size(),
+            n_basis, uncompressed / static_cast<double>(1 << 30), Bytes() / static_cast<double>(1 << 30));
+  }
+
+  CompressedDeflationSpace::~CompressedDeflationSpace() = default;
+
+  size_t CompressedDeflationSpace::Bytes() const
+  {
+    size_t bytes = transfer->Vectors().Bytes() + B[0].Bytes() + fine.Bytes() + coarse.Bytes();
+    for (auto &c : coeff) bytes += c.Bytes();
+    return bytes;
+  }
+
+  void CompressedDeflationSpace::expand(ColorSpinorField &v, int i) const
+  {
+    if (i < 0 || i >= size()) errorQuda("Invalid index %d for compressed deflation space of size %d", i, size());
+    coarse = coeff[i];
+    transfer->P(fine, coarse);
+    v = fine;
+  }
+
+  void CompressedDeflationSpace::deflate(cvector_ref<ColorSpinorField> &sol, cvector_ref<const ColorSpinorField> &src,
+                                         const std::vector<Complex> &evals, int n_defl, bool accumulate) const
+  {
+    if (n_defl > size()) errorQuda("Requested %d vectors from a compressed deflation space of size %d", n_defl, size());
+
+    // Since V^dag V = 1 on each aggregate, (P c_i)^dag x = c_i^dag R x,
+    // so the projection is computed entirely on the coarse grid
+
+    // 1. Restrict the sources: R x_j
+    ColorSpinorParam param(coeff[0]);
+    param.create = QUDA_NULL_FIELD_CREATE;
+    std::vector<ColorSpinorField> src_coarse(src.size());
+    for (auto j = 0u; j < src.size(); j++) {
+      fine = src[j];
+      transfer->R(coarse, fine);
+      src_coarse[j] = ColorSpinorField(param);
+      src_coarse[j] = coarse;
+    }
+
+    // 2. Take block inner product: c_i^dag R x_j = A_ij
+    std::vector<Complex> s(n_defl * src.size());
+    blas::cDotProduct(s, {coeff.begin(), coeff.begin() + n_defl}, src_coarse);
+
+    // 3. Accumulate the coarse solution sum_i c_i (L_i)^{-1} A_ij in single precision
+    for (int i = 0; i < n_defl; i++)
+      for (auto j = 0u; j < src.size(); j++) s[i * src.size() + j] /= evals[i].real();
+
+    param = ColorSpinorParam(coarse);
+    param.create = QUDA_ZERO_FIELD_CREATE;
+    std::vector<ColorSpinorField> sol_coarse(src.size());
+    for (auto &x : sol_coarse) x = ColorSpinorField(param);
+    blas::caxpy(s, {coeff.begin(), coeff.begin() + n_defl}, sol_coarse);
+
+    // 4. Prolongate onto the fine grid
+    for (auto j = 0u; j < sol.size(); j++) {
+      transfer->P(fine, sol_coarse[j]);
+      if (accumulate) {
+        ColorSpinorParam tmp_param(sol[j]);
+        tmp_param.create = QUDA_NULL_FIELD_CREATE;
+        ColorSpinorField tmp(tmp_param);
+        tmp = fine;
+        blas::xpy(tmp, sol[j]);
+      } else {
+        sol[j] = fine;
+      }
+    }
+  }
+
+  void EigenSolver::compressDeflationSpace(std::vector<ColorSpinorField> &evecs)
+  {
+    if (compute_svd) errorQuda("Compressed deflation is not supported for SVD deflation spaces");
+
+    const QudaParity parity = impliedParityFromMatPC(mat.getMatPCType());
+    compressed_space = std::make_unique<CompressedDeflationSpace>(evecs, eig_param->compress_n_basis,
+                                                                  eig_param->compress_block_size,
+                                                                  eig_param->compress_prec, parity);
+    evecs.clear();
+  }
+
+} // namespace quda
@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <content_hash.h>
+
+namespace quda
+{
+
+  namespace
+  {
+
+    constexpr uint64_t prime1 = 0x9e3779b185ebca87ull;
+    constexpr uint64_t prime2 = 0xc2b2ae3d27d4eb4full;
+    constexpr uint64_t prime3 = 0x165667b19e3779f9ull;
+    constexpr size_t block_bytes = 1 << 20;
+
+    inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    inline uint64_t mix_round(uint64_t acc, uint64_t word) { return rotl(acc + word * prime2, 31) * prime1; }
+
+    inline uint64_t avalanche(uint64_t h)
+    {
+      h ^= h >> 33;
+      h *= prime2;
+      h ^= h >> 29;
+      h *= prime3;
+      h ^= h >> 32;
+      return h;
+    }
+
+    /**
+       @brief Hash a single block using four independent lanes to
+       expose instruction-level parallelism
+    */
+    uint64_t block_hash(const char *data, size_t bytes, uint64_t seed)
+    {
+      uint64_t lane[4] = {seed + prime1 + prime2, seed + prime2, seed, seed - prime1};
+      size_t i = 0;
+      for (; i + 32 <= bytes; i += 32) {
+        uint64_t word[4];
+        memcpy(word, data + i, sizeof(word));
+        for (int l = 0; l < 4; l++) lane[l] = mix_round(lane[l], word[l]);
+      }
+
+      uint64_t h = rotl(lane[0], 1) + rotl(lane[1], 7) + rotl(lane[2], 12) + rotl(lane[3], 18) + bytes;
+      for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        h = rotl(h ^ mix_round(0, word), 27) * prime1 + prime3;
+      }
+      for (; i < bytes; i++) h = rotl(h ^ (static_cast<unsigned char>(data[i]) * prime3), 11) * prime1;
+
+      return avalanche(h);
+    }
+
+  } // namespace
+
+  uint64_t content_hash(const void *data, size_t bytes, uint64_t seed)
+  {
+    const char *ptr = static_cast<const char *>(data);
+    const long n_block = (bytes + block_bytes - 1) / block_bytes;
+    std::vector<uint64_t> hash(n_block);
+
+#pragma omp parallel for schedule(static)
+    for (long b = 0; b < n_block; b++) {
+      size_t offset = b * block_bytes;
+      size_t size = offset + block_bytes <= bytes ? block_bytes : bytes - offset;
+      hash[b] = block_hash(ptr + offset, size, seed + b);
+    }
+
+    uint64_t h = avalanche(seed ^ bytes);
+    for (auto &hb : hash) h = avalanche(h ^ hb) * prime1;
+    return h;
+  }
+
+  uint64_t parallel_xor(size_t n, const std::function<uint64_t(size_t, size_t)> &f)
+  {
+    constexpr size_t chunk = 4096;
+    const long n_chunk = (n + chunk - 1) / chunk;
+    uint64_t result = 0;
+
+#pragma omp parallel for schedule(static) reduction(^ : result)
+    for (long c = 0; c < n_chunk; c++) {
+      size_t begin = c * chunk;
+      result ^= f(begin, begin + chunk <= n ? begin + chunk : n);
+    }
+
+    return result;
+  }
+
+  namespace
+  {
+
+    constexpr uint32_t sha256_k[64]
+      = {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+         0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+         0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+         0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+         0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+         0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+         0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+         0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+    inline uint32_t rotr(uint32_t x, int r) { return (x >> r) | (x << (32 - r)); }
+
+  } // namespace
+
+  SHA256::SHA256() :
+    state {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19}
+  {
+  }
+
+  void SHA256::compress(const unsigned char *chunk)
+  {
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++)
+      w[i] = (uint32_t(chunk[4 * i]) << 24) | (uint32_t(chunk[4 * i + 1]) << 16) | (uint32_t(chunk[4 * i + 2]) << 8)
+        | uint32_t(chunk[4 * i + 3]);
+    for (int i = 16; i < 64; i++) {
+      uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+      uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+      uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+  }
+
+  void SHA256::update(const void *data, size_t bytes)
+  {
+    const unsigned char *ptr = static_cast<const unsigned char *>(data);
+    length += bytes;
+
+    if (fill > 0) {
+      size_t n = std::min(bytes, sizeof(block) - fill);
+      memcpy(block + fill, ptr, n);
+      fill += n;
+      ptr += n;
+      bytes -= n;
+      if (fill < sizeof(block)) return;
+      compress(block);
+      fill = 0;
+    }
+
+    for (; bytes >= sizeof(block); ptr += sizeof(block), bytes -= sizeof(block)) compress(ptr);
+
+    memcpy(block, ptr, bytes);
+    fill = bytes;
+  }
+
+  std::array<unsigned char, 32> SHA256::digest()
+  {
+    const uint64_t bits = length * 8;
+    const unsigned char pad = 0x80;
+    update(&pad, 1);
+    const unsigned char zero[64] = {};
+    update(zero, (fill <= 56 ? 56 - fill : 120 - fill));
+
+    unsigned char len[8];
+    for (int i = 0; i < 8; i++) len[i] = static_cast<unsigned char>(bits >> (56 - 8 * i));
+    update(len, 8);
+
+    std::array<unsigned char, 32> out;
+    for (int i = 0; i < 8; i++)
+      for (int j = 0; j < 4; j++) out[4 * i + j] = static_cast<unsigned char>(state[i] >> (24 - 8 * j));
+    return out;
+  }
+
+  std::string SHA256::hex(const std::array<unsigned char, 32> &digest)
+  {
+    char str[2 * 32 + 1];
+    for (int i = 0; i < 32; i++) snprintf(str + 2 * i, 3, "%02x", digest[i]);
+    return std::string(str);
+  }
+
+} // namespace quda
@@ -1,6 +1,8 @@
 #include <color_spinor_field.h>
 #include <contract_quda.h>
 #include <tunable_nd.h>
+#include <tunable_block_reduction.h>
+#include <power_of_two_array.h>
 #include <instantiate.h>
 #include <kernels/contraction.cuh>
 
@@ -55,6 +57,84 @@ public:
     }
   };
 
+  // dummy block-size list for the summed contraction: the block
+  // reduction does not template on the block size, so the x block
+  // size is freely tuned
+  struct ContractionSummedBlock {
+    using array_type = PowerOfTwoArray<1, 1>;
+    static constexpr array_type block = array_type();
+  };
+
+  template <typename Float, int nColor> class ContractionSummedCompute : TunableBlock2D
+  {
+    using reduce_t = array<double, 32>;
+    cvector_ref<const ColorSpinorField> &x;
+    cvector_ref<const ColorSpinorField> &y;
+    reduce_t *result;
+    const QudaContractType cType;
+    const int *mom;
+    const int n_mom;
+    const int *source_position;
+    bool tuneSharedBytes() const { return false; }
+    unsigned int minThreads() const { return x[0].Volume() / x[0].X()[3]; } // both parities of a time slice
+
+  public:
+    ContractionSummedCompute(const ColorSpinorField &meta, cvector_ref<const ColorSpinorField> &x,
+                             cvector_ref<const ColorSpinorField> &y, reduce_t *result, const QudaContractType cType,
+                             const int *mom, int n_mom, const int *source_position) :
+      TunableBlock2D(meta, true, meta.X()[3], 1),
+      x(x),
+      y(y),
+      result(result),
+      cType(cType),
+      mom(mom),
+      n_mom(n_mom),
+      source_position(source_position)
+    {
+      switch (cType) {
+      case QUDA_CONTRACT_TYPE_OPEN: strcat(aux, "open,"); break;
+      case QUDA_CONTRACT_TYPE_DR: strcat(aux, "degrand-rossi,"); break;
+      default: errorQuda("Unexpected contraction type %d", cType);
+      }
+      strcat(aux, "n_pair=");
+      u32toa(aux + strlen(aux), x.size());
+      strcat(aux, ",n_mom=");
+      u32toa(aux + strlen(aux), n_mom);
+      apply(device::get_default_stream());
+    }
+
+    void apply(const qudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      // the time-slice results are accumulated atomically across the thread blocks
+      qudaMemsetAsync(result, 0, x[0].X()[3] * n_mom * sizeof(reduce_t), stream);
+      switch (cType) {
+      case QUDA_CONTRACT_TYPE_OPEN: {
+        ContractionSummedArg<Float, nColor, QUDA_CONTRACT_TYPE_OPEN> arg(x, y, mom, n_mom, source_position, result);
+        launch<ContractionSummed, ContractionSummedBlock>(tp, stream, arg);
+      } break;
+      case QUDA_CONTRACT_TYPE_DR: {
+        ContractionSummedArg<Float, nColor, QUDA_CONTRACT_TYPE_DR> arg(x, y, mom, n_mom, source_position, result);
+        launch<ContractionSummed, ContractionSummedBlock>(tp, stream, arg);
+      } break;
+      default: errorQuda("Unexpected contraction type %d", cType);
+      }
+    }
+
+    long long flops() const
+    {
+      // contraction and sum per pair, then phase and complex multiply of each component per momentum
+      long long contract = cType == QUDA_CONTRACT_TYPE_OPEN ? 16 * 3 * 6ll : (16 * 3 * 6ll) + (16 * (4 + 12));
+      return ((contract + 16 * 2) * x.size() + (16 * 6 + 10) * n_mom) * x[0].Volume();
+    }
+
+    // each spinor is read once, independent of the number of momenta
+    long long bytes() const
+    {
+      return x.size() * (x[0].Bytes() + y[0].Bytes()) + x[0].X()[3] * n_mom * sizeof(reduce_t);
+    }
+  };
+
 #ifdef GPU_CONTRACT
   void contractQuda(const ColorSpinorField &x, const ColorSpinorField &y, void *result, const QudaContractType cType)
   {
@@ -65,11 +145,74 @@ public:
 
     instantiate<Contraction>(x, y, result, cType);
   }
+
+  void contractSummedQuda(cvector_ref<const ColorSpinorField> &x, cvector_ref<const ColorSpinorField> &y,
+                          std::vector<Complex> &result, const QudaContractType cType, const std::vector<int> &mom,
+                          const int source_position[4])
+  {
+    if (x.size() != y.size()) errorQuda("Mismatched set sizes x=%lu y=%lu", x.size(), y.size());
+    if (mom.size() % 3 != 0) errorQuda("Momenta must have three spatial components (size = %lu)", mom.size());
+
+    const int n_mom = mom.size() / 3;
+    if (x.size() == 0 || n_mom == 0) return;
+    const int lt = x[0].X()[3];
+    const int nt = lt * comm_dim(3);
+    const int t_offset = lt * comm_coord(3);
+    if (result.size() != static_cast<size_t>(nt * n_mom * 16))
+      errorQuda("Result size %lu does not match %d time slices x %d momenta x 16", result.size(), nt, n_mom);
+
+    for (auto i = 0u; i < x.size(); i++) {
+      checkPrecision(x[0], x[i], y[i]);
+      checkLocation(x[0], x[i], y[i]);
+      if (x[i].GammaBasis() != QUDA_DEGRAND_ROSSI_GAMMA_BASIS || y[i].GammaBasis() != QUDA_DEGRAND_ROSSI_GAMMA_BASIS)
+        errorQuda("Unexpected gamma basis x=%d y=%d", x[i].GammaBasis(), y[i].GammaBasis());
+      if (x[i].Nspin() != 4 || y[i].Nspin() != 4)
+        errorQuda("Unexpected number of spins x=%d y=%d", x[i].Nspin(), y[i].Nspin());
+      if (x[i].SiteSubset() != QUDA_FULL_SITE_SUBSET) errorQuda("Summed contractions require full fields");
+    }
+
+    // the local time slices are placed in the global time extent and then reduced across all processes
+    std::vector<Complex> result_global(nt * n_mom * 16, 0.0);
+    const int n_mom_max = std::min(n_mom, max_n_mom_contract());
+    auto d_local = static_cast<array<double, 32> *>(pool_device_malloc(lt * n_mom_max * sizeof(array<double, 32>)));
+    std::vector<array<double, 32>> local(lt * n_mom_max);
+
+    // the pairs are summed in the kernel, so each launch covers up
+    // to max_n_pair_contract pairs and max_n_mom_contract momenta
+    for (auto i0 = 0u; i0 < x.size(); i0 += max_n_pair_contract()) {
+      const auto n_pair = std::min<size_t>(x.size() - i0, max_n_pair_contract());
+      vector_ref<const ColorSpinorField> x_block {x.begin() + i0, x.begin() + i0 + n_pair};
+      vector_ref<const ColorSpinorField> y_block {y.begin() + i0, y.begin() + i0 + n_pair};
+
+      for (int m0 = 0; m0 < n_mom; m0 += max_n_mom_contract()) {
+        const int n_mom_block = std::min(n_mom - m0, max_n_mom_contract());
+        instantiate<ContractionSummedCompute>(x[0], x_block, y_block, d_local, cType, mom.data() + 3 * m0,
+                                              n_mom_block, source_position);
+        qudaMemcpy(local.data(), d_local, lt * n_mom_block * sizeof(array<double, 32>), qudaMemcpyDeviceToHost);
+        for (int t = 0; t < lt; t++)
+          for (int m = 0; m < n_mom_block; m++)
+            for (int g = 0; g < 16; g++) {
+              auto &r = local[t * n_mom_block + m];
+              result_global[((t + t_offset) * n_mom + m0 + m) * 16 + g] += Complex(r[2 * g], r[2 * g + 1]);
+            }
+      }
+    }
+    pool_device_free(d_local);
+
+    comm_allreduce_sum(result_global);
+    for (auto i = 0u; i < result.size(); i++) result[i] += result_global[i];
+  }
 #else
   void contractQuda(const ColorSpinorField &, const ColorSpinorField &, void *, const QudaContractType)
   {
     errorQuda("Contraction code has not been built");
   }
+
+  void contractSummedQuda(cvector_ref<const ColorSpinorField> &, cvector_ref<const ColorSpinorField> &,
+                          std::vector<Complex> &, const QudaContractType, const std::vector<int> &, const int[4])
+  {
+    errorQuda("Contraction code has not been built");
+  }
 #endif
 
 } // namespace quda
@@ -259,6 +259,11 @@ namespace quda {
       errorQuda("TIFR interface has not been built\n");
 #endif
 
+    } else if (in.Order() == QUDA_ILDG_GAUGE_ORDER) {
+
+      copyGauge<FloatOut, FloatIn, length>(ILDGOrder<FloatIn, length>(in, In, inGhost), out, in, location, Out,
+                                           outGhost, type);
+
     } else {
       errorQuda("Gauge field order %d not supported", in.Order());
     }
@@ -76,6 +76,13 @@ namespace quda {
 	errorQuda("Unsupported creation type %d", create);
       }
 
+    } else if (order == QUDA_ILDG_GAUGE_ORDER) {
+
+      // the payload spans the global lattice and is typically a read-only memory map
+      if (create != QUDA_REFERENCE_FIELD_CREATE) errorQuda("ILDG gauge order only supported for reference fields");
+      if (ghostExchange == QUDA_GHOST_EXCHANGE_PAD) errorQuda("ILDG gauge order does not support ghost exchange");
+      gauge = (void **)param.gauge;
+
     } else {
       errorQuda("Unsupported gauge order type %d", order);
     }
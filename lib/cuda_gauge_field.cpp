@@ -17,7 +17,7 @@ namespace quda {
 
     if (order == QUDA_QDP_GAUGE_ORDER ||
 	order == QUDA_TIFR_GAUGE_ORDER || order == QUDA_TIFR_PADDED_GAUGE_ORDER ||
-	order == QUDA_BQCD_GAUGE_ORDER || order == QUDA_CPS_WILSON_GAUGE_ORDER)
+	order == QUDA_BQCD_GAUGE_ORDER || order == QUDA_CPS_WILSON_GAUGE_ORDER || order == QUDA_ILDG_GAUGE_ORDER)
       errorQuda("Field ordering %d presently disabled for this type", order);
 
 #ifdef MULTI_GPU
@@ -532,7 +532,8 @@ namespace quda {
       }
 
     } else if (typeid(src) == typeid(cpuGaugeField)) {
-      if (reorder_location() == QUDA_CPU_FIELD_LOCATION) { // do reorder on the CPU
+      // a (memory-mapped) ILDG payload spans the global lattice, so we always reorder it on the CPU
+      if (reorder_location() == QUDA_CPU_FIELD_LOCATION || src.Order() == QUDA_ILDG_GAUGE_ORDER) {
 	void *buffer = pool_pinned_malloc(bytes);
 
 	if (ghostExchange != QUDA_GHOST_EXCHANGE_EXTENDED && src.GhostExchange() != QUDA_GHOST_EXCHANGE_EXTENDED) {
@@ -212,7 +212,7 @@ namespace quda
 
     // Offset for alpha, beta matrices
     int arrow_offset = j * block_size;
-    int idx = 0, idx_conj = 0;
+    int idx = 0;
 
     // r = A * v_j
     //for (int b = 0; b < block_size; b++) chebyOp(mat, r[b], v[j + b]);
@@ -264,8 +264,8 @@ namespace quda
     // Orthogonalise R[0:block_size] against the Krylov space V[0:j + block_size]
     for (int k = 0; k < 1; k++) blockOrthogonalize(v, r, j + block_size);
 
-    // QR decomposition via modified Gram-Schmidt
-    // NB, QR via modified Gram-Schmidt is numerically unstable.
+    // QR decomposition via Cholesky QR
+    // NB, a single pass of Cholesky QR loses orthogonality as cond(V)^2.
     // We perform the QR iteratively to recover numerical stability.
     //
     // Q_0 * R_0(V)   -> Q_0 * R_0 = V
@@ -279,23 +279,15 @@ namespace quda
     // Column major order
     bool orthed = false;
     int k = 0, kmax = 3;
+    MatrixXcd Rk;
     while (!orthed && k < kmax) {
       // Compute R_{k}
       logQuda(QUDA_DEBUG_VERBOSE, "Orthing k = %d\n", k);
+      orthonormalizeCholQR(r, block_size, Rk);
       for (int b = 0; b < block_size; b++) {
-        double norm = sqrt(blas::norm2(r[b]));
-        blas::ax(1.0 / norm, r[b]);
-        jth_block[b * (block_size + 1)] = norm;
-        for (int c = b + 1; c < block_size; c++) {
-
-          Complex cnorm = blas::cDotProduct(r[b], r[c]);
-          blas::caxpy(-cnorm, r[b], r[c]);
-
-          idx = c * block_size + b;
-          idx_conj = b * block_size + c;
-
-          jth_block[idx] = cnorm;
-          jth_block[idx_conj] = 0.0;
+        for (int c = 0; c < block_size; c++) {
+          idx = b * block_size + c;
+          jth_block[idx] = c <= b ? Rk(c, b) : Complex(0.0);
         }
       }
       // Accumulate R_{k} products
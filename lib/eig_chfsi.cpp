@@ -0,0 +1,265 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+#include <quda_internal.h>
+#include <eigensolve_quda.h>
+#include <random_quda.h>
+#include <color_spinor_field.h>
+#include <blas_quda.h>
+#include <util_quda.h>
+#include <eigen_helper.h>
+
+/**
+   @file eig_chfsi.cpp
+
+   Implementation of the Chebyshev-filtered subspace iteration.
+   Based on the description here: https://doi.org/10.1016/j.jcp.2006.03.017
+
+   Each sweep applies the Chebyshev polynomial of the operator
+   (chebyOp) to the unconverged vectors of the subspace, which damps
+   the eigenvalues in [a_min, a_max] relative to those below a_min.
+   The filtered vectors are orthonormalized and rotated onto their
+   Ritz vectors, and the converged Ritz pairs are locked.  After each
+   sweep a_min is set to the largest Ritz value of the subspace, so
+   the filter adapts to the spectrum and only the initial a_min need
+   be supplied.
+*/
+
+namespace quda
+{
+
+  ChFSI::ChFSI(const DiracMatrix &mat, QudaEigParam *eig_param, TimeProfile &profile) :
+    EigenSolver(mat, eig_param, profile)
+  {
+    bool profile_running = profile.isRunning(QUDA_PROFILE_INIT);
+    if (!profile_running) profile.TPSTART(QUDA_PROFILE_INIT);
+
+    ritz.resize(n_ev, 0.0);
+
+    if (eig_param->spectrum != QUDA_SPECTRUM_SR_EIG)
+      errorQuda("Only the smallest real (SR) spectrum can be passed to the ChFSI solver");
+    if (!eig_param->use_poly_acc) errorQuda("The ChFSI solver requires polynomial acceleration");
+
+    if (!profile_running) profile.TPSTOP(QUDA_PROFILE_INIT);
+  }
+
+  void ChFSI::operator()(std::vector<ColorSpinorField> &kSpace, std::vector<Complex> &evals)
+  {
+    // Pre-launch checks and preparation
+    //---------------------------------------------------------------------------
+    queryPrec(kSpace[0].Precision());
+    // Check to see if we are loading eigenvectors
+    if (strcmp(eig_param->vec_infile, "") != 0) {
+      logQuda(QUDA_VERBOSE, "Loading evecs from file name %s\n", eig_param->vec_infile);
+      loadFromFile(kSpace, evals);
+      return;
+    }
+
+    // The subspace is followed by the workspace used to filter a block of vectors
+    int n_work = std::max(block_size, 2);
+    resize(kSpace, std::max(n_ev + n_work, compute_svd ? 2 * n_conv : 0), QUDA_ZERO_FIELD_CREATE);
+    evals.resize(n_ev, 0.0);
+
+    // Any user supplied vectors are used as the initial subspace,
+    // with the remainder populated with rands
+    RNG rng(kSpace[0], 1234);
+    int n_guess = 0;
+    for (int i = 0; i < n_ev; i++) {
+      if (sqrt(blas::norm2(kSpace[i])) == 0.0)
+        spinorNoise(kSpace[i], rng, QUDA_NOISE_UNIFORM);
+      else
+        n_guess++;
+    }
+    if (n_guess > 0) logQuda(QUDA_SUMMARIZE, "Warm starting ChFSI from %d of %d vectors\n", n_guess, n_ev);
+
+    // Check for Chebyshev maximum estimation, using the workspace as temporaries
+    if (eig_param->a_max <= 0.0) {
+      eig_param->a_max = estimateChebyOpMax(kSpace[n_ev + 1], kSpace[n_ev]);
+      logQuda(QUDA_SUMMARIZE, "Chebyshev maximum estimate: %e.\n", eig_param->a_max);
+    }
+    if (eig_param->a_min >= eig_param->a_max)
+      errorQuda("Invalid a_min = %e a_max = %e combination", eig_param->a_min, eig_param->a_max);
+    const double a_min = eig_param->a_min;
+
+    // Convergence is measured relative to the spectral radius estimate
+    double mat_norm = eig_param->a_max / 1.10;
+
+    // Print Eigensolver params
+    printEigensolverSetup();
+    //---------------------------------------------------------------------------
+
+    // Begin ChFSI Eigensolver computation
+    //---------------------------------------------------------------------------
+    orthonormalize(kSpace);
+    rayleighRitz(kSpace);
+    if (eig_param->a_min <= 0.0) eig_param->a_min = ritz[n_ev - 1];
+
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    // Loop over filter sweeps
+    while (restart_iter < max_restarts && !converged) {
+
+      filter(kSpace);
+      iter += (n_ev - num_locked);
+      orthonormalize(kSpace);
+
+      profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+      rayleighRitz(kSpace);
+      profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+      // Lock the leading converged Ritz pairs, which are no longer filtered
+      while (num_locked < n_ev && residua[num_locked] < tol * mat_norm) {
+        logQuda(QUDA_DEBUG_VERBOSE, "**** Locking %d resid=%+.6e condition=%.6e ****\n", num_locked,
+                residua[num_locked], tol * mat_norm);
+        num_locked++;
+      }
+      num_converged = num_locked;
+
+      logQuda(QUDA_VERBOSE, "%04d converged eigenvalues at restart iter %04d\n", num_converged, restart_iter + 1);
+      for (int i = 0; i < n_ev; i++) {
+        logQuda(QUDA_DEBUG_VERBOSE, "Ritz[%d] = %.16e residual[%d] = %.16e\n", i, ritz[i], i, residua[i]);
+      }
+
+      // Check for convergence
+      if (num_converged >= n_conv) converged = true;
+
+      // The unwanted part of the spectrum now starts at the largest Ritz value
+      eig_param->a_min = ritz[n_ev - 1];
+      if (eig_param->a_min >= eig_param->a_max)
+        errorQuda("Largest Ritz value %e exceeds a_max = %e", eig_param->a_min, eig_param->a_max);
+      logQuda(QUDA_DEBUG_VERBOSE, "a_min = %e\n", eig_param->a_min);
+
+      restart_iter++;
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+    eig_param->a_min = a_min;
+
+    // Locking may have left the subspace out of order, so sort by Ritz value
+    for (int i = 1; i < n_ev; i++) {
+      for (int j = i; j > 0 && ritz[j - 1] > ritz[j]; j--) {
+        std::swap(ritz[j - 1], ritz[j]);
+        std::swap(residua[j - 1], residua[j]);
+        std::swap(kSpace[j - 1], kSpace[j]);
+      }
+    }
+
+    // Post computation report
+    //---------------------------------------------------------------------------
+    if (!converged) {
+      if (eig_param->require_convergence) {
+        errorQuda("ChFSI failed to compute the requested %d vectors with a %d search space in %d restart steps. "
+                  "Exiting.",
+                  n_conv, n_ev, max_restarts);
+      } else {
+        warningQuda("ChFSI failed to compute the requested %d vectors with a %d search space in %d restart steps. "
+                    "Continuing with current subspace.",
+                    n_conv, n_ev, max_restarts);
+      }
+    } else {
+      logQuda(QUDA_SUMMARIZE, "ChFSI computed the requested %d vectors in %d restart steps and %d OP*x operations.\n",
+              n_conv, restart_iter, iter);
+
+      for (int i = 0; i < n_conv; i++) {
+        logQuda(QUDA_VERBOSE, "RitzValue[%04d]: (%+.16e, %+.16e) residual %.16e\n", i, ritz[i], 0.0, residua[i]);
+      }
+
+      // Compute eigenvalues/singular values
+      computeEvals(kSpace, evals);
+      if (compute_svd) computeSVD(kSpace, evals);
+    }
+
+    // Local clean-up
+    cleanUpEigensolver(kSpace, evals);
+  }
+
+  void ChFSI::filter(std::vector<ColorSpinorField> &kSpace)
+  {
+    for (int b = num_locked; b < n_ev; b += block_size) {
+      int size = std::min(block_size, n_ev - b);
+      chebyOp({kSpace.begin() + n_ev, kSpace.begin() + n_ev + size}, {kSpace.begin() + b, kSpace.begin() + b + size});
+      for (int i = 0; i < size; i++) std::swap(kSpace[b + i], kSpace[n_ev + i]);
+    }
+  }
+
+  void ChFSI::orthonormalize(std::vector<ColorSpinorField> &kSpace)
+  {
+    int n_active = n_ev - num_locked;
+
+    // Move the unlocked vectors to their own set
+    std::vector<ColorSpinorField> active(n_active);
+    for (int i = 0; i < n_active; i++) std::swap(active[i], kSpace[num_locked + i]);
+
+    if (num_locked > 0) blockOrthogonalize(kSpace, active, num_locked);
+
+    // The filtered vectors are badly conditioned, so the first pass of
+    // Cholesky QR may need to be shifted and a further two applied
+    // (shifted CholeskyQR3).  Once a pass finds the input to be close to
+    // orthonormal its result is orthonormal to working precision.
+    MatrixXcd R;
+    for (int k = 0; k < 3; k++) {
+      orthonormalizeCholQR(active, n_active, R);
+      double deviation = (R - MatrixXcd::Identity(n_active, n_active)).cwiseAbs().maxCoeff();
+      logQuda(QUDA_DEBUG_VERBOSE, "Cholesky QR pass %d: max |R - 1| = %e\n", k, deviation);
+      if (deviation < 0.1) break;
+    }
+
+    for (int i = 0; i < n_active; i++) std::swap(active[i], kSpace[num_locked + i]);
+  }
+
+  void ChFSI::rayleighRitz(std::vector<ColorSpinorField> &kSpace)
+  {
+    int n_active = n_ev - num_locked;
+    auto active_ref = {kSpace.begin() + num_locked, kSpace.begin() + n_ev};
+
+    // Project the operator onto the unlocked subspace, H = V^dag A V
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    MatrixXcd H(n_active, n_active);
+    for (int b = 0; b < n_active; b += block_size) {
+      int size = std::min(block_size, n_active - b);
+      auto work_ref = {kSpace.begin() + n_ev, kSpace.begin() + n_ev + size};
+      mat(work_ref, {kSpace.begin() + num_locked + b, kSpace.begin() + num_locked + b + size});
+
+      std::vector<Complex> h(n_active * size);
+      blas::cDotProduct(h, active_ref, work_ref);
+      for (int i = 0; i < n_active; i++)
+        for (int j = 0; j < size; j++) H(i, b + j) = h[i * size + j];
+    }
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+    // Eigensolve the projected matrix, with eigenvalues returned in ascending order
+    profile.TPSTART(QUDA_PROFILE_EIGEN);
+    H = 0.5 * (H + H.adjoint()).eval();
+    SelfAdjointEigenSolver<MatrixXcd> eigensolver(H);
+
+    std::vector<Complex> rot(n_active * n_active);
+    for (int i = 0; i < n_active; i++) {
+      ritz[num_locked + i] = eigensolver.eigenvalues()[i];
+      for (int j = 0; j < n_active; j++) rot[j * n_active + i] = eigensolver.eigenvectors()(j, i);
+    }
+    profile.TPSTOP(QUDA_PROFILE_EIGEN);
+
+    // Rotate the unlocked vectors onto the Ritz vectors
+    rotateVecs(kSpace, rot, n_ev, n_active, n_active, num_locked, profile);
+
+    // Compute the residua ||A v - lambda v||, with one reduction per block
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    for (int b = 0; b < n_active; b += block_size) {
+      int size = std::min(block_size, n_active - b);
+      auto work_ref = {kSpace.begin() + n_ev, kSpace.begin() + n_ev + size};
+      mat(work_ref, {kSpace.begin() + num_locked + b, kSpace.begin() + num_locked + b + size});
+      for (int j = 0; j < size; j++)
+        blas::axpy(-ritz[num_locked + b + j], kSpace[num_locked + b + j], kSpace[n_ev + j]);
+
+      std::vector<Complex> r2(size * size);
+      blas::cDotProduct(r2, work_ref, work_ref);
+      for (int j = 0; j < size; j++) residua[num_locked + b + j] = sqrt(r2[j * size + j].real());
+    }
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+  }
+
+} // namespace quda
@@ -116,6 +116,10 @@ namespace quda
       logQuda(QUDA_VERBOSE, "Creating Block TR Lanczos eigensolver\n");
       eig_solver = new BLKTRLM(mat, eig_param, profile);
       break;
+    case QUDA_EIG_CHFSI:
+      logQuda(QUDA_VERBOSE, "Creating Chebyshev-filtered subspace iteration eigensolver\n");
+      eig_solver = new ChFSI(mat, eig_param, profile);
+      break;
     default: errorQuda("Invalid eig solver type");
     }
 
@@ -158,10 +162,11 @@ namespace quda
 
     bool orthed = false;
     int k = 0, kmax = 5;
+    MatrixXcd R;
     while (!orthed && k < kmax) {
-      orthonormalizeMGS(kSpace, block_size);
+      orthonormalizeCholQR(kSpace, block_size, R);
       if (block_size > 1) {
-        logQuda(QUDA_SUMMARIZE, "Orthonormalising initial guesses with Modified Gram Schmidt, iter k=%d/5\n", (k + 1));
+        logQuda(QUDA_SUMMARIZE, "Orthonormalising initial guesses with Cholesky QR, iter k=%d/5\n", (k + 1));
       } else {
         logQuda(QUDA_SUMMARIZE, "Orthonormalising initial guess\n");
       }
@@ -251,9 +256,11 @@ namespace quda
       const QudaParity mat_parity = impliedParityFromMatPC(mat.getMatPCType());
       for (auto &k : kSpace) k.setSuggestedParity(mat_parity);
 
-      // save the vectors
-      VectorIO io(eig_param->vec_outfile, eig_param->io_parity_inflate == QUDA_BOOLEAN_TRUE);
+      // save the vectors: this returns once they are staged to the host
+      profile.TPSTART(QUDA_PROFILE_IO);
+      VectorIO io(eig_param->vec_outfile, eig_param->io_parity_inflate == QUDA_BOOLEAN_TRUE, true);
       io.save(kSpace, save_prec, n_eig);
+      profile.TPSTOP(QUDA_PROFILE_IO);
     }
 
     mat.flops();
@@ -359,10 +366,12 @@ namespace quda
     blas::hDotProduct(H, {vecs.begin(), vecs.begin() + size}, {vecs.begin(), vecs.begin() + size});
 
     double epsilon = setEpsilon(vecs[0].Precision());
+    double loss = 0.0;
 
     for (int i = 0; i < size; i++) {
       for (int j = 0; j < size; j++) {
         auto cnorm = H[i * size + j];
+        loss = std::max(loss, abs((i == j ? Unit : 0.0) - cnorm));
         if (j != i) {
           if (abs(cnorm) > 5.0 * epsilon) {
             logQuda(QUDA_SUMMARIZE, "Norm <%d|%d>^2 = ||(%e,%e)|| = %e\n", i, j, cnorm.real(), cnorm.imag(), abs(cnorm));
@@ -378,6 +387,8 @@ namespace quda
       }
     }
 
+    logQuda(QUDA_VERBOSE, "Orthogonality loss max |<i|j> - delta_ij| = %e over %d vectors\n", loss, size);
+
     return orthed;
   }
 
@@ -393,19 +404,74 @@ namespace quda
     }
   }
 
+  void EigenSolver::orthonormalizeCholQR(std::vector<ColorSpinorField> &vecs, int size, MatrixXcd &R)
+  {
+    // Gram matrix G = V^dag V with a single multi-reduction
+    std::vector<Complex> g(size * size);
+    blas::cDotProduct(g, {vecs.begin(), vecs.begin() + size}, {vecs.begin(), vecs.begin() + size});
+    MatrixXcd G(size, size);
+    for (int i = 0; i < size; i++)
+      for (int j = 0; j < size; j++) G(i, j) = g[i * size + j];
+
+    // G = R^dag R
+    Eigen::LLT<MatrixXcd> llt(G);
+    if (llt.info() != Eigen::Success) {
+      // shifted Cholesky QR: subsequent passes restore the orthogonality
+      double shift = 11.0 * size * setEpsilon(vecs[0].Precision()) * G.trace().real();
+      logQuda(QUDA_VERBOSE, "Gram matrix not positive definite, shifting by %e\n", shift);
+      G += shift * MatrixXcd::Identity(size, size);
+      llt.compute(G);
+      if (llt.info() != Eigen::Success) errorQuda("Cholesky factorization of the Gram matrix failed");
+    }
+    R = llt.matrixU();
+    MatrixXcd Rinv = R.triangularView<Eigen::Upper>().solve(MatrixXcd::Identity(size, size));
+
+    // V <- V R^{-1} in place: since R^{-1} is upper triangular, column
+    // j of the result only depends on v[0:j] so we work backwards
+    for (int j = size - 1; j >= 0; j--) {
+      blas::ax(Rinv(j, j).real(), vecs[j]);
+      if (j > 0) {
+        std::vector<Complex> a(j);
+        for (int i = 0; i < j; i++) a[i] = Rinv(i, j);
+        blas::caxpy(a, {vecs.begin(), vecs.begin() + j}, vecs[j]);
+      }
+    }
+  }
+
   // Orthogonalise r[0:] against V_[0:j]
   void EigenSolver::blockOrthogonalize(std::vector<ColorSpinorField> &vecs, std::vector<ColorSpinorField> &rvecs, int j)
   {
     auto vecs_size = j;
-    auto array_size = vecs_size * rvecs.size();
-    std::vector<Complex> s(array_size);
+    auto r_size = rvecs.size();
+    auto array_size = vecs_size * r_size;
 
-    // Block dot products stored in s.
-    blas::cDotProduct(s, {vecs.begin(), vecs.begin() + vecs_size}, {rvecs.begin(), rvecs.end()});
+    // Block dot products of [V r] with r stored in s, so the Gram
+    // matrix of r is obtained with the same reduction
+    vector_ref<const ColorSpinorField> vr(vecs.begin(), vecs.begin() + vecs_size);
+    for (auto &r : rvecs) vr.push_back(r);
+    std::vector<Complex> s((vecs_size + r_size) * r_size);
+    blas::cDotProduct(s, vr, {rvecs.begin(), rvecs.end()});
+
+    // the norm of each r after projection follows from Pythagoras
+    bool reorthogonalize = false;
+    for (auto c = 0u; c < r_size; c++) {
+      double r2 = s[(vecs_size + c) * r_size + c].real();
+      double proj2 = 0.0;
+      for (auto i = 0; i < vecs_size; i++) proj2 += norm(s[i * r_size + c]);
+      if (r2 - proj2 < 0.5 * r2) reorthogonalize = true;
+    }
 
     // Block orthogonalise
+    s.resize(array_size);
     for (auto i = 0u; i < array_size; i++) s[i] *= -1.0;
     blas::caxpy(s, {vecs.begin(), vecs.begin() + vecs_size}, {rvecs.begin(), rvecs.end()});
+
+    if (reorthogonalize) {
+      logQuda(QUDA_DEBUG_VERBOSE, "Reorthogonalising against %d vectors\n", vecs_size);
+      blas::cDotProduct(s, {vecs.begin(), vecs.begin() + vecs_size}, {rvecs.begin(), rvecs.end()});
+      for (auto i = 0u; i < array_size; i++) s[i] *= -1.0;
+      blas::caxpy(s, {vecs.begin(), vecs.begin() + vecs_size}, {rvecs.begin(), rvecs.end()});
+    }
   }
 
   void EigenSolver::permuteVecs(std::vector<ColorSpinorField> &kSpace, MatrixXi &mat, int size)
@@ -541,6 +607,8 @@ namespace quda
       return;
     }
 
+    if (compressed_space) errorQuda("Compressed deflation is not supported for SVD deflation spaces");
+
     int n_defl = n_ev_deflate;
     if (evecs.size() != (unsigned int)(2 * eig_param->n_conv))
       errorQuda("Incorrect deflation space sized %d passed to deflateSVD, expected %d", (int)(evecs.size()),
@@ -560,7 +628,8 @@ namespace quda
     //    A_i -> (\sigma_i)^{-1} * A_i
     //    vec_defl = Sum_i (R_i)^{-1} * A_i
     if (!accumulate) for (auto &x : sol) blas::zero(x);
-    for (int i = 0; i < n_defl; i++) s[i] /= evals[i].real();
+    for (int i = 0; i < n_defl; i++)
+      for (auto j = 0u; j < src.size(); j++) s[i * src.size() + j] /= evals[i].real();
 
     blas::caxpy(s, {evecs.begin(), evecs.begin() + n_defl}, {sol.begin(), sol.end()});
   }
@@ -610,15 +679,26 @@ namespace quda
     int n_defl = n_ev_deflate;
     logQuda(QUDA_VERBOSE, "Deflating %d vectors\n", n_defl);
 
+    // The eigenvectors have been replaced by their compressed representation
+    if (compressed_space) {
+      compressed_space->deflate(sol, src, evals, n_defl, accumulate);
+      return;
+    }
+
     // Perform Sum_i V_i * (L_i)^{-1} * (V_i)^dag * vec = vec_defl
     // for all i computed eigenvectors and values.
+    // The eigenvectors may be stored at lower precision than the
+    // sources (see QudaEigParam::deflation_prec): both block operations
+    // are mixed precision, with the inner products reduced in double and
+    // the result accumulated at the precision of sol.
 
     // 1. Take block inner product: (V_i)^dag * vec = A_i
     std::vector<Complex> s(n_defl * src.size());
     blas::cDotProduct(s, {evecs.begin(), evecs.begin() + n_defl}, {src.begin(), src.end()});
 
     // 2. Perform block caxpy: V_i * (L_i)^{-1} * A_i
-    for (int i = 0; i < n_defl; i++) { s[i] /= evals[i].real(); }
+    for (int i = 0; i < n_defl; i++)
+      for (auto j = 0u; j < src.size(); j++) s[i * src.size() + j] /= evals[i].real();
 
     // 3. Accumulate sum vec_defl = Sum_i V_i * (L_i)^{-1} * A_i
     if (!accumulate) for (auto &x : sol) blas::zero(x);
@@ -634,9 +714,11 @@ namespace quda
     for (int i = 0; i < n_conv; i++) { kSpace[i].setSuggestedParity(mat_parity); }
 
     {
-      // load the vectors
+      // load the vectors, completing any prefetch that has been issued
+      profile.TPSTART(QUDA_PROFILE_IO);
       VectorIO io(eig_param->vec_infile, eig_param->io_parity_inflate == QUDA_BOOLEAN_TRUE);
       io.load({kSpace.begin(), kSpace.begin() + n_conv});
+      profile.TPSTOP(QUDA_PROFILE_IO);
     }
 
     // Create the device side residual vector by cloning
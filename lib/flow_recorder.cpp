@@ -0,0 +1,86 @@
+#include <cmath>
+
+#include <externals/json.hpp>
+#include <comm_quda.h>
+#include <flow_recorder.h>
+#include <util_quda.h>
+
+namespace quda
+{
+
+  using json = nlohmann::json;
+
+  FlowRecorder::FlowRecorder(const QudaGaugeSmearParam &param) :
+    t0_ref(param.t0_ref), w0_ref(param.w0_ref), stop(param.stop_at_scale == QUDA_BOOLEAN_TRUE)
+  {
+    if (stop && t0_ref <= 0.0 && w0_ref <= 0.0) warningQuda("Early stopping requested but no scale has been requested");
+    if (param.flow_record_file[0] == '\0' || comm_rank() != 0) return;
+
+    stream.open(param.flow_record_file, std::ios::out | std::ios::app);
+    if (!stream.is_open()) errorQuda("Unable to open flow record file %s", param.flow_record_file);
+
+    json header = {{"flow", param.smear_type == QUDA_GAUGE_SMEAR_SYMANZIK_FLOW ? "symanzik" : "wilson"},
+                   {"epsilon", param.epsilon},
+                   {"n_steps", param.n_steps},
+                   {"meas_interval", param.meas_interval},
+                   {"adaptive", param.adaptive == QUDA_BOOLEAN_TRUE},
+                   {"t0_ref", t0_ref},
+                   {"w0_ref", w0_ref}};
+    stream << json {{"header", header}} << std::endl;
+  }
+
+  FlowRecorder::~FlowRecorder()
+  {
+    if (!stream.is_open()) return;
+    json summary = {{"n_meas", n_meas}, {"t_final", t_prev}};
+    summary["t0"] = t0_ >= 0.0 ? json(t0_) : json(nullptr);
+    summary["w0"] = w0_ >= 0.0 ? json(w0_) : json(nullptr);
+    stream << json {{"summary", summary}} << std::endl;
+  }
+
+  void FlowRecorder::record(double t, const QudaGaugeObservableParam &obs)
+  {
+    if (n_meas > 0 && t <= t_prev) errorQuda("Flow time %e does not follow previous measurement at %e", t, t_prev);
+
+    const double E = obs.energy[0];
+    const double t2E = t * t * E;
+
+    // W = t d/dt t^2 E is evaluated at the midpoint of successive measurements
+    const bool have_W = n_meas > 0;
+    const double t_W = have_W ? 0.5 * (t + t_prev) : 0.0;
+    const double W = have_W ? t_W * (t2E - t2E_prev) / (t - t_prev) : 0.0;
+
+    if (t0_ref > 0.0 && t0_ < 0.0 && n_meas > 0 && t2E_prev < t0_ref && t2E >= t0_ref) {
+      t0_ = t_prev + (t0_ref - t2E_prev) * (t - t_prev) / (t2E - t2E_prev);
+      logQuda(QUDA_SUMMARIZE, "Flow scale t0/a^2 = %.12e (t^2 E = %g)\n", t0_, t0_ref);
+    }
+
+    if (w0_ref > 0.0 && w0_ < 0.0 && have_W && n_meas > 1 && W_prev < w0_ref && W >= w0_ref) {
+      const double t_w0 = t_W_prev + (w0_ref - W_prev) * (t_W - t_W_prev) / (W - W_prev);
+      w0_ = std::sqrt(t_w0);
+      logQuda(QUDA_SUMMARIZE, "Flow scale w0/a = %.12e (W = %g)\n", w0_, w0_ref);
+    }
+
+    if (stream.is_open()) {
+      json entry = {{"t", t},
+                    {"plaquette", obs.plaquette[0]},
+                    {"E", E},
+                    {"E_spatial", obs.energy[1]},
+                    {"E_temporal", obs.energy[2]},
+                    {"t2E", t2E},
+                    {"Q", obs.qcharge}};
+      entry["W"] = have_W ? json(W) : json(nullptr);
+      entry["t_W"] = have_W ? json(t_W) : json(nullptr);
+      stream << entry << '\n';
+    }
+
+    t_prev = t;
+    t2E_prev = t2E;
+    if (have_W) {
+      t_W_prev = t_W;
+      W_prev = W;
+    }
+    n_meas++;
+  }
+
+} // namespace quda
@@ -350,6 +350,8 @@ namespace quda {
     return Checksum(*this, mini);
   }
 
+  std::string GaugeField::digest() const { return Digest(*this); }
+
   GaugeField* GaugeField::Create(const GaugeFieldParam &param) {
 
     GaugeField *field = nullptr;
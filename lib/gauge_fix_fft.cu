@@ -7,6 +7,7 @@
 #include <gauge_tools.h>
 
 #include <FFT_Plans.h>
+#include <host_fft.h>
 #include <instantiate.h>
 
 #include <tunable_nd.h>
@@ -41,8 +42,8 @@ namespace quda {
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       switch (dir) {
-      case 0: launch<FFTrotate>(tp, stream, Arg<0>(data, tmp0, tmp1)); break;
-      case 1: launch<FFTrotate>(tp, stream, Arg<1>(data, tmp0, tmp1)); break;
+      case 0: launch<FFTrotate, true>(tp, stream, Arg<0>(data, tmp0, tmp1)); break;
+      case 1: launch<FFTrotate, true>(tp, stream, Arg<1>(data, tmp0, tmp1)); break;
       default: errorQuda("Error in GaugeFixFFTRotate option");
       }
     }
@@ -65,7 +66,7 @@ namespace quda {
     void apply(const qudaStream_t &stream)
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      launch<FixQualityFFT>(arg.result, tp, stream, arg);
+      launch<FixQualityFFT, true>(arg.result, tp, stream, arg);
 
       arg.result[0] /= static_cast<double>(3 * Arg::gauge_dir * meta.Volume());
       arg.result[1] /= static_cast<double>(3 * meta.Volume());
@@ -76,11 +77,45 @@ namespace quda {
     { return (Arg::gauge_dir * meta.Bytes() / 4) + 12 * meta.Volume() * meta.Precision(); }
   };
 
+  /**
+     @brief Real inner product of two fields of anti-hermitian matrices
+     as stored by the quality kernel, used by the conjugate gradient
+   */
+  template <typename Float> class GaugeFixDotProduct : TunableReduction2D {
+    const GaugeField &meta;
+    const complex<Float> *a;
+    const complex<Float> *b;
+    double &result;
+
+  public:
+    GaugeFixDotProduct(const GaugeField &meta, const complex<Float> *a, const complex<Float> *b, double &result) :
+      TunableReduction2D(meta),
+      meta(meta),
+      a(a),
+      b(b),
+      result(result)
+    {
+      apply(device::get_default_stream());
+    }
+
+    void apply(const qudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      GaugeFixDotArg<Float> arg(meta, a, b);
+      launch<GaugeFixDot, true>(result, tp, stream, arg);
+    }
+
+    long long flops() const { return 6 * 4 * meta.Volume(); }
+    long long bytes() const { return 2 * 6 * 2 * sizeof(Float) * meta.Volume(); }
+  };
+
   enum GaugeFixFFTKernel {
     KERNEL_SET_INVPSQ,
     KERNEL_NORMALIZE,
     KERNEL_GX,
-    KERNEL_UEO
+    KERNEL_UEO,
+    KERNEL_CG,
+    KERNEL_REUNIT
   };
 
   template <typename Arg> class GaugeFixerFFT : TunableKernel2D {
@@ -112,6 +147,8 @@ namespace quda {
         strcat(aux, "_new");
 #endif
         break;
+      case KERNEL_CG: strcat(aux, ",cg"); break;
+      case KERNEL_REUNIT: strcat(aux, ",reunit"); break;
       default: errorQuda("Unknown kernel type %d", type);
       }
     }
@@ -120,14 +157,16 @@ namespace quda {
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       switch (type) {
-      case KERNEL_SET_INVPSQ: launch<set_invpsq>(tp, stream, arg); break;
-      case KERNEL_NORMALIZE: launch<mult_norm_2d>(tp, stream, arg); break;
-      case KERNEL_GX: launch<GX>(tp, stream, arg); break;
+      case KERNEL_SET_INVPSQ: launch<set_invpsq, true>(tp, stream, arg); break;
+      case KERNEL_NORMALIZE: launch<mult_norm_2d, true>(tp, stream, arg); break;
+      case KERNEL_GX: launch<GX, true>(tp, stream, arg); break;
 #ifdef GAUGEFIXING_DONT_USE_GX
-      case KERNEL_UEO: launch<U_EO_NEW>(tp, stream, arg); break;
+      case KERNEL_UEO: launch<U_EO_NEW, true>(tp, stream, arg); break;
 #else
-      case KERNEL_UEO: launch<U_EO>(tp, stream, arg); break;
+      case KERNEL_UEO: launch<U_EO, true>(tp, stream, arg); break;
 #endif //GAUGEFIXING_DONT_USE_GX
+      case KERNEL_CG: launch<cg_direction, true>(tp, stream, arg); break;
+      case KERNEL_REUNIT: launch<reunit_gauge, true>(tp, stream, arg); break;
       default: errorQuda("Unexpected kernel type %d", type);
       }
     }
@@ -136,7 +175,8 @@ namespace quda {
     {
       switch (type) {
       case KERNEL_NORMALIZE: std::swap(arg.gx, arg.delta); break; // delta is irrelevant here, so use as backup
-      case KERNEL_UEO: field.backup(); break;
+      case KERNEL_UEO:
+      case KERNEL_REUNIT: field.backup(); break;
       default: break;
       }
     }
@@ -145,7 +185,8 @@ namespace quda {
     {
       switch (type) {
       case KERNEL_NORMALIZE: std::swap(arg.gx, arg.delta); break;
-      case KERNEL_UEO: field.restore(); break;
+      case KERNEL_UEO:
+      case KERNEL_REUNIT: field.restore(); break;
       default: break;
       }
     }
@@ -161,6 +202,8 @@ namespace quda {
 #else
       case KERNEL_UEO: return (arg.elems == 6 ? 1794 : 1536) * field.Volume();
 #endif
+      case KERNEL_CG: return 6 * 4 * field.Volume();
+      case KERNEL_REUNIT: return 4 * 130 * field.Volume();
       default: errorQuda("Unexpected kernel type %d", type); return 0;
       }
     }
@@ -176,22 +219,32 @@ namespace quda {
 #else
       case KERNEL_UEO: return 26 * arg.elems * field.Precision() * field.Volume();
 #endif
+      case KERNEL_CG: return 3 * 6 * 2 * sizeof(typename Arg::Float) * field.Volume();
+      case KERNEL_REUNIT: return 2 * field.Bytes();
       default: errorQuda("Unexpected kernel type %d", type); return 0;
       }
     }
   };
 
-  template <typename Float, QudaReconstructType recon, int gauge_dir>
-  void gaugeFixingFFT(GaugeField& data, int Nsteps, int verbose_interval,
-                      double alpha0, int autotune, double tolerance, int stopWtheta)
+  /**
+     @tparam native Whether the field is a device field, using the
+     device FFT plans, or a QDP ordered host field, using the host FFT
+     @return The number of iterations performed
+   */
+  template <typename Float, QudaReconstructType recon, int gauge_dir, bool native>
+  int gaugeFixingFFT(GaugeField& data, int Nsteps, int verbose_interval,
+                      double alpha0, int autotune, double tolerance, int stopWtheta, bool cg, double *quality)
   {
+    using Plan = std::conditional_t<native, FFTPlanHandle, HostFFTPlan>;
     TimeProfile profileInternalGaugeFixFFT("InternalGaugeFixQudaFFT", false);
 
     profileInternalGaugeFixFFT.TPSTART(QUDA_PROFILE_COMPUTE);
 
     if (getVerbosity() >= QUDA_SUMMARIZE) {
-      printfQuda("\tAuto tune active: %s\n", autotune ? "true" : "false");      
-      printfQuda("\tAlpha parameter of the Steepest Descent Method: %e\n", alpha0);
+      printfQuda("\tMethod: %s\n", cg ? "Conjugate Gradient" : "Steepest Descent");
+      if (!cg) printfQuda("\tAuto tune active: %s\n", autotune ? "true" : "false");
+      printfQuda("\tAlpha parameter of the %s Method: %e\n", cg ? "Conjugate Gradient (initial)" : "Steepest Descent",
+                 alpha0);
       printfQuda("\tTolerance: %lf\n", tolerance);
       printfQuda("\tStop criterion method: %s\n", stopWtheta ? "Theta" : "Delta");
       printfQuda("\tMaximum number of iterations: %d\n", Nsteps);
@@ -200,10 +253,11 @@ namespace quda {
     
     unsigned int delta_pad = data.X()[0] * data.X()[1] * data.X()[2] * data.X()[3];
     int4 size = make_int4(data.X()[0], data.X()[1], data.X()[2], data.X()[3]);
-    FFTPlanHandle plan_xy;
-    FFTPlanHandle plan_zt;
+    Plan plan_xy;
+    Plan plan_zt;
 
-    GaugeFixArg<Float, recon> arg(data, alpha0);
+    GaugeFixArg<Float, recon, native> arg(data, alpha0, cg);
+    using real = typename decltype(arg)::Float;
     SetPlanFFT2DMany(plan_zt, size, 0, data.Precision()); // for space and time ZT
     SetPlanFFT2DMany(plan_xy, size, 1, data.Precision()); // with space only XY
 
@@ -213,22 +267,21 @@ namespace quda {
     gfix.set_type(KERNEL_SET_INVPSQ);
     gfix.apply(device::get_default_stream());
 
-    GaugeFixQualityFFTArg<Float, recon, gauge_dir> argQ(data, arg.delta);
+    GaugeFixQualityFFTArg<Float, recon, gauge_dir, native> argQ(data, arg.delta);
     GaugeFixQuality<decltype(argQ)> gfixquality(argQ, data);
     gfixquality.apply(device::get_default_stream());
     double action0 = argQ.getAction();
     if(getVerbosity() >= QUDA_SUMMARIZE) printf("Step: %d\tAction: %.16e\ttheta: %.16e\n", 0, argQ.getAction(), argQ.getTheta());
 
-    double diff = 0.0;
-    int iter = 0;
-    for (iter = 0; iter < Nsteps; iter++) {
+    // Apply the Fourier acceleration to delta in place, delta <- F^-1 (p_max^2 / p^2) F delta
+    auto precondition = [&]() {
       for (int k = 0; k < 6; k++) {
         //------------------------------------------------------------------------
         // Set a pointer do the element k in lattice volume
         // each element is stored with stride lattice volume
         // it uses gx as temporary array!!!!!!
         //------------------------------------------------------------------------
-        complex<Float> *_array = arg.delta + k * delta_pad;
+        complex<real> *_array = arg.delta + k * delta_pad;
         //////  2D FFT + 2D FFT
         //------------------------------------------------------------------------
         // Perform FFT on xy plane
@@ -262,7 +315,10 @@ namespace quda {
         //------------------------------------------------------------------------
         ApplyFFT(plan_xy, arg.gx, _array, FFT_INVERSE);
       }
+    };
 
+    // Apply the gauge transformation g(x) = exp(alpha delta(x)) to the gauge field
+    auto gauge_transform = [&]() {
 #ifndef GAUGEFIXING_DONT_USE_GX
       //------------------------------------------------------------------------
       // Calculate g(x)
@@ -277,16 +333,103 @@ namespace quda {
       //------------------------------------------------------------------------
       gfix.set_type(KERNEL_UEO);
       gfix.apply(device::get_default_stream());
+    };
+
+    auto dot = [&](const complex<real> *a, const complex<real> *b) {
+      double result = 0.0;
+      GaugeFixDotProduct<real> dot_product(data, a, b, result);
+      return result;
+    };
+
+    // conjugate gradient state: <Delta_{n-1}, P Delta_{n-1}> and whether to restart with steepest ascent
+    double den = 0.0;
+    bool restart = true;
+    const double alpha_min = alpha0 / 64.0;
+    const double alpha_max = alpha0 * 16.0;
+    const size_t delta_bytes = 6 * delta_pad * sizeof(complex<real>);
+
+    double diff = 0.0;
+    int iter = 0;
+    for (iter = 0; iter < Nsteps; iter++) {
+      if (!cg) {
+        precondition();
+        gauge_transform();
+
+        //------------------------------------------------------------------------
+        // Measure gauge quality and recalculate new Delta(x)
+        //------------------------------------------------------------------------
+        gfixquality.apply(device::get_default_stream());
+      } else {
+        //------------------------------------------------------------------------
+        // Polak-Ribiere conjugate gradient with the Fourier accelerated
+        // gradient: delta holds Delta_n, pgrad holds P Delta_{n-1} and
+        // dir holds the previous search direction s_{n-1}
+        //------------------------------------------------------------------------
+        double num0 = restart ? 0.0 : dot(arg.delta, arg.pgrad); // <Delta_n, P Delta_{n-1}>
+        qudaMemcpy(arg.pgrad, arg.delta, delta_bytes, native ? qudaMemcpyDeviceToDevice : qudaMemcpyHostToHost);
+        precondition();
+        double num1 = dot(arg.pgrad, arg.delta); // <Delta_n, P Delta_n>
+
+        double beta = (restart || den <= 0.0) ? 0.0 : std::max(0.0, (num1 - num0) / den);
+        den = num1;
+        // slope of the functional along s_n, which must be an ascent direction
+        double slope0 = num1;
+        if (beta > 0.0) {
+          slope0 += beta * dot(arg.pgrad, arg.dir);
+          if (slope0 <= 0.0) {
+            beta = 0.0;
+            slope0 = num1;
+          }
+        }
+
+        //------------------------------------------------------------------------
+        // s_n = P Delta_n + beta s_{n-1} is written to pgrad, then
+        // delta <- s_n, pgrad <- P Delta_n and dir is free
+        //------------------------------------------------------------------------
+        arg.beta = beta;
+        gfix.set_type(KERNEL_CG);
+        gfix.apply(device::get_default_stream());
+        std::swap(arg.pgrad, arg.delta);
+        argQ.delta = arg.dir;
+
+        //------------------------------------------------------------------------
+        // Line search: step by the current alpha, measure the slope
+        // there, and move to the secant estimate of the maximum.
+        // Successive transformations along s_n compose to the sum of
+        // the steps up to the reunitarization of g(x).
+        //------------------------------------------------------------------------
+        const double alpha = arg.alpha;
+        gauge_transform();
+        gfixquality.apply(device::get_default_stream());
+        double slope1 = dot(arg.dir, arg.delta);
+
+        double t = slope1 < slope0 ? slope0 / (slope0 - slope1) : 4.0;
+        t = std::min(std::max(t, 0.25), 4.0);
+        if (t != 1.0) {
+          arg.alpha = (t - 1.0) * alpha;
+          gauge_transform();
+          gfixquality.apply(device::get_default_stream());
+        }
+
+        //------------------------------------------------------------------------
+        // Adapt the step for the next iteration, restarting with
+        // steepest ascent and a shorter step if the functional decreased
+        //------------------------------------------------------------------------
+        restart = (argQ.getAction() - action0) < -1e-14;
+        arg.alpha = std::min(std::max(restart ? 0.5 * alpha : t * alpha, alpha_min), alpha_max);
+        if (restart && getVerbosity() >= QUDA_VERBOSE)
+          printfQuda("Step: %d\tRestarting the conjugate gradient, alpha -> %.4e\n", iter + 1, arg.alpha);
+
+        // delta <- Delta_{n+1}, dir <- s_n
+        std::swap(arg.delta, arg.dir);
+        argQ.delta = arg.delta;
+      }
 
-      //------------------------------------------------------------------------
-      // Measure gauge quality and recalculate new Delta(x)
-      //------------------------------------------------------------------------
-      gfixquality.apply(device::get_default_stream());
       double action = argQ.getAction();
       diff = abs(action0 - action);
       if ((iter % verbose_interval) == (verbose_interval - 1) && getVerbosity() >= QUDA_SUMMARIZE)
         printf("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, argQ.getAction(), argQ.getTheta(), diff);
-      if ( autotune && ((action - action0) < -1e-14) ) {
+      if ( !cg && autotune && ((action - action0) < -1e-14) ) {
         if ( arg.alpha > 0.01 ) {
           arg.alpha = 0.95 * arg.alpha;
           if(getVerbosity() >= QUDA_SUMMARIZE) printf(">>>>>>>>>>>>>> Warning: changing alpha down -> %.4e\n", arg.alpha);
@@ -302,23 +445,33 @@ namespace quda {
     }
     if ((iter % verbose_interval) != (verbose_interval - 1) && getVerbosity() >= QUDA_SUMMARIZE)
       printf("Step: %d\tAction: %.16e\ttheta: %.16e\tDelta: %.16e\n", iter + 1, argQ.getAction(), argQ.getTheta(), diff);
+    if (quality) {
+      quality[0] = argQ.getAction();
+      quality[1] = argQ.getTheta();
+    }
     
     // Reunitarize at end
-    const double unitarize_eps = 1e-14;
-    const double max_error = 1e-10;
-    const int reunit_allow_svd = 1;
-    const int reunit_svd_only  = 0;
-    const double svd_rel_error = 1e-6;
-    const double svd_abs_error = 1e-6;
-    setUnitarizeLinksConstants(unitarize_eps, max_error,
-                               reunit_allow_svd, reunit_svd_only,
-                               svd_rel_error, svd_abs_error);
-    int *num_failures_h = static_cast<int*>(mapped_malloc(sizeof(int)));
-    int *num_failures_d = static_cast<int*>(get_mapped_device_pointer(num_failures_h));
-
-    *num_failures_h = 0;
-    unitarizeLinks(data, data, num_failures_d);
-    if (*num_failures_h > 0) errorQuda("Error in the unitarization (%d errors)\n", *num_failures_h);
+    if constexpr (native) {
+      const double unitarize_eps = 1e-14;
+      const double max_error = 1e-10;
+      const int reunit_allow_svd = 1;
+      const int reunit_svd_only  = 0;
+      const double svd_rel_error = 1e-6;
+      const double svd_abs_error = 1e-6;
+      setUnitarizeLinksConstants(unitarize_eps, max_error,
+                                 reunit_allow_svd, reunit_svd_only,
+                                 svd_rel_error, svd_abs_error);
+      int *num_failures_h = static_cast<int*>(mapped_malloc(sizeof(int)));
+      int *num_failures_d = static_cast<int*>(get_mapped_device_pointer(num_failures_h));
+
+      *num_failures_h = 0;
+      unitarizeLinks(data, data, num_failures_d);
+      if (*num_failures_h > 0) errorQuda("Error in the unitarization (%d errors)\n", *num_failures_h);
+      host_free(num_failures_h);
+    } else {
+      gfix.set_type(KERNEL_REUNIT);
+      gfix.apply(device::get_default_stream());
+    }
     // end reunitarize
 
     arg.free();
@@ -349,6 +502,20 @@ namespace quda {
     byte += gfix.bytes();
     flop += gfixquality.flops();
     byte += gfixquality.bytes();
+    if (cg) {
+      // second gauge transformation and quality measurement of the line search
+#ifndef GAUGEFIXING_DONT_USE_GX
+      gfix.set_type(KERNEL_GX);
+      flop += gfix.flops();
+      byte += gfix.bytes();
+      gfix.set_type(KERNEL_UEO);
+#endif
+      flop += gfix.flops() + gfixquality.flops();
+      byte += gfix.bytes() + gfixquality.bytes();
+      gfix.set_type(KERNEL_CG);
+      flop += gfix.flops() + 4 * 6 * 4 * data.Volume();  // direction update and inner products
+      byte += gfix.bytes() + 4 * 2 * delta_bytes;
+    }
     gflops += flop * iter;
     gbytes += byte * iter;
     gflops += 4588.0 * data.Volume(); //Reunitarize at end
@@ -358,19 +525,27 @@ namespace quda {
     gbytes = gbytes / (secs * 1e9);
     if (getVerbosity() > QUDA_SUMMARIZE) printfQuda("Time: %6.6f s, Gflop/s = %6.1f, GB/s = %6.1f\n", secs, gflops, gbytes);
 
-    host_free(num_failures_h);
+    // iter is the index of the converged step if the loop stopped early
+    return iter < Nsteps ? iter + 1 : Nsteps;
   }
 
   template<typename Float, int nColors, QudaReconstructType recon> struct GaugeFixingFFT {
     GaugeFixingFFT(GaugeField& data, int gauge_dir, int Nsteps, int verbose_interval,
-                   double alpha, int autotune, double tolerance, int stopWtheta)
+                   double alpha, int autotune, double tolerance, int stopWtheta, bool cg, double *quality, int &iter)
     {
+      const bool native = data.Location() == QUDA_CUDA_FIELD_LOCATION;
       if (gauge_dir != 3) {
 	if (getVerbosity() > QUDA_SUMMARIZE) printfQuda("Starting Landau gauge fixing with FFTs...\n");
-        gaugeFixingFFT<Float, recon, 4>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+        if (native)
+          iter = gaugeFixingFFT<Float, recon, 4, true>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, cg, quality);
+        else
+          iter = gaugeFixingFFT<Float, recon, 4, false>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, cg, quality);
       } else {
 	if (getVerbosity() > QUDA_SUMMARIZE) printfQuda("Starting Coulomb gauge fixing with FFTs...\n");
-        gaugeFixingFFT<Float, recon, 3>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+        if (native)
+          iter = gaugeFixingFFT<Float, recon, 3, true>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, cg, quality);
+        else
+          iter = gaugeFixingFFT<Float, recon, 3, false>(data, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, cg, quality);
       }
     }
   };
@@ -385,12 +560,20 @@ namespace quda {
    * @param[in] autotune, 1 to autotune the method, i.e., if the Fg inverts its tendency we decrease the alpha value
    * @param[in] tolerance, torelance value to stop the method, if this value is zero then the method stops when iteration reachs the maximum number of steps defined by Nsteps
    * @param[in] stopWtheta, 0 for MILC criterion and 1 to use the theta value
+   * @param[in] cg, use the conjugate gradient method with an adaptive alpha instead of steepest descent
+   * @param[out] quality, if non-null, the functional and theta of the last step are returned here
+   * @return The number of iterations performed
    */
-  void gaugeFixingFFT(GaugeField& data, const int gauge_dir, const int Nsteps, const int verbose_interval, const double alpha,
-                      const int autotune, const double tolerance, const int stopWtheta)
+  int gaugeFixingFFT(GaugeField& data, const int gauge_dir, const int Nsteps, const int verbose_interval, const double alpha,
+                     const int autotune, const double tolerance, const int stopWtheta, const bool cg,
+                     double *quality)
   {
     if (comm_partitioned()) errorQuda("Gauge Fixing with FFTs in multi-GPU support NOT implemented yet!");
-    instantiate<GaugeFixingFFT>(data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+    if (data.Location() == QUDA_CPU_FIELD_LOCATION && data.Order() != QUDA_QDP_GAUGE_ORDER)
+      errorQuda("Host gauge fixing with FFTs requires a QDP ordered field (order = %d)", data.Order());
+    int iter = 0;
+    instantiate<GaugeFixingFFT>(data, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, cg, quality, iter);
+    return iter;
   }
 
 }
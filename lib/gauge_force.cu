@@ -1,3 +1,5 @@
+#include <map>
+#include <string>
 #include <tunable_nd.h>
 #include <instantiate.h>
 #include <gauge_path_quda.h>
@@ -11,18 +13,24 @@ namespace quda {
     GaugeField &mom;
     double epsilon;
     const paths<4> &p;
+    const path_trie &trie;
     unsigned int minThreads() const { return mom.VolumeCB(); }
 
   public:
-    ForceGauge(const GaugeField &u, GaugeField &mom, double epsilon, const paths<4> &p) :
+    ForceGauge(const GaugeField &u, GaugeField &mom, double epsilon, const paths<4> &p, const path_trie &trie) :
       TunableKernel3D(u, 2, 4),
       u(u),
       mom(mom),
       epsilon(epsilon),
-      p(p)
+      p(p),
+      trie(trie)
     {
       strcat(aux, ",num_paths=");
       strcat(aux, std::to_string(p.num_paths).c_str());
+      if (trie.enabled) {
+        strcat(aux, ",trie_nodes=");
+        strcat(aux, std::to_string(trie.num_nodes).c_str());
+      }
       strcat(aux, comm_dim_partitioned_string());
       apply(device::get_default_stream());
     }
@@ -31,20 +39,97 @@ namespace quda {
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       launch<GaugeForce>(tp, stream, GaugeForceArg<Float, nColor, recon_u,
-                         compute_force ? QUDA_RECONSTRUCT_10 : QUDA_RECONSTRUCT_NO, compute_force>(mom, u, epsilon, p));
+                         compute_force ? QUDA_RECONSTRUCT_10 : QUDA_RECONSTRUCT_NO, compute_force>(mom, u, epsilon, p, trie));
     }
 
     void preTune() { mom.backup(); }
     void postTune() { mom.restore(); }
 
-    long long flops() const { return (p.count - p.num_paths + 1) * 198ll * mom.Volume() * 4; }
-    long long bytes() const { return (p.count + 1ll) * u.Bytes() + 2 * mom.Bytes(); }
+    long long flops() const
+    {
+      // with the trie every distinct path prefix is one multiplication
+      if (trie.enabled) return (trie.num_nodes + 4ll) * 198ll * mom.Volume();
+      return (p.count - p.num_paths + 1) * 198ll * mom.Volume() * 4;
+    }
+
+    long long bytes() const
+    {
+      if (trie.enabled) {
+        // each node of the tree of a direction loads one link of that direction, plus U(x)
+        long long links = 0;
+        for (int dir = 0; dir < 4; dir++) links += trie.tree_nodes(dir);
+        return links * (u.Bytes() / 4) + u.Bytes() + 2 * mom.Bytes();
+      }
+      return (p.count + 1ll) * u.Bytes() + 2 * mom.Bytes();
+    }
   };
 
   template<typename Float, int nColor, QudaReconstructType recon_u> using GaugeForce_ = ForceGauge<Float,nColor,recon_u,true>;
 
   template<typename Float, int nColor, QudaReconstructType recon_u> using GaugePath = ForceGauge<Float,nColor,recon_u,false>;
 
+  static bool path_trie_enabled = true;
+
+  void setPathTrie(bool enable) { path_trie_enabled = enable; }
+
+  bool pathTrieEnabled() { return path_trie_enabled; }
+
+  // the compiled tries, keyed on the serialized paths, and the maximum number cached
+  static std::map<std::string, path_trie> path_trie_cache;
+  constexpr size_t max_path_trie_cache = 16;
+
+  template <typename T> static void append_key(std::string &key, const T &value)
+  {
+    key.append(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  const path_trie &getPathTrie(const std::vector<std::vector<path_entry>> &paths,
+                               const std::vector<std::array<int, 4>> &origin)
+  {
+    std::string key;
+    append_key(key, pathTrieEnabled());
+    append_key(key, paths.size());
+    for (auto t = 0u; t < paths.size(); t++) {
+      if (t < origin.size()) append_key(key, origin[t]);
+      append_key(key, paths[t].size());
+      for (auto &p : paths[t]) {
+        append_key(key, p.length);
+        append_key(key, p.coeff);
+        append_key(key, p.path);
+        append_key(key, p.slot);
+        key.append(reinterpret_cast<const char *>(p.step), p.length * sizeof(int));
+      }
+    }
+
+    auto it = path_trie_cache.find(key);
+    if (it != path_trie_cache.end()) return it->second;
+
+    if (path_trie_cache.size() >= max_path_trie_cache) freePathTrieCache();
+    return path_trie_cache.emplace(key, path_trie(paths, origin)).first->second;
+  }
+
+  void freePathTrieCache()
+  {
+    for (auto &t : path_trie_cache) t.second.free();
+    path_trie_cache.clear();
+  }
+
+  /**
+     @brief Compile the paths of each direction into a trie, where the
+     paths of direction mu start at x + mu
+   */
+  static const path_trie &forcePathTrie(std::vector<int **> &input_path, std::vector<int> &length,
+                                 std::vector<double> &path_coeff, int num_paths)
+  {
+    std::vector<std::vector<path_entry>> tree(4);
+    std::vector<std::array<int, 4>> origin(4, {0, 0, 0, 0});
+    for (int dir = 0; dir < 4; dir++) {
+      origin[dir][dir] = 1;
+      for (int i = 0; i < num_paths; i++) tree[dir].push_back({input_path[dir][i], length[i], path_coeff[i], i, 0});
+    }
+    return getPathTrie(tree, origin);
+  }
+
   void gaugeForce(GaugeField& mom, const GaugeField& u, double epsilon, std::vector<int**>& input_path,
                   std::vector<int>& length, std::vector<double>& path_coeff, int num_paths, int path_max_length)
   {
@@ -53,9 +138,10 @@ namespace quda {
     if (mom.Reconstruct() != QUDA_RECONSTRUCT_10) errorQuda("Reconstruction type %d not supported", mom.Reconstruct());
 
     paths<4> p(input_path, length, path_coeff, num_paths, path_max_length);
+    const path_trie &trie = forcePathTrie(input_path, length, path_coeff, num_paths);
 
     // gauge field must be passed as first argument so we peel off its reconstruct type
-    instantiate<GaugeForce_>(u, mom, epsilon, p);
+    instantiate<GaugeForce_>(u, mom, epsilon, p, trie);
     p.free();
   }
   
@@ -67,9 +153,10 @@ namespace quda {
     if (out.Reconstruct() != QUDA_RECONSTRUCT_NO) errorQuda("Reconstruction type %d not supported", out.Reconstruct());
 
     paths<4> p(input_path, length, path_coeff, num_paths, path_max_length);
+    const path_trie &trie = forcePathTrie(input_path, length, path_coeff, num_paths);
 
     // gauge field must be passed as first argument so we peel off its reconstruct type
-    instantiate<GaugePath>(u, out, coeff, p);
+    instantiate<GaugePath>(u, out, coeff, p, trie);
     p.free();
   }
 
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <numeric>
 #include <gauge_field.h>
 #include <gauge_path_quda.h>
 #include <instantiate.h>
@@ -9,24 +11,32 @@ namespace quda {
   template<typename Float, int nColor, QudaReconstructType recon>
   class GaugeLoopTrace : public TunableMultiReduction {
     const GaugeField &u;
-    using reduce_t = array<double, 2>;
+    using reduce_t = array<double, 2 * loop_trace_group()>;
     std::vector<reduce_t>& loop_traces;
     double factor;
     const paths<1> p;
+    const path_trie &trie;
 
   public:
-    // max block size of 8 is arbitrary for now
-    GaugeLoopTrace(const GaugeField &u, std::vector<reduce_t> &loop_traces, double factor, const paths<1>& p) :
-      TunableMultiReduction(u, 2u, p.num_paths, 8),
+    // each block reduces a single batch of loop_trace_group() loops
+    GaugeLoopTrace(const GaugeField &u, std::vector<reduce_t> &loop_traces, double factor, const paths<1>& p,
+                   const path_trie &trie) :
+      TunableMultiReduction(u, 2u, trie.num_trees, max_n_batch_block_loop_trace()),
       u(u),
       loop_traces(loop_traces),
       factor(factor),
-      p(p)
+      p(p),
+      trie(trie)
     {
-      if (p.num_paths != static_cast<int>(loop_traces.size())) errorQuda("Loop traces size %lu != number of paths %d", loop_traces.size(), p.num_paths);
+      if (trie.num_trees != static_cast<int>(loop_traces.size()))
+        errorQuda("Loop traces size %lu != number of batches %d", loop_traces.size(), trie.num_trees);
 
       strcat(aux, "num_paths=");
       u32toa(aux + strlen(aux), p.num_paths);
+      if (trie.enabled) {
+        strcat(aux, ",trie_nodes=");
+        u32toa(aux + strlen(aux), trie.num_nodes);
+      }
 
       apply(device::get_default_stream());
     }
@@ -34,7 +44,7 @@ namespace quda {
     void apply(const qudaStream_t &stream)
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
-      GaugeLoopTraceArg<Float, nColor, recon> arg(u, factor, p);
+      GaugeLoopTraceArg<Float, nColor, recon> arg(u, factor, p, trie);
       launch<GaugeLoop>(loop_traces, tp, stream, arg);
     }
 
@@ -42,27 +52,52 @@ namespace quda {
     {
       auto Nc = u.Ncolor();
       auto mat_mul_flops = 8ll * Nc * Nc * Nc - 2 * Nc * Nc;
-      // matrix multiplies + traces + rescale
-      return (p.count * mat_mul_flops + p.num_paths * (2 * Nc + 2)) * u.Volume();
+      // matrix multiplies (one per distinct prefix with the trie) + traces + rescale
+      auto links = trie.enabled ? trie.num_nodes : p.count;
+      return (links * mat_mul_flops + p.num_paths * (2 * Nc + 2)) * u.Volume();
     }
 
     long long bytes() const {
       // links * one LatticeColorMatrix worth of data
-      return p.count * u.Bytes() / 4;
+      auto links = trie.enabled ? trie.num_nodes : p.count;
+      return links * u.Bytes() / 4;
     }
   };
 
   void gaugeLoopTrace(const GaugeField& u, std::vector<Complex>& loop_traces, double factor, std::vector<int**>& input_path,
 		 std::vector<int>& length, std::vector<double>& path_coeff, int num_paths, int path_max_length)
   {
+    if (num_paths != static_cast<int>(loop_traces.size()))
+      errorQuda("Loop traces size %lu != number of paths %d", loop_traces.size(), num_paths);
+
     paths<1> p(input_path, length, path_coeff, num_paths, path_max_length);
 
-    std::vector<array<double, 2>> tr_array(loop_traces.size());
+    // sort the loops so that loops with common prefixes share a batch, and compile each batch into a tree
+    constexpr int group = loop_trace_group();
+    std::vector<int> order(num_paths);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+      return std::lexicographical_compare(input_path[0][a], input_path[0][a] + length[a], input_path[0][b],
+                                          input_path[0][b] + length[b]);
+    });
+
+    const int num_batches = (num_paths + group - 1) / group;
+    std::vector<std::vector<path_entry>> tree(num_batches);
+    for (int k = 0; k < num_paths; k++) {
+      int i = order[k];
+      tree[k / group].push_back({input_path[0][i], length[i], path_coeff[i], i, k % group});
+    }
+    const path_trie &trie = getPathTrie(tree, std::vector<std::array<int, 4>>(num_batches, {0, 0, 0, 0}));
+
+    std::vector<array<double, 2 * group>> tr_array(num_batches);
 
     // gauge field must be passed as first argument so we peel off its reconstruct type
-    instantiate<GaugeLoopTrace, ReconstructNo12>(u, tr_array, factor, p);
+    instantiate<GaugeLoopTrace, ReconstructNo12>(u, tr_array, factor, p, trie);
 
-    for (auto i = 0u; i < tr_array.size(); i++) { loop_traces[i] = Complex(tr_array[i][0], tr_array[i][1]); }
+    for (int k = 0; k < num_paths; k++) {
+      auto &tr = tr_array[k / group];
+      loop_traces[order[k]] = Complex(tr[2 * (k % group)], tr[2 * (k % group) + 1]);
+    }
 
     p.free();
   }
@@ -0,0 +1,194 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gauge_mmap.h>
+
+namespace quda
+{
+
+  namespace
+  {
+
+    // LIME record header: magic, version, flags, data length and record type
+    constexpr uint32_t lime_magic = 0x456789ab;
+    constexpr size_t lime_header_size = 144;
+    constexpr size_t lime_type_size = 128;
+
+    struct MappedFile {
+      std::string filename;
+      dev_t dev;
+      ino_t ino;
+      time_t mtime;
+      size_t size;
+      void *base;
+      const char *payload;
+      QudaPrecision precision;
+      lat_dim_t X;
+      int count;
+    };
+
+    std::list<MappedFile> mapped_files;
+    std::mutex mapped_mutex;
+
+    template <typename T> T load_be(const char *p)
+    {
+      T v = 0;
+      for (size_t i = 0; i < sizeof(T); i++) v = (v << 8) | static_cast<unsigned char>(p[i]);
+      return v;
+    }
+
+    /**
+       @brief Return the contents of the first <tag>...</tag> element
+       of the xml string, or an empty string if not present
+    */
+    std::string xml_value(const std::string &xml, const std::string &tag)
+    {
+      auto begin = xml.find("<" + tag + ">");
+      if (begin == std::string::npos) return "";
+      begin += tag.size() + 2;
+      auto end = xml.find("</" + tag + ">", begin);
+      return end == std::string::npos ? "" : xml.substr(begin, end - begin);
+    }
+
+    /**
+       @brief Parse the LIME records of the mapped file, locating the
+       binary gauge payload together with its precision and the
+       global lattice dimensions
+    */
+    void parse(MappedFile &file)
+    {
+      const char *base = static_cast<const char *>(file.base);
+      std::string ildg_xml, file_xml, record_xml, pending_record_xml;
+      const char *ildg_data = nullptr, *scidac_data = nullptr;
+      size_t ildg_bytes = 0, scidac_bytes = 0;
+
+      size_t pos = 0;
+      while (pos + lime_header_size <= file.size) {
+        const char *header = base + pos;
+        if (load_be<uint32_t>(header) != lime_magic)
+          errorQuda("Invalid LIME record header at offset %lu in %s", pos, file.filename.c_str());
+        uint64_t bytes = load_be<uint64_t>(header + 8);
+        std::string type(header + 16, strnlen(header + 16, lime_type_size));
+        const char *data = header + lime_header_size;
+        if (pos + lime_header_size + bytes > file.size)
+          errorQuda("Truncated LIME record %s in %s", type.c_str(), file.filename.c_str());
+
+        if (type == "ildg-format") {
+          ildg_xml.assign(data, bytes);
+        } else if (type == "ildg-binary-data" && !ildg_data) {
+          ildg_data = data;
+          ildg_bytes = bytes;
+        } else if (type == "scidac-private-file-xml") {
+          file_xml.assign(data, bytes);
+        } else if (type == "scidac-private-record-xml") {
+          pending_record_xml.assign(data, bytes);
+        } else if (type == "scidac-binary-data" && !scidac_data) {
+          scidac_data = data;
+          scidac_bytes = bytes;
+          record_xml = pending_record_xml;
+        }
+
+        pos += lime_header_size + ((bytes + 7) / 8) * 8; // records are padded to 8 bytes
+      }
+
+      int prec_bytes = 0;
+      size_t bytes = 0;
+      if (ildg_data) {
+        const char *lname[] = {"lx", "ly", "lz", "lt"};
+        for (int d = 0; d < 4; d++) file.X[d] = std::stoi("0" + xml_value(ildg_xml, lname[d]));
+        prec_bytes = std::stoi("0" + xml_value(ildg_xml, "precision")) / 8;
+        file.payload = ildg_data;
+        bytes = ildg_bytes;
+      } else if (scidac_data) {
+        std::string dims = xml_value(file_xml, "dims");
+        if (sscanf(dims.c_str(), "%d %d %d %d", &file.X[0], &file.X[1], &file.X[2], &file.X[3]) != 4)
+          errorQuda("Unable to parse lattice dimensions \"%s\" in %s", dims.c_str(), file.filename.c_str());
+        std::string prec = xml_value(record_xml, "precision");
+        prec_bytes = prec == "D" ? 8 : prec == "F" ? 4 : 0;
+        if (std::stoi("0" + xml_value(record_xml, "datacount")) != 4)
+          errorQuda("Binary record in %s is not a gauge field", file.filename.c_str());
+        file.payload = scidac_data;
+        bytes = scidac_bytes;
+      } else {
+        errorQuda("No ILDG or SciDAC binary data found in %s", file.filename.c_str());
+      }
+
+      if (prec_bytes != 4 && prec_bytes != 8) errorQuda("Unsupported precision in %s", file.filename.c_str());
+      file.precision = prec_bytes == 8 ? QUDA_DOUBLE_PRECISION : QUDA_SINGLE_PRECISION;
+
+      size_t volume = 1;
+      for (int d = 0; d < 4; d++) volume *= file.X[d];
+      if (volume == 0 || bytes != volume * 4 * 18 * prec_bytes)
+        errorQuda("Binary payload of %s has %lu bytes, expected %lu for a %dx%dx%dx%d lattice", file.filename.c_str(),
+                  bytes, volume * 4 * 18 * prec_bytes, file.X[0], file.X[1], file.X[2], file.X[3]);
+    }
+
+  } // namespace
+
+  const void *mapGaugeFile(const char *filename, QudaPrecision &precision, lat_dim_t &X)
+  {
+    std::lock_guard<std::mutex> lock(mapped_mutex);
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) errorQuda("Unable to open %s", filename);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+      close(fd);
+      errorQuda("Unable to stat %s", filename);
+    }
+
+    // reuse an existing mapping if the file is unchanged
+    for (auto &file : mapped_files) {
+      if (file.filename == filename && file.dev == st.st_dev && file.ino == st.st_ino && file.mtime == st.st_mtime
+          && file.size == static_cast<size_t>(st.st_size)) {
+        close(fd);
+        file.count++;
+        precision = file.precision;
+        X = file.X;
+        return file.payload;
+      }
+    }
+
+    MappedFile file = {filename, st.st_dev, st.st_ino, st.st_mtime, static_cast<size_t>(st.st_size)};
+    file.base = mmap(nullptr, file.size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping holds its own reference to the file
+    if (file.base == MAP_FAILED) errorQuda("Unable to map %s", filename);
+
+    parse(file);
+    file.count = 1;
+    mapped_files.push_back(file);
+
+    if (getVerbosity() >= QUDA_VERBOSE)
+      printfQuda("Mapped %s: %dx%dx%dx%d %s precision gauge field\n", filename, file.X[0], file.X[1], file.X[2],
+                 file.X[3], file.precision == QUDA_DOUBLE_PRECISION ? "double" : "single");
+
+    precision = file.precision;
+    X = file.X;
+    return file.payload;
+  }
+
+  void unmapGaugeFile(const void *payload)
+  {
+    std::lock_guard<std::mutex> lock(mapped_mutex);
+
+    for (auto it = mapped_files.begin(); it != mapped_files.end(); it++) {
+      if (it->payload != payload) continue;
+      if (--it->count == 0) {
+        munmap(it->base, it->size);
+        mapped_files.erase(it);
+      }
+      return;
+    }
+    errorQuda("Pointer %p is not a mapped gauge field", payload);
+  }
+
+} // namespace quda
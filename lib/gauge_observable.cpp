@@ -18,7 +18,8 @@ namespace quda
       pool_pinned_free(num_failures_h);
     }
 
-    if (param.compute_plaquette) {
+    // the plaquette alone does not need the clover field strength
+    if (param.compute_plaquette && !param.compute_qcharge && !param.compute_qcharge_density) {
       double3 plaq = plaquette(u);
       param.plaquette[0] = plaq.x;
       param.plaquette[1] = plaq.y;
@@ -26,6 +27,41 @@ namespace quda
     }
     profile.TPSTOP(QUDA_PROFILE_COMPUTE);
 
+    // the plaquette, field energy and topological charge are all computed in a single fused pass
+    if (param.compute_qcharge || param.compute_qcharge_density) {
+      profile.TPSTART(QUDA_PROFILE_INIT);
+      if (param.compute_qcharge_density && !param.qcharge_density)
+        errorQuda("Charge density requested, but destination field not defined");
+      size_t size = u.LocalVolume() * u.Precision();
+      void *d_qDensity = param.compute_qcharge_density ? pool_device_malloc(size) : nullptr;
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+
+      profile.TPSTART(QUDA_PROFILE_COMPUTE);
+      double plaq[3];
+      double energy[3];
+      double qcharge;
+      gaugeObservablesFused(u, plaq, energy, qcharge, d_qDensity);
+      profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+      if (param.compute_plaquette)
+        for (int i = 0; i < 3; i++) param.plaquette[i] = plaq[i];
+
+      if (param.compute_qcharge || param.compute_qcharge_density) {
+        for (int i = 0; i < 3; i++) param.energy[i] = energy[i];
+        param.qcharge = qcharge;
+      }
+
+      if (param.compute_qcharge_density) {
+        profile.TPSTART(QUDA_PROFILE_D2H);
+        qudaMemcpy(param.qcharge_density, d_qDensity, size, qudaMemcpyDeviceToHost);
+        profile.TPSTOP(QUDA_PROFILE_D2H);
+
+        profile.TPSTART(QUDA_PROFILE_FREE);
+        pool_device_free(d_qDensity);
+        profile.TPSTOP(QUDA_PROFILE_FREE);
+      }
+    }
+
     if (param.compute_polyakov_loop) { gaugePolyakovLoop(param.ploop, u, 3, profile); }
 
     if (param.compute_gauge_loop_trace) {
@@ -52,56 +88,6 @@ namespace quda
 
       for (int i = 0; i < param.num_paths; i++) { memcpy(param.traces + i, &loop_traces[i], sizeof(Complex)); }
     }
-
-    // no point constructing Fmunu unless we are going to use it
-    if (!param.compute_qcharge && !param.compute_qcharge_density) return;
-
-    // create the Fmunu field
-    profile.TPSTART(QUDA_PROFILE_INIT);
-    // u is an extended field we need to shrink for the Fmunu field
-    lat_dim_t x;
-    for (int i = 0; i < 4; i++) x[i] = u.X()[i] - 2 * u.R()[i];
-    GaugeFieldParam tensorParam(x, u.Precision(), QUDA_RECONSTRUCT_NO, 0, QUDA_TENSOR_GEOMETRY);
-    tensorParam.location = QUDA_CUDA_FIELD_LOCATION;
-    tensorParam.siteSubset = QUDA_FULL_SITE_SUBSET;
-    tensorParam.order = QUDA_FLOAT2_GAUGE_ORDER;
-    tensorParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
-    cudaGaugeField gaugeFmunu(tensorParam);
-    profile.TPSTOP(QUDA_PROFILE_INIT);
-
-    profile.TPSTART(QUDA_PROFILE_COMPUTE);
-    computeFmunu(gaugeFmunu, u);
-    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
-    profile.TPSTOP(QUDA_PROFILE_TOTAL);
-
-    if (param.compute_qcharge || param.compute_qcharge_density) {
-      profile.TPSTART(QUDA_PROFILE_TOTAL);
-      profile.TPSTART(QUDA_PROFILE_INIT);
-      if (param.compute_qcharge_density && !param.qcharge_density)
-        errorQuda("Charge density requested, but destination field not defined");
-      size_t size = gaugeFmunu.Volume() * gaugeFmunu.Precision();
-      void *d_qDensity = param.compute_qcharge_density ? pool_device_malloc(size) : nullptr;
-      profile.TPSTOP(QUDA_PROFILE_INIT);
-
-      profile.TPSTART(QUDA_PROFILE_COMPUTE);
-
-      if (param.compute_qcharge_density)
-        computeQChargeDensity(param.energy, param.qcharge, d_qDensity, gaugeFmunu);
-      else
-        computeQCharge(param.energy, param.qcharge, gaugeFmunu);
-
-      profile.TPSTOP(QUDA_PROFILE_COMPUTE);
-
-      if (param.compute_qcharge_density) {
-        profile.TPSTART(QUDA_PROFILE_D2H);
-        qudaMemcpy(param.qcharge_density, d_qDensity, size, qudaMemcpyDeviceToHost);
-        profile.TPSTOP(QUDA_PROFILE_D2H);
-
-        profile.TPSTART(QUDA_PROFILE_FREE);
-        pool_device_free(d_qDensity);
-        profile.TPSTOP(QUDA_PROFILE_FREE);
-      }
-    }
   }
 
 } // namespace quda
@@ -0,0 +1,95 @@
+#include <gauge_field.h>
+#include <instantiate.h>
+#include <tunable_reduction.h>
+#include <kernels/gauge_observable_fused.cuh>
+
+namespace quda
+{
+
+  template <typename Float, int nColor, QudaReconstructType recon> class GaugeObservablesFused : TunableReduction2D
+  {
+    const GaugeField &u;
+    double *plaq;
+    double *energy;
+    double &qcharge;
+    void *qdensity;
+    bool density;
+
+  public:
+    GaugeObservablesFused(const GaugeField &u, double plaq[3], double energy[3], double &qcharge, void *qdensity) :
+      TunableReduction2D(u),
+      u(u),
+      plaq(plaq),
+      energy(energy),
+      qcharge(qcharge),
+      qdensity(qdensity),
+      density(qdensity != nullptr)
+    {
+      if (!u.isNative() && u.Order() != QUDA_QDP_GAUGE_ORDER)
+        errorQuda("Gauge observables only supported on native or QDP ordered fields");
+      for (int d = 0; d < 4; d++)
+        if (comm_dim_partitioned(d) && u.R()[d] == 0)
+          errorQuda("Gauge field must be extended in partitioned dimension %d", d);
+      strcat(aux, comm_dim_partitioned_string());
+      if (density) strcat(aux, ",density");
+      apply(device::get_default_stream());
+    }
+
+    template <bool compute_density, bool native>
+    using Arg = GaugeObservablesArg<Float, nColor, recon, compute_density, native>;
+
+    template <bool native>
+    void launch_observables(array<double, 5> &result, const TuneParam &tp, const qudaStream_t &stream)
+    {
+      if (!density) {
+        Arg<false, native> arg(u, static_cast<Float *>(qdensity));
+        launch<GaugeObservables, true>(result, tp, stream, arg);
+      } else {
+        Arg<true, native> arg(u, static_cast<Float *>(qdensity));
+        launch<GaugeObservables, true>(result, tp, stream, arg);
+      }
+    }
+
+    void apply(const qudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+
+      array<double, 5> result {};
+      if (u.isNative())
+        launch_observables<true>(result, tp, stream);
+      else
+        launch_observables<false>(result, tp, stream);
+
+      double volume = 2.0 * u.LocalVolumeCB() * comm_size();
+      for (int i = 0; i < 2; i++) {
+        plaq[i + 1] = result[i] / (9. * volume);
+        energy[i + 1] = result[i + 2] / volume;
+      }
+      plaq[0] = 0.5 * (plaq[1] + plaq[2]);
+      energy[0] = energy[1] + energy[2];
+      qcharge = result[4];
+    }
+
+    long long flops() const
+    {
+      auto Nc = u.Ncolor();
+      auto mm_flops = 8 * Nc * Nc * (Nc - 2);
+      auto traceless_flops = (Nc * Nc + Nc + 1);
+      auto energy_flops = 6 * (mm_flops + traceless_flops + Nc);
+      auto q_flops = 3 * mm_flops + 2 * Nc + 2;
+      return 2 * u.LocalVolumeCB() * ((2430 + 36 + Nc) * 6 + energy_flops + q_flops);
+    }
+
+    long long bytes() const
+    {
+      auto link_bytes = u.Reconstruct() * u.Precision();
+      return 2 * u.LocalVolumeCB() * (16 * 6 * link_bytes + density * u.Precision());
+    }
+  };
+
+  void gaugeObservablesFused(const GaugeField &u, double plaq[3], double energy[3], double &qcharge, void *qdensity)
+  {
+    instantiate<GaugeObservablesFused, ReconstructGauge>(u, plaq, energy, qcharge, qdensity);
+  }
+
+} // namespace quda
@@ -11,16 +11,22 @@ namespace quda {
   class GaugeGauss : TunableKernel2D
   {
     GaugeField &U;
-    RNG &rng;
+    RNG *rng;
+    unsigned long long seed;
     Float sigma;
     bool group;
     unsigned int minThreads() const { return U.VolumeCB(); }
 
   public:
-    GaugeGauss(GaugeField &U, RNG &rng, double sigma) :
+    /**
+       @brief Generate the field with either the stateful generator
+       rng, or if rng is nullptr the counter-based generator keyed by seed
+     */
+    GaugeGauss(GaugeField &U, RNG *rng, unsigned long long seed, double sigma) :
       TunableKernel2D(U, 2),
       U(U),
       rng(rng),
+      seed(seed),
       sigma(static_cast<Float>(sigma)),
       group(U.LinkType() == QUDA_SU3_LINKS)
     {
@@ -30,6 +36,7 @@ namespace quda {
         logQuda(QUDA_SUMMARIZE, "Creating Gaussian distributed Lie algebra field\n");
       }
       strcat(aux, group ? ",lie_group" : "lie_algebra");
+      if (!rng) strcat(aux, ",counter");
       apply(device::get_default_stream());
     }
 
@@ -37,25 +44,39 @@ namespace quda {
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (group) {
-        launch<GaussGauge>(tp, stream, GaugeGaussArg<Float, nColor, recon, true>(U, rng.State(), sigma));
+        launch_gauss<true>(tp, stream);
       } else {
-        launch<GaussGauge>(tp, stream, GaugeGaussArg<Float, nColor, recon, false>(U, rng.State(), sigma));
+        launch_gauss<false>(tp, stream);
       }
     }
 
+    template <bool group> void launch_gauss(const TuneParam &tp, const qudaStream_t &stream)
+    {
+      if (rng)
+        launch<GaussGauge>(tp, stream, GaugeGaussArg<Float, nColor, recon, group>(U, rng->State(), sigma));
+      else
+        launch<GaussGauge>(tp, stream, GaugeGaussArg<Float, nColor, recon, group, true>(U, nullptr, sigma, seed));
+    }
+
     long long bytes() const { return U.Bytes(); }
 
-    void preTune() { rng.backup(); }
-    void postTune() { rng.restore(); }
+    void preTune()
+    {
+      if (rng) rng->backup();
+    }
+    void postTune()
+    {
+      if (rng) rng->restore();
+    }
   };
 
-  void gaugeGauss(GaugeField &U, RNG &rng, double sigma)
+  static void gaugeGauss(GaugeField &U, RNG *rng, unsigned long long seed, double sigma)
   {
     if (!U.isNative()) errorQuda("Order %d with %d reconstruct not supported", U.Order(), U.Reconstruct());
     if (U.LinkType() != QUDA_SU3_LINKS && U.LinkType() != QUDA_MOMENTUM_LINKS)
       errorQuda("Unexpected link type %d", U.LinkType());
 
-    instantiate<GaugeGauss, ReconstructFull>(U, rng, sigma);
+    instantiate<GaugeGauss, ReconstructFull>(U, rng, seed, sigma);
 
     // ensure multi-gpu consistency if required
     if (U.GhostExchange() == QUDA_GHOST_EXCHANGE_EXTENDED) {
@@ -65,10 +86,8 @@ namespace quda {
     }
   }
 
-  void gaugeGauss(GaugeField &U, unsigned long long seed, double sigma)
-  {
-    RNG randstates(U, seed);
-    gaugeGauss(U, randstates, sigma);
-  }
+  void gaugeGauss(GaugeField &U, RNG &rng, double sigma) { gaugeGauss(U, &rng, 0, sigma); }
+
+  void gaugeGauss(GaugeField &U, unsigned long long seed, double sigma) { gaugeGauss(U, nullptr, seed, sigma); }
 
 }
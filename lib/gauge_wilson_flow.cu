@@ -13,6 +13,7 @@ namespace quda {
     GaugeField &out;
     GaugeField &temp;
     const GaugeField &in;
+    GaugeField *err;
     const real epsilon;
     const QudaGaugeSmearType wflow_type;
     const WFlowStepType step_type;
@@ -24,11 +25,13 @@ namespace quda {
     int blockMin() const { return 8; }
 
   public:
-    GaugeWFlowStep(GaugeField &out, GaugeField &temp, const GaugeField &in, const double epsilon, const QudaGaugeSmearType wflow_type, const WFlowStepType step_type) :
+    GaugeWFlowStep(GaugeField &out, GaugeField &temp, const GaugeField &in, const double epsilon,
+                   const QudaGaugeSmearType wflow_type, const WFlowStepType step_type, GaugeField *err = nullptr) :
       TunableKernel3D(in, 2, wflow_dim),
       out(out),
       temp(temp),
       in(in),
+      err(err),
       epsilon(epsilon),
       wflow_type(wflow_type),
       step_type(step_type)
@@ -45,6 +48,7 @@ namespace quda {
       case WFLOW_STEP_VT: strcat(aux, "_VT"); break;
       default : errorQuda("Unknown Wilson Flow step type %d", step_type);
       }
+      if (err) strcat(aux, ",adaptive");
 
       apply(device::get_default_stream());
     }
@@ -60,26 +64,26 @@ namespace quda {
       case QUDA_GAUGE_SMEAR_WILSON_FLOW:
         switch (step_type) {
         case WFLOW_STEP_W1:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_W1>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_W1>(out, temp, in, epsilon, err));
           break;
         case WFLOW_STEP_W2:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_W2>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_W2>(out, temp, in, epsilon, err));
           break;
         case WFLOW_STEP_VT:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_VT>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_WILSON_FLOW, WFLOW_STEP_VT>(out, temp, in, epsilon, err));
           break;
         }
         break;
       case QUDA_GAUGE_SMEAR_SYMANZIK_FLOW:
         switch (step_type) {
         case WFLOW_STEP_W1:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_W1>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_W1>(out, temp, in, epsilon, err));
           break;
         case WFLOW_STEP_W2:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_W2>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_W2>(out, temp, in, epsilon, err));
           break;
         case WFLOW_STEP_VT:
-          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_VT>(out, temp, in, epsilon));
+          launch<WFlow>(tp, stream, Arg<QUDA_GAUGE_SMEAR_SYMANZIK_FLOW, WFLOW_STEP_VT>(out, temp, in, epsilon, err));
           break;
         }
         break;
@@ -87,8 +91,19 @@ namespace quda {
       }
     }
 
-    void preTune() { out.backup(); temp.backup(); }
-    void postTune() { out.restore(); temp.restore(); }
+    void preTune()
+    {
+      out.backup();
+      temp.backup();
+      if (err) err->backup();
+    }
+
+    void postTune()
+    {
+      out.restore();
+      temp.restore();
+      if (err) err->restore();
+    }
 
     long long flops() const
     {
@@ -113,7 +128,9 @@ namespace quda {
       default : errorQuda("Unknown Wilson Flow type");
       }
       auto temp_io = step_type == WFLOW_STEP_W2 ? 2 : step_type == WFLOW_STEP_VT ? 1 : 0;
-      return ((1 + (wflow_dim - 1) * links) * in.Bytes() + out.Bytes() + temp_io * temp.Bytes());
+      auto err_io = step_type == WFLOW_STEP_W2 ? 1 : step_type == WFLOW_STEP_VT ? 2 : 0;
+      return ((1 + (wflow_dim - 1) * links) * in.Bytes() + out.Bytes() + temp_io * temp.Bytes()
+              + (err ? err_io * err->Bytes() : 0));
     }
   }; // GaugeWFlowStep
 
@@ -140,4 +157,33 @@ namespace quda {
     out.exchangeExtendedGhost(out.R(), false);
   }
 
+  double WFlowStepAdaptive(GaugeField &out, GaugeField &stage, GaugeField &temp, GaugeField &err,
+                           const GaugeField &in, const double epsilon, const QudaGaugeSmearType smear_type)
+  {
+    checkPrecision(out, stage, temp, err, in);
+    checkReconstruct(out, stage, in);
+    checkNative(out, stage, in);
+    if (temp.Reconstruct() != QUDA_RECONSTRUCT_NO || err.Reconstruct() != QUDA_RECONSTRUCT_NO)
+      errorQuda("Temporary vectors must not use reconstruct");
+    if (!(smear_type == QUDA_GAUGE_SMEAR_WILSON_FLOW || smear_type == QUDA_GAUGE_SMEAR_SYMANZIK_FLOW))
+      errorQuda("Gauge smear type %d not supported for flow kernels", smear_type);
+
+    // As WFlowStep, but the intermediate stage is kept in stage so
+    // that the input field survives for a rejected step
+
+    // Step W1
+    instantiate<GaugeWFlowStep>(out, temp, in, epsilon, smear_type, WFLOW_STEP_W1);
+    out.exchangeExtendedGhost(out.R(), false);
+
+    // Step W2, also forming the second-order solution in err
+    instantiate<GaugeWFlowStep>(stage, temp, out, epsilon, smear_type, WFLOW_STEP_W2, &err);
+    stage.exchangeExtendedGhost(stage.R(), false);
+
+    // Step Vt, leaving the difference to the second-order solution in err
+    instantiate<GaugeWFlowStep>(out, temp, stage, epsilon, smear_type, WFLOW_STEP_VT, &err);
+    out.exchangeExtendedGhost(out.R(), false);
+
+    return err.abs_max();
+  }
+
 }
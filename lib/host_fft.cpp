@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+#include <host_fft.h>
+
+namespace quda
+{
+
+  /**
+     @brief Create the plan of a 1-d transform: the length is
+     decomposed into its prime factors, with the twiddle factors
+     taken from a table of the n-th roots of unity
+   */
+  static void setPlan1D(HostFFTPlan1D &plan, int n)
+  {
+    if (n < 1) errorQuda("Invalid transform length %d", n);
+    plan.n = n;
+    plan.factors.clear();
+    int m = n;
+    for (int p = 2; p * p <= m; p++) {
+      while (m % p == 0) {
+        plan.factors.push_back(p);
+        m /= p;
+      }
+    }
+    if (m > 1) plan.factors.push_back(m);
+
+    plan.root.resize(n);
+    for (int k = 0; k < n; k++) plan.root[k] = std::polar(1.0, -2.0 * M_PI * k / n);
+  }
+
+  /**
+     @brief Recursive decimation-in-time transform of length n of the
+     strided input into the contiguous output, splitting off the
+     radix factors[f] at each level
+   */
+  template <typename T>
+  static void fft(const HostFFTPlan1D &plan, const std::complex<T> *in, std::complex<T> *out, int n, int stride, int f,
+                  bool inverse, std::vector<std::complex<T>> &tmp)
+  {
+    if (n == 1) {
+      out[0] = in[0];
+      return;
+    }
+
+    const int p = plan.factors[f];
+    const int m = n / p;
+    for (int q = 0; q < p; q++) fft(plan, in + q * stride, out + q * m, m, stride * p, f + 1, inverse, tmp);
+
+    // combine the p sub-transforms: X[k + r m] = sum_q w_n^(q (k + r m)) Y_q[k]
+    const int step = plan.n / n;
+    tmp.resize(p);
+    for (int k = 0; k < m; k++) {
+      for (int q = 0; q < p; q++) tmp[q] = out[q * m + k];
+      for (int r = 0; r < p; r++) {
+        const int j = k + r * m;
+        std::complex<T> sum = tmp[0];
+        for (int q = 1; q < p; q++) {
+          auto w = plan.root[((static_cast<long>(q) * j) % n) * step];
+          sum += tmp[q] * std::complex<T>(w.real(), inverse ? -w.imag() : w.imag());
+        }
+        out[j] = sum;
+      }
+    }
+  }
+
+  void SetPlanFFT2DMany(HostFFTPlan &plan, int4 size, int dim, QudaPrecision precision)
+  {
+    switch (dim) {
+    case 0: // Z-T planes, outer-most dimension is first
+      setPlan1D(plan.plan[0], size.w);
+      setPlan1D(plan.plan[1], size.z);
+      plan.batch = size.x * size.y;
+      break;
+    case 1: // X-Y planes, outer-most dimension is first
+      setPlan1D(plan.plan[0], size.y);
+      setPlan1D(plan.plan[1], size.x);
+      plan.batch = size.z * size.w;
+      break;
+    default: errorQuda("Invalid plan dimension %d", dim);
+    }
+    plan.precision = precision;
+  }
+
+  template <typename T> static void applyFFT(HostFFTPlan &plan, complex<T> *data_in, complex<T> *data_out, int direction)
+  {
+    if (plan.precision != static_cast<QudaPrecision>(sizeof(T)))
+      errorQuda("Plan precision %d does not match data precision %lu", plan.precision, sizeof(T));
+
+    const bool inverse = direction > 0;
+    const int n0 = plan.plan[0].n;
+    const int n1 = plan.plan[1].n;
+    auto in = reinterpret_cast<const std::complex<T> *>(data_in);
+    auto out = reinterpret_cast<std::complex<T> *>(data_out);
+
+#pragma omp parallel
+    {
+      std::vector<std::complex<T>> line(std::max(n0, n1));
+      std::vector<std::complex<T>> work(std::max(n0, n1));
+      std::vector<std::complex<T>> tmp;
+
+#pragma omp for schedule(static)
+      for (int b = 0; b < plan.batch; b++) {
+        const std::complex<T> *a_in = in + static_cast<size_t>(b) * n0 * n1;
+        std::complex<T> *a = out + static_cast<size_t>(b) * n0 * n1;
+
+        // transform the rows (inner dimension), the input may alias the output
+        for (int r = 0; r < n0; r++) {
+          for (int c = 0; c < n1; c++) line[c] = a_in[r * n1 + c];
+          fft(plan.plan[1], line.data(), a + r * n1, n1, 1, 0, inverse, tmp);
+        }
+
+        // transform the columns (outer dimension)
+        for (int c = 0; c < n1; c++) {
+          fft(plan.plan[0], a + c, work.data(), n0, n1, 0, inverse, tmp);
+          for (int r = 0; r < n0; r++) a[r * n1 + c] = work[r];
+        }
+      }
+    }
+  }
+
+  void ApplyFFT(HostFFTPlan &plan, complex<float> *data_in, complex<float> *data_out, int direction)
+  {
+    applyFFT(plan, data_in, data_out, direction);
+  }
+
+  void ApplyFFT(HostFFTPlan &plan, complex<double> *data_in, complex<double> *data_out, int direction)
+  {
+    applyFFT(plan, data_in, data_out, direction);
+  }
+
+  void FFTDestroyPlan(HostFFTPlan &plan) { plan = HostFFTPlan(); }
+
+} // namespace quda
@@ -76,6 +76,8 @@ void invert_multishift_quda_(void *h_x, void *hp_b, QudaInvertParam *param)
 
 void flush_chrono_quda_(int *index) { flushChronoQuda(*index); }
 
+void flush_vector_io_quda_(int *n_failed) { *n_failed = flushVectorIOQuda(); }
+
 void register_pinned_quda_(void *ptr, size_t *bytes) { register_pinned(ptr, *bytes); }
 
 void unregister_pinned_quda_(void *ptr) { unregister_pinned(ptr); }
@@ -270,3 +272,19 @@ static int bqcd_rank_from_coords(const int *coords, void *fdata)
 void comm_set_gridsize_(int *grid) { initCommsGridQuda(4, grid, bqcd_rank_from_coords, static_cast<void *>(grid)); }
 
 void plaq_quda_(double plaq[3]) { plaqQuda(plaq); }
+
+void compute_gauge_fixing_fft_quda_(void *gauge, int *gauge_dir, int *n_steps, int *verbose_interval, double *alpha,
+                                    int *autotune, double *tolerance, int *stop_w_theta, QudaGaugeParam *param,
+                                    double timeinfo[3])
+{
+  computeGaugeFixingFFTQuda(gauge, *gauge_dir, *n_steps, *verbose_interval, *alpha, *autotune, *tolerance,
+                            *stop_w_theta, param, timeinfo);
+}
+
+void compute_gauge_fixing_fft_cg_quda_(void *gauge, int *gauge_dir, int *n_steps, int *verbose_interval,
+                                       double *alpha, double *tolerance, int *stop_w_theta, QudaGaugeParam *param,
+                                       double timeinfo[3])
+{
+  computeGaugeFixingFFTCGQuda(gauge, *gauge_dir, *n_steps, *verbose_interval, *alpha, *tolerance, *stop_w_theta,
+                              param, timeinfo);
+}
@@ -3,6 +3,8 @@
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <limits>
+#include <map>
 #include <sys/time.h>
 #include <complex.h>
 
@@ -18,6 +20,9 @@
 #include <dslash_quda.h>
 #include <invert_quda.h>
 #include <eigensolve_quda.h>
+#include <vector_io.h>
+#include <gauge_mmap.h>
+#include <content_hash.h>
 #include <color_spinor_field.h>
 #include <clover_field.h>
 #include <llfat_quda.h>
@@ -60,6 +65,7 @@ void checkBLASParam(QudaBLASParam &param) { checkBLASParam(&param); }
 #undef PRINT_PARAM
 
 #include <gauge_tools.h>
+#include <flow_recorder.h>
 #include <contract_quda.h>
 #include <momentum.h>
 
@@ -111,6 +117,17 @@ std::vector<ColorSpinorField> solutionResident;
 // each entry is one p
 std::vector<std::vector<ColorSpinorField>> chronoResident(QUDA_MAX_CHRONO);
 
+// operator applied to each vector of the chronological basis, together
+// with the Gram matrix of the basis, retained between solves so that
+// only newly added vectors need the operator applied
+struct ChronoCache {
+  std::vector<ColorSpinorField> Ap; // operator applied to each basis vector
+  std::vector<Complex> gram;        // Gram matrix of the basis (row major)
+  std::vector<bool> stale;          // whether each basis vector needs its Ap and Gram entries recomputed
+  uint64_t key = 0;                 // identifies the operator the cache was built with
+};
+std::vector<ChronoCache> chronoCache(QUDA_MAX_CHRONO);
+
 // Mapped memory buffer used to hold unitarization failures
 static int *num_failures_h = nullptr;
 static int *num_failures_d = nullptr;
@@ -518,11 +535,137 @@ void initQuda(int dev)
   initQudaMemory();
 }
 
+void *mapGaugeQuda(const char *filename, QudaGaugeParam *param)
+{
+  if (!comms_initialized) errorQuda("Communications must be initialized before mapping a gauge field");
+
+  QudaPrecision precision;
+  lat_dim_t X;
+  const void *gauge = mapGaugeFile(filename, precision, X);
+
+  for (int d = 0; d < 4; d++) {
+    if (X[d] != param->X[d] * comm_dim(d))
+      errorQuda("Global lattice dimension %d of %s is %d, expected %d", d, filename, X[d], param->X[d] * comm_dim(d));
+  }
+
+  param->cpu_prec = precision;
+  param->gauge_order = QUDA_ILDG_GAUGE_ORDER;
+  return const_cast<void *>(gauge);
+}
+
+void unmapGaugeQuda(void *h_gauge) { unmapGaugeFile(h_gauge); }
+
 // This is a flag used to signal when we have downloaded new gauge
 // field.  Set by loadGaugeQuda and consumed by loadCloverQuda as one
 // possible flag to indicate we need to recompute the clover field
 static bool invalidate_clover = true;
 
+// Counter that is incremented whenever the resident gauge or clover
+// fields change, used to invalidate state derived from them
+static uint64_t resident_epoch = 0;
+
+// Content hashes of the most recently loaded host gauge fields (per
+// link type) and clover field, together with the resident field they
+// were loaded into.  These allow loadGaugeQuda and loadCloverQuda to
+// skip the reorder, download and sloppy copies when called again with
+// unchanged fields.
+struct LoadCacheEntry {
+  uint64_t hash;
+  const GaugeField *resident;
+};
+static std::map<QudaLinkType, LoadCacheEntry> gauge_load_cache;
+static uint64_t clover_load_hash = 0;
+static bool clover_computed = false;
+
+/**
+   @brief Whether to use content hashing to skip reloading unchanged
+   gauge and clover fields.  Enabled by default, it can be disabled by
+   setting the environment variable QUDA_ENABLE_LOAD_CACHE=0.
+*/
+static bool loadCacheEnabled()
+{
+  static bool init = false;
+  static bool enabled = true;
+  if (!init) {
+    char *enable_str = getenv("QUDA_ENABLE_LOAD_CACHE");
+    if (enable_str && strcmp(enable_str, "0") == 0) enabled = false;
+    init = true;
+  }
+  return enabled;
+}
+
+/**
+   @brief Invalidate the load cache.  This must be called whenever
+   the resident gauge fields are freed or modified other than through
+   loadGaugeQuda.
+*/
+static void invalidateLoadCache()
+{
+  gauge_load_cache.clear();
+  invalidate_clover = true;
+  resident_epoch++;
+}
+
+/**
+   @brief Compute the hash of a host gauge field and the parameters
+   that determine the resident fields created from it.  The hash is
+   seeded with the rank and combined across all processes, so all
+   processes agree on whether the field has changed.
+*/
+static uint64_t hostGaugeHash(const GaugeField &u, const QudaGaugeParam &p)
+{
+  double meta[] = {double(p.X[0]),
+                   double(p.X[1]),
+                   double(p.X[2]),
+                   double(p.X[3]),
+                   p.anisotropy,
+                   p.tadpole_coeff,
+                   p.scale,
+                   double(p.type),
+                   double(p.gauge_order),
+                   double(p.t_boundary),
+                   double(p.cpu_prec),
+                   double(p.cuda_prec),
+                   double(p.reconstruct),
+                   double(p.cuda_prec_sloppy),
+                   double(p.reconstruct_sloppy),
+                   double(p.cuda_prec_refinement_sloppy),
+                   double(p.reconstruct_refinement_sloppy),
+                   double(p.cuda_prec_precondition),
+                   double(p.reconstruct_precondition),
+                   double(p.cuda_prec_eigensolver),
+                   double(p.reconstruct_eigensolver),
+                   double(p.gauge_fix),
+                   double(p.ga_pad),
+                   double(p.staggered_phase_type),
+                   double(p.staggered_phase_applied),
+                   p.i_mu,
+                   double(p.overlap),
+                   double(p.gauge_offset),
+                   double(p.site_size)};
+  uint64_t hash = content_hash(meta, sizeof(meta), comm_rank());
+
+  if (u.Order() == QUDA_QDP_GAUGE_ORDER || u.Order() == QUDA_QDPJIT_GAUGE_ORDER) {
+    for (int d = 0; d < u.Geometry(); d++)
+      hash = content_hash(static_cast<void *const *>(u.Gauge_p())[d], u.Bytes() / u.Geometry(), hash);
+  } else {
+    hash = content_hash(u.Gauge_p(), u.Bytes(), hash);
+  }
+
+  comm_allreduce_xor(hash);
+  return hash;
+}
+
+static const GaugeField *residentGauge(QudaLinkType type)
+{
+  switch (type) {
+  case QUDA_WILSON_LINKS: return gaugePrecise;
+  case QUDA_ASQTAD_FAT_LINKS: return gaugeFatPrecise;
+  case QUDA_ASQTAD_LONG_LINKS: return gaugeLongPrecise;
+  default: return nullptr;
+  }
+}
+
 void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
 {
   profileGauge.TPSTART(QUDA_PROFILE_TOTAL);
@@ -536,26 +679,33 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
   // Set the specific input parameters and create the cpu gauge field
   GaugeFieldParam gauge_param(*param, h_gauge);
 
-  if (gauge_param.order <= 4) gauge_param.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+  if (gauge_param.order <= 4 || gauge_param.order == QUDA_ILDG_GAUGE_ORDER)
+    gauge_param.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
   GaugeField *in = (param->location == QUDA_CPU_FIELD_LOCATION) ?
     static_cast<GaugeField*>(new cpuGaugeField(gauge_param)) :
     static_cast<GaugeField*>(new cudaGaugeField(gauge_param));
 
-  if (in->Order() == QUDA_BQCD_GAUGE_ORDER) {
-    static size_t checksum = SIZE_MAX;
-    size_t in_checksum = in->checksum(true);
-    if (in_checksum == checksum) {
+  // skip the reload if neither the host field nor the parameters have changed since the last load
+  bool cacheable = loadCacheEnabled() && param->location == QUDA_CPU_FIELD_LOCATION && !param->use_resident_gauge
+    && param->type != QUDA_SMEARED_LINKS && in->Order() != QUDA_ILDG_GAUGE_ORDER;
+  uint64_t load_hash = 0;
+  if (cacheable) {
+    load_hash = hostGaugeHash(*in, *param);
+    auto entry = gauge_load_cache.find(param->type);
+    if (entry != gauge_load_cache.end() && entry->second.hash == load_hash && residentGauge(param->type)
+        && entry->second.resident == residentGauge(param->type)) {
       if (getVerbosity() >= QUDA_VERBOSE)
-        printfQuda("Gauge field unchanged - using cached gauge field %lu\n", checksum);
+        printfQuda("Gauge field unchanged - using cached gauge field %lx\n", load_hash);
       profileGauge.TPSTOP(QUDA_PROFILE_INIT);
       profileGauge.TPSTOP(QUDA_PROFILE_TOTAL);
       delete in;
-      invalidate_clover = false;
+      if (param->type == QUDA_WILSON_LINKS) invalidate_clover = false;
       return;
     }
-    checksum = in_checksum;
-    invalidate_clover = true;
   }
+  gauge_load_cache.erase(param->type);
+  if (param->type == QUDA_WILSON_LINKS) invalidate_clover = true;
+  resident_epoch++;
 
   // free any current gauge field before new allocations to reduce memory overhead
   switch (param->type) {
@@ -764,6 +914,8 @@ void loadGaugeQuda(void *h_gauge, QudaGaugeParam *param)
       errorQuda("Invalid gauge type %d", param->type);
   }
 
+  if (cacheable) gauge_load_cache[param->type] = {load_hash, precise};
+
   profileGauge.TPSTART(QUDA_PROFILE_FREE);
   delete in;
   profileGauge.TPSTOP(QUDA_PROFILE_FREE);
@@ -864,13 +1016,32 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
 
   profileClover.TPSTOP(QUDA_PROFILE_INIT);
 
+  // a downloaded clover field has changed if its content (or that of its inverse) has changed, while a
+  // computed one has changed if the gauge field has
+  bool clover_changed = invalidate_clover || !clover_computed;
+  uint64_t load_hash = 0;
+  if (!device_calc) {
+    if (loadCacheEnabled() && inv_param->clover_location == QUDA_CPU_FIELD_LOCATION
+        && inv_param->clover_order == QUDA_PACKED_CLOVER_ORDER && !inv_param->return_clover
+        && !inv_param->return_clover_inverse) {
+      double meta[] = {double(inv_param->clover_cpu_prec), double(inv_param->clover_cuda_prec),
+                       double(inv_param->compute_clover_inverse), double(inv_param->compute_clover_trlog)};
+      size_t bytes = gaugePrecise->Volume() * 72 * inv_param->clover_cpu_prec;
+      load_hash = content_hash(meta, sizeof(meta), comm_rank());
+      load_hash = content_hash(h_clover, bytes, load_hash);
+      if (h_clovinv) load_hash = content_hash(h_clovinv, bytes, load_hash);
+      comm_allreduce_xor(load_hash);
+    }
+    clover_changed = load_hash == 0 || load_hash != clover_load_hash;
+  }
+
   bool clover_update = false;
   // If either of the clover params have changed, trigger a recompute
   double csw_old = cloverPrecise ? cloverPrecise->Csw() : 0.0;
   double coeff_old = cloverPrecise ? cloverPrecise->Coeff() : 0.0;
   double rho_old = cloverPrecise ? cloverPrecise->Rho() : 0.0;
   double mu2_old = cloverPrecise ? cloverPrecise->Mu2() : 0.0;
-  if (!cloverPrecise || invalidate_clover || inv_param->clover_coeff != coeff_old || inv_param->clover_csw != csw_old
+  if (!cloverPrecise || clover_changed || inv_param->clover_coeff != coeff_old || inv_param->clover_csw != csw_old
       || inv_param->clover_csw != csw_old || inv_param->clover_rho != rho_old
       || 4 * inv_param->kappa * inv_param->kappa * inv_param->mu * inv_param->mu != mu2_old)
     clover_update = true;
@@ -880,6 +1051,9 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
     if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Creating new clover field\n");
     freeSloppyCloverQuda();
     if (cloverPrecise) delete cloverPrecise;
+    clover_load_hash = load_hash;
+    clover_computed = device_calc;
+    resident_epoch++;
 
     profileClover.TPSTART(QUDA_PROFILE_INIT);
     cloverPrecise = new CloverField(clover_param);
@@ -921,7 +1095,7 @@ void loadCloverQuda(void *h_clover, void *h_clovinv, QudaInvertParam *inv_param)
       profileClover.TPSTOP(QUDA_PROFILE_COMPUTE);
     }
   } else {
-    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Gauge field unchanged - using cached clover field\n");
+    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Clover field unchanged - using cached clover field\n");
   }
 
   // if requested, copy back the clover / inverse field
@@ -1100,6 +1274,8 @@ void freeGaugeQuda(void)
 {
   if (!initialized) errorQuda("QUDA not initialized");
 
+  invalidateLoadCache();
+
   freeSloppyGaugeQuda();
 
   if (gaugePrecise) delete gaugePrecise;
@@ -1373,6 +1549,9 @@ void freeCloverQuda(void)
   freeSloppyCloverQuda();
   if (cloverPrecise) delete cloverPrecise;
   cloverPrecise = nullptr;
+  clover_load_hash = 0;
+  clover_computed = false;
+  resident_epoch++;
 }
 
 void flushChronoQuda(int i)
@@ -1381,6 +1560,13 @@ void flushChronoQuda(int i)
     errorQuda("Requested chrono index %d is outside of max %d\n", i, QUDA_MAX_CHRONO);
 
   chronoResident[i].clear();
+  chronoCache[i] = {};
+}
+
+int flushVectorIOQuda(void)
+{
+  static TimeProfile profileVectorIO("flushVectorIOQuda");
+  return VectorIO::flush(profileVectorIO);
 }
 
 void endQuda(void)
@@ -1389,6 +1575,10 @@ void endQuda(void)
 
   if (!initialized) return;
 
+  // complete any outstanding asynchronous vector I/O
+  int failed_saves = VectorIO::flush(profileEnd);
+  if (failed_saves > 0) errorQuda("%d asynchronous vector saves failed", failed_saves);
+
   freeGaugeQuda();
   freeCloverQuda();
 
@@ -1405,6 +1595,7 @@ void endQuda(void)
   blas_lapack::generic::destroy();
   blas_lapack::native::destroy();
   reducer::destroy();
+  freePathTrieCache();
 
   pool::flush_pinned();
   pool::flush_device();
@@ -2310,7 +2501,14 @@ void eigensolveQuda(void **host_evecs, double _Complex *host_evals, QudaEigParam
   std::vector<ColorSpinorField> kSpace(n_eig);
   for (int i = 0; i < n_eig; i++) {
     kSpace[i] = ColorSpinorField(cudaParam);
-    if (i < eig_param->block_size) kSpace[i] = host_evecs_[i];
+    // ChFSI is warm started from the full set of user supplied vectors
+    if (i < eig_param->block_size || eig_param->eig_type == QUDA_EIG_CHFSI) kSpace[i] = host_evecs_[i];
+  }
+
+  // Start reading any eigenvectors from file in the background
+  if (strcmp(eig_param->vec_infile, "") != 0 && !eig_param->arpack_check) {
+    VectorIO io(eig_param->vec_infile, eig_param->io_parity_inflate == QUDA_BOOLEAN_TRUE, true);
+    io.prefetch({kSpace.begin(), kSpace.begin() + eig_param->n_conv});
   }
 
   // Simple vector for eigenvalues.
@@ -2395,6 +2593,92 @@ void eigensolveQuda(void **host_evecs, double _Complex *host_evals, QudaEigParam
   profileEigensolve.TPSTOP(QUDA_PROFILE_TOTAL);
 }
 
+double deflationBenchmarkQuda(QudaInvertParam *param, int n_src, int niter)
+{
+  if (!initialized) errorQuda("QUDA not initialized");
+  if (!param->eig_param) errorQuda("No eigensolver parameters set");
+  if (n_src < 1 || niter < 1) errorQuda("Invalid number of sources %d or iterations %d", n_src, niter);
+
+  auto eig_param = static_cast<QudaEigParam *>(param->eig_param);
+  auto space = static_cast<deflation_space *>(eig_param->preserve_deflation_space);
+  if (!space || space->evecs.size() == 0) errorQuda("No preserved deflation space found");
+  if (space->svd) errorQuda("Benchmarking of SVD deflation is not supported");
+
+  profileEigensolve.TPSTART(QUDA_PROFILE_TOTAL);
+  profileEigensolve.TPSTART(QUDA_PROFILE_INIT);
+
+  pushVerbosity(param->verbosity);
+  checkGauge(param);
+
+  // The operator is only needed to instantiate the eigensolver
+  Dirac *d = nullptr;
+  Dirac *dSloppy = nullptr;
+  Dirac *dPre = nullptr;
+  bool pc_solve = (param->solve_type == QUDA_DIRECT_PC_SOLVE) || (param->solve_type == QUDA_NORMOP_PC_SOLVE);
+  createDirac(d, dSloppy, dPre, *param, pc_solve);
+  DiracMdagM m(*d);
+  auto eig_solve = quda::EigenSolver::create(eig_param, m, profileEigensolve);
+
+  // The sources and solutions are at the solver precision
+  ColorSpinorParam csParam(space->evecs[0]);
+  csParam.create = QUDA_NULL_FIELD_CREATE;
+  csParam.setPrecision(param->cuda_prec, param->cuda_prec, true);
+  std::vector<ColorSpinorField> src(n_src);
+  std::vector<ColorSpinorField> sol(n_src);
+  for (int i = 0; i < n_src; i++) {
+    src[i] = ColorSpinorField(csParam);
+    sol[i] = ColorSpinorField(csParam);
+  }
+  RNG rng(src[0], 1234);
+  for (auto &v : src) spinorNoise(v, rng, QUDA_NOISE_GAUSS);
+
+  profileEigensolve.TPSTOP(QUDA_PROFILE_INIT);
+
+  // tune the deflation kernels outside of the timed region
+  eig_solve->deflate(sol, src, space->evecs, space->evals);
+  qudaDeviceSynchronize();
+
+  profileEigensolve.TPSTART(QUDA_PROFILE_COMPUTE);
+  host_timer_t timer;
+  timer.start();
+  for (int i = 0; i < niter; i++) eig_solve->deflate(sol, src, space->evecs, space->evals);
+  qudaDeviceSynchronize();
+  timer.stop();
+  profileEigensolve.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  // each eigenvector is streamed once by the projection and once by the accumulation
+  int n_defl = eig_param->n_ev_deflate == -1 ? eig_param->n_conv : eig_param->n_ev_deflate;
+  double bytes = 2.0 * n_defl * space->evecs[0].Bytes() * niter;
+  double secs = timer.last();
+  comm_allreduce_sum(bytes);
+  comm_allreduce_max(secs);
+  double gbs = bytes / (secs * 1e9);
+
+  logQuda(QUDA_SUMMARIZE,
+          "Deflating %d sources with %d vectors in precision %d: %e secs per deflation, %g GB/s\n", n_src, n_defl,
+          space->evecs[0].Precision(), secs / niter, gbs);
+
+  profileEigensolve.TPSTART(QUDA_PROFILE_FREE);
+  delete eig_solve;
+  delete d;
+  delete dSloppy;
+  delete dPre;
+  if (!eig_param->preserve_deflation) {
+    delete space;
+    eig_param->preserve_deflation_space = nullptr;
+  }
+  profileEigensolve.TPSTOP(QUDA_PROFILE_FREE);
+
+  popVerbosity();
+
+  // cache is written out even if a long benchmarking job gets interrupted
+  saveTuneCache();
+
+  profileEigensolve.TPSTOP(QUDA_PROFILE_TOTAL);
+
+  return gbs;
+}
+
 multigrid_solver::multigrid_solver(QudaMultigridParam &mg_param, TimeProfile &profile)
   : profile(profile) {
   profile.TPSTART(QUDA_PROFILE_INIT);
@@ -2713,6 +2997,101 @@ void destroyDeflationQuda(void *df) {
   delete static_cast<deflated_solver*>(df);
 }
 
+/**
+   @brief Compute a key identifying the operator used for
+   chronological forecasting, such that the cached A p vectors are
+   recomputed whenever the operator parameters or the resident fields
+   it is built from change.
+*/
+static uint64_t chronoOperatorKey(const QudaInvertParam &p, bool hermitian)
+{
+  double meta[] = {double(p.dslash_type),
+                   p.mass,
+                   p.kappa,
+                   p.mu,
+                   p.tm_rho,
+                   p.epsilon,
+                   double(p.twist_flavor),
+                   p.m5,
+                   double(p.Ls),
+                   p.eofa_shift,
+                   double(p.eofa_pm),
+                   p.mq1,
+                   p.mq2,
+                   p.mq3,
+                   p.clover_coeff,
+                   p.clover_csw,
+                   p.clover_rho,
+                   double(p.matpc_type),
+                   double(p.dagger),
+                   double(p.solve_type),
+                   double(p.solution_type),
+                   double(p.mass_normalization),
+                   double(p.cuda_prec),
+                   double(p.cuda_prec_sloppy),
+                   double(p.chrono_precision),
+                   double(hermitian),
+                   double(resident_epoch)};
+  uint64_t key = content_hash(meta, sizeof(meta));
+  if (p.dslash_type == QUDA_MOBIUS_DWF_DSLASH || p.dslash_type == QUDA_MOBIUS_DWF_EOFA_DSLASH) {
+    key = content_hash(p.b_5, p.Ls * sizeof(p.b_5[0]), key);
+    key = content_hash(p.c_5, p.Ls * sizeof(p.c_5[0]), key);
+  }
+  return key;
+}
+
+/**
+   @brief Form the chronological forecast of the solution from the
+   resident basis.  The operator applications and Gram matrix are
+   cached alongside the basis, so only vectors added since the last
+   forecast have the operator applied, unless the operator has
+   changed in which case the cache is rebuilt.
+   @param[out] x The forecast solution
+   @param[in] b The source vector
+   @param[in] m The operator in the outer precision
+   @param[in] mSloppy The operator in the sloppy precision
+   @param[in] hermitian Whether the operator is Hermitian
+   @param[in] param The invert param
+*/
+static void chronoForecast(ColorSpinorField &x, const ColorSpinorField &b, const DiracMatrix &m,
+                           const DiracMatrix &mSloppy, bool hermitian, QudaInvertParam *param)
+{
+  profileInvert.TPSTART(QUDA_PROFILE_CHRONO);
+
+  auto &basis = chronoResident[param->chrono_index];
+  auto &cache = chronoCache[param->chrono_index];
+
+  auto key = chronoOperatorKey(*param, hermitian);
+  if (cache.stale.size() != basis.size() || cache.key != key) {
+    if (getVerbosity() >= QUDA_VERBOSE) printfQuda("Rebuilding chronological operator cache\n");
+    ColorSpinorParam cs_param(basis[0]);
+    cache = {};
+    cache.Ap.resize(basis.size(), cs_param);
+    cache.gram.resize(basis.size() * basis.size());
+    cache.stale.resize(basis.size(), true);
+    cache.key = key;
+  }
+
+  const DiracMatrix *mat = nullptr;
+  if (param->chrono_precision == param->cuda_prec) {
+    mat = &m;
+  } else if (param->chrono_precision == param->cuda_prec_sloppy) {
+    mat = &mSloppy;
+  } else {
+    errorQuda("Unexpected precision %d for chrono vectors (doesn't match outer %d or sloppy precision %d)",
+              param->chrono_precision, param->cuda_prec, param->cuda_prec_sloppy);
+  }
+  for (auto j = 0u; j < basis.size(); j++)
+    if (cache.stale[j]) (*mat)(cache.Ap[j], basis[j]);
+
+  bool orthogonal = true;
+  bool apply_mat = false;
+  MinResExt mre(m, orthogonal, apply_mat, hermitian, profileInvert);
+  mre(x, b, basis, cache.Ap, cache.gram, cache.stale);
+
+  profileInvert.TPSTOP(QUDA_PROFILE_CHRONO);
+}
+
 void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
 {
   profilerStart(__func__);
@@ -2922,31 +3301,8 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     DiracM m(dirac), mSloppy(diracSloppy), mPre(diracPre), mEig(diracEig);
     SolverParam solverParam(*param);
     // chronological forecasting
-    if (param->chrono_use_resident && chronoResident[param->chrono_index].size() > 0) {
-      profileInvert.TPSTART(QUDA_PROFILE_CHRONO);
-
-      auto &basis = chronoResident[param->chrono_index];
-
-      ColorSpinorParam cs_param(basis[0]);
-      std::vector<ColorSpinorField> Ap(basis.size(), cs_param);
-
-      if (param->chrono_precision == param->cuda_prec) {
-        for (unsigned int j = 0; j < basis.size(); j++) m(Ap[j], basis[j]);
-      } else if (param->chrono_precision == param->cuda_prec_sloppy) {
-        for (unsigned int j = 0; j < basis.size(); j++) mSloppy(Ap[j], basis[j]);
-      } else {
-        errorQuda("Unexpected precision %d for chrono vectors (doesn't match outer %d or sloppy precision %d)",
-                  param->chrono_precision, param->cuda_prec, param->cuda_prec_sloppy);
-      }
-
-      bool orthogonal = true;
-      bool apply_mat = false;
-      bool hermitian = false;
-      MinResExt mre(m, orthogonal, apply_mat, hermitian, profileInvert);
-      mre(*out, *in, basis, Ap);
-
-      profileInvert.TPSTOP(QUDA_PROFILE_CHRONO);
-    }
+    if (param->chrono_use_resident && chronoResident[param->chrono_index].size() > 0)
+      chronoForecast(*out, *in, m, mSloppy, false, param);
 
     Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, mEig, profileInvert);
     (*solve)(*out, *in);
@@ -2957,31 +3313,8 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
     SolverParam solverParam(*param);
 
     // chronological forecasting
-    if (param->chrono_use_resident && chronoResident[param->chrono_index].size() > 0) {
-      profileInvert.TPSTART(QUDA_PROFILE_CHRONO);
-
-      auto &basis = chronoResident[param->chrono_index];
-
-      ColorSpinorParam cs_param(basis[0]);
-      std::vector<ColorSpinorField> Ap(basis.size(), cs_param);
-
-      if (param->chrono_precision == param->cuda_prec) {
-        for (unsigned int j = 0; j < basis.size(); j++) m(Ap[j], basis[j]);
-      } else if (param->chrono_precision == param->cuda_prec_sloppy) {
-        for (unsigned int j = 0; j < basis.size(); j++) mSloppy(Ap[j], basis[j]);
-      } else {
-        errorQuda("Unexpected precision %d for chrono vectors (doesn't match outer %d or sloppy precision %d)",
-                  param->chrono_precision, param->cuda_prec, param->cuda_prec_sloppy);
-      }
-
-      bool orthogonal = true;
-      bool apply_mat = false;
-      bool hermitian = true;
-      MinResExt mre(m, orthogonal, apply_mat, hermitian, profileInvert);
-      mre(*out, *in, basis, Ap);
-
-      profileInvert.TPSTOP(QUDA_PROFILE_CHRONO);
-    }
+    if (param->chrono_use_resident && chronoResident[param->chrono_index].size() > 0)
+      chronoForecast(*out, *in, m, mSloppy, true, param);
 
     // if using a Schwarz preconditioner with a normal operator then we must use the DiracMdagMLocal operator
     if (param->inv_type_precondition != QUDA_INVALID_INVERTER && param->schwarz_type != QUDA_INVALID_SCHWARZ) {
@@ -3025,18 +3358,41 @@ void invertQuda(void *hp_x, void *hp_b, QudaInvertParam *param)
       errorQuda("Requested chrono_max_dim %i is smaller than already existing chronology %lu", param->chrono_max_dim, basis.size());
     }
 
+    auto &cache = chronoCache[i];
+    if (cache.stale.size() != basis.size()) { // basis was created without a cache, so start afresh
+      ColorSpinorParam cs_param(*out);
+      cs_param.setPrecision(param->chrono_precision);
+      cache = {};
+      cache.Ap.resize(basis.size(), cs_param);
+      cache.gram.resize(basis.size() * basis.size());
+      cache.stale.resize(basis.size(), true);
+    }
+
     if(not param->chrono_replace_last){
+      const auto n_old = basis.size();
       // if we have not filled the space yet just augment
       if ((int)basis.size() < param->chrono_max_dim) {
         ColorSpinorParam cs_param(*out);
         cs_param.setPrecision(param->chrono_precision);
         basis.emplace_back(cs_param);
+        cache.Ap.emplace_back(cs_param);
+        cache.stale.push_back(true);
       }
 
       // shuffle every entry down one and bring the last to the front
       std::rotate(basis.begin(), basis.end() - 1, basis.end());
+      std::rotate(cache.Ap.begin(), cache.Ap.end() - 1, cache.Ap.end());
+      std::rotate(cache.stale.begin(), cache.stale.end() - 1, cache.stale.end());
+
+      // shift the Gram matrix to match, dropping the oldest entry if the basis was full
+      const auto n = basis.size();
+      std::vector<Complex> gram(n * n);
+      for (auto j = 1u; j < n && j <= n_old; j++)
+        for (auto k = 1u; k < n && k <= n_old; k++) gram[j * n + k] = cache.gram[(j - 1) * n_old + (k - 1)];
+      cache.gram = std::move(gram);
     }
     basis[0] = *out; // set first entry to new solution
+    cache.stale[0] = true;
   }
   dirac.reconstruct(x, b, param->solution_type);
 
@@ -3140,6 +3496,232 @@ void loadFatLongGaugeQuda(QudaInvertParam *inv_param, QudaGaugeParam *gauge_para
   }
 }
 
+/**
+   Solve the linear systems for a set of sources with a single block
+   solver, so that the operator is applied to all the sources at once.
+   This follows invertQuda, excepting the two-pass, normal-error and
+   chronological solves, which are not supported.  If a dilution is
+   requested, hp_b[0] is the single source and the members of its
+   dilution set are generated on the device and solved
+   dilution_batch_size at a time, so only a batch of sources and
+   solutions is resident at once.
+ */
+static void invertMultiSrcDeviceQuda(void **hp_x, void **hp_b, QudaInvertParam *param)
+{
+  profilerStart(__func__);
+
+  profileInvertMultiSrc.TPSTART(QUDA_PROFILE_TOTAL);
+
+  if (!initialized) errorQuda("QUDA not initialized");
+
+  pushVerbosity(param->verbosity);
+  if (getVerbosity() >= QUDA_DEBUG_VERBOSE) printQudaInvertParam(param);
+
+  checkInvertParam(param, hp_x[0], hp_b[0]);
+
+  const bool dilute = param->dilution_type != QUDA_DILUTION_INVALID;
+  const int n_src = param->num_src;
+  const int n_batch = dilute ? std::min(param->dilution_batch_size, n_src) : n_src;
+  if (n_batch < 1) errorQuda("Invalid dilution batch size %d", param->dilution_batch_size);
+  if (n_batch > QUDA_MAX_MULTI_SHIFT)
+    errorQuda("Number of sources %d exceeds QUDA_MAX_MULTI_SHIFT %d", n_batch, QUDA_MAX_MULTI_SHIFT);
+  if (dilute && param->use_init_guess == QUDA_USE_INIT_GUESS_YES)
+    errorQuda("Initial guesses not supported with diluted sources");
+
+  // check the gauge fields have been created
+  cudaGaugeField *cudaGauge = checkGauge(param);
+
+  bool pc_solution = (param->solution_type == QUDA_MATPC_SOLUTION) || (param->solution_type == QUDA_MATPCDAG_MATPC_SOLUTION);
+  bool pc_solve = (param->solve_type == QUDA_DIRECT_PC_SOLVE) || (param->solve_type == QUDA_NORMOP_PC_SOLVE)
+    || (param->solve_type == QUDA_NORMERR_PC_SOLVE);
+  bool mat_solution = (param->solution_type == QUDA_MAT_SOLUTION) || (param->solution_type == QUDA_MATPC_SOLUTION);
+  bool direct_solve = (param->solve_type == QUDA_DIRECT_SOLVE) || (param->solve_type == QUDA_DIRECT_PC_SOLVE);
+  bool norm_error_solve = (param->solve_type == QUDA_NORMERR_SOLVE) || (param->solve_type == QUDA_NORMERR_PC_SOLVE);
+
+  if (pc_solution && !pc_solve) errorQuda("Preconditioned (PC) solution_type requires a PC solve_type");
+  if (!mat_solution && !pc_solution && pc_solve)
+    errorQuda("Unpreconditioned MATDAG_MAT solution_type requires an unpreconditioned solve_type");
+  if (!mat_solution && direct_solve) errorQuda("Two-pass solves not supported by the block solver");
+  if (norm_error_solve) errorQuda("Normal-error solves not supported by the block solver");
+  if (param->chrono_use_resident || param->chrono_make_resident)
+    errorQuda("Chronological forecasting not supported by the block solver");
+
+  param->secs = 0;
+  param->gflops = 0;
+  param->iter = 0;
+
+  Dirac *d = nullptr;
+  Dirac *dSloppy = nullptr;
+  Dirac *dPre = nullptr;
+  Dirac *dEig = nullptr;
+
+  // Create the dirac operator and operators for sloppy, precondition,
+  // and an eigensolver
+  createDiracWithEig(d, dSloppy, dPre, dEig, *param, pc_solve);
+
+  Dirac &dirac = *d;
+  Dirac &diracSloppy = *dSloppy;
+  Dirac &diracPre = *dPre;
+  Dirac &diracEig = *dEig;
+
+  profileInvertMultiSrc.TPSTART(QUDA_PROFILE_H2D);
+
+  const auto X = cudaGauge->X();
+
+  // wrap CPU host side pointers, and allocate the device sources and
+  // solutions for a batch
+  std::vector<ColorSpinorField> h_b(dilute ? 1 : n_src), h_x(n_src), b(n_batch), x(n_batch);
+  ColorSpinorParam cpuParam(hp_b[0], *param, X, pc_solution, param->input_location);
+  for (auto i = 0u; i < h_b.size(); i++) {
+    cpuParam.v = hp_b[i];
+    h_b[i] = ColorSpinorField(cpuParam);
+  }
+  cpuParam.location = param->output_location;
+  for (int i = 0; i < n_src; i++) {
+    cpuParam.v = hp_x[i];
+    h_x[i] = ColorSpinorField(cpuParam);
+  }
+
+  ColorSpinorParam cudaParam(cpuParam, *param, QUDA_CUDA_FIELD_LOCATION);
+  cudaParam.create = QUDA_NULL_FIELD_CREATE;
+  for (int i = 0; i < n_batch; i++) {
+    b[i] = ColorSpinorField(cudaParam);
+    x[i] = ColorSpinorField(cudaParam);
+  }
+
+  // the undiluted source is downloaded once
+  ColorSpinorField src;
+  if (dilute) {
+    cudaParam.create = QUDA_COPY_FIELD_CREATE;
+    cudaParam.field = &h_b[0];
+    src = ColorSpinorField(cudaParam);
+    const lat_dim_t block = {param->dilution_block_size[0], param->dilution_block_size[1],
+                             param->dilution_block_size[2], param->dilution_block_size[3]};
+    auto size = dilutionSize(src, param->dilution_type, block, param->dilution_probe_size);
+    if (size != n_src) errorQuda("Number of sources %d does not match the dilution set size %d", n_src, size);
+  }
+
+  profileInvertMultiSrc.TPSTOP(QUDA_PROFILE_H2D);
+
+  auto solve_batch = [&](int offset, int n) {
+    vector_ref<ColorSpinorField> b_batch {b.begin(), b.begin() + n};
+    vector_ref<ColorSpinorField> x_batch {x.begin(), x.begin() + n};
+
+    profileInvertMultiSrc.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    if (dilute) {
+      const lat_dim_t block = {param->dilution_block_size[0], param->dilution_block_size[1],
+                               param->dilution_block_size[2], param->dilution_block_size[3]};
+      spinorDilute(b_batch, src, param->dilution_type, offset, block, param->dilution_probe_size);
+      blas::zero(x_batch);
+    } else {
+      for (int i = 0; i < n; i++) {
+        b[i] = h_b[offset + i];
+        if (param->use_init_guess == QUDA_USE_INIT_GUESS_YES)
+          x[i] = h_x[offset + i];
+        else
+          blas::zero(x[i]);
+      }
+    }
+
+    std::vector<double> nb(n);
+    std::vector<ColorSpinorField *> in(n, nullptr), out(n, nullptr);
+    for (int i = 0; i < n; i++) {
+      nb[i] = blas::norm2(b[i]);
+      if (nb[i] == 0.0) errorQuda("Source %d has zero norm", offset + i);
+      logQuda(QUDA_VERBOSE, "Source %d: %g\n", offset + i, nb[i]);
+
+      // rescale the source and solution vectors to help prevent the onset of underflow
+      if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+        blas::ax(1.0 / sqrt(nb[i]), b[i]);
+        blas::ax(1.0 / sqrt(nb[i]), x[i]);
+      }
+
+      massRescale(b[i], *param, false);
+
+      dirac.prepare(in[i], out[i], x[i], b[i], param->solution_type);
+    }
+
+    profileInvertMultiSrc.TPSTOP(QUDA_PROFILE_PREAMBLE);
+
+    vector_ref<ColorSpinorField> in_ref, out_ref;
+    for (int i = 0; i < n; i++) {
+      if (mat_solution && !direct_solve) { // prepare source: b' = A^dag b
+        ColorSpinorField tmp(*in[i]);
+        dirac.Mdag(*in[i], tmp);
+      }
+      in_ref.push_back(*in[i]);
+      out_ref.push_back(*out[i]);
+    }
+
+    SolverParam solverParam(*param);
+    if (direct_solve) {
+      DiracM m(dirac), mSloppy(diracSloppy), mPre(diracPre), mEig(diracEig);
+      Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, mEig, profileInvertMultiSrc);
+      solve->solve_multi_src(out_ref, in_ref);
+      delete solve;
+    } else {
+      DiracMdagM m(dirac), mSloppy(diracSloppy), mPre(diracPre), mEig(diracEig);
+      Solver *solve = Solver::create(solverParam, m, mSloppy, mPre, mEig, profileInvertMultiSrc);
+      solve->solve_multi_src(out_ref, in_ref);
+      delete solve;
+    }
+
+    solverParam.updateInvertParam(*param); // accumulates the statistics over the batches
+
+    profileInvertMultiSrc.TPSTART(QUDA_PROFILE_EPILOGUE);
+    for (int i = 0; i < n; i++) {
+      dirac.reconstruct(x[i], b[i], param->solution_type);
+
+      if (param->solver_normalization == QUDA_SOURCE_NORMALIZATION) {
+        // rescale the solution
+        blas::ax(sqrt(nb[i]), x[i]);
+      }
+    }
+    profileInvertMultiSrc.TPSTOP(QUDA_PROFILE_EPILOGUE);
+
+    profileInvertMultiSrc.TPSTART(QUDA_PROFILE_D2H);
+    for (int i = 0; i < n; i++) h_x[offset + i] = x[i];
+    profileInvertMultiSrc.TPSTOP(QUDA_PROFILE_D2H);
+  };
+
+  for (int offset = 0; offset < n_src; offset += n_batch) solve_batch(offset, std::min(n_batch, n_src - offset));
+
+  profileInvertMultiSrc.TPSTART(QUDA_PROFILE_FREE);
+
+  delete d;
+  delete dSloppy;
+  delete dPre;
+  delete dEig;
+
+  profileInvertMultiSrc.TPSTOP(QUDA_PROFILE_FREE);
+
+  popVerbosity();
+
+  // cache is written out even if a long benchmarking job gets interrupted
+  saveTuneCache();
+
+  profileInvertMultiSrc.TPSTOP(QUDA_PROFILE_TOTAL);
+
+  profilerStop(__func__);
+}
+
+/**
+   Whether the sources should be solved from device-resident batches:
+   either with a single block solve, or when streaming diluted
+   sources.  With a split grid each sub-partition instead solves its
+   sources in turn.
+ */
+static bool useMultiSrcDeviceSolve(const QudaInvertParam *param)
+{
+  bool split = param->split_grid[0] * param->split_grid[1] * param->split_grid[2] * param->split_grid[3] > 1;
+  if (param->dilution_type != QUDA_DILUTION_INVALID) {
+    if (split) errorQuda("Diluted sources not supported with a split grid");
+    return true;
+  }
+  return param->inv_type == QUDA_BLOCK_CG_INVERTER && !split;
+}
+
 template <class Interface, class... Args>
 void callMultiSrcQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param, // color spinor field pointers, and inv_param
                       void *h_gauge, void *milc_fatlinks, void *milc_longlinks,
@@ -3438,6 +4020,11 @@ void callMultiSrcQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param, // col
 
 void invertMultiSrcQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param, void *h_gauge, QudaGaugeParam *gauge_param)
 {
+  if (useMultiSrcDeviceSolve(param)) {
+    invertMultiSrcDeviceQuda(_hp_x, _hp_b, param);
+    return;
+  }
+
   auto op = [](void *_x, void *_b, QudaInvertParam *param) { invertQuda(_x, _b, param); };
   callMultiSrcQuda(_hp_x, _hp_b, param, h_gauge, nullptr, nullptr, gauge_param, nullptr, nullptr, op);
 }
@@ -3445,6 +4032,11 @@ void invertMultiSrcQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param, void
 void invertMultiSrcStaggeredQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param, void *milc_fatlinks,
                                  void *milc_longlinks, QudaGaugeParam *gauge_param)
 {
+  if (useMultiSrcDeviceSolve(param)) {
+    invertMultiSrcDeviceQuda(_hp_x, _hp_b, param);
+    return;
+  }
+
   auto op = [](void *_x, void *_b, QudaInvertParam *param) { invertQuda(_x, _b, param); };
   callMultiSrcQuda(_hp_x, _hp_b, param, nullptr, milc_fatlinks, milc_longlinks, gauge_param, nullptr, nullptr, op);
 }
@@ -3452,6 +4044,11 @@ void invertMultiSrcStaggeredQuda(void **_hp_x, void **_hp_b, QudaInvertParam *pa
 void invertMultiSrcCloverQuda(void **_hp_x, void **_hp_b, QudaInvertParam *param, void *h_gauge,
                               QudaGaugeParam *gauge_param, void *h_clover, void *h_clovinv)
 {
+  if (useMultiSrcDeviceSolve(param)) {
+    invertMultiSrcDeviceQuda(_hp_x, _hp_b, param);
+    return;
+  }
+
   auto op = [](void *_x, void *_b, QudaInvertParam *param) { invertQuda(_x, _b, param); };
   callMultiSrcQuda(_hp_x, _hp_b, param, h_gauge, nullptr, nullptr, gauge_param, h_clover, h_clovinv, op);
 }
@@ -3689,6 +4286,14 @@ void invertMultiShiftQuda(void **hp_x, void *hp_b, QudaInvertParam *param)
     Dirac &diracSloppy = *dRefine;
     diracSloppy.prefetch(QUDA_CUDA_FIELD_LOCATION);
 
+    // Shifts other than the unshifted system (which is refined using
+    // its Krylov space) are deferred and refined in batches when
+    // requested.  Heavy-quark refinement is always done sequentially.
+    const bool batch_refine
+      = param->multishift_refine_batch > 1 && !(param->residual_type & QUDA_HEAVY_QUARK_RESIDUAL);
+    std::vector<int> refine_shifts;
+    std::vector<double> refine_tol_offset(param->num_offset);
+
 #define REFINE_INCREASING_MASS
 #ifdef REFINE_INCREASING_MASS
     for(int i=0; i < param->num_offset; i++) {
@@ -3716,6 +4321,12 @@ void invertMultiShiftQuda(void **hp_x, void *hp_b, QudaInvertParam *param)
 	  printfQuda("Refining shift %d: L2 residual %e / %e, heavy quark %e / %e (actual / requested)\n",
 		     i, param->true_res_offset[i], param->tol_offset[i], rsd_hq, tol_hq);
 
+        if (batch_refine && i > 0) {
+          refine_shifts.push_back(i);
+          refine_tol_offset[i] = (param->tol_offset[i] > 0.0 ? param->tol_offset[i] : iter_tol);
+          continue;
+        }
+
         // for staggered the shift is just a change in mass term (FIXME: for twisted mass also)
         if (param->dslash_type == QUDA_ASQTAD_DSLASH ||
             param->dslash_type == QUDA_STAGGERED_DSLASH) {
@@ -3795,6 +4406,46 @@ void invertMultiShiftQuda(void **hp_x, void *hp_b, QudaInvertParam *param)
         delete mSloppy;
       }
     }
+
+    if (refine_shifts.size() > 0) {
+      // the operators are those of the unshifted system, with the shifts applied by the solver
+      DiracMatrix *m, *mSloppy;
+
+      if (param->dslash_type == QUDA_ASQTAD_DSLASH || param->dslash_type == QUDA_STAGGERED_DSLASH) {
+        m = new DiracM(dirac);
+        mSloppy = new DiracM(diracSloppy);
+      } else {
+        m = new DiracMdagM(dirac);
+        mSloppy = new DiracMdagM(diracSloppy);
+      }
+
+      SolverParam solverParam(refineparam);
+      solverParam.iter = 0;
+      solverParam.secs = 0;
+      solverParam.gflops = 0;
+      solverParam.delta = param->reliable_delta_refinement;
+      for (auto i : refine_shifts) solverParam.tol_offset[i] = refine_tol_offset[i];
+
+      {
+        BatchedShiftCG cg(*m, *mSloppy, solverParam, profileMulti);
+        const auto batch = static_cast<unsigned int>(param->multishift_refine_batch);
+        for (auto j = 0u; j < refine_shifts.size(); j += batch) {
+          std::vector<int> shifts(refine_shifts.begin() + j,
+                                  refine_shifts.begin() + std::min<size_t>(j + batch, refine_shifts.size()));
+          cg(x, b, shifts);
+        }
+      }
+
+      for (auto i : refine_shifts) {
+        param->true_res_offset[i] = solverParam.true_res_offset[i];
+        param->iter_res_offset[i] = solverParam.iter_res_offset[i];
+        param->true_res_hq_offset[i] = solverParam.true_res_hq_offset[i];
+      }
+      solverParam.updateInvertParam(*param, refine_shifts.back());
+
+      delete m;
+      delete mSloppy;
+    }
   }
 
   // restore shifts
@@ -4024,6 +4675,7 @@ int computeGaugeForceQuda(void* mom, void* siteLink,  int*** input_path_buf, int
 			  double* loop_coeff, int num_paths, int max_length, double eb3, QudaGaugeParam* qudaGaugeParam)
 {
   profileGaugeForce.TPSTART(QUDA_PROFILE_TOTAL);
+  invalidateLoadCache(); // this may modify the resident gauge field
   profileGaugeForce.TPSTART(QUDA_PROFILE_INIT);
 
   checkGaugeParam(qudaGaugeParam);
@@ -4159,6 +4811,7 @@ int computeGaugePathQuda(void *out, void *siteLink, int ***input_path_buf, int *
                          int num_paths, int max_length, double eb3, QudaGaugeParam *qudaGaugeParam)
 {
   profileGaugePath.TPSTART(QUDA_PROFILE_TOTAL);
+  invalidateLoadCache(); // this may modify the resident gauge field
   profileGaugePath.TPSTART(QUDA_PROFILE_INIT);
 
   checkGaugeParam(qudaGaugeParam);
@@ -4992,6 +5645,7 @@ void updateGaugeFieldQuda(void* gauge,
 			  QudaGaugeParam* param)
 {
   profileGaugeUpdate.TPSTART(QUDA_PROFILE_TOTAL);
+  invalidateLoadCache(); // this may modify the resident gauge field
 
   checkGaugeParam(param);
 
@@ -5088,6 +5742,7 @@ void updateGaugeFieldQuda(void* gauge,
 
  void projectSU3Quda(void *gauge_h, double tol, QudaGaugeParam *param) {
    profileProject.TPSTART(QUDA_PROFILE_TOTAL);
+   invalidateLoadCache(); // this may modify the resident gauge field
 
    profileProject.TPSTART(QUDA_PROFILE_INIT);
    checkGaugeParam(param);
@@ -5151,6 +5806,7 @@ void updateGaugeFieldQuda(void* gauge,
 
  void staggeredPhaseQuda(void *gauge_h, QudaGaugeParam *param) {
    profilePhase.TPSTART(QUDA_PROFILE_TOTAL);
+   invalidateLoadCache(); // this may modify the resident gauge field
 
    profilePhase.TPSTART(QUDA_PROFILE_INIT);
    checkGaugeParam(param);
@@ -5268,6 +5924,7 @@ double momActionQuda(void* momentum, QudaGaugeParam* param)
 void gaussGaugeQuda(unsigned long long seed, double sigma)
 {
   profileGauss.TPSTART(QUDA_PROFILE_TOTAL);
+  invalidateLoadCache(); // this may modify the resident gauge field
 
   if (!gaugePrecise) errorQuda("Cannot generate Gauss GaugeField as there is no resident gauge field");
 
@@ -5662,34 +6319,120 @@ void performWFlowQuda(QudaGaugeSmearParam *smear_param, QudaGaugeObservableParam
 
   int measurement_n = 0; // The nth measurement to take
 
-  gaugeObservables(*in, obs_param[measurement_n], profileWFlow);
+  FlowRecorder recorder(*smear_param);
+  const bool record
+    = smear_param->flow_record_file[0] != '\0' || smear_param->t0_ref > 0.0 || smear_param->w0_ref > 0.0;
+
+  // measure the observables on the flowed field at time t
+  auto measure = [&](GaugeField &u, double t) {
+    auto &obs = obs_param[measurement_n];
+    // measure on a copy, since the recorder requires the field energy even if the caller did not request it
+    QudaGaugeObservableParam param = obs;
+    if (record) param.compute_qcharge = QUDA_BOOLEAN_TRUE;
+    gaugeObservables(u, param, profileWFlow);
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      printfQuda("%le %.16e %+.16e %+.16e %+.16e %+.16e\n", t, param.plaquette[0], param.energy[0], param.energy[1],
+                 param.energy[2], param.qcharge);
+    }
+    if (record) recorder.record(t, param);
 
-  if (getVerbosity() >= QUDA_SUMMARIZE) {
-    printfQuda("flow t, plaquette, E_tot, E_spatial, E_temporal, Q charge\n");
-    printfQuda("%le %.16e %+.16e %+.16e %+.16e %+.16e\n", 0.0, obs_param[0].plaquette[0], obs_param[0].energy[0],
-               obs_param[0].energy[1], obs_param[0].energy[2], obs_param[0].qcharge);
-  }
+    // return only the requested observables
+    if (!obs.compute_qcharge) {
+      param.compute_qcharge = obs.compute_qcharge;
+      param.qcharge = obs.qcharge;
+      for (int i = 0; i < 3; i++) param.energy[i] = obs.energy[i];
+    }
+    obs = param;
+  };
+
+  if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("flow t, plaquette, E_tot, E_spatial, E_temporal, Q charge\n");
+  measure(*in, 0.0);
+
+  if (smear_param->adaptive == QUDA_BOOLEAN_TRUE) {
+    // Adaptive step size flow: the step is controlled by the
+    // difference between the third-order solution and an embedded
+    // second-order solution (https://arxiv.org/abs/1301.4388), and
+    // clipped to land on each measurement time
+    auto *gaugeStage = GaugeField::Create(gParamEx);
+    auto *gaugeErr = GaugeField::Create(gParam);
+
+    const double t_final = smear_param->n_steps * smear_param->epsilon;
+    const double t_meas = smear_param->meas_interval * smear_param->epsilon;
+    const unsigned int n_meas = smear_param->n_steps / smear_param->meas_interval;
+    const double tol = smear_param->tolerance;
+
+    double t = 0.0;
+    double epsilon = smear_param->epsilon;
+    unsigned int n_accept = 0;
+    unsigned int n_reject = 0;
+
+    while (t < t_final) {
+      const double t_next = measurement_n < (int)n_meas ? std::min((measurement_n + 1) * t_meas, t_final) : t_final;
+      const bool clip = t + epsilon >= t_next;
+      const double h = clip ? t_next - t : epsilon;
+
+      profileWFlow.TPSTART(QUDA_PROFILE_COMPUTE);
+      double err = WFlowStepAdaptive(*out, *gaugeStage, *gaugeTemp, *gaugeErr, *in, h, smear_param->smear_type);
+      profileWFlow.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+      // the local error is O(h^3)
+      const double scale = err > 0.0 ? std::min(std::max(0.9 * std::cbrt(tol / err), 0.2), 5.0) : 5.0;
+
+      if (err > tol) {
+        n_reject++;
+        epsilon = h * scale;
+        logQuda(QUDA_DEBUG_VERBOSE, "Rejected step %e at t = %e with error %e\n", h, t, err);
+        if (epsilon < std::numeric_limits<double>::epsilon() * t_final)
+          errorQuda("Flow step size %e underflow at t = %e", epsilon, t);
+        continue;
+      }
 
-  for (unsigned int i = 0; i < smear_param->n_steps; i++) {
-    // Perform W1, W2, and Vt Wilson Flow steps as defined in
-    // https://arxiv.org/abs/1006.4518v3
-    profileWFlow.TPSTART(QUDA_PROFILE_COMPUTE);
-    if (i > 0) std::swap(in, out); // output from prior step becomes input for next step
-    WFlowStep(*out, *gaugeTemp, *in, smear_param->epsilon, smear_param->smear_type);
-    profileWFlow.TPSTOP(QUDA_PROFILE_COMPUTE);
+      std::swap(in, out); // output from this step becomes input for the next step
+      t = clip ? t_next : t + h;
+      n_accept++;
+      // a clipped step does not tell us that the unclipped step was too large
+      epsilon = clip ? std::max(epsilon, h * scale) : h * scale;
+      logQuda(QUDA_DEBUG_VERBOSE, "Accepted step %e to t = %e with error %e\n", h, t, err);
+
+      if (clip && measurement_n < (int)n_meas) {
+        measurement_n++; // increment measurements.
+        measure(*in, t);
+        if (recorder.done()) break;
+      }
+    }
 
-    if ((i + 1) % smear_param->meas_interval == 0) {
-      measurement_n++; // increment measurements.
-      gaugeObservables(*out, obs_param[measurement_n], profileWFlow);
-      if (getVerbosity() >= QUDA_SUMMARIZE) {
-        printfQuda("%le %.16e %+.16e %+.16e %+.16e %+.16e\n", smear_param->epsilon * (i + 1),
-                   obs_param[measurement_n].plaquette[0], obs_param[measurement_n].energy[0],
-                   obs_param[measurement_n].energy[1], obs_param[measurement_n].energy[2],
-                   obs_param[measurement_n].qcharge);
+    logQuda(QUDA_SUMMARIZE, "Adaptive flow to t = %e in %u steps (%u rejected), versus %u fixed steps\n", t,
+            n_accept, n_reject, smear_param->n_steps);
+
+    // leave the flowed field in gaugeSmeared
+    if (in != gaugeSmeared) gaugeSmeared->copy(*in);
+
+    delete gaugeErr;
+    delete gaugeStage;
+  } else {
+    for (unsigned int i = 0; i < smear_param->n_steps; i++) {
+      // Perform W1, W2, and Vt Wilson Flow steps as defined in
+      // https://arxiv.org/abs/1006.4518v3
+      profileWFlow.TPSTART(QUDA_PROFILE_COMPUTE);
+      if (i > 0) std::swap(in, out); // output from prior step becomes input for next step
+      WFlowStep(*out, *gaugeTemp, *in, smear_param->epsilon, smear_param->smear_type);
+      profileWFlow.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+      if ((i + 1) % smear_param->meas_interval == 0) {
+        measurement_n++; // increment measurements.
+        measure(*out, smear_param->epsilon * (i + 1));
+        if (recorder.done()) {
+          logQuda(QUDA_SUMMARIZE, "Requested flow scales found, stopping after %u of %u steps\n", i + 1,
+                  smear_param->n_steps);
+          break;
+        }
       }
     }
   }
 
+  smear_param->t0 = recorder.t0();
+  smear_param->w0 = recorder.w0();
+
   delete gaugeTemp;
   delete gaugeAux;
   profileWFlow.TPSTOP(QUDA_PROFILE_TOTAL);
@@ -5755,6 +6498,7 @@ int computeGaugeFixingOVRQuda(void *gauge, const unsigned int gauge_dir, const u
   GaugeFixOVRQuda.TPSTOP(QUDA_PROFILE_TOTAL);
 
   if (param->make_resident_gauge) {
+    invalidateLoadCache(); // the resident gauge field is replaced by the gauge-fixed one
     if (gaugePrecise != nullptr) delete gaugePrecise;
     gaugePrecise = cudaInGauge;
     if (extendedGaugeResident) delete extendedGaugeResident;
@@ -5775,9 +6519,11 @@ int computeGaugeFixingOVRQuda(void *gauge, const unsigned int gauge_dir, const u
   return 0;
 }
 
-int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const unsigned int Nsteps, \
-  const unsigned int verbose_interval, const double alpha, const unsigned int autotune, const double tolerance, \
-  const unsigned int  stopWtheta, QudaGaugeParam* param , double* timeinfo)
+// shared by the steepest descent and conjugate gradient entry points
+static int computeGaugeFixingFFT(void *gauge, const unsigned int gauge_dir, const unsigned int Nsteps,
+                                 const unsigned int verbose_interval, const double alpha, const unsigned int autotune,
+                                 const double tolerance, const unsigned int stopWtheta, const bool cg,
+                                 QudaGaugeParam *param, double *timeinfo)
 {
   GaugeFixFFTQuda.TPSTART(QUDA_PROFILE_TOTAL);
 
@@ -5809,7 +6555,7 @@ int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const
   // perform the update
   GaugeFixFFTQuda.TPSTART(QUDA_PROFILE_COMPUTE);
 
-  gaugeFixingFFT(*cudaInGauge, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta);
+  gaugeFixingFFT(*cudaInGauge, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta, cg);
 
   GaugeFixFFTQuda.TPSTOP(QUDA_PROFILE_COMPUTE);
 
@@ -5821,6 +6567,7 @@ int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const
   GaugeFixFFTQuda.TPSTOP(QUDA_PROFILE_TOTAL);
 
   if (param->make_resident_gauge) {
+    invalidateLoadCache(); // the resident gauge field is replaced by the gauge-fixed one
     if (gaugePrecise != nullptr) delete gaugePrecise;
     gaugePrecise = cudaInGauge;
   } else {
@@ -5836,6 +6583,22 @@ int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const
   return 0;
 }
 
+int computeGaugeFixingFFTQuda(void* gauge, const unsigned int gauge_dir,  const unsigned int Nsteps, \
+  const unsigned int verbose_interval, const double alpha, const unsigned int autotune, const double tolerance, \
+  const unsigned int  stopWtheta, QudaGaugeParam* param , double* timeinfo)
+{
+  return computeGaugeFixingFFT(gauge, gauge_dir, Nsteps, verbose_interval, alpha, autotune, tolerance, stopWtheta,
+                               false, param, timeinfo);
+}
+
+int computeGaugeFixingFFTCGQuda(void *gauge, const unsigned int gauge_dir, const unsigned int Nsteps,
+                                const unsigned int verbose_interval, const double alpha, const double tolerance,
+                                const unsigned int stopWtheta, QudaGaugeParam *param, double *timeinfo)
+{
+  return computeGaugeFixingFFT(gauge, gauge_dir, Nsteps, verbose_interval, alpha, 0, tolerance, stopWtheta, true,
+                               param, timeinfo);
+}
+
 void contractQuda(const void *hp_x, const void *hp_y, void *h_result, const QudaContractType cType,
                   QudaInvertParam *param, const int *X)
 {
@@ -5885,6 +6648,122 @@ void contractQuda(const void *hp_x, const void *hp_y, void *h_result, const Quda
   profileContract.TPSTOP(QUDA_PROFILE_TOTAL);
 }
 
+void contractSummedQuda(void **hp_x, void **hp_y, int n_prop, double *h_result, const QudaContractType cType,
+                        QudaInvertParam *param, const int *X, int n_mom, const int *mom, const int *source_position,
+                        int n_gamma, const int *gamma)
+{
+  profileContract.TPSTART(QUDA_PROFILE_TOTAL);
+  profileContract.TPSTART(QUDA_PROFILE_INIT);
+
+  if (n_prop < 1 || n_mom < 1 || n_gamma < 1)
+    errorQuda("Invalid contraction batch n_prop = %d n_mom = %d n_gamma = %d", n_prop, n_mom, n_gamma);
+  for (int g = 0; g < n_gamma; g++)
+    if (gamma[g] < 0 || gamma[g] >= 16) errorQuda("Invalid insertion index gamma[%d] = %d", g, gamma[g]);
+
+  lat_dim_t X_ = {X[0], X[1], X[2], X[3]};
+  ColorSpinorParam cpuParam(hp_x[0], *param, X_, false, param->input_location);
+
+  // Quda uses Degrand-Rossi gamma basis for contractions and will
+  // automatically reorder data if necessary.
+  ColorSpinorParam cudaParam(cpuParam);
+  cudaParam.location = QUDA_CUDA_FIELD_LOCATION;
+  cudaParam.create = QUDA_NULL_FIELD_CREATE;
+  cudaParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  cudaParam.setPrecision(cpuParam.Precision(), cpuParam.Precision(), true);
+
+  std::vector<ColorSpinorField> x(n_prop, ColorSpinorField(cudaParam));
+  std::vector<ColorSpinorField> y(n_prop, ColorSpinorField(cudaParam));
+  profileContract.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileContract.TPSTART(QUDA_PROFILE_H2D);
+  for (int i = 0; i < n_prop; i++) {
+    cpuParam.v = hp_x[i];
+    ColorSpinorField h_x(cpuParam);
+    x[i] = h_x;
+    cpuParam.v = hp_y[i];
+    ColorSpinorField h_y(cpuParam);
+    y[i] = h_y;
+  }
+  profileContract.TPSTOP(QUDA_PROFILE_H2D);
+
+  profileContract.TPSTART(QUDA_PROFILE_COMPUTE);
+  const int nt = X[3] * comm_dim(3);
+  std::vector<int> mom_(mom, mom + 3 * n_mom);
+  std::vector<Complex> result(nt * n_mom * 16, 0.0);
+  contractSummedQuda(x, y, result, cType, mom_, source_position);
+  profileContract.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  profileContract.TPSTART(QUDA_PROFILE_EPILOGUE);
+  for (int tm = 0; tm < nt * n_mom; tm++) {
+    for (int g = 0; g < n_gamma; g++) {
+      h_result[2 * (tm * n_gamma + g) + 0] = result[tm * 16 + gamma[g]].real();
+      h_result[2 * (tm * n_gamma + g) + 1] = result[tm * 16 + gamma[g]].imag();
+    }
+  }
+  profileContract.TPSTOP(QUDA_PROFILE_EPILOGUE);
+
+  profileContract.TPSTOP(QUDA_PROFILE_TOTAL);
+}
+
+void mesonFieldQuda(void **hp_w, int n_w, void **hp_v, int n_v, double *h_result, QudaInvertParam *param, const int *X,
+                    int n_mom, const int *mom, int n_gamma, const int *gamma, QudaFieldLocation location)
+{
+  profileContract.TPSTART(QUDA_PROFILE_TOTAL);
+  profileContract.TPSTART(QUDA_PROFILE_INIT);
+
+  if (n_w < 1 || n_v < 1 || n_mom < 1 || n_gamma < 1)
+    errorQuda("Invalid meson field n_w = %d n_v = %d n_mom = %d n_gamma = %d", n_w, n_v, n_mom, n_gamma);
+  const bool same = hp_w == hp_v && n_w == n_v;
+
+  lat_dim_t X_ = {X[0], X[1], X[2], X[3]};
+  ColorSpinorParam cpuParam(hp_w[0], *param, X_, false, param->input_location);
+  std::vector<ColorSpinorField> h_w, h_v;
+  for (int i = 0; i < n_w; i++) {
+    cpuParam.v = hp_w[i];
+    h_w.emplace_back(cpuParam);
+  }
+  for (int j = 0; j < (same ? 0 : n_v); j++) {
+    cpuParam.v = hp_v[j];
+    h_v.emplace_back(cpuParam);
+  }
+
+  // Quda uses Degrand-Rossi gamma basis for contractions and will
+  // automatically reorder data if necessary.
+  ColorSpinorParam cudaParam(cpuParam);
+  cudaParam.location = QUDA_CUDA_FIELD_LOCATION;
+  cudaParam.create = QUDA_NULL_FIELD_CREATE;
+  cudaParam.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  cudaParam.setPrecision(cpuParam.Precision(), cpuParam.Precision(), true);
+
+  std::vector<ColorSpinorField> d_w, d_v;
+  if (location == QUDA_CUDA_FIELD_LOCATION) {
+    d_w.resize(n_w, cudaParam);
+    if (!same) d_v.resize(n_v, cudaParam);
+  }
+  profileContract.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileContract.TPSTART(QUDA_PROFILE_H2D);
+  if (location == QUDA_CUDA_FIELD_LOCATION) {
+    for (int i = 0; i < n_w; i++) d_w[i] = h_w[i];
+    for (int j = 0; j < (same ? 0 : n_v); j++) d_v[j] = h_v[j];
+  }
+  profileContract.TPSTOP(QUDA_PROFILE_H2D);
+
+  profileContract.TPSTART(QUDA_PROFILE_COMPUTE);
+  auto &w = location == QUDA_CUDA_FIELD_LOCATION ? d_w : h_w;
+  auto &v = same ? w : location == QUDA_CUDA_FIELD_LOCATION ? d_v : h_v;
+  const int nt = X[3] * comm_dim(3);
+  std::vector<Complex> result(nt * n_mom * n_gamma * n_w * n_v);
+  mesonFieldQuda(w, v, result, std::vector<int>(mom, mom + 3 * n_mom), std::vector<int>(gamma, gamma + n_gamma));
+  profileContract.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  profileContract.TPSTART(QUDA_PROFILE_EPILOGUE);
+  memcpy(h_result, result.data(), result.size() * sizeof(Complex));
+  profileContract.TPSTOP(QUDA_PROFILE_EPILOGUE);
+
+  profileContract.TPSTOP(QUDA_PROFILE_TOTAL);
+}
+
 void gaugeObservablesQuda(QudaGaugeObservableParam *param)
 {
   profileGaugeObs.TPSTART(QUDA_PROFILE_TOTAL);
@@ -5911,3 +6790,40 @@ void gaugeObservablesQuda(QudaGaugeObservableParam *param)
   gaugeObservables(*gauge, *param, profileGaugeObs);
   profileGaugeObs.TPSTOP(QUDA_PROFILE_TOTAL);
 }
+
+void gaugeObservablesHostQuda(void *h_gauge, QudaGaugeParam *gauge_param, QudaGaugeObservableParam *param)
+{
+  profileGaugeObs.TPSTART(QUDA_PROFILE_TOTAL);
+  checkGaugeParam(gauge_param);
+  checkGaugeObservableParam(param);
+
+  if (gauge_param->gauge_order != QUDA_QDP_GAUGE_ORDER) errorQuda("Only QDP-ordered host gauge fields are supported");
+  for (int d = 0; d < 4; d++)
+    if (comm_dim_partitioned(d)) errorQuda("Host gauge observables not supported with partitioned dimension %d", d);
+  if (param->compute_polyakov_loop || param->compute_gauge_loop_trace)
+    errorQuda("Only the plaquette, field energy and topological charge may be computed on the host");
+  if (param->compute_qcharge_density && !param->qcharge_density)
+    errorQuda("Charge density requested, but destination field not defined");
+
+  profileGaugeObs.TPSTART(QUDA_PROFILE_INIT);
+  GaugeFieldParam gParam(*gauge_param, h_gauge);
+  cpuGaugeField cpuGauge(gParam);
+  profileGaugeObs.TPSTOP(QUDA_PROFILE_INIT);
+
+  profileGaugeObs.TPSTART(QUDA_PROFILE_COMPUTE);
+  double plaq[3];
+  double energy[3];
+  double qcharge;
+  void *qdensity = param->compute_qcharge_density ? param->qcharge_density : nullptr;
+  gaugeObservablesFused(cpuGauge, plaq, energy, qcharge, qdensity);
+  profileGaugeObs.TPSTOP(QUDA_PROFILE_COMPUTE);
+
+  if (param->compute_plaquette)
+    for (int i = 0; i < 3; i++) param->plaquette[i] = plaq[i];
+  if (param->compute_qcharge || param->compute_qcharge_density) {
+    for (int i = 0; i < 3; i++) param->energy[i] = energy[i];
+    param->qcharge = qcharge;
+  }
+
+  profileGaugeObs.TPSTOP(QUDA_PROFILE_TOTAL);
+}
@@ -0,0 +1,429 @@
+#include <algorithm>
+
+#include <invert_quda.h>
+#include <blas_quda.h>
+#include <eigen_helper.h>
+
+/**
+   @file inv_block_cg_quda.cpp
+
+   Implementation of the block conjugate gradient algorithm for
+   solving a set of linear systems with a common Hermitian operator.
+   Based on the description here:
+   https://doi.org/10.1016/0024-3795(80)90247-5
+
+   Each iteration applies the operator to the whole block of search
+   directions with a single multi-RHS application, and the inner
+   products required are computed with the batched block reductions.
+   Following the breakdown-free variant
+   (https://doi.org/10.1007/s11075-016-0241-5), the search directions
+   are orthonormalized through an eigen-decomposition of their Gram
+   matrix, dropping any directions which have become numerically
+   linearly dependent.  Systems whose true residual has converged are
+   removed from the block at reliable updates.
+*/
+
+namespace quda
+{
+
+  BlockCG::BlockCG(const DiracMatrix &mat, const DiracMatrix &matSloppy, const DiracMatrix &matPrecon,
+                   const DiracMatrix &matEig, SolverParam &param, TimeProfile &profile) :
+    Solver(mat, matSloppy, matPrecon, matEig, param, profile)
+  {
+  }
+
+  BlockCG::~BlockCG()
+  {
+    if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_FREE);
+    destroyDeflationSpace();
+    if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_FREE);
+  }
+
+  void BlockCG::create(cvector_ref<ColorSpinorField> &x, cvector_ref<ColorSpinorField> &b)
+  {
+    Solver::create(x[0], b[0]);
+    if (r.size() != b.size()) {
+      if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_INIT);
+
+      r.clear();
+      y.clear();
+      rSloppy.clear();
+      xSloppy.clear();
+      p.clear();
+      q.clear();
+      w.clear();
+
+      ColorSpinorParam csParam(b[0]);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      for (auto i = 0u; i < b.size(); i++) {
+        r.push_back(ColorSpinorField(csParam));
+        y.push_back(ColorSpinorField(csParam));
+      }
+
+      // now allocate sloppy fields
+      csParam.setPrecision(param.precision_sloppy);
+      for (auto i = 0u; i < b.size(); i++) {
+        if (mixed()) {
+          rSloppy.push_back(ColorSpinorField(csParam));
+          xSloppy.push_back(ColorSpinorField(csParam));
+        } else {
+          rSloppy.push_back(r[i].create_alias());
+        }
+        p.push_back(ColorSpinorField(csParam));
+        q.push_back(ColorSpinorField(csParam));
+        w.push_back(ColorSpinorField(csParam));
+      }
+
+      if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_INIT);
+    }
+  }
+
+  int BlockCG::orthonormalize(int m)
+  {
+    vector_ref<const ColorSpinorField> W(w.begin(), w.begin() + m);
+
+    std::vector<Complex> gram(m * m);
+    blas::cDotProduct(gram, W, W);
+
+    MatrixXcd G(m, m);
+    for (int i = 0; i < m; i++)
+      for (int j = 0; j < m; j++) G(i, j) = gram[i * m + j];
+
+    // eigenvalues are returned in ascending order
+    SelfAdjointEigenSolver<MatrixXcd> eigen(G);
+    const auto &lambda = eigen.eigenvalues();
+    const auto &V = eigen.eigenvectors();
+
+    const double lambda_max = lambda(m - 1);
+    if (!(lambda_max > 0.0)) return 0;
+
+    // directions whose norm relative to the largest has fallen to the
+    // sloppy precision are numerically dependent and are dropped
+    const double tol = sqrt(precisionEpsilon(param.precision_sloppy)) * lambda_max;
+    std::vector<int> keep;
+    for (int j = m - 1; j >= 0; j--)
+      if (lambda(j) > tol) keep.push_back(j);
+    const int k = keep.size();
+
+    // p_j = sum_i w_i V(i, j) / sqrt(lambda_j)
+    std::vector<Complex> a(m * k);
+    for (int i = 0; i < m; i++)
+      for (int j = 0; j < k; j++) a[i * k + j] = V(i, keep[j]) / sqrt(lambda(keep[j]));
+
+    vector_ref<ColorSpinorField> P(p.begin(), p.begin() + k);
+    blas::zero(P);
+    blas::caxpy(a, W, P);
+
+    if (k < m) logQuda(QUDA_DEBUG_VERBOSE, "Block CG: dropped %d dependent search directions\n", m - k);
+
+    return k;
+  }
+
+  void BlockCG::operator()(ColorSpinorField &x, ColorSpinorField &b)
+  {
+    solve_multi_src(cvector_ref<ColorSpinorField> {x}, cvector_ref<ColorSpinorField> {b});
+  }
+
+  void BlockCG::solve_multi_src(cvector_ref<ColorSpinorField> &x, cvector_ref<ColorSpinorField> &b)
+  {
+    if (x.size() != b.size()) errorQuda("Mismatched number of solutions %lu and sources %lu", x.size(), b.size());
+    const int n_src = b.size();
+    if (n_src > QUDA_MAX_MULTI_SHIFT)
+      errorQuda("Number of sources %d exceeds QUDA_MAX_MULTI_SHIFT %d", n_src, QUDA_MAX_MULTI_SHIFT);
+
+    if (param.is_preconditioner) commGlobalReductionPush(param.global_reduction);
+
+    if (checkLocation(x[0], b[0]) != QUDA_CUDA_FIELD_LOCATION) errorQuda("Not supported");
+    if (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) errorQuda("Heavy-quark residual not supported by block CG");
+
+    if (param.maxiter == 0 || param.Nsteps == 0) {
+      if (param.use_init_guess == QUDA_USE_INIT_GUESS_NO) blas::zero(x);
+      if (param.is_preconditioner) commGlobalReductionPop();
+      return;
+    }
+
+    create(x, b);
+
+    if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    std::vector<double> b2(n_src);
+    for (int i = 0; i < n_src; i++) b2[i] = blas::norm2(b[i]);
+
+    if (param.deflate) {
+      // Construct the eigensolver and deflation space.
+      constructDeflationSpace(b[0], matEig);
+      if (deflate_compute) {
+        // compute the deflation space.
+        if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+        (*eig_solve)(evecs, evals);
+        prepareDeflationSpace();
+        if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+        deflate_compute = false;
+      }
+      if (recompute_evals) recomputeDeflationEvals();
+    }
+
+    vector_ref<ColorSpinorField> R(r.begin(), r.end());
+    vector_ref<ColorSpinorField> Y(y.begin(), y.end());
+    vector_ref<const ColorSpinorField> cR(r.begin(), r.end());
+    vector_ref<const ColorSpinorField> cY(y.begin(), y.end());
+
+    // compute the initial residuals, with y holding the initial guess
+    std::vector<double> r2(n_src);
+    if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+      vector_ref<const ColorSpinorField> cX(x.begin(), x.end());
+      mat(R, cX);
+      for (int i = 0; i < n_src; i++) {
+        r2[i] = blas::xmyNorm(b[i], r[i]);
+        blas::copy(y[i], x[i]);
+      }
+    } else {
+      for (int i = 0; i < n_src; i++) {
+        blas::copy(r[i], b[i]);
+        r2[i] = b2[i];
+      }
+      blas::zero(Y);
+    }
+
+    if (param.deflate && param.maxiter > 1) {
+      // Deflate and accumulate to solution vectors
+      eig_solve->deflate(Y, cR, evecs, evals, true);
+      mat(R, cY);
+      for (int i = 0; i < n_src; i++) r2[i] = blas::xmyNorm(b[i], r[i]);
+    }
+
+    // in uniform precision we accumulate directly into x
+    auto xS = [&](int i) -> ColorSpinorField & { return mixed() ? xSloppy[i] : x[i]; };
+
+    std::vector<double> stop(n_src);
+    std::vector<double> maxrr(n_src);         // largest iterated residual since the last reliable update
+    std::vector<double> maxr_deflate(n_src); // residual at which each system was last deflated
+    std::vector<int> active;                  // the systems which have not yet converged
+    for (int i = 0; i < n_src; i++) {
+      blas::zero(xS(i));
+      if (mixed()) blas::copy(rSloppy[i], r[i]);
+
+      // Check to see that we're not trying to invert on a zero-field source
+      if (b2[i] == 0) {
+        warningQuda("inverting on zero-field source %d\n", i);
+        blas::zero(y[i]);
+        r2[i] = 0.0;
+      }
+
+      stop[i] = stopping(param.tol, b2[i], param.residual_type); // stopping condition of solver
+      maxrr[i] = sqrt(r2[i]);
+      maxr_deflate[i] = sqrt(r2[i]);
+      if (b2[i] > 0 && r2[i] > stop[i]) active.push_back(i);
+    }
+
+    // the initial search directions are the orthonormalized residuals
+    for (auto j = 0u; j < active.size(); j++) blas::copy(w[j], rSloppy[active[j]]);
+    int k = active.size() > 0 ? orthonormalize(active.size()) : 0;
+
+    if (!param.is_preconditioner) {
+      blas::flops = 0;
+      profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+      profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    }
+
+    // print the statistics of the least converged system
+    auto print_stats = [&](int iter) {
+      if (active.empty()) return;
+      auto worst = *std::max_element(active.begin(), active.end(),
+                                     [&](int i, int j) { return r2[i] / b2[i] < r2[j] / b2[j]; });
+      PrintStats("Block CG", iter, r2[worst], b2[worst], 0.0);
+    };
+
+    int iter = 0;
+    int rUpdate = 0;
+
+    print_stats(iter);
+
+    while (!active.empty() && iter < param.maxiter) {
+      if (k == 0) {
+        warningQuda("Block CG: search space collapsed with %lu unconverged systems", active.size());
+        break;
+      }
+
+      int m = active.size();
+      vector_ref<ColorSpinorField> Q(q.begin(), q.begin() + k);
+      vector_ref<const ColorSpinorField> cP(p.begin(), p.begin() + k);
+      vector_ref<const ColorSpinorField> cQ(q.begin(), q.begin() + k);
+
+      // Q = A P with a single multi-RHS operator application
+      matSloppy(Q, cP);
+
+      // P^H [Q R] with a single multi-reduction
+      auto Ra = make_subset<ColorSpinorField>(rSloppy, active);
+      vector_ref<const ColorSpinorField> QR(q.begin(), q.begin() + k);
+      for (auto i : active) QR.push_back(rSloppy[i]);
+      std::vector<Complex> pqr(k * (k + m));
+      blas::cDotProduct(pqr, cP, QR);
+
+      MatrixXcd PQ(k, k);
+      MatrixXcd PR(k, m);
+      for (int i = 0; i < k; i++) {
+        for (int j = 0; j < k; j++) PQ(i, j) = pqr[i * (k + m) + j];
+        for (int j = 0; j < m; j++) PR(i, j) = pqr[i * (k + m) + k + j];
+      }
+      PQ = 0.5 * (PQ + PQ.adjoint()).eval();
+      auto PQ_ldlt = PQ.ldlt();
+
+      // X += P alpha, R -= Q alpha, with alpha = (P^H Q)^{-1} P^H R
+      MatrixXcd alpha = PQ_ldlt.solve(PR);
+      std::vector<Complex> a(k * m);
+      for (int i = 0; i < k; i++)
+        for (int j = 0; j < m; j++) a[i * m + j] = alpha(i, j);
+      vector_ref<ColorSpinorField> Xa;
+      for (auto i : active) Xa.push_back(xS(i));
+      blas::caxpy(a, cP, Xa);
+      for (auto &a_ij : a) a_ij = -a_ij;
+      blas::caxpy(a, cQ, Ra);
+
+      // Q^H R and the residual norms with a single multi-reduction
+      std::vector<Complex> qrr((k + m) * m);
+      blas::cDotProduct(qrr, QR, make_subset<const ColorSpinorField>(rSloppy, active));
+      MatrixXcd QHR(k, m);
+      for (int i = 0; i < k; i++)
+        for (int j = 0; j < m; j++) QHR(i, j) = qrr[i * m + j];
+      for (int j = 0; j < m; j++) r2[active[j]] = qrr[(k + j) * m + j].real();
+
+      iter++;
+
+      print_stats(iter);
+
+      // a reliable update is triggered once any system has either
+      // converged or reduced its residual sufficiently
+      bool update = false;
+      for (auto i : active) {
+        maxrr[i] = std::max(maxrr[i], sqrt(r2[i]));
+        if (r2[i] <= stop[i] || sqrt(r2[i]) < param.delta * maxrr[i]) update = true;
+      }
+
+      if (update) {
+        // flush the accumulated solutions and replace the residuals
+        for (auto i : active) {
+          if (mixed()) blas::copy(x[i], xSloppy[i]);
+          blas::xpy(x[i], y[i]);
+          blas::zero(xS(i));
+        }
+
+        auto ra = make_subset<ColorSpinorField>(r, active);
+        mat(ra, make_subset<const ColorSpinorField>(y, active));
+        for (auto i : active) r2[i] = blas::xmyNorm(b[i], r[i]);
+
+        if (param.deflate) {
+          std::vector<int> restart;
+          for (auto i : active)
+            if (sqrt(r2[i]) < maxr_deflate[i] * param.tol_restart) restart.push_back(i);
+
+          if (restart.size() > 0) {
+            // Deflate and accumulate to solution vectors
+            eig_solve->deflate(make_subset<ColorSpinorField>(y, restart),
+                               make_subset<const ColorSpinorField>(r, restart), evecs, evals, true);
+
+            // Compute r_defl = RHS - A * LHS
+            mat(make_subset<ColorSpinorField>(r, restart), make_subset<const ColorSpinorField>(y, restart));
+            for (auto i : restart) {
+              r2[i] = blas::xmyNorm(b[i], r[i]);
+              maxr_deflate[i] = sqrt(r2[i]);
+            }
+          }
+        }
+
+        if (mixed())
+          for (auto i : active) blas::copy(rSloppy[i], r[i]);
+
+        rUpdate++;
+
+        // remove the converged systems from the block
+        std::vector<int> unconverged;
+        for (auto i : active) {
+          if (r2[i] > stop[i]) unconverged.push_back(i);
+          maxrr[i] = sqrt(r2[i]);
+        }
+        if (unconverged.size() < active.size())
+          logQuda(QUDA_VERBOSE, "Block CG: %lu of %d systems converged at iteration %d\n",
+                  n_src - unconverged.size(), n_src, iter);
+        active = unconverged;
+        if (active.empty()) break;
+
+        // the residuals have changed so Q^H R must be recomputed
+        m = active.size();
+        std::vector<Complex> qr(k * m);
+        blas::cDotProduct(qr, cQ, make_subset<const ColorSpinorField>(rSloppy, active));
+        QHR.resize(k, m);
+        for (int i = 0; i < k; i++)
+          for (int j = 0; j < m; j++) QHR(i, j) = qr[i * m + j];
+      }
+
+      // W = R + P beta, with beta = -(P^H Q)^{-1} Q^H R making W A-orthogonal to P
+      MatrixXcd beta = -PQ_ldlt.solve(QHR);
+      std::vector<Complex> c(k * m);
+      for (int i = 0; i < k; i++)
+        for (int j = 0; j < m; j++) c[i * m + j] = beta(i, j);
+      for (int j = 0; j < m; j++) blas::copy(w[j], rSloppy[active[j]]);
+      blas::caxpy(c, cP, vector_ref<ColorSpinorField>(w.begin(), w.begin() + m));
+
+      k = orthonormalize(m);
+    }
+
+    // apply the trailing solution updates
+    for (int i = 0; i < n_src; i++) {
+      if (mixed()) blas::copy(x[i], xSloppy[i]);
+      blas::xpy(y[i], x[i]);
+    }
+
+    if (iter == param.maxiter) warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    logQuda(QUDA_VERBOSE, "Block CG: Reliable updates = %d\n", rUpdate);
+
+    param.true_res = 0.0;
+    param.true_res_hq = 0.0;
+    if (param.compute_true_res) {
+      // compute the true residuals
+      mat(R, vector_ref<const ColorSpinorField>(x.begin(), x.end()));
+      for (int i = 0; i < n_src; i++) {
+        double true_r2 = blas::xmyNorm(b[i], r[i]);
+        param.true_res_offset[i] = b2[i] > 0 ? sqrt(true_r2 / b2[i]) : 0.0;
+        param.true_res_hq_offset[i] = 0.0;
+        param.true_res = std::max(param.true_res, param.true_res_offset[i]);
+      }
+    }
+    for (int i = 0; i < n_src; i++) param.iter_res_offset[i] = b2[i] > 0 ? sqrt(r2[i] / b2[i]) : 0.0;
+
+    if (!param.is_preconditioner) {
+      qudaDeviceSynchronize(); // ensure solver is complete before ending timing
+      profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+      profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+      param.secs += profile.Last(QUDA_PROFILE_COMPUTE);
+
+      // store flops and reset counters
+      double gflops = (blas::flops + mat.flops() + matSloppy.flops() + matPrecon.flops() + matEig.flops()) * 1e-9;
+
+      param.gflops += gflops;
+      param.iter += iter;
+
+      // reset the flops counters
+      blas::flops = 0;
+      mat.flops();
+      matSloppy.flops();
+      matPrecon.flops();
+      matEig.flops();
+
+      profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    }
+
+    // PrintSummary reports param.true_res, so set it per system
+    const double true_res = param.true_res;
+    for (int i = 0; i < n_src; i++) {
+      if (b2[i] == 0) continue;
+      if (param.compute_true_res) param.true_res = param.true_res_offset[i];
+      PrintSummary("Block CG", iter, r2[i], b2[i], stop[i], param.tol_hq);
+    }
+    param.true_res = true_res;
+
+    if (param.is_preconditioner) commGlobalReductionPop();
+  }
+
+} // namespace quda
@@ -1,3 +1,6 @@
+#include <cmath>
+#include <limits>
+
 #include <invert_quda.h>
 #include <blas_quda.h>
 #include <eigen_helper.h>
@@ -16,7 +19,11 @@ namespace quda
 
   CACG::CACG(const DiracMatrix &mat, const DiracMatrix &matSloppy, const DiracMatrix &matPrecon,
              const DiracMatrix &matEig, SolverParam &param, TimeProfile &profile) :
-    Solver(mat, matSloppy, matPrecon, matEig, param, profile), lambda_init(false), basis(param.ca_basis)
+    Solver(mat, matSloppy, matPrecon, matEig, param, profile),
+    lambda_init(false),
+    basis(param.ca_basis),
+    ritz_min(std::numeric_limits<double>::max()),
+    ritz_max(0.0)
   {
   }
 
@@ -189,10 +196,13 @@ namespace quda
         profile.TPSTART(QUDA_PROFILE_INIT);
       }
 
-      Q_AQandg.resize(param.Nkrylov * (param.Nkrylov + 1));
-      Q_AS.resize(param.Nkrylov * param.Nkrylov);
-      alpha.resize(param.Nkrylov);
-      beta.resize(param.Nkrylov * param.Nkrylov);
+      // the adaptive basis starts at half the maximum length
+      const int n_krylov = adaptive() ? (param.Nkrylov + 1) / 2 : param.Nkrylov;
+
+      Q_AQandg.resize(n_krylov * (n_krylov + 1));
+      Q_AS.resize(n_krylov * n_krylov);
+      alpha.resize(n_krylov);
+      beta.resize(n_krylov * n_krylov);
 
       ColorSpinorParam csParam(b);
       csParam.create = QUDA_NULL_FIELD_CREATE;
@@ -202,18 +212,18 @@ namespace quda
       // now allocate sloppy fields
       csParam.setPrecision(param.precision_sloppy);
 
-      AS.resize(param.Nkrylov);
-      Q.resize(param.Nkrylov);
-      AQ.resize(param.Nkrylov);
-      Qtmp.resize(param.Nkrylov); // only used as an intermediate for pointer swaps
-      S.resize(param.Nkrylov);
-      for (int i = 0; i < param.Nkrylov; i++) {
+      AS.resize(n_krylov);
+      Q.resize(n_krylov);
+      AQ.resize(n_krylov);
+      Qtmp.resize(n_krylov); // only used as an intermediate for pointer swaps
+      S.resize(n_krylov);
+      for (int i = 0; i < n_krylov; i++) {
         AS[i] = ColorSpinorField(csParam);
         Q[i] = ColorSpinorField(csParam);
         AQ[i] = ColorSpinorField(csParam);
         Qtmp[i] = ColorSpinorField(csParam);
-        // in the power basis we can alias AS[k] to S[k+1]
-        S[i] = (basis == QUDA_POWER_BASIS && i > 0) ? AS[i - 1] : ColorSpinorField(csParam);
+        // in the power basis we can alias AS[k] to S[k+1], unless the basis may change
+        S[i] = (basis == QUDA_POWER_BASIS && i > 0 && !adaptive()) ? AS[i - 1] : ColorSpinorField(csParam);
       }
 
       if (!mixed()) r = S[0].create_alias(csParam);
@@ -224,6 +234,84 @@ namespace quda
     } // init
   }
 
+  void CACG::resize_basis(int n)
+  {
+    ColorSpinorParam csParam(S[0]);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+
+    auto resize = [&](std::vector<ColorSpinorField> &v) {
+      auto n_old = v.size();
+      v.resize(n);
+      for (auto i = n_old; i < v.size(); i++) v[i] = ColorSpinorField(csParam);
+    };
+    resize(AS);
+    resize(Q);
+    resize(AQ);
+    resize(Qtmp);
+    resize(S);
+
+    Q_AQandg.resize(n * (n + 1));
+    Q_AS.resize(n * n);
+    alpha.resize(n);
+    beta.resize(n * n);
+  }
+
+  /**
+     @brief Compute the extreme Ritz values of the operator on the
+     space spanned by Q, from the solution of the generalized
+     eigenvalue problem Q^dagger A Q v = lambda Q^dagger Q v
+     @param[in] Q_AQandQ The fused inner product matrix [Q_AQ Q_Q g]
+     @param[in] N The dimension of the space
+     @param[out] lambda_min The smallest Ritz value
+     @param[out] lambda_max The largest Ritz value
+     @return Whether the eigenvalue problem was successfully solved
+  */
+  static bool compute_ritz_bounds(const std::vector<double> &Q_AQandQ, int N, double &lambda_min, double &lambda_max)
+  {
+    typedef Matrix<double, Dynamic, Dynamic, RowMajor> matrix;
+    matrix matQ_AQ(N, N);
+    matrix matQ_Q(N, N);
+    for (int i = 0; i < N; i++) {
+      for (int j = 0; j < N; j++) {
+        matQ_AQ(i, j) = Q_AQandQ[i * (2 * N + 1) + j];
+        matQ_Q(i, j) = Q_AQandQ[i * (2 * N + 1) + N + j];
+      }
+    }
+    matQ_AQ = 0.5 * (matQ_AQ + matQ_AQ.transpose()).eval();
+    matQ_Q = 0.5 * (matQ_Q + matQ_Q.transpose()).eval();
+
+    GeneralizedSelfAdjointEigenSolver<matrix> eigensolver(matQ_AQ, matQ_Q, EigenvaluesOnly);
+    if (eigensolver.info() != Success || !eigensolver.eigenvalues().allFinite()) return false;
+
+    lambda_min = eigensolver.eigenvalues()(0);
+    lambda_max = eigensolver.eigenvalues()(N - 1);
+    return lambda_min > 0.0;
+  }
+
+  /**
+     @brief Select the basis length for the following cycles by hill
+     climbing on the measured convergence rate, log(|r_0|^2 / |r|^2)
+     per second.  Unmeasured neighbouring lengths are explored first,
+     else the fastest of n-1, n and n+1 is chosen.
+     @param[in] log_reduction Accumulated log residual reduction for each length
+     @param[in] time Accumulated time for each length
+     @param[in] n The current basis length
+     @param[in] n_max The maximum basis length
+     @return The selected basis length
+  */
+  static int select_basis_length(const std::vector<double> &log_reduction, const std::vector<double> &time, int n,
+                                 int n_max)
+  {
+    if (n < n_max && time[n + 1] == 0.0) return n + 1;
+    if (n > 1 && time[n - 1] == 0.0) return n - 1;
+
+    auto rate = [&](int m) { return log_reduction[m] / time[m]; };
+    int n_best = n;
+    for (int m = std::max(1, n - 1); m <= std::min(n_max, n + 1); m++)
+      if (rate(m) > rate(n_best)) n_best = m;
+    return n_best;
+  }
+
   // template!
   template <int N> void compute_alpha_N(const std::vector<double> &Q_AQandg, std::vector<double> &alpha)
   {
@@ -244,7 +332,7 @@ namespace quda
     // psi = svd.solve(phi);
   }
 
-  void CACG::compute_alpha()
+  bool CACG::compute_alpha()
   {
     if (!param.is_preconditioner) {
       profile.TPSTOP(QUDA_PROFILE_COMPUTE);
@@ -252,6 +340,7 @@ namespace quda
       profile.TPSTART(QUDA_PROFILE_EIGEN);
     }
 
+    bool stable = true;
     const int N = Q.size();
     switch (N) {
 #if 0 // since CA-CG is not used anywhere at the moment, no point paying for this compilation cost
@@ -281,7 +370,14 @@ namespace quda
       }
       Map<vector> vecalpha(alpha.data(), N);
 
-      vecalpha = matQ_AQ.fullPivLu().solve(vecg);
+      auto lu = matQ_AQ.fullPivLu();
+      vecalpha = lu.solve(vecg);
+
+      // the basis has lost stability if Q_AQ is singular to the sloppy precision
+      const double eps = param.precision_sloppy == 8 ?
+        std::numeric_limits<double>::epsilon() :
+        ((param.precision_sloppy == 4) ? std::numeric_limits<float>::epsilon() : pow(2., -17));
+      stable = vecalpha.allFinite() && lu.rcond() > eps;
 
       // JacobiSVD<matrix> svd(A, ComputeThinU | ComputeThinV);
       // psi = svd.solve(phi);
@@ -293,6 +389,8 @@ namespace quda
       param.secs += profile.Last(QUDA_PROFILE_EIGEN);
       profile.TPSTART(QUDA_PROFILE_COMPUTE);
     }
+
+    return stable;
   }
 
   // template!
@@ -408,15 +506,15 @@ namespace quda
   {
     if (param.is_preconditioner) commGlobalReductionPush(param.global_reduction);
 
-    const int n_krylov = param.Nkrylov;
-
-    if (param.maxiter == 0 || n_krylov == 0) {
+    if (param.maxiter == 0 || param.Nkrylov == 0) {
       if (param.use_init_guess == QUDA_USE_INIT_GUESS_NO) blas::zero(x);
       return;
     }
 
     create(x, b);
 
+    int n_krylov = Q.size(); // the basis length, which is only varied in adaptive mode
+
     if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_PREAMBLE);
 
     // compute b2, but only if we need to
@@ -431,13 +529,11 @@ namespace quda
         // compute the deflation space.
         if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
         (*eig_solve)(evecs, evals);
+        prepareDeflationSpace();
         if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_PREAMBLE);
         deflate_compute = false;
       }
-      if (recompute_evals) {
-        eig_solve->computeEvals(evecs, evals);
-        recompute_evals = false;
-      }
+      if (recompute_evals) recomputeDeflationEvals();
     }
 
     // compute initial residual depending on whether we have an initial guess or not
@@ -473,6 +569,11 @@ namespace quda
     auto &lambda_min = param.ca_lambda_min;
     auto &lambda_max = param.ca_lambda_max;
 
+    // In adaptive mode the Chebyshev bounds are instead estimated from
+    // the Ritz values, with the power basis used until they are known
+    const bool adapt = adaptive() && !fixed_iteration;
+    if (adapt && basis == QUDA_CHEBYSHEV_BASIS && lambda_max < lambda_min && !lambda_init) basis = QUDA_POWER_BASIS;
+
     if (basis == QUDA_CHEBYSHEV_BASIS && lambda_max < lambda_min && !lambda_init) {
       if (!param.is_preconditioner) {
         profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
@@ -543,19 +644,58 @@ namespace quda
 
     blas::copy(S[0], r); // no op if uni-precision
 
+    // State for the adaptive basis: the residual reduction and time
+    // measured for each basis length, from which the convergence rate
+    // per unit time is derived
+    int n_max = param.Nkrylov;    // the largest basis length found to be stable
+    std::vector<double> log_reduction(param.Nkrylov + 1, 0.0);
+    std::vector<double> cycle_time(param.Nkrylov + 1, 0.0);
+    const int adapt_cycles = 4;   // number of cycles measured before the basis length is adapted
+    int cycles = 0;               // number of cycles measured since the basis length last changed
+    bool restart = false;         // whether to restart the direction vectors
+    bool estimate = adapt;        // whether we are still estimating the Ritz values
+    double r2_cycle = 0.0;        // the iterated residual at the start of the previous cycle
+    host_timer_t cycle_timer;
+    if (adapt) cycle_timer.start();
+
+    // Respond to a loss of stability of the basis: prefer switching to
+    // the Chebyshev basis, else shorten the basis.  In both cases the
+    // direction vectors are restarted.
+    auto stabilize = [&]() {
+      if (basis == QUDA_POWER_BASIS && lambda_init) {
+        basis = QUDA_CHEBYSHEV_BASIS;
+        logQuda(QUDA_SUMMARIZE, "CA-CG: power basis lost stability, switching to the Chebyshev basis\n");
+      } else if (n_krylov > 1) {
+        n_max = std::max(1, n_krylov / 2);
+        logQuda(QUDA_SUMMARIZE, "CA-CG: basis lost stability, reducing the basis length from %d to %d\n", n_krylov, n_max);
+        n_krylov = n_max;
+        resize_basis(n_krylov);
+        cycles = 0;
+      }
+      restart = true;
+      r2_cycle = 0.0;
+    };
+
     PrintStats("CA-CG", total_iter, r2, b2, heavy_quark_res);
     while (!convergence(r2, heavy_quark_res, stop, param.tol_hq) && total_iter < param.maxiter) {
 
+      if (adapt && basis == QUDA_CHEBYSHEV_BASIS) {
+        // the bounds may have been updated
+        m_map = 2. / (lambda_max - lambda_min);
+        b_map = -(lambda_max + lambda_min) / (lambda_max - lambda_min);
+      }
+
       // build up a space of size n_krylov, assumes S[0] is in place
       computeCAKrylovSpace(matSloppy, AS, S, n_krylov, basis, m_map, b_map);
 
       // we can greatly simplify the workflow for fixed iterations
       if (!fixed_iteration) {
         // first iteration, copy S and AS into Q and AQ
-        if (total_iter == 0) {
+        if (total_iter == 0 || restart) {
           // first iteration Q = S
           for (int i = 0; i < n_krylov; i++) Q[i] = S[i];
           for (int i = 0; i < n_krylov; i++) AQ[i] = AS[i];
+          restart = false;
 
         } else {
 
@@ -576,20 +716,79 @@ namespace quda
         // compute the alpha coefficients
         // 1. Compute Q_AQ = Q^\dagger AQ and g = Q^dagger r = Q^dagger S[0]
         // 2. Solve Q_AQ alpha = g
-        {
+        bool stable;
+        if (estimate) {
+          // Fuse the Gram matrix Q_Q into the same reduction, giving the Ritz values on the span of Q
+          std::vector<double> Q_AQandQ(n_krylov * (2 * n_krylov + 1));
+          blas::reDotProduct(Q_AQandQ, Q, {AQ, Q, S[0]});
+          for (int i = 0; i < n_krylov; i++) {
+            for (int j = 0; j < n_krylov; j++) Q_AQandg[i * (n_krylov + 1) + j] = Q_AQandQ[i * (2 * n_krylov + 1) + j];
+            Q_AQandg[i * (n_krylov + 1) + n_krylov] = Q_AQandQ[i * (2 * n_krylov + 1) + 2 * n_krylov];
+          }
+
+          profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+          param.secs += profile.Last(QUDA_PROFILE_COMPUTE);
+          profile.TPSTART(QUDA_PROFILE_EIGEN);
+          double ritz_lo, ritz_hi;
+          bool valid = compute_ritz_bounds(Q_AQandQ, n_krylov, ritz_lo, ritz_hi);
+          profile.TPSTOP(QUDA_PROFILE_EIGEN);
+          param.secs += profile.Last(QUDA_PROFILE_EIGEN);
+          profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+          if (valid) {
+            // Ritz values lie within the spectrum, so the extremes seen bound it from the inside
+            const double ritz_min_old = ritz_min;
+            const double ritz_max_old = ritz_max;
+            ritz_min = std::min(ritz_min, ritz_lo);
+            ritz_max = std::max(ritz_max, ritz_hi);
+            lambda_min = ritz_min;
+            lambda_max = 1.1 * ritz_max;
+            logQuda(QUDA_VERBOSE, "CA-CG: Ritz value bounds [%e, %e]\n", ritz_min, ritz_max);
+
+            // stop estimating once the bounds have settled
+            if (lambda_init && ritz_min > 0.99 * ritz_min_old && ritz_max < 1.01 * ritz_max_old) estimate = false;
+            lambda_init = true;
+
+            if (param.ca_basis == QUDA_CHEBYSHEV_BASIS && basis == QUDA_POWER_BASIS) {
+              logQuda(QUDA_VERBOSE, "CA-CG: switching to the Chebyshev basis with bounds [%e, %e]\n", lambda_min,
+                      lambda_max);
+              basis = QUDA_CHEBYSHEV_BASIS;
+            }
+          }
+        } else {
           blas::reDotProduct(Q_AQandg, Q, {AQ, S[0]});
-          compute_alpha();
+        }
+        stable = compute_alpha();
+
+        if (adapt) {
+          if (!stable) {
+            // discard this cycle, rebuilding the basis from the current residual
+            total_iter += n_krylov;
+            stabilize();
+            continue;
+          }
+
+          // measure the reduction of the iterated residual in the previous cycle against its time
+          cycle_timer.stop();
+          const double r2_start = Q_AQandg[n_krylov];
+          if (r2_cycle > 0.0 && r2_start > 0.0) {
+            log_reduction[n_krylov] += log(r2_cycle / r2_start);
+            cycle_time[n_krylov] += cycle_timer.last();
+            cycles++;
+          }
+          r2_cycle = r2_start;
+          cycle_timer.start();
         }
 
         // update the solution vector
         blas::axpy(alpha, Q, x);
 
-        for (int i = 0; i < param.Nkrylov; i++) { alpha[i] = -alpha[i]; }
+        for (int i = 0; i < n_krylov; i++) { alpha[i] = -alpha[i]; }
 
         // Can we fuse these? We don't need this reduce in all cases...
         blas::axpy(alpha, AQ, S[0]);
         // if (getVerbosity() >= QUDA_VERBOSE) r2 = blas::norm2(S[0]);
-        /*else*/ r2 = Q_AQandg[param.Nkrylov]; // actually the old r2... so we do one more iter than needed...
+        /*else*/ r2 = Q_AQandg[n_krylov]; // actually the old r2... so we do one more iter than needed...
       } else {
         // fixed iterations
         // On the first pass, Q = S; AQ = AQ. We can just skip that.
@@ -606,7 +805,7 @@ namespace quda
         blas::axpy(alpha, S, x);
 
         // no need to update AS
-        r2 = Q_AQandg[param.Nkrylov]; // actually the old r2... so we do one more iter than needed...
+        r2 = Q_AQandg[n_krylov]; // actually the old r2... so we do one more iter than needed...
       }
 
       // NOTE: Because we always carry around the residual from an iteration before, we
@@ -651,12 +850,31 @@ namespace quda
             warningQuda("CA-CG: solver exiting due to too many true residual norm increases");
             break;
           }
+          if (adapt) stabilize();
         } else {
           resIncrease = 0;
         }
 
         r2_old = r2;
       }
+
+      if (adapt && cycles >= adapt_cycles) {
+        // choose the basis length with the best convergence rate per unit time
+        int n_new = select_basis_length(log_reduction, cycle_time, n_krylov, n_max);
+        if (n_new != n_krylov) {
+          logQuda(QUDA_VERBOSE, "CA-CG: changing basis length from %d to %d\n", n_krylov, n_new);
+          n_krylov = n_new;
+          resize_basis(n_krylov);
+          restart = true;
+          r2_cycle = 0.0;
+        }
+        cycles = 0;
+      }
+    }
+
+    if (adapt) {
+      logQuda(QUDA_VERBOSE, "CA-CG: final basis length %d with the %s basis\n", n_krylov,
+              basis == QUDA_POWER_BASIS ? "power" : "Chebyshev");
     }
 
     if (total_iter > param.maxiter && getVerbosity() >= QUDA_SUMMARIZE)
@@ -170,15 +170,12 @@ namespace quda
           extendSVDDeflationSpace();
           // populate extra memory with L/R singular vectors
           eig_solve->computeSVD(evecs, evals);
+          prepareDeflationSpace();
         }
         if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_PREAMBLE);
         deflate_compute = false;
       }
-      if (recompute_evals) {
-        eig_solve->computeEvals(evecs, evals);
-        eig_solve->computeSVD(evecs, evals);
-        recompute_evals = false;
-      }
+      if (recompute_evals) recomputeDeflationEvals(true);
     }
 
     // compute intitial residual depending on whether we have an initial guess or not
@@ -281,13 +281,11 @@ namespace quda {
         // compute the deflation space.
         if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_INIT);
         (*eig_solve)(evecs, evals);
+        prepareDeflationSpace();
         if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_INIT);
         deflate_compute = false;
       }
-      if (recompute_evals) {
-        eig_solve->computeEvals(evecs, evals);
-        recompute_evals = false;
-      }
+      if (recompute_evals) recomputeDeflationEvals();
     }
 
     ColorSpinorField &r = *rp;
@@ -250,15 +250,12 @@ namespace quda {
           extendSVDDeflationSpace();
           // populate extra memory with L/R singular vectors
           eig_solve->computeSVD(evecs, evals);
+          prepareDeflationSpace();
         }
         profile.TPSTART(QUDA_PROFILE_INIT);
         deflate_compute = false;
       }
-      if (recompute_evals) {
-        eig_solve->computeEvals(evecs, evals);
-        eig_solve->computeSVD(evecs, evals);
-        recompute_evals = false;
-      }
+      if (recompute_evals) recomputeDeflationEvals(true);
     }
 
     double b2 = blas::norm2(b);  // norm sq of source
@@ -0,0 +1,414 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include <invert_quda.h>
+#include <blas_quda.h>
+#include <util_quda.h>
+#include <eigen_helper.h>
+
+/**
+   @file inv_gcrodr_quda.cpp
+
+   Implementation of GCRO-DR (Parks, de Sturler, Mackey, Johnson and
+   Maiti, SIAM J. Sci. Comput. 28, 1651 (2006)).  A recycle space U,
+   with C = A U orthonormal, is carried between restart cycles and,
+   optionally, between solves.  Each cycle first removes the
+   component of the residual in range(C), and then runs Arnoldi on
+   (1 - C C^dagger) A, so that the Krylov space never has to
+   rediscover the slow modes captured by U.  At the end of each cycle
+   U is replaced by the harmonic Ritz vectors of smallest magnitude
+   over span{U, V}.
+
+   The Arnoldi process and the recycle space are kept in sloppy
+   precision, while the correction from each cycle is accumulated
+   into the solution in high precision and followed by a true
+   residual computation.
+*/
+
+namespace quda
+{
+
+  /**
+     @brief Helper to form the concatenation of two sets of fields
+     @param[in] a The leading set of fields
+     @param[in] na The number of fields from a to include
+     @param[in] b The trailing set of fields
+     @param[in] nb The number of fields from b to include
+     @return The vector_ref to the concatenated set
+  */
+  template <class T, class V> static vector_ref<T> concat(V &a, int na, V &b, int nb)
+  {
+    vector_ref<T> set;
+    set.reserve(na + nb);
+    for (int i = 0; i < na; i++) set.push_back(a[i]);
+    for (int i = 0; i < nb; i++) set.push_back(b[i]);
+    return set;
+  }
+
+  /**
+     @brief Flatten the coefficient matrix into the row-major layout
+     expected by the block caxpy
+  */
+  static std::vector<Complex> flatten(const MatrixXcd &a)
+  {
+    std::vector<Complex> a_(a.rows() * a.cols());
+    for (int i = 0; i < a.rows(); i++)
+      for (int j = 0; j < a.cols(); j++) a_[i * a.cols() + j] = a(i, j);
+    return a_;
+  }
+
+  GCRODR::GCRODR(const DiracMatrix &mat, const DiracMatrix &matSloppy, const DiracMatrix &matPrecon,
+                 const DiracMatrix &matEig, SolverParam &param, TimeProfile &profile) :
+    Solver(mat, matSloppy, matPrecon, matEig, param, profile), n_krylov(param.Nkrylov), n_recycle(param.n_ev)
+  {
+    if (n_recycle <= 0 || n_recycle >= n_krylov)
+      errorQuda("Recycle space dimension %d must be positive and less than the Krylov space dimension %d", n_recycle,
+                n_krylov);
+    if (param.inv_type_precondition != QUDA_INVALID_INVERTER)
+      errorQuda("Preconditioned GCRO-DR is not supported (inv_type_precondition = %d)", param.inv_type_precondition);
+  }
+
+  GCRODR::~GCRODR()
+  {
+    profile.TPSTART(QUDA_PROFILE_FREE);
+    preserveRecycleSpace();
+    profile.TPSTOP(QUDA_PROFILE_FREE);
+  }
+
+  void GCRODR::create(ColorSpinorField &x, const ColorSpinorField &b)
+  {
+    Solver::create(x, b);
+
+    if (!init) {
+      profile.TPSTART(QUDA_PROFILE_INIT);
+      ColorSpinorParam csParam(x);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      r = ColorSpinorField(csParam);
+
+      csParam.setPrecision(param.precision_sloppy);
+      r_sloppy = ColorSpinorField(csParam);
+      e = ColorSpinorField(csParam);
+      resize(V, n_krylov + 1, csParam);
+      resize(U, n_recycle, csParam);
+      resize(C, n_recycle, csParam);
+      resize(U_tmp, n_recycle, csParam);
+      resize(C_tmp, n_recycle, csParam);
+
+      profile.TPSTOP(QUDA_PROFILE_INIT);
+      init = true;
+    }
+  }
+
+  bool GCRODR::orthonormalizeRecycleSpace()
+  {
+    // two passes of Cholesky QR, C = Q R with Q = C R^{-1} and U -> U R^{-1}
+    for (int pass = 0; pass < 2; pass++) {
+      std::vector<Complex> gram(n_recycle * n_recycle);
+      blas::cDotProduct(gram, C, C);
+
+      MatrixXcd G(n_recycle, n_recycle);
+      for (int i = 0; i < n_recycle; i++)
+        for (int j = 0; j < n_recycle; j++) G(i, j) = gram[i * n_recycle + j];
+
+      LLT<MatrixXcd> llt(G);
+      if (llt.info() != Success) return false;
+      MatrixXcd R_inv = llt.matrixU().solve(MatrixXcd::Identity(n_recycle, n_recycle));
+      auto a = flatten(R_inv);
+
+      blas::zero(C_tmp);
+      blas::caxpy(a, C, C_tmp);
+      std::swap(C, C_tmp);
+      blas::zero(U_tmp);
+      blas::caxpy(a, U, U_tmp);
+      std::swap(U, U_tmp);
+    }
+    return true;
+  }
+
+  bool GCRODR::restoreRecycleSpace()
+  {
+    auto space = static_cast<recycle_space *>(param.recycle_space);
+    if (!space) return false;
+
+    bool restored = false;
+    if (space->U.size() == static_cast<size_t>(n_recycle) && space->U[0].VolumeCB() == U[0].VolumeCB()
+        && space->U[0].SiteSubset() == U[0].SiteSubset() && space->U[0].Nspin() == U[0].Nspin()
+        && space->U[0].Ncolor() == U[0].Ncolor()) {
+      logQuda(QUDA_VERBOSE, "Restoring recycle space of size %lu\n", space->U.size());
+      for (int i = 0; i < n_recycle; i++) U[i] = space->U[i];
+      restored = true;
+    } else {
+      warningQuda("Discarding preserved recycle space of size %lu incompatible with the current solve",
+                  space->U.size());
+    }
+
+    delete space;
+    param.recycle_space = nullptr;
+    if (!restored) return false;
+
+    // the operator may have changed since the space was preserved,
+    // so recompute its image with a single batched application
+    matSloppy(C, U);
+    if (!orthonormalizeRecycleSpace()) {
+      warningQuda("Preserved recycle space is rank deficient, discarding");
+      return false;
+    }
+    return true;
+  }
+
+  void GCRODR::preserveRecycleSpace()
+  {
+    if (param.preserve_recycle && recycle) {
+      logQuda(QUDA_VERBOSE, "Preserving recycle space of size %d\n", n_recycle);
+      if (param.recycle_space) delete static_cast<recycle_space *>(param.recycle_space);
+      auto space = new recycle_space;
+      space->U = std::move(U);
+      param.recycle_space = space;
+      recycle = false;
+    } else if (!param.preserve_recycle && param.recycle_space) {
+      delete static_cast<recycle_space *>(param.recycle_space);
+      param.recycle_space = nullptr;
+    }
+  }
+
+  void GCRODR::operator()(ColorSpinorField &x, ColorSpinorField &b)
+  {
+    create(x, b);
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+
+    double b2 = blas::norm2(b); // norm sq of source
+    double r2;                  // norm sq of residual
+
+    // compute initial residual depending on whether we have an initial guess or not
+    if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+      mat(r, x);
+      r2 = blas::xmyNorm(b, r);
+    } else {
+      blas::copy(r, b);
+      r2 = b2;
+      blas::zero(x);
+    }
+
+    // Check to see that we're not trying to invert on a zero-field source
+    if (b2 == 0) {
+      if (param.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_NO) {
+        profile.TPSTOP(QUDA_PROFILE_INIT);
+        warningQuda("inverting on zero-field source\n");
+        x = b;
+        param.true_res = 0.0;
+        param.true_res_hq = 0.0;
+        return;
+      } else {
+        b2 = r2;
+      }
+    }
+
+    double stop = stopping(param.tol, b2, param.residual_type); // stopping condition of solver
+
+    const bool use_heavy_quark_res = (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) ? true : false;
+    double heavy_quark_res = use_heavy_quark_res ? sqrt(blas::HeavyQuarkResidualNorm(x, r).z) : 0.0;
+
+    const int maxResIncrease = param.max_res_increase;
+    const int maxResIncreaseTotal = param.max_res_increase_total;
+    int resIncrease = 0;
+    int resIncreaseTotal = 0;
+
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+    profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    blas::flops = 0;
+    if (!recycle) recycle = restoreRecycleSpace();
+
+    profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+
+    int total_iter = 0;
+    int restart = 0;
+    double r2_old = r2;
+
+    // G is the projected operator, A [U V_n] = [C V_{n+1}] G
+    MatrixXcd G(n_krylov + 1, n_krylov);
+
+    PrintStats("GCRO-DR", total_iter, r2, b2, heavy_quark_res);
+    while (!convergence(r2, heavy_quark_res, stop, param.tol_hq) && total_iter < param.maxiter) {
+
+      const int kc = recycle ? n_recycle : 0;
+      blas::copy(r_sloppy, r);
+      blas::zero(e);
+
+      // remove the component of the residual in range(C): e = U C^dagger r, r -= C C^dagger r
+      if (kc > 0) {
+        std::vector<Complex> c(kc);
+        blas::cDotProduct(c, C, r_sloppy);
+        blas::caxpy(c, U, e);
+        for (auto &c_i : c) c_i = -c_i;
+        blas::caxpy(c, C, r_sloppy);
+      }
+
+      const double beta = sqrt(blas::norm2(r_sloppy));
+      if (beta > 0.0) blas::axy(1.0 / beta, r_sloppy, V[0]);
+
+      G.setZero();
+      for (int i = 0; i < kc; i++) G(i, i) = 1.0;
+      VectorXcd y = VectorXcd::Zero(kc);
+      int n = 0;
+
+      // Arnoldi on (1 - C C^dagger) A
+      for (int j = 0; j < n_krylov - kc && total_iter < param.maxiter && beta > 0.0; j++) {
+        matSloppy(V[j + 1], V[j]);
+
+        if (kc > 0) {
+          std::vector<Complex> c(kc);
+          blas::cDotProduct(c, C, V[j + 1]);
+          for (int i = 0; i < kc; i++) {
+            G(i, kc + j) = c[i];
+            c[i] = -c[i];
+          }
+          blas::caxpy(c, C, V[j + 1]);
+        }
+
+        // classical Gram-Schmidt with reorthogonalization
+        for (int pass = 0; pass < 2; pass++) {
+          std::vector<Complex> h(j + 1);
+          blas::cDotProduct(h, {V.begin(), V.begin() + j + 1}, V[j + 1]);
+          for (int i = 0; i <= j; i++) {
+            G(kc + i, kc + j) += h[i];
+            h[i] = -h[i];
+          }
+          blas::caxpy(h, {V.begin(), V.begin() + j + 1}, V[j + 1]);
+        }
+
+        const double h = sqrt(blas::norm2(V[j + 1]));
+        G(kc + j + 1, kc + j) = h;
+        if (h > 0.0) blas::ax(1.0 / h, V[j + 1]);
+
+        n = j + 1;
+        total_iter++;
+
+        // solve the least squares problem min |beta e_kc - G y|
+        VectorXcd rhs = VectorXcd::Zero(kc + n + 1);
+        rhs(kc) = beta;
+        auto Gn = G.topLeftCorner(kc + n + 1, kc + n);
+        y = Gn.colPivHouseholderQr().solve(rhs);
+        r2 = (rhs - Gn * y).squaredNorm();
+
+        PrintStats("GCRO-DR", total_iter, r2, b2, heavy_quark_res);
+        if (h == 0.0 || r2 < stop) break;
+      }
+
+      // accumulate the correction e += [U V_n] y, and update the solution in high precision
+      {
+        std::vector<Complex> y_(y.data(), y.data() + kc + n);
+        blas::caxpy(y_, concat<const ColorSpinorField>(U, kc, V, n), e);
+      }
+      blas::copy(r, e);
+      blas::xpy(r, x);
+
+      // update the recycle space with the harmonic Ritz vectors of smallest magnitude
+      if (kc + n > n_recycle) {
+        const int m = kc + n;
+        auto Gm = G.topLeftCorner(m + 1, m);
+
+        // Z = [C V_{n+1}]^dagger [U V_n]
+        MatrixXcd Z = MatrixXcd::Zero(m + 1, m);
+        if (kc > 0) {
+          std::vector<Complex> CU(kc * kc);
+          blas::cDotProduct(CU, C, U);
+          std::vector<Complex> VU((n + 1) * kc);
+          blas::cDotProduct(VU, {V.begin(), V.begin() + n + 1}, U);
+          for (int i = 0; i < kc; i++)
+            for (int j = 0; j < kc; j++) Z(i, j) = CU[i * kc + j];
+          for (int i = 0; i <= n; i++)
+            for (int j = 0; j < kc; j++) Z(kc + i, j) = VU[i * kc + j];
+        }
+        for (int i = 0; i < n; i++) Z(kc + i, kc + i) = 1.0;
+
+        // G^dagger G z = theta G^dagger Z z
+        MatrixXcd GhG = Gm.adjoint() * Gm;
+        MatrixXcd GhZ = Gm.adjoint() * Z;
+        ComplexEigenSolver<MatrixXcd> eigensolver(GhZ.partialPivLu().solve(GhG));
+
+        if (eigensolver.info() == Success) {
+          std::vector<int> order(m);
+          std::iota(order.begin(), order.end(), 0);
+          std::sort(order.begin(), order.end(), [&](int a, int b) {
+            return std::abs(eigensolver.eigenvalues()(a)) < std::abs(eigensolver.eigenvalues()(b));
+          });
+
+          MatrixXcd P(m, n_recycle);
+          for (int i = 0; i < n_recycle; i++) P.col(i) = eigensolver.eigenvectors().col(order[i]);
+
+          // G P = Q R, C = [C V_{n+1}] Q, U = [U V_n] P R^{-1}
+          HouseholderQR<MatrixXcd> qr(Gm * P);
+          MatrixXcd Q = qr.householderQ() * MatrixXcd::Identity(m + 1, n_recycle);
+          MatrixXcd R = qr.matrixQR().topLeftCorner(n_recycle, n_recycle).triangularView<Upper>();
+          MatrixXcd PR_inv = P * R.triangularView<Upper>().solve(MatrixXcd::Identity(n_recycle, n_recycle));
+
+          if (Q.allFinite() && PR_inv.allFinite()) {
+            blas::zero(C_tmp);
+            blas::caxpy(flatten(Q), concat<const ColorSpinorField>(C, kc, V, n + 1), C_tmp);
+            blas::zero(U_tmp);
+            blas::caxpy(flatten(PR_inv), concat<const ColorSpinorField>(U, kc, V, n), U_tmp);
+            std::swap(U, U_tmp);
+            std::swap(C, C_tmp);
+            recycle = true;
+          }
+        } else {
+          warningQuda("Harmonic Ritz eigensolve failed, retaining the previous recycle space");
+        }
+      }
+
+      mat(r, x);
+      r2 = blas::xmyNorm(b, r);
+      if (use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(x, r).z);
+
+      // break-out check if we have reached the limit of the precision
+      if (r2 > r2_old) {
+        resIncrease++;
+        resIncreaseTotal++;
+        warningQuda(
+          "GCRO-DR: new reliable residual norm %e is greater than previous reliable residual norm %e (total #inc %i)",
+          sqrt(r2), sqrt(r2_old), resIncreaseTotal);
+        if (resIncrease > maxResIncrease or resIncreaseTotal > maxResIncreaseTotal) {
+          warningQuda("GCRO-DR: solver exiting due to too many true residual norm increases");
+          break;
+        }
+      } else {
+        resIncrease = 0;
+      }
+      r2_old = r2;
+
+      if (!convergence(r2, heavy_quark_res, stop, param.tol_hq)) {
+        restart++;
+        PrintStats("GCRO-DR (restart)", restart, r2, b2, heavy_quark_res);
+      }
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    param.secs += profile.Last(QUDA_PROFILE_COMPUTE);
+    param.gflops += (blas::flops + mat.flops() + matSloppy.flops()) * 1e-9;
+    param.iter += total_iter;
+
+    if (total_iter >= param.maxiter) warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    logQuda(QUDA_VERBOSE, "GCRO-DR: number of restarts = %d\n", restart);
+
+    // r already holds the true residual
+    param.true_res = sqrt(r2 / b2);
+    param.true_res_hq = use_heavy_quark_res ? heavy_quark_res : 0.0;
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+
+    PrintSummary("GCRO-DR", total_iter, r2, b2, stop, param.tol_hq);
+  }
+
+} // namespace quda
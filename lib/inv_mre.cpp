@@ -10,18 +10,39 @@ namespace quda
   {
   }
 
-  /* Solve the equation A p_k psi_k = b by minimizing the residual and
-     using Eigen's SVD algorithm for numerical stability */
-  void MinResExt::solve(std::vector<Complex> &psi_, std::vector<ColorSpinorField> &p, std::vector<ColorSpinorField> &q,
-                        const ColorSpinorField &b, bool hermitian)
+  void MinResExt::solve(std::vector<Complex> &psi_, const std::vector<Complex> &A_, const std::vector<Complex> &phi_)
   {
     typedef Matrix<Complex, Dynamic, Dynamic> matrix;
     typedef Matrix<Complex, Dynamic, 1> vector;
 
-    const int N = q.size();
+    const int N = phi_.size();
     vector phi(N), psi(N);
     matrix A(N, N);
 
+    for (int i = 0; i < N; i++) {
+      phi(i) = phi_[i];
+      for (int j = 0; j < N; j++) { A(i, j) = A_[i * N + j]; }
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_CHRONO);
+    profile.TPSTART(QUDA_PROFILE_EIGEN);
+
+    LDLT<matrix> cholesky(A);
+    psi = cholesky.solve(phi);
+
+    profile.TPSTOP(QUDA_PROFILE_EIGEN);
+    profile.TPSTART(QUDA_PROFILE_CHRONO);
+
+    for (int i = 0; i < N; i++) psi_[i] = psi(i);
+  }
+
+  /* Solve the equation A p_k psi_k = b by minimizing the residual and
+     using Eigen's SVD algorithm for numerical stability */
+  void MinResExt::solve(std::vector<Complex> &psi_, std::vector<ColorSpinorField> &p, std::vector<ColorSpinorField> &q,
+                        const ColorSpinorField &b, bool hermitian)
+  {
+    const int N = q.size();
+
     // form the a Nx(N+1) matrix using only a single reduction - this
     // presently requires forgoing the matrix symmetry, but the improvement is well worth it
 
@@ -39,21 +60,13 @@ namespace quda
       blas::cDotProduct(A_, q, {q, b});
     }
 
+    std::vector<Complex> A(N * N), phi(N);
     for (int i = 0; i < N; i++) {
-      phi(i) = A_[i * (N + 1) + N];
-      for (int j = 0; j < N; j++) { A(i, j) = A_[i * (N + 1) + j]; }
+      phi[i] = A_[i * (N + 1) + N];
+      for (int j = 0; j < N; j++) { A[i * N + j] = A_[i * (N + 1) + j]; }
     }
 
-    profile.TPSTOP(QUDA_PROFILE_CHRONO);
-    profile.TPSTART(QUDA_PROFILE_EIGEN);
-
-    LDLT<matrix> cholesky(A);
-    psi = cholesky.solve(phi);
-
-    profile.TPSTOP(QUDA_PROFILE_EIGEN);
-    profile.TPSTART(QUDA_PROFILE_CHRONO);
-
-    for (int i = 0; i < N; i++) psi_[i] = psi(i);
+    solve(psi_, A, phi);
   }
 
   /*
@@ -136,4 +149,126 @@ namespace quda
     if (!running) profile.TPSTOP(QUDA_PROFILE_CHRONO);
   }
 
+  /*
+    Incremental variant of the above: only the stale basis vectors
+    are orthonormalized (against the current ones, which are left
+    untouched) and only the stale rows and columns of the Gram matrix
+    are recomputed.  Adding a single vector to a basis of size N thus
+    costs at most one operator application and O(N) inner products,
+    rather than N operator applications and O(N^2) inner products.
+  */
+  void MinResExt::operator()(ColorSpinorField &x, const ColorSpinorField &b, std::vector<ColorSpinorField> &p,
+                             std::vector<ColorSpinorField> &q, std::vector<Complex> &gram, std::vector<bool> &stale)
+  {
+    bool running = profile.isRunning(QUDA_PROFILE_CHRONO);
+    if (!running) profile.TPSTART(QUDA_PROFILE_CHRONO);
+
+    const int N = p.size();
+    if (q.size() != p.size() || stale.size() != p.size() || gram.size() != p.size() * p.size())
+      errorQuda("Inconsistent basis size %lu, Ap size %lu, stale size %lu and Gram matrix size %lu", p.size(), q.size(),
+                stale.size(), gram.size());
+
+    std::vector<int> idx_new, idx_cur;
+    vector_ref<ColorSpinorField> p_cur, q_cur;
+    for (int i = 0; i < N; i++) {
+      if (stale[i]) {
+        idx_new.push_back(i);
+      } else {
+        idx_cur.push_back(i);
+        p_cur.push_back(p[i]);
+        q_cur.push_back(q[i]);
+      }
+    }
+    logQuda(QUDA_VERBOSE, "Constructing minimum residual extrapolation with basis size %d (%lu new)\n", N,
+            idx_new.size());
+
+    if (N == 0) {
+      blas::zero(x);
+      if (!running) profile.TPSTOP(QUDA_PROFILE_CHRONO);
+      return;
+    }
+
+    // Orthonormalise the new vectors against the current (orthonormal) ones
+    for (auto i : idx_new) {
+      if (orthogonal) {
+        // two passes of classical Gram-Schmidt for numerical stability
+        for (int pass = 0; pass < 2 && p_cur.size() > 0; pass++) {
+          std::vector<Complex> alpha(p_cur.size());
+          blas::cDotProduct(alpha, p_cur, {p[i]});
+          for (auto &a : alpha) a = -a;
+          blas::caxpy(alpha, p_cur, {p[i]});
+          if (!apply_mat) blas::caxpy(alpha, q_cur, {q[i]});
+        }
+        double p2 = blas::norm2(p[i]);
+        blas::ax(1 / sqrt(p2), p[i]);
+        if (!apply_mat) blas::ax(1 / sqrt(p2), q[i]);
+      }
+
+      if (apply_mat) mat(q[i], p[i]);
+      p_cur.push_back(p[i]);
+      q_cur.push_back(q[i]);
+    }
+
+    std::unique_ptr<ColorSpinorField> b_sloppy;
+    if (b.Precision() != p[0].Precision()) { // need to make a sloppy copy of b
+      ColorSpinorParam param(b);
+      param.setPrecision(p[0].Precision(), p[0].Precision(), true);
+      param.create = QUDA_COPY_FIELD_CREATE;
+      b_sloppy = std::make_unique<ColorSpinorField>(param);
+    }
+    const ColorSpinorField &b_ = b_sloppy ? *b_sloppy : b;
+
+    // the Gram matrix is (p_i, q_j) if Hermitian, else (q_i, q_j)
+    auto &X = hermitian ? p : q;
+    std::vector<Complex> phi(N);
+    const int n_new = idx_new.size();
+    const int n_cur = N - n_new;
+
+    // rows of the new vectors together with the rhs
+    if (n_new > 0) {
+      vector_ref<const ColorSpinorField> x_new, q_all(q);
+      for (auto i : idx_new) x_new.push_back(X[i]);
+      q_all.push_back(b_);
+      std::vector<Complex> rows(n_new * (N + 1));
+      blas::cDotProduct(rows, x_new, q_all);
+      for (int k = 0; k < n_new; k++) {
+        for (int j = 0; j < N; j++) gram[idx_new[k] * N + j] = rows[k * (N + 1) + j];
+        phi[idx_new[k]] = rows[k * (N + 1) + N];
+      }
+    }
+
+    // columns of the new vectors together with the rhs
+    if (n_cur > 0) {
+      vector_ref<const ColorSpinorField> x_cur, q_new;
+      for (auto i : idx_cur) x_cur.push_back(X[i]);
+      for (auto i : idx_new) q_new.push_back(q[i]);
+      q_new.push_back(b_);
+      std::vector<Complex> cols(n_cur * (n_new + 1));
+      blas::cDotProduct(cols, x_cur, q_new);
+      for (int k = 0; k < n_cur; k++) {
+        for (int j = 0; j < n_new; j++) gram[idx_cur[k] * N + idx_new[j]] = cols[k * (n_new + 1) + j];
+        phi[idx_cur[k]] = cols[k * (n_new + 1) + n_new];
+      }
+    }
+
+    for (int i = 0; i < N; i++) stale[i] = false;
+
+    // Solution coefficient vectors
+    std::vector<Complex> alpha(N);
+    solve(alpha, gram, phi);
+
+    blas::zero(x);
+    blas::caxpy(alpha, p, x);
+
+    if (getVerbosity() >= QUDA_SUMMARIZE) {
+      // compute the residual only if we're going to print it
+      ColorSpinorField r(b);
+      for (auto &a : alpha) a = -a;
+      blas::caxpy(alpha, q, r);
+      printfQuda("MinResExt: N = %d, |res| / |src| = %e\n", N, sqrt(blas::norm2(r) / blas::norm2(b)));
+    }
+
+    if (!running) profile.TPSTOP(QUDA_PROFILE_CHRONO);
+  }
+
 } // namespace quda
@@ -2,6 +2,7 @@
 #include <cstdlib>
 #include <cmath>
 #include <limits>
+#include <utility>
 
 #include <quda_internal.h>
 #include <color_spinor_field.h>
@@ -164,6 +165,19 @@ namespace quda {
     }
   }
 
+  void MultiShiftCG::retireShift(std::vector<ColorSpinorField> &x, std::vector<ColorSpinorField> &p, int j)
+  {
+    // accumulate the partial solution and release the sloppy fields,
+    // so the remaining shifts run with a smaller working set
+    if (group_update) blas::xpy(x_sloppy[j], x[j]);
+    {
+      ColorSpinorField x_tmp, p_tmp;
+      std::swap(x_tmp, x_sloppy[j]);
+      std::swap(p_tmp, p[j]);
+    }
+    logQuda(QUDA_DEBUG_VERBOSE, "Retired shift %d\n", j);
+  }
+
   /**
      Compute the new values of alpha and zeta
    */
@@ -230,6 +244,8 @@ namespace quda {
 
     int j_low = 0;
     int num_offset_now = num_offset;
+    int num_offset_update = num_offset; // number of shifts still receiving updates in the dslash
+    std::vector<bool> retired(num_offset, false);
 
     profile.TPSTART(QUDA_PROFILE_PREAMBLE);
 
@@ -284,6 +300,15 @@ namespace quda {
       // iteration so that all shifts are updated during the dslash
       shift_update.updateNshift(num_offset_now);
 
+      // shifts removed in the previous iteration have now received
+      // their final update, so retire them from the solver
+      for (int j = num_offset_now; j < num_offset_update; j++) {
+        if (j == 0) continue;
+        retireShift(x, p, j);
+        retired[j] = true;
+      }
+      num_offset_update = num_offset_now;
+
       // at some point we should curry these into the Dirac operator
       if (r.Nspin() == 4)
         pAp = blas::axpyReDot(offset[0], p[0], Ap);
@@ -434,7 +459,7 @@ namespace quda {
 
     for (int i=0; i<num_offset; i++) {
       if (iter[i] == 0) iter[i] = k;
-      if (group_update) blas::xpy(x_sloppy[i], x[i]);
+      if (group_update && !retired[i]) blas::xpy(x_sloppy[i], x[i]);
     }
 
     profile.TPSTOP(QUDA_PROFILE_COMPUTE);
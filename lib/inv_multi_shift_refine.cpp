@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+#include <invert_quda.h>
+#include <blas_quda.h>
+#include <util_quda.h>
+
+/**
+   @file inv_multi_shift_refine.cpp
+
+   Batched refinement of the shifted systems left by the multi-shift
+   solver.  Rather than refining each shift with its own sequential
+   CG, the shifts are refined concurrently: the true residuals of all
+   the shifts are computed in high precision with a single multi-RHS
+   operator application, and the correction equations are then
+   solved in sloppy precision by CG iterations run in lock-step, so
+   that each iteration applies the sloppy operator to the search
+   directions of every unconverged shift at once.  Each system drops
+   out of the batch as soon as it has converged.
+*/
+
+namespace quda
+{
+
+  BatchedShiftCG::BatchedShiftCG(const DiracMatrix &mat, const DiracMatrix &matSloppy, SolverParam &param,
+                                 TimeProfile &profile) :
+    MultiShiftSolver(mat, matSloppy, param, profile)
+  {
+  }
+
+  void BatchedShiftCG::operator()(std::vector<ColorSpinorField> &x, ColorSpinorField &b, const std::vector<int> &shifts)
+  {
+    if (shifts.size() == 0) return;
+    pushOutputPrefix("BatchedShiftCG: ");
+
+    profile.TPSTART(QUDA_PROFILE_INIT);
+    MultiShiftSolver::create(x, b);
+    const int n = shifts.size();
+
+    // the operator does not include the shift (for staggered fermions
+    // it is constructed with the mass of the first shift)
+    const double b2 = blas::norm2(b);
+    std::vector<double> sigma(n);
+    std::vector<double> stop(n);
+    for (int i = 0; i < n; i++) {
+      const int s = shifts[i];
+      if (s < 0 || s >= param.num_offset) errorQuda("Invalid shift %d for %d shifts", s, param.num_offset);
+      sigma[i] = b.Nspin() == 4 ? param.offset[s] : param.offset[s] - param.offset[0];
+      stop[i] = Solver::stopping(param.tol_offset[s], b2, param.residual_type);
+    }
+
+    ColorSpinorParam csParam(b);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    std::vector<ColorSpinorField> r(n, csParam);
+    csParam.setPrecision(param.precision_sloppy);
+    std::vector<ColorSpinorField> r_sloppy(n, csParam);
+    std::vector<ColorSpinorField> p(n, csParam);
+    std::vector<ColorSpinorField> Ap(n, csParam);
+    std::vector<ColorSpinorField> e(n, csParam);
+    profile.TPSTOP(QUDA_PROFILE_INIT);
+
+    profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    blas::flops = 0;
+
+    std::vector<int> active(n);
+    std::iota(active.begin(), active.end(), 0);
+    std::vector<double> r2(n, 0.0);
+    std::vector<double> r2_prev(n, std::numeric_limits<double>::max());
+    std::vector<int> res_increase(n, 0);
+    std::vector<double> rs2(n);
+    std::vector<double> inner_stop(n);
+
+    int k = 0;
+    while (true) {
+      // compute the true residual of every remaining shift with a single operator application
+      std::vector<int> active_shift(active.size());
+      for (auto i = 0u; i < active.size(); i++) active_shift[i] = shifts[active[i]];
+      mat(make_subset<ColorSpinorField>(r, active), make_subset<const ColorSpinorField>(x, active_shift));
+      for (auto i : active) {
+        if (sigma[i] != 0.0) blas::axpy(sigma[i], x[shifts[i]], r[i]);
+        r2[i] = blas::xmyNorm(b, r[i]);
+        logQuda(QUDA_VERBOSE, "%d iterations, shift %d true residual |r|/|b| = %e\n", k, shifts[i], sqrt(r2[i] / b2));
+
+        if (r2[i] > r2_prev[i]) {
+          res_increase[i]++;
+          warningQuda("Shift %d, true residual %e is greater than previous residual %e (total #inc %i)", shifts[i],
+                      sqrt(r2[i]), sqrt(r2_prev[i]), res_increase[i]);
+        }
+        r2_prev[i] = r2[i];
+      }
+
+      // remove the shifts which have converged, or which are no longer converging
+      auto done = [&](int i) {
+        if (r2[i] <= stop[i]) return true;
+        if (res_increase[i] > param.max_res_increase_total) {
+          warningQuda("Shift %d exiting due to too many true residual norm increases", shifts[i]);
+          return true;
+        }
+        return false;
+      };
+      active.erase(std::remove_if(active.begin(), active.end(), done), active.end());
+      if (active.empty() || k >= param.maxiter) break;
+
+      // solve A e = r in sloppy precision, reducing each residual by delta
+      std::vector<int> inner(active);
+      for (auto i : inner) {
+        r_sloppy[i] = r[i];
+        p[i] = r_sloppy[i];
+        blas::zero(e[i]);
+        rs2[i] = r2[i];
+        inner_stop[i] = std::max(param.delta * param.delta * r2[i], stop[i]);
+      }
+
+      while (!inner.empty() && k < param.maxiter) {
+        matSloppy(make_subset<ColorSpinorField>(Ap, inner), make_subset<const ColorSpinorField>(p, inner));
+
+        for (auto i : inner) {
+          double pAp = blas::axpyReDot(sigma[i], p[i], Ap[i]);
+          double alpha = rs2[i] / pAp;
+          double r2_new = blas::axpyCGNorm(-alpha, Ap[i], r_sloppy[i]).x;
+          double beta = r2_new / rs2[i];
+          blas::axpyZpbx(alpha, p[i], e[i], r_sloppy[i], beta);
+          rs2[i] = r2_new;
+        }
+        k++;
+
+        logQuda(QUDA_DEBUG_VERBOSE, "%d iterations, %lu shifts active\n", k, inner.size());
+        inner.erase(std::remove_if(inner.begin(), inner.end(), [&](int i) { return rs2[i] < inner_stop[i]; }),
+                    inner.end());
+      }
+
+      // accumulate the corrections
+      for (auto i : active) {
+        r[i] = e[i];
+        blas::xpy(r[i], x[shifts[i]]);
+      }
+    }
+
+    profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+    profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+
+    if (k >= param.maxiter) warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    param.secs += profile.Last(QUDA_PROFILE_COMPUTE);
+    param.gflops += (blas::flops + mat.flops() + matSloppy.flops()) * 1e-9;
+    param.iter += k;
+
+    logQuda(QUDA_SUMMARIZE, "Refined %d shifts in %d iterations\n", n, k);
+    for (int i = 0; i < n; i++) {
+      const int s = shifts[i];
+      param.true_res_offset[s] = sqrt(r2[i] / b2);
+      param.iter_res_offset[s] = param.true_res_offset[s];
+      param.true_res_hq_offset[s] = sqrt(blas::HeavyQuarkResidualNorm(x[s], r[i]).z);
+      logQuda(QUDA_SUMMARIZE, " shift=%d, relative residual: true = %e\n", s, param.true_res_offset[s]);
+    }
+    param.true_res = param.true_res_offset[shifts[n - 1]];
+    param.true_res_hq = param.true_res_hq_offset[shifts[n - 1]];
+
+    // reset the flops counters
+    blas::flops = 0;
+    mat.flops();
+    matSloppy.flops();
+
+    profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    popOutputPrefix();
+  }
+
+} // namespace quda
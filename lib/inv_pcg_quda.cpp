@@ -178,12 +178,10 @@ namespace quda
       if (deflate_compute) {
         // compute the deflation space.
         (*eig_solve)(evecs, evals);
+        prepareDeflationSpace();
         deflate_compute = false;
       }
-      if (recompute_evals) {
-        eig_solve->computeEvals(evecs, evals);
-        recompute_evals = false;
-      }
+      if (recompute_evals) recomputeDeflationEvals();
     }
 
     double Anorm = 0;
@@ -0,0 +1,379 @@
+#include <array>
+
+#include <invert_quda.h>
+#include <blas_quda.h>
+#include <reliable_updates.h>
+
+/**
+   @file inv_pipelined_cg_quda.cpp
+
+   Implementation of the pipelined conjugate gradient algorithm.
+   Based on the description here: https://doi.org/10.1016/j.parco.2013.06.001
+
+   Alongside the residual r and search direction p we carry the
+   auxiliary vectors w = A r, s = A p, z = A s and q = A w, which
+   allows all vector updates of an iteration to be fused into a
+   single kernel producing the two inner products (r, r) and (r, w)
+   required for the next iteration.  The global sum of these is
+   started as a non-blocking all-reduce, which completes while the
+   operator is applied to w.
+*/
+
+namespace quda
+{
+
+  PipelinedCG::PipelinedCG(const DiracMatrix &mat, const DiracMatrix &matSloppy, const DiracMatrix &matPrecon,
+                           const DiracMatrix &matEig, SolverParam &param, TimeProfile &profile) :
+    Solver(mat, matSloppy, matPrecon, matEig, param, profile)
+  {
+  }
+
+  PipelinedCG::~PipelinedCG()
+  {
+    if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_FREE);
+    destroyDeflationSpace();
+    if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_FREE);
+  }
+
+  void PipelinedCG::create(ColorSpinorField &x, const ColorSpinorField &b)
+  {
+    Solver::create(x, b);
+    if (!init) {
+      if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_INIT);
+
+      ColorSpinorParam csParam(b);
+      csParam.create = QUDA_NULL_FIELD_CREATE;
+      r = ColorSpinorField(csParam);
+      y = ColorSpinorField(csParam);
+
+      // now allocate sloppy fields
+      csParam.setPrecision(param.precision_sloppy);
+      if (mixed()) {
+        rSloppy = ColorSpinorField(csParam);
+        xSloppy = ColorSpinorField(csParam);
+      } else {
+        rSloppy = r.create_alias();
+      }
+
+      p = ColorSpinorField(csParam);
+      w = ColorSpinorField(csParam);
+      s = ColorSpinorField(csParam);
+      z = ColorSpinorField(csParam);
+      q = ColorSpinorField(csParam);
+
+      if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_INIT);
+
+      init = true;
+    }
+  }
+
+  ColorSpinorField &PipelinedCG::get_residual()
+  {
+    if (!init) errorQuda("No residual vector present");
+    if (!param.return_residual) errorQuda("SolverParam::return_residual not enabled");
+
+    // unless the true residual was computed and left in r, convert the iterated residual
+    if (!param.compute_true_res && mixed()) r = rSloppy;
+    return r;
+  }
+
+  void PipelinedCG::operator()(ColorSpinorField &x, ColorSpinorField &b)
+  {
+    if (param.is_preconditioner) commGlobalReductionPush(param.global_reduction);
+
+    if (checkLocation(x, b) != QUDA_CUDA_FIELD_LOCATION) errorQuda("Not supported");
+
+    if (param.maxiter == 0 || param.Nsteps == 0) {
+      if (param.use_init_guess == QUDA_USE_INIT_GUESS_NO) blas::zero(x);
+      if (param.is_preconditioner) commGlobalReductionPop();
+      return;
+    }
+
+    create(x, b);
+
+    if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+
+    double b2 = blas::norm2(b);
+
+    // Check to see that we're not trying to invert on a zero-field source
+    if (b2 == 0 && param.compute_null_vector == QUDA_COMPUTE_NULL_VECTOR_NO) {
+      if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+      warningQuda("inverting on zero-field source\n");
+      x = b;
+      param.true_res = 0.0;
+      param.true_res_hq = 0.0;
+      if (param.is_preconditioner) commGlobalReductionPop();
+      return;
+    }
+
+    if (param.deflate) {
+      // Construct the eigensolver and deflation space.
+      constructDeflationSpace(b, matEig);
+      if (deflate_compute) {
+        // compute the deflation space.
+        if (!param.is_preconditioner) profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+        (*eig_solve)(evecs, evals);
+        prepareDeflationSpace();
+        if (!param.is_preconditioner) profile.TPSTART(QUDA_PROFILE_PREAMBLE);
+        deflate_compute = false;
+      }
+      if (recompute_evals) recomputeDeflationEvals();
+    }
+
+    const bool alternative_reliable = param.use_alternative_reliable;
+    const double u = precisionEpsilon(param.precision_sloppy);
+    const double uhigh = precisionEpsilon(); // solver precision
+
+    double Anorm = 0;
+    if (alternative_reliable) {
+      // estimate norm for reliable updates
+      mat(r, b);
+      Anorm = sqrt(blas::norm2(r) / b2);
+    }
+
+    // compute the initial residual, with y holding the initial guess
+    double r2 = 0.0;
+    if (param.use_init_guess == QUDA_USE_INIT_GUESS_YES) {
+      mat(r, x);
+      r2 = blas::xmyNorm(b, r);
+      blas::copy(y, x);
+    } else {
+      blas::copy(r, b);
+      r2 = b2;
+      blas::zero(y);
+    }
+
+    if (param.deflate && param.maxiter > 1) {
+      // Deflate and accumulate to solution vector
+      eig_solve->deflate(y, r, evecs, evals, true);
+      mat(r, y);
+      r2 = blas::xmyNorm(b, r);
+    }
+
+    if (b2 == 0) b2 = r2;
+
+    // in uniform precision we accumulate directly into x
+    ColorSpinorField &xS = mixed() ? xSloppy : x;
+    blas::zero(xS);
+    if (mixed()) blas::copy(rSloppy, r);
+
+    const bool use_heavy_quark_res = (param.residual_type & QUDA_HEAVY_QUARK_RESIDUAL) ? true : false;
+    bool heavy_quark_restart = false;
+    double heavy_quark_res = use_heavy_quark_res ? sqrt(blas::HeavyQuarkResidualNorm(y, r).z) : 0.0;
+    double heavy_quark_res_old = heavy_quark_res;
+
+    double stop = stopping(param.tol, b2, param.residual_type); // stopping condition of solver
+
+    // set this to true if maxResIncrease has been exceeded but when we use heavy quark residual we still want to continue
+    bool L2breakdown = false;
+    const double L2breakdown_eps = 100. * uhigh;
+
+    // p, s and z are zeroed so the first step sets p = r, s = w and z = q
+    blas::zero(p);
+    blas::zero(s);
+    blas::zero(z);
+    matSloppy(w, rSloppy);
+    double delta = blas::reDotProduct(rSloppy, w);
+
+    ReliableUpdatesParams ru_params;
+
+    ru_params.alternative_reliable = alternative_reliable;
+    ru_params.u = u;
+    ru_params.uhigh = uhigh;
+    ru_params.Anorm = Anorm;
+    ru_params.delta = param.delta;
+
+    ru_params.maxResIncrease = param.max_res_increase;
+    ru_params.maxResIncreaseTotal = param.max_res_increase_total;
+    ru_params.use_heavy_quark_res = use_heavy_quark_res;
+    ru_params.hqmaxresIncrease = param.max_hq_res_increase;
+    ru_params.hqmaxresRestartTotal = param.max_hq_res_restart_total;
+
+    ReliableUpdates ru(ru_params, r2);
+
+    // if global reductions are disabled (e.g., for a DD preconditioner) the local sums are used as is
+    const bool global_reduction = commGlobalReduction();
+
+    if (!param.is_preconditioner) {
+      blas::flops = 0;
+      profile.TPSTOP(QUDA_PROFILE_PREAMBLE);
+      profile.TPSTART(QUDA_PROFILE_COMPUTE);
+    }
+
+    double r2_old = 0.0;
+    double alpha = 0.0;   // step length for the current search direction
+    double alpha_x = 0.0; // pending step length for the lagged solution update
+    double beta = 0.0;
+    double ppnorm = 0.0; // running estimate of ||p||^2 for alternative reliable updates
+    bool restart = true; // whether the next step starts from p = r
+
+    int k = 0;
+
+    PrintStats("Pipelined CG", k, r2, b2, heavy_quark_res);
+
+    bool converged = convergence(r2, heavy_quark_res, stop, param.tol_hq);
+
+    if (!converged) matSloppy(q, w);
+
+    while (!converged && k < param.maxiter) {
+      beta = restart ? 0.0 : r2 / r2_old;
+      double alpha_new = restart ? r2 / delta : r2 / (delta - beta * r2 / alpha);
+
+      // x += alpha_x * p (lagged from the previous iteration) and p = r + beta * p
+      blas::axpyZpbx(alpha_x, p, xS, rSloppy, beta);
+      alpha = alpha_new;
+      alpha_x = alpha;
+
+      // (r, p_old) = 0, so this recurrence requires no additional reduction
+      ppnorm = r2 + beta * beta * ppnorm;
+      ru.update_ppnorm(ppnorm);
+
+      // fused update of the recurrences, with the local contribution to (r, r) and (r, w)
+      commGlobalReductionPush(false);
+      auto local = blas::pipelinedCGUpdate(alpha, beta, rSloppy, w, s, z, q);
+      commGlobalReductionPop();
+
+      // the global sum is overlapped with q = A w
+      std::array<double, 2> sum = {local.x, local.y};
+      if (global_reduction) comm_allreduce_sum_array_start(sum.data(), sum.size());
+      matSloppy(q, w);
+      if (global_reduction) comm_allreduce_sum_array_wait();
+
+      r2_old = r2;
+      r2 = sum[0];
+      delta = sum[1];
+      restart = false;
+
+      // reliable update conditions
+      ru.update_rNorm(sqrt(r2));
+      ru.evaluate(r2_old);
+
+      // force a reliable update if we are within target tolerance (only if doing reliable updates)
+      if (convergence(r2, heavy_quark_res, stop, param.tol_hq) && param.delta >= param.tol) ru.set_updateX();
+
+      // the heavy quark residual is only computed at reliable updates
+      if (use_heavy_quark_res && convergenceL2(r2, heavy_quark_res, stop, param.tol_hq) && param.delta >= param.tol)
+        ru.set_updateX();
+
+      if (!ru.trigger()) {
+        ru.accumulate_norm(alpha);
+      } else {
+        // flush the pending solution update and replace the residual
+        blas::axpy(alpha_x, p, xS);
+        alpha_x = 0.0;
+
+        if (mixed()) blas::copy(x, xSloppy);
+        blas::xpy(x, y);
+        mat(r, y);
+        r2 = blas::xmyNorm(b, r);
+
+        if (param.deflate && sqrt(r2) < ru.maxr_deflate * param.tol_restart) {
+          // Deflate and accumulate to solution vector
+          eig_solve->deflate(y, r, evecs, evals, true);
+
+          // Compute r_defl = RHS - A * LHS
+          mat(r, y);
+          r2 = blas::xmyNorm(b, r);
+
+          ru.update_maxr_deflate(r2);
+        }
+
+        if (mixed()) blas::copy(rSloppy, r);
+        blas::zero(xS);
+
+        ru.update_norm(r2, y);
+
+        if (use_heavy_quark_res) heavy_quark_res = sqrt(blas::HeavyQuarkResidualNorm(y, r).z);
+
+        if (ru.reliable_break(r2, stop, L2breakdown, L2breakdown_eps)) break;
+
+        // if L2 broke down already we turn off reliable updates and restart the CG
+        if (use_heavy_quark_res
+            && ru.reliable_heavy_quark_break(L2breakdown, heavy_quark_res, heavy_quark_res_old, heavy_quark_restart))
+          break;
+
+        if (heavy_quark_restart) {
+          restart = true;
+          heavy_quark_restart = false;
+        } else {
+          // explicitly restore the orthogonality of the search direction
+          Complex rp = blas::cDotProduct(rSloppy, p) / r2;
+          blas::caxpy(-rp, rSloppy, p);
+        }
+
+        // the auxiliary vectors are recomputed from the corrected r and p
+        matSloppy(w, rSloppy);
+        matSloppy(q, w);
+        delta = blas::reDotProduct(rSloppy, w);
+        if (!restart) {
+          matSloppy(s, p);
+          matSloppy(z, s);
+          // rescale the prior step length to be consistent with the corrected p
+          auto pAp = blas::cDotProductNormA(p, s);
+          alpha = r2_old / pAp.x;
+          ppnorm = pAp.z;
+        }
+
+        ru.reset(r2);
+
+        heavy_quark_res_old = heavy_quark_res;
+      }
+
+      k++;
+
+      PrintStats("Pipelined CG", k, r2, b2, heavy_quark_res);
+      converged = convergence(r2, heavy_quark_res, stop, param.tol_hq);
+
+      // check for recent enough reliable updates of the HQ residual if we use it
+      if (use_heavy_quark_res) {
+        bool L2done = L2breakdown || convergenceL2(r2, heavy_quark_res, stop, param.tol_hq);
+        bool HQdone = (ru.steps_since_reliable == 0 && param.delta > 0)
+          && convergenceHQ(r2, heavy_quark_res, stop, param.tol_hq);
+        converged = L2done && HQdone;
+      }
+    }
+
+    // apply any trailing solution update
+    if (alpha_x != 0.0) blas::axpy(alpha_x, p, xS);
+    if (mixed()) blas::copy(x, xSloppy);
+    blas::xpy(y, x);
+
+    if (k == param.maxiter) warningQuda("Exceeded maximum iterations %d", param.maxiter);
+
+    logQuda(QUDA_VERBOSE, "Pipelined CG: Reliable updates = %d\n", ru.rUpdate);
+
+    if (param.compute_true_res) {
+      // compute the true residuals
+      mat(r, x);
+      param.true_res = sqrt(blas::xmyNorm(b, r) / b2);
+      param.true_res_hq = use_heavy_quark_res ? sqrt(blas::HeavyQuarkResidualNorm(x, r).z) : 0.0;
+    }
+
+    if (!param.is_preconditioner) {
+      qudaDeviceSynchronize(); // ensure solver is complete before ending timing
+      profile.TPSTOP(QUDA_PROFILE_COMPUTE);
+      profile.TPSTART(QUDA_PROFILE_EPILOGUE);
+      param.secs += profile.Last(QUDA_PROFILE_COMPUTE);
+
+      // store flops and reset counters
+      double gflops = (blas::flops + mat.flops() + matSloppy.flops() + matPrecon.flops() + matEig.flops()) * 1e-9;
+
+      param.gflops += gflops;
+      param.iter += k;
+
+      // reset the flops counters
+      blas::flops = 0;
+      mat.flops();
+      matSloppy.flops();
+      matPrecon.flops();
+      matEig.flops();
+
+      profile.TPSTOP(QUDA_PROFILE_EPILOGUE);
+    }
+
+    PrintSummary("Pipelined CG", k, r2, b2, stop, param.tol_hq);
+
+    if (param.is_preconditioner) commGlobalReductionPop();
+  }
+
+} // namespace quda
@@ -0,0 +1,231 @@
+#include <color_spinor_field.h>
+#include <contract_quda.h>
+#include <tunable_block_reduction.h>
+#include <power_of_two_array.h>
+#include <instantiate.h>
+#include <kernels/meson_field.cuh>
+
+namespace quda
+{
+
+  // dummy block-size list for the meson field: the block reduction
+  // does not template on the block size, so the x block size is
+  // freely tuned on the device, and is one site on the host
+  struct MesonFieldBlock {
+    using array_type = PowerOfTwoArray<1, 1>;
+    static constexpr array_type block = array_type();
+  };
+
+  template <typename Float, int nColor> class MesonFieldCompute : TunableBlock2D
+  {
+    using reduce_t = array<double, 2 * meson_field_tile() * meson_field_tile()>;
+    cvector_ref<const ColorSpinorField> &w;
+    cvector_ref<const ColorSpinorField> &v;
+    reduce_t *result;
+    const MesonFieldInsertion *insertion;
+    const int n_insertion;
+    bool tuneSharedBytes() const { return false; }
+    unsigned int minThreads() const { return w[0].Volume() / w[0].X()[3]; } // both parities of a time slice
+
+    /**
+       @brief The thread blocks are aligned to the time slices, so the
+       grid is the number of blocks per time slice times the number of
+       local time slices
+     */
+    unsigned int gridX(unsigned int block_x) const { return w[0].X()[3] * ((minThreads() + block_x - 1) / block_x); }
+
+  public:
+    MesonFieldCompute(const ColorSpinorField &meta, cvector_ref<const ColorSpinorField> &w,
+                      cvector_ref<const ColorSpinorField> &v, reduce_t *result, const MesonFieldInsertion *insertion,
+                      int n_insertion) :
+      TunableBlock2D(meta, true, 1),
+      w(w),
+      v(v),
+      result(result),
+      insertion(insertion),
+      n_insertion(n_insertion)
+    {
+      strcat(aux, ",n_w=");
+      u32toa(aux + strlen(aux), w.size());
+      strcat(aux, ",n_v=");
+      u32toa(aux + strlen(aux), v.size());
+      strcat(aux, ",n_insertion=");
+      u32toa(aux + strlen(aux), n_insertion);
+      apply(device::get_default_stream());
+    }
+
+    void apply(const qudaStream_t &stream)
+    {
+      if constexpr (sizeof(Float) < sizeof(float)) {
+        errorQuda("Meson fields not supported in precision %lu", sizeof(Float));
+      } else {
+        TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+        // the time-slice results are accumulated atomically across the thread blocks
+        const size_t result_bytes = w[0].X()[3] * n_insertion * sizeof(reduce_t);
+        if (location == QUDA_CUDA_FIELD_LOCATION) {
+          qudaMemsetAsync(result, 0, result_bytes, stream);
+          MesonFieldArg<Float, nColor, true> arg(w, v, insertion, n_insertion, result);
+          launch_device<MesonField, MesonFieldBlock>(tp, stream, arg);
+        } else {
+          memset(result, 0, result_bytes);
+          MesonFieldArg<Float, nColor, false> arg(w, v, insertion, n_insertion, result);
+          launch_host<MesonField, MesonFieldBlock>(tp, stream, arg);
+        }
+      }
+    }
+
+    bool advanceBlockDim(TuneParam &param) const
+    {
+      if (location == QUDA_CPU_FIELD_LOCATION) return false;
+      bool ret = TunableBlock2D::advanceBlockDim(param);
+      param.grid.x = gridX(param.block.x);
+      return ret;
+    }
+
+    void initTuneParam(TuneParam &param) const
+    {
+      TunableBlock2D::initTuneParam(param);
+      if (location == QUDA_CPU_FIELD_LOCATION) param.block.x = 1; // the host kernel runs a single thread per block
+      param.grid.x = gridX(param.block.x);
+    }
+
+    void defaultTuneParam(TuneParam &param) const
+    {
+      TunableBlock2D::defaultTuneParam(param);
+      if (location == QUDA_CPU_FIELD_LOCATION) param.block.x = 1;
+      param.grid.x = gridX(param.block.x);
+    }
+
+    long long flops() const
+    {
+      // color inner products, gamma and phase per pair and insertion
+      long long pair = 4 * (nColor * 8 + 8);
+      return pair * w.size() * v.size() * n_insertion * w[0].Volume();
+    }
+
+    // the tile of w and v vectors is read once for all insertions
+    long long bytes() const
+    {
+      return (w.size() + v.size()) * w[0].Bytes() + w[0].X()[3] * n_insertion * sizeof(reduce_t);
+    }
+  };
+
+#ifdef GPU_CONTRACT
+  /**
+     The Degrand-Rossi gamma matrices in the order of enum_quda.h, as
+     (column, power of i) of the single non-zero element of each row.
+     These are the insertions formed by contractDegrandRossi.
+   */
+  static constexpr int gamma_dr[16][4][2] = {
+    {{0, 0}, {1, 0}, {2, 0}, {3, 0}}, // I
+    {{3, 1}, {2, 1}, {1, 3}, {0, 3}}, // gamma_1
+    {{3, 2}, {2, 0}, {1, 0}, {0, 2}}, // gamma_2
+    {{2, 1}, {3, 3}, {0, 3}, {1, 1}}, // gamma_3
+    {{2, 0}, {3, 0}, {0, 0}, {1, 0}}, // gamma_4
+    {{0, 0}, {1, 0}, {2, 2}, {3, 2}}, // gamma_5
+    {{3, 1}, {2, 1}, {1, 1}, {0, 1}}, // gamma_5 gamma_1
+    {{3, 2}, {2, 0}, {1, 2}, {0, 0}}, // gamma_5 gamma_2
+    {{2, 1}, {3, 3}, {0, 1}, {1, 3}}, // gamma_5 gamma_3
+    {{2, 0}, {3, 0}, {0, 2}, {1, 2}}, // gamma_5 gamma_4
+    {{0, 0}, {1, 2}, {2, 0}, {3, 2}}, // (i/2) [gamma_1, gamma_2]
+    {{2, 3}, {3, 3}, {0, 1}, {1, 1}}, // (i/2) [gamma_1, gamma_3]
+    {{1, 2}, {0, 2}, {3, 0}, {2, 0}}, // (i/2) [gamma_1, gamma_4]
+    {{1, 0}, {0, 0}, {3, 0}, {2, 0}}, // (i/2) [gamma_2, gamma_3]
+    {{1, 3}, {0, 1}, {3, 1}, {2, 3}}, // (i/2) [gamma_2, gamma_4]
+    {{0, 2}, {1, 2}, {2, 0}, {3, 0}}, // (i/2) [gamma_3, gamma_4]
+  };
+
+  void mesonFieldQuda(cvector_ref<const ColorSpinorField> &w, cvector_ref<const ColorSpinorField> &v,
+                      std::vector<Complex> &result, const std::vector<int> &mom, const std::vector<int> &gamma)
+  {
+    if (w.size() == 0 || v.size() == 0) errorQuda("Empty vector set n_w = %lu n_v = %lu", w.size(), v.size());
+    if (mom.size() == 0 || mom.size() % 3 != 0)
+      errorQuda("Momenta must have three spatial components (size = %lu)", mom.size());
+    if (gamma.size() == 0) errorQuda("No gamma insertions requested");
+
+    for (auto set : {&w, &v}) {
+      for (auto i = 0u; i < set->size(); i++) {
+        const ColorSpinorField &f = (*set)[i];
+        checkPrecision(w[0], f);
+        checkLocation(w[0], f);
+        if (f.Precision() < QUDA_SINGLE_PRECISION) errorQuda("Unsupported precision %d", f.Precision());
+        if (f.GammaBasis() != QUDA_DEGRAND_ROSSI_GAMMA_BASIS) errorQuda("Unexpected gamma basis %d", f.GammaBasis());
+        if (f.Nspin() != 4) errorQuda("Unexpected number of spins %d", f.Nspin());
+        if (f.SiteSubset() != QUDA_FULL_SITE_SUBSET) errorQuda("Meson fields require full fields");
+        if (w[0].Location() == QUDA_CPU_FIELD_LOCATION && f.FieldOrder() != QUDA_SPACE_SPIN_COLOR_FIELD_ORDER)
+          errorQuda("Unsupported host field order %d", f.FieldOrder());
+      }
+    }
+
+    const int n_w = w.size();
+    const int n_v = v.size();
+    const int n_mom = mom.size() / 3;
+    const int n_gamma = gamma.size();
+    const int lt = w[0].X()[3];
+    const int nt = lt * comm_dim(3);
+    const int t_offset = lt * comm_coord(3);
+    if (result.size() != static_cast<size_t>(nt * n_mom * n_gamma * n_w * n_v))
+      errorQuda("Result size %lu does not match %d x %d x %d x %d x %d", result.size(), nt, n_mom, n_gamma, n_w, n_v);
+
+    std::vector<MesonFieldInsertion> insertion(n_mom * n_gamma);
+    for (int m = 0; m < n_mom; m++) {
+      for (int g = 0; g < n_gamma; g++) {
+        if (gamma[g] < 0 || gamma[g] >= 16) errorQuda("Invalid insertion index gamma[%d] = %d", g, gamma[g]);
+        auto &ins = insertion[m * n_gamma + g];
+        for (int d = 0; d < 3; d++) ins.mom[d] = mom[3 * m + d];
+        for (int mu = 0; mu < 4; mu++) {
+          ins.col[mu] = gamma_dr[gamma[g]][mu][0];
+          ins.phase[mu] = gamma_dr[gamma[g]][mu][1];
+        }
+      }
+    }
+
+    // the local time slices are placed in the global time extent and then reduced across all processes
+    constexpr int tile = meson_field_tile();
+    std::vector<Complex> result_global(result.size(), 0.0);
+    using reduce_t = array<double, 2 * tile * tile>;
+    const int nk_max = std::min(n_mom * n_gamma, max_n_insertion_meson());
+    std::vector<reduce_t> local(lt * nk_max);
+    auto d_local = w[0].Location() == QUDA_CUDA_FIELD_LOCATION ?
+      static_cast<reduce_t *>(pool_device_malloc(local.size() * sizeof(reduce_t))) :
+      nullptr;
+    for (int i0 = 0; i0 < n_w; i0 += tile) {
+      const int ni = std::min(tile, n_w - i0);
+      vector_ref<const ColorSpinorField> w_tile {w.begin() + i0, w.begin() + i0 + ni};
+      for (int j0 = 0; j0 < n_v; j0 += tile) {
+        const int nj = std::min(tile, n_v - j0);
+        vector_ref<const ColorSpinorField> v_tile {v.begin() + j0, v.begin() + j0 + nj};
+
+        for (int k0 = 0; k0 < n_mom * n_gamma; k0 += max_n_insertion_meson()) {
+          const int nk = std::min(n_mom * n_gamma - k0, max_n_insertion_meson());
+          instantiate<MesonFieldCompute>(w[0], w_tile, v_tile, d_local ? d_local : local.data(),
+                                         insertion.data() + k0, nk);
+          if (d_local) qudaMemcpy(local.data(), d_local, lt * nk * sizeof(reduce_t), qudaMemcpyDeviceToHost);
+
+          for (int t = 0; t < lt; t++) {
+            for (int k = 0; k < nk; k++) {
+              auto &r = local[t * nk + k];
+              auto *M = result_global.data() + ((t + t_offset) * n_mom * n_gamma + k0 + k) * n_w * n_v;
+              for (int i = 0; i < ni; i++)
+                for (int j = 0; j < nj; j++)
+                  M[(i0 + i) * n_v + j0 + j] = Complex(r[2 * (i * tile + j)], r[2 * (i * tile + j) + 1]);
+            }
+          }
+        }
+      }
+    }
+
+    if (d_local) pool_device_free(d_local);
+
+    comm_allreduce_sum(result_global);
+    result = result_global;
+  }
+#else
+  void mesonFieldQuda(cvector_ref<const ColorSpinorField> &, cvector_ref<const ColorSpinorField> &,
+                      std::vector<Complex> &, const std::vector<int> &, const std::vector<int> &)
+  {
+    errorQuda("Contraction code has not been built");
+  }
+#endif
+
+} // namespace quda
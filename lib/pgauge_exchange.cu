@@ -111,7 +111,9 @@ namespace quda {
         }
       }
 
-      qudaDeviceSynchronize();
+      // only wait for the update on the default stream, so that work on
+      // other streams (e.g., the next interior update) can overlap the exchange
+      qudaStreamSynchronize(device::get_default_stream());
       for (int d = 0; d < 4; d++) {
         if (!commDimPartitioned(d)) continue;
         comm_start(mh_recv_back[d]);
@@ -163,7 +165,6 @@ namespace quda {
         qudaStreamSynchronize(device::get_stream(0));
         qudaStreamSynchronize(device::get_stream(1));
       }
-      qudaDeviceSynchronize();
     }
 
     TuneKey tuneKey() const
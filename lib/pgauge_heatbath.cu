@@ -15,106 +15,215 @@ namespace quda {
   class GaugeHB : TunableKernel1D {
     GaugeField &U;
     Float beta;
-    RNG &rng;
+    RNG *rng;
+    unsigned long long seed;
+    uint32_t rng_stream;
     int mu;
     int parity;
     bool heatbath; // true = heatbath, false = over relaxation
-    char aux2[TuneKey::aux_n];
-    unsigned int minThreads() const { return U.LocalVolumeCB(); }
+    int n_hit;
+    MonteRegion region;
+    unsigned int minThreads() const { return monteThreads(U, region); }
+
+    /**
+       @brief The number of sites updated by this kernel
+     */
+    long long sites() const
+    {
+      int lo[4], box[4];
+      switch (region) {
+      case MonteRegion::interior: return monteInterior(U, lo, box);
+      case MonteRegion::boundary: return U.LocalVolumeCB() - monteInterior(U, lo, box);
+      default: return U.LocalVolumeCB();
+      }
+    }
 
   public:
-    GaugeHB(GaugeField &U, double beta, RNG &rng, int mu, int parity, bool heatbath) :
+    GaugeHB(GaugeField &U, double beta, RNG *rng, unsigned long long seed, uint32_t rng_stream, int mu, int parity,
+            bool heatbath, int n_hit, MonteRegion region, const qudaStream_t &stream) :
       TunableKernel1D(U),
       U(U),
       beta(static_cast<Float>(beta)),
       rng(rng),
+      seed(seed),
+      rng_stream(rng_stream),
       mu(mu),
       parity(parity),
-      heatbath(heatbath)
+      heatbath(heatbath),
+      n_hit(n_hit),
+      region(region)
     {
       strcat(aux, mu == 0 ? ",mu=0" : mu == 1 ? ",mu=1" : mu == 2 ? ",mu=2" : ",mu=3");
       strcat(aux, parity ? ",parity=1" : ",parity=0");
       strcat(aux, heatbath ? ",heatbath" : ",ovr");
-      apply(device::get_default_stream());
+      if (heatbath && !rng) strcat(aux, ",counter");
+      if (n_hit > 1) {
+        strcat(aux, ",n_hit=");
+        u32toa(aux + strlen(aux), n_hit);
+      }
+      if (region != MonteRegion::all) {
+        strcat(aux, region == MonteRegion::interior ? ",interior," : ",boundary,");
+        strcat(aux, comm_dim_partitioned_string());
+      }
+      apply(stream);
+    }
+
+    template <bool hb, bool native, bool counter> using Arg = MonteArg<Float, nColor, recon, hb, native, counter>;
+
+    template <bool hb> void launch_monte(const TuneParam &tp, const qudaStream_t &stream)
+    {
+      RNGState *state = rng ? rng->State() : nullptr;
+      if (U.isNative()) {
+        if (rng)
+          launch<HB>(tp, stream, Arg<hb, true, false>(U, beta, state, seed, rng_stream, mu, parity, n_hit, region));
+        else
+          launch<HB>(tp, stream, Arg<hb, true, true>(U, beta, state, seed, rng_stream, mu, parity, n_hit, region));
+      } else if constexpr (sizeof(Float) < sizeof(float)) {
+        errorQuda("Non-native heatbath not supported in precision %lu", sizeof(Float));
+      } else {
+        // the host path always uses the counter-based generator
+        launch<HB, true>(tp, stream, Arg<hb, false, true>(U, beta, state, seed, rng_stream, mu, parity, n_hit, region));
+      }
     }
 
     void apply(const qudaStream_t &stream)
     {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       if (heatbath) {
-        launch<HB>(tp, stream, MonteArg<Float, nColor, recon, true>(U, beta, rng.State(), mu, parity));
+        launch_monte<true>(tp, stream);
       } else {
-        launch<HB>(tp, stream, MonteArg<Float, nColor, recon, false>(U, beta, rng.State(), mu, parity));
+        launch_monte<false>(tp, stream);
       }
     }
 
     void preTune() {
       U.backup();
-      if (heatbath) rng.backup();
+      if (heatbath && rng) rng->backup();
     }
 
     void postTune() {
       U.restore();
-      if (heatbath) rng.restore();
+      if (heatbath && rng) rng->restore();
     }
 
     long long flops() const
     {
       //NEED TO CHECK THIS!!!!!!
+      // the staple is computed once and reused for each hit
+      long long staple, update;
       if ( nColor == 3 ) {
-        long long flop = 2268LL;
-        if (heatbath) {
-          flop += 801LL;
-        } else {
-          flop += 843LL;
-        }
-        flop *= U.LocalVolumeCB();
-        return flop;
+        staple = 2268LL;
+        update = heatbath ? 801LL : 843LL;
       } else {
-        long long flop = nColor * nColor * nColor * 84LL;
+        staple = nColor * nColor * nColor * 84LL;
         if (heatbath) {
-          flop += nColor * nColor * nColor + (nColor * ( nColor - 1) / 2) * (46LL + 48LL + 56LL * nColor);
+          update = nColor * nColor * nColor + (nColor * ( nColor - 1) / 2) * (46LL + 48LL + 56LL * nColor);
         } else {
-          flop += nColor * nColor * nColor + (nColor * ( nColor - 1) / 2) * (17LL + 112LL * nColor);
+          update = nColor * nColor * nColor + (nColor * ( nColor - 1) / 2) * (17LL + 112LL * nColor);
         }
-        flop *= U.LocalVolumeCB();
-        return flop;
       }
+      return (staple + n_hit * update) * sites();
     }
 
     long long bytes() const
     {
       //NEED TO CHECK THIS!!!!!!
-      if ( nColor == 3 ) {
-        long long byte = 20LL * recon * sizeof(Float);
-        if (heatbath) byte += 2LL * sizeof(RNGState);
-        byte *= U.LocalVolumeCB();
-        return byte;
-      } else {
-        long long byte = 20LL * nColor * nColor * 2 * sizeof(Float);
-        if (heatbath) byte += 2LL * sizeof(RNGState);
-        byte *= U.LocalVolumeCB();
-        return byte;
-      }
+      long long byte = nColor == 3 ? 20LL * recon * sizeof(Float) : 20LL * nColor * nColor * 2 * sizeof(Float);
+      if (heatbath && rng) byte += 2LL * sizeof(RNGState);
+      return byte * sites();
     }
   };
 
   template <typename Float, int nColor, QudaReconstructType recon>
   struct MonteAlg {
-    MonteAlg(GaugeField& data, RNG &rngstate, Float Beta, int nhb, int nover)
+    GaugeField &data;
+    RNG *rng;
+    unsigned long long seed;
+    int sweep;
+    Float Beta;
+    int nhit;
+    bool overlap;
+    int interior;
+
+    /**
+       @brief Update the links of a given direction and parity on a set of sites
+     */
+    void update(bool heatbath, int step, int mu, int parity, MonteRegion region, const qudaStream_t &stream)
     {
-      host_timer_t timer;
-      double hb_time = 0.0, ovr_time = 0.0;
-      if (getVerbosity() >= QUDA_VERBOSE) timer.start();
+      // each heatbath step and direction is a distinct stream of the counter-based generator
+      uint32_t rng_stream = 4 * (sweep + step) + mu;
+      GaugeHB<Float, nColor, recon>(data, Beta, rng, seed, rng_stream, mu, parity, heatbath, nhit, region, stream);
+    }
 
-      for (int step = 0; step < nhb; step++) {
+    /**
+       @brief Perform nstep heatbath or overrelaxation steps.  With
+       the overlapped schedule, the halo exchange of each update runs
+       concurrently with the update of the interior sites of the next
+       one, whose staples do not touch the halo, and the boundary sites
+       are updated once the exchange has completed.
+     */
+    void steps(bool heatbath, int nstep)
+    {
+      qudaEvent_t interior_start = qudaEventCreate();
+      qudaEvent_t interior_end = qudaEventCreate();
+      bool pending = false;
+      int mu_prev = 0;
+      int parity_prev = 0;
+
+      for (int step = 0; step < nstep; step++) {
         for (int parity = 0; parity < 2; parity++) {
-          for (int mu = 0; mu < 4; ++mu) {
-            GaugeHB<Float, nColor, recon>(data, Beta, rngstate, mu, parity, true);
-            PGaugeExchange(data, mu, parity);
+          for (int mu = 0; mu < 4; mu++) {
+            if (pending) {
+              if (interior > 0) {
+                qudaEventRecord(interior_start, device::get_default_stream());
+                qudaStreamWaitEvent(device::get_stream(2), interior_start, 0);
+                update(heatbath, step, mu, parity, MonteRegion::interior, device::get_stream(2));
+              }
+              PGaugeExchange(data, mu_prev, parity_prev);
+              update(heatbath, step, mu, parity, MonteRegion::boundary, device::get_default_stream());
+              if (interior > 0) {
+                qudaEventRecord(interior_end, device::get_stream(2));
+                qudaStreamWaitEvent(device::get_default_stream(), interior_end, 0);
+              }
+            } else {
+              update(heatbath, step, mu, parity, MonteRegion::all, device::get_default_stream());
+              if (!overlap) PGaugeExchange(data, mu, parity);
+            }
+            pending = overlap;
+            mu_prev = mu;
+            parity_prev = parity;
           }
         }
       }
+      if (pending) PGaugeExchange(data, mu_prev, parity_prev);
+
+      qudaEventDestroy(interior_start);
+      qudaEventDestroy(interior_end);
+    }
+
+    MonteAlg(GaugeField &data, RNG *rng, unsigned long long seed, int sweep, Float Beta, int nhb, int nover, int nhit,
+             bool overlap) :
+      data(data),
+      rng(rng),
+      seed(seed),
+      sweep(sweep),
+      Beta(Beta),
+      nhit(nhit),
+      overlap(overlap && comm_partitioned())
+    {
+      if (nhit < 1) errorQuda("Invalid number of hits %d", nhit);
+      if (data.Location() == QUDA_CPU_FIELD_LOCATION) {
+        if (comm_partitioned()) errorQuda("Host heatbath not supported on a partitioned lattice");
+        if (rng) errorQuda("Host heatbath requires the counter-based generator");
+      }
+      int lo[4], box[4];
+      interior = monteInterior(data, lo, box);
+
+      host_timer_t timer;
+      double hb_time = 0.0, ovr_time = 0.0;
+      if (getVerbosity() >= QUDA_VERBOSE) timer.start();
+
+      steps(true, nhb);
 
       if (getVerbosity() >= QUDA_VERBOSE) {
         qudaDeviceSynchronize();
@@ -123,14 +232,7 @@ namespace quda {
         timer.start();
       }
 
-      for (int step = 0; step < nover; step++) {
-        for (int parity = 0; parity < 2; parity++) {
-          for (int mu = 0; mu < 4; mu++) {
-            GaugeHB<Float, nColor, recon>(data, Beta, rngstate, mu, parity, false);
-            PGaugeExchange(data, mu, parity);
-          }
-        }
-      }
+      steps(false, nover);
 
       if (getVerbosity() >= QUDA_VERBOSE) {
         qudaDeviceSynchronize();
@@ -141,17 +243,16 @@ namespace quda {
     }
   };
 
-  /** @brief Perform heatbath and overrelaxation. Performs nhb heatbath steps followed by nover overrelaxation steps.
-   *
-   * @param[in,out] data Gauge field
-   * @param[in,out] rngstate state of the CURAND random number generator
-   * @param[in] Beta inverse of the gauge coupling, beta = 2 Nc / g_0^2
-   * @param[in] nhb number of heatbath steps
-   * @param[in] nover number of overrelaxation steps
-   */
-  void Monte(GaugeField& data, RNG &rngstate, double Beta, int nhb, int nover)
+  void Monte(GaugeField &data, RNG &rngstate, double Beta, int nhb, int nover, int nhit, bool overlap)
+  {
+    if (data.Location() != QUDA_CUDA_FIELD_LOCATION) errorQuda("The stateful generator requires a device field");
+    instantiate<MonteAlg>(data, &rngstate, 0ull, 0, (float)Beta, nhb, nover, nhit, overlap);
+  }
+
+  void Monte(GaugeField &data, unsigned long long seed, int sweep, double Beta, int nhb, int nover, int nhit,
+             bool overlap)
   {
-    instantiate<MonteAlg>(data, rngstate, (float)Beta, nhb, nover);
+    instantiate<MonteAlg>(data, static_cast<RNG *>(nullptr), seed, sweep, (float)Beta, nhb, nover, nhit, overlap);
   }
 
 }
@@ -6,9 +6,17 @@
 #include <layout_hyper.h>
 
 #include <string>
+#include <mutex>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 using namespace quda;
 
+// serializes the entry points below, which share the layout state and may
+// be called from both the calling thread and the asynchronous I/O thread
+static std::mutex qio_mutex;
+
 static QIO_Layout layout;
 static int lattice_size[4];
 int quda_this_node;
@@ -64,6 +72,97 @@ template <typename oFloat, typename iFloat> void vget(char *s1, size_t index, in
   }
 }
 
+// Half and quarter precision files use a block-scaled fixed-point
+// encoding matching QUDA's native fixed-point fields: for each field at
+// each site we store a single float norm (the maximum absolute element at
+// that site) followed by the vlen elements rescaled to the range of the
+// storage type.  The datum is padded to a multiple of four bytes, so with
+// a four-byte word size QIO's byte swapping is symmetric between write
+// and read.
+static size_t block_typesize(size_t store_size, int len)
+{
+  return ((sizeof(float) + store_size * len + sizeof(float) - 1) / sizeof(float)) * sizeof(float);
+}
+
+template <typename storeFloat> constexpr float block_max_value() { return sizeof(storeFloat) == 2 ? 32767.0f : 127.0f; }
+
+// accumulators used to compute the relative residual of the block-scaled encoding
+static double block_norm2;
+static double block_residual2;
+
+// templatized version of vput for block-scaled fixed-point file data
+template <typename oFloat, typename storeFloat> void vput_block(char *s1, size_t index, int count, void *s2)
+{
+  oFloat **field = (oFloat **)s2;
+  const size_t typesize = block_typesize(sizeof(storeFloat), vlen);
+
+  for (int i = 0; i < count; i++) {
+    char *src = s1 + i * typesize;
+    float max;
+    memcpy(&max, src, sizeof(float));
+    const float scale = max / block_max_value<storeFloat>();
+    const storeFloat *q = reinterpret_cast<const storeFloat *>(src + sizeof(float));
+    oFloat *dest = field[i] + vlen * index;
+    for (int j = 0; j < vlen; j++) dest[j] = q[j] * scale;
+  }
+}
+
+// templatized version of vget for block-scaled fixed-point file data
+template <typename storeFloat, typename iFloat> void vget_block(char *s1, size_t index, int count, void *s2)
+{
+  iFloat **field = (iFloat **)s2;
+  const size_t typesize = block_typesize(sizeof(storeFloat), vlen);
+
+  for (int i = 0; i < count; i++) {
+    char *dest = s1 + i * typesize;
+    const iFloat *src = field[i] + vlen * index;
+
+    float max = 0.0f;
+    for (int j = 0; j < vlen; j++) max = std::max(max, std::abs(static_cast<float>(src[j])));
+    const float scale_inv = max > 0.0f ? block_max_value<storeFloat>() / max : 0.0f;
+    const float scale = max / block_max_value<storeFloat>();
+
+    memset(dest, 0, typesize);
+    memcpy(dest, &max, sizeof(float));
+    storeFloat *q = reinterpret_cast<storeFloat *>(dest + sizeof(float));
+    for (int j = 0; j < vlen; j++) {
+      q[j] = static_cast<storeFloat>(std::lrint(src[j] * scale_inv));
+      double residual = src[j] - q[j] * scale;
+      block_norm2 += static_cast<double>(src[j]) * src[j];
+      block_residual2 += residual * residual;
+    }
+  }
+}
+
+static bool is_block_precision(QudaPrecision prec)
+{
+  return prec == QUDA_HALF_PRECISION || prec == QUDA_QUARTER_PRECISION;
+}
+
+static const char *qio_precision_string(QudaPrecision prec)
+{
+  switch (prec) {
+  case QUDA_DOUBLE_PRECISION: return "D";
+  case QUDA_SINGLE_PRECISION: return "F";
+  case QUDA_HALF_PRECISION: return "H";
+  case QUDA_QUARTER_PRECISION: return "Q";
+  default: errorQuda("Unsupported file precision %d", prec);
+  }
+  return nullptr;
+}
+
+static QudaPrecision qio_file_precision(int prec)
+{
+  switch (prec) {
+  case 'D': return QUDA_DOUBLE_PRECISION;
+  case 'F': return QUDA_SINGLE_PRECISION;
+  case 'H': return QUDA_HALF_PRECISION;
+  case 'Q': return QUDA_QUARTER_PRECISION;
+  default: errorQuda("Unsupported file precision %c", prec);
+  }
+  return QUDA_INVALID_PRECISION;
+}
+
 QIO_Reader *open_test_input(const char *filename, int volfmt, int serpar)
 {
   QIO_Iflag iflag;
@@ -146,7 +245,9 @@ int read_field(QIO_Reader *infile, int count, void *field_in[], QudaPrecision cp
   int in_nColor = QIO_get_colors(rec_info);
   int in_count = QIO_get_datacount(rec_info);   // 4 for gauge fields, nVec for packs of vectors
   int in_typesize = QIO_get_typesize(rec_info); // size of data at each site in bytes
-  QudaPrecision file_prec = (prec == 70) ? QUDA_SINGLE_PRECISION : QUDA_DOUBLE_PRECISION;
+  QudaPrecision file_prec = qio_file_precision(prec);
+  const bool block = is_block_precision(file_prec);
+  const size_t typesize = block ? block_typesize(file_prec, len) : file_prec * len;
 
   // Various checks
   // Note: we exclude gauge fields from this b/c QUDA originally saved gauge fields as
@@ -162,8 +263,8 @@ int read_field(QIO_Reader *infile, int count, void *field_in[], QudaPrecision cp
 
   if (in_count != count) errorQuda("QIO_get_datacount %d does not match expected number of fields %d", in_count, count);
 
-  if (in_typesize != file_prec * len)
-    errorQuda("QIO_get_typesize %d does not match expected datasize %d", in_typesize, file_prec * len);
+  if (in_typesize != static_cast<int>(typesize))
+    errorQuda("QIO_get_typesize %d does not match expected datasize %lu", in_typesize, typesize);
 
   // Print the XML string.
   // The len != 18 is a WAR for this line segfaulting on some Chroma configs.
@@ -171,12 +272,28 @@ int read_field(QIO_Reader *infile, int count, void *field_in[], QudaPrecision cp
   if (len != 18 && QIO_string_length(xml_record_in) > 0) printfQuda("QIO string: %s\n", QIO_string_ptr(xml_record_in));
 
   // Get total size. Could probably check the filesize better, but tbd.
-  size_t rec_size = file_prec * count * len;
+  size_t rec_size = typesize * count;
 
   vlen = len;
 
   /* Read the field record and convert to cpu precision*/
-  if (cpu_prec == QUDA_DOUBLE_PRECISION) {
+  if (block) {
+    // block-scaled data is byte swapped in units of the float norm
+    const size_t word_size = sizeof(float);
+    if (cpu_prec == QUDA_DOUBLE_PRECISION) {
+      if (file_prec == QUDA_HALF_PRECISION) {
+        status = QIO_read(infile, rec_info, xml_record_in, vput_block<double, short>, rec_size, word_size, field_in);
+      } else {
+        status = QIO_read(infile, rec_info, xml_record_in, vput_block<double, int8_t>, rec_size, word_size, field_in);
+      }
+    } else {
+      if (file_prec == QUDA_HALF_PRECISION) {
+        status = QIO_read(infile, rec_info, xml_record_in, vput_block<float, short>, rec_size, word_size, field_in);
+      } else {
+        status = QIO_read(infile, rec_info, xml_record_in, vput_block<float, int8_t>, rec_size, word_size, field_in);
+      }
+    }
+  } else if (cpu_prec == QUDA_DOUBLE_PRECISION) {
     if (file_prec == QUDA_DOUBLE_PRECISION) {
       status = QIO_read(infile, rec_info, xml_record_in, vput<double, double>, rec_size, QUDA_DOUBLE_PRECISION, field_in);
     } else {
@@ -249,6 +366,7 @@ void set_layout(const int *X, QudaSiteSubset subset = QUDA_FULL_SITE_SUBSET)
 
 void read_gauge_field(const char *filename, void *gauge[], QudaPrecision precision, const int *X, int, char *[])
 {
+  std::lock_guard<std::mutex> lock(qio_mutex);
   quda_this_node = QMP_get_node_number();
 
   set_layout(X);
@@ -270,6 +388,7 @@ void read_gauge_field(const char *filename, void *gauge[], QudaPrecision precisi
 void read_spinor_field(const char *filename, void *V[], QudaPrecision precision, const int *X, QudaSiteSubset subset,
                        QudaParity parity, int nColor, int nSpin, int Nvec, int, char *[])
 {
+  std::lock_guard<std::mutex> lock(qio_mutex);
   quda_this_node = QMP_get_node_number();
 
   set_layout(X, subset);
@@ -335,10 +454,12 @@ int write_field(QIO_Writer *outfile, int count, const void *field_out[], QudaPre
   int status;
 
   // Create the record info for the field
-  if (file_prec != QUDA_DOUBLE_PRECISION && file_prec != QUDA_SINGLE_PRECISION)
+  if (file_prec != QUDA_DOUBLE_PRECISION && file_prec != QUDA_SINGLE_PRECISION && !is_block_precision(file_prec))
     errorQuda("Error, file_prec=%d not supported", file_prec);
 
-  const char *precision = (file_prec == QUDA_DOUBLE_PRECISION) ? "D" : "F";
+  const char *precision = qio_precision_string(file_prec);
+  const bool block = is_block_precision(file_prec);
+  const size_t typesize = block ? block_typesize(file_prec, len) : file_prec * len;
 
   // presently assumes 4-d
   const int nDim = 4;
@@ -346,7 +467,7 @@ int write_field(QIO_Writer *outfile, int count, const void *field_out[], QudaPre
   int upper[nDim] = {lattice_size[0], lattice_size[1], lattice_size[2], lattice_size[3]};
 
   QIO_RecordInfo *rec_info = QIO_create_record_info(QIO_FIELD, lower, upper, nDim, const_cast<char *>(type),
-                                                    const_cast<char *>(precision), nColor, nSpin, file_prec * len, count);
+                                                    const_cast<char *>(precision), nColor, nSpin, typesize, count);
 
   // Create the record XML for the field
   QIO_String *xml_record_out = QIO_string_create();
@@ -354,8 +475,37 @@ int write_field(QIO_Writer *outfile, int count, const void *field_out[], QudaPre
 
   /* Write the field record converting to desired file precision*/
   vlen = len;
-  size_t rec_size = file_prec*count*len;
-  if (cpu_prec == QUDA_DOUBLE_PRECISION) {
+  size_t rec_size = typesize * count;
+  if (block) {
+    block_norm2 = 0.0;
+    block_residual2 = 0.0;
+    const size_t word_size = sizeof(float);
+    if (cpu_prec == QUDA_DOUBLE_PRECISION) {
+      if (file_prec == QUDA_HALF_PRECISION) {
+        status = QIO_write(outfile, rec_info, xml_record_out, vget_block<short, double>, rec_size, word_size, field_out);
+      } else {
+        status = QIO_write(outfile, rec_info, xml_record_out, vget_block<int8_t, double>, rec_size, word_size, field_out);
+      }
+    } else {
+      if (file_prec == QUDA_HALF_PRECISION) {
+        status = QIO_write(outfile, rec_info, xml_record_out, vget_block<short, float>, rec_size, word_size, field_out);
+      } else {
+        status = QIO_write(outfile, rec_info, xml_record_out, vget_block<int8_t, float>, rec_size, word_size, field_out);
+      }
+    }
+
+    // residual check: the per-site rounding error is bounded by half a
+    // unit of the fixed-point range, so exceeding this bound signals
+    // non-finite or otherwise corrupt input data
+    double sums[2] = {block_norm2, block_residual2};
+    QMP_sum_double_array(sums, 2);
+    double residual = sums[0] > 0.0 ? sqrt(sums[1] / sums[0]) : 0.0;
+    double bound = 0.5 * sqrt(static_cast<double>(len))
+      / (file_prec == QUDA_HALF_PRECISION ? block_max_value<short>() : block_max_value<int8_t>());
+    printfQuda("%s: block-scaled encoding relative residual = %e (bound = %e)\n", __func__, residual, bound);
+    if (!std::isfinite(residual) || residual > bound)
+      warningQuda("Block-scaled encoding residual %e exceeds expected bound %e", residual, bound);
+  } else if (cpu_prec == QUDA_DOUBLE_PRECISION) {
     if (file_prec == QUDA_DOUBLE_PRECISION) {
       status
         = QIO_write(outfile, rec_info, xml_record_out, vget<double, double>, rec_size, QUDA_DOUBLE_PRECISION, field_out);
@@ -390,6 +540,7 @@ int write_su3_field(QIO_Writer *outfile, int count, const void *field_out[],
 
 void write_gauge_field(const char *filename, void *gauge[], QudaPrecision precision, const int *X, int, char *[])
 {
+  std::lock_guard<std::mutex> lock(qio_mutex);
   quda_this_node = QMP_get_node_number();
 
   set_layout(X);
@@ -413,29 +564,36 @@ void write_gauge_field(const char *filename, void *gauge[], QudaPrecision precis
   printfQuda("%s: Closed file for writing\n", __func__);
 }
 
-void write_spinor_field(const char *filename, const void *V[], QudaPrecision precision, const int *X, QudaSiteSubset subset,
-                        QudaParity parity, int nColor, int nSpin, int Nvec, int, char *[])
+int write_spinor_field(const char *filename, const void *V[], QudaPrecision precision, const int *X, QudaSiteSubset subset,
+                       QudaParity parity, int nColor, int nSpin, int Nvec, int, char *[], QudaPrecision file_prec,
+                       bool abort_on_error)
 {
+  std::lock_guard<std::mutex> lock(qio_mutex);
   quda_this_node = QMP_get_node_number();
 
   set_layout(X, subset);
 
-  QudaPrecision file_prec = precision;
+  if (file_prec == QUDA_INVALID_PRECISION) file_prec = precision;
 
   char type[128];
-  sprintf(type, "QUDA_%sNs%dNc%d_ColorSpinorField", (file_prec == QUDA_DOUBLE_PRECISION) ? "D" : "F", nSpin, nColor);
+  sprintf(type, "QUDA_%sNs%dNc%d_ColorSpinorField", qio_precision_string(file_prec), nSpin, nColor);
 
   /* Open the test file for reading */
   QIO_Writer *outfile = open_test_output(filename, QIO_SINGLEFILE, QIO_PARALLEL, QIO_ILDGNO);
-  if (outfile == NULL) { errorQuda("Open file failed\n"); }
+  if (outfile == NULL) {
+    if (abort_on_error) errorQuda("Open file failed\n");
+    return QIO_ERR_OPEN_WRITE;
+  }
 
   /* Read the spinor field record */
   printfQuda("%s: writing %d vector fields\n", __func__, Nvec); fflush(stdout);
   int status
-    = write_field(outfile, Nvec, V, precision, precision, subset, parity, nSpin, nColor, 2 * nSpin * nColor, type);
-  if (status) { errorQuda("write_spinor_fields failed %d\n", status); }
+    = write_field(outfile, Nvec, V, file_prec, precision, subset, parity, nSpin, nColor, 2 * nSpin * nColor, type);
+  if (status && abort_on_error) { errorQuda("write_spinor_fields failed %d\n", status); }
 
   /* Close the file */
-  QIO_close_write(outfile);
+  int close_status = QIO_close_write(outfile);
+  if (close_status && abort_on_error) errorQuda("Closing %s failed %d\n", filename, close_status);
   printfQuda("%s: Closed file for writing\n",__func__);
+  return status ? status : close_status;
 }
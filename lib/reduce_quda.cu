@@ -260,6 +260,13 @@ namespace quda {
       return make_double4(red[0], red[1], red[2], red[3]);
     }
 
+    double2 pipelinedCGUpdate(double a, double b, ColorSpinorField &r, ColorSpinorField &w, ColorSpinorField &s,
+                              ColorSpinorField &z, const ColorSpinorField &q)
+    {
+      auto red = instantiateReduce<pipelinedCGUpdate_, false>(a, b, 0.0, r, w, s, z, q);
+      return make_double2(red[0], red[1]);
+    }
+
     double quadrupleCG3InitNorm(double a, ColorSpinorField &x, ColorSpinorField &y,
                                 ColorSpinorField &z, ColorSpinorField &w, const ColorSpinorField &v)
     {
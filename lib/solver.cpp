@@ -92,6 +92,18 @@ namespace quda {
       report("CA-GCR");
       solver = new CAGCR(mat, matSloppy, matPrecon, matEig, param, profile);
       break;
+    case QUDA_PIPELINED_CG_INVERTER:
+      report("Pipelined CG");
+      solver = new PipelinedCG(mat, matSloppy, matPrecon, matEig, param, profile);
+      break;
+    case QUDA_BLOCK_CG_INVERTER:
+      report("Block CG");
+      solver = new BlockCG(mat, matSloppy, matPrecon, matEig, param, profile);
+      break;
+    case QUDA_GCRODR_INVERTER:
+      report("GCRO-DR");
+      solver = new GCRODR(mat, matSloppy, matPrecon, matEig, param, profile);
+      break;
     case QUDA_MR_INVERTER:
       report("MR");
       solver = new MR(mat, matSloppy, param, profile);
@@ -163,6 +175,9 @@ namespace quda {
     bool profile_running = profile.isRunning(QUDA_PROFILE_INIT);
     if (!param.is_preconditioner && !profile_running) profile.TPSTART(QUDA_PROFILE_INIT);
 
+    if (param.eig_param.compress_n_basis > 0 && param.eig_param.preserve_deflation)
+      errorQuda("Preserving a compressed deflation space is not supported");
+
     eig_solve = EigenSolver::create(&param.eig_param, mat, profile);
 
     // Clone from an existing vector
@@ -250,6 +265,51 @@ namespace quda {
     defl_space = std::move(evecs); // move evecs to defl_space
   }
 
+  /**
+     @brief Convert a set of vectors in place to the given precision
+     @param[in,out] v The vectors to convert
+     @param[in] prec The precision to convert to
+   */
+  static void convertPrecision(std::vector<ColorSpinorField> &v, QudaPrecision prec)
+  {
+    ColorSpinorParam csParam(v[0]);
+    csParam.create = QUDA_NULL_FIELD_CREATE;
+    csParam.setPrecision(prec, QUDA_INVALID_PRECISION, true);
+    for (auto &vi : v) {
+      ColorSpinorField tmp(csParam);
+      tmp = vi;
+      vi = std::move(tmp);
+    }
+  }
+
+  void Solver::prepareDeflationSpace()
+  {
+    QudaPrecision prec = param.eig_param.deflation_prec;
+    if (prec != QUDA_INVALID_PRECISION && prec < evecs[0].Precision()) {
+      logQuda(QUDA_VERBOSE, "Demoting deflation space of size %lu to precision %d\n", evecs.size(), prec);
+      convertPrecision(evecs, prec);
+    }
+
+    if (param.eig_param.compress_n_basis > 0) eig_solve->compressDeflationSpace(evecs);
+  }
+
+  void Solver::recomputeDeflationEvals(bool svd)
+  {
+    if (param.eig_param.compress_n_basis > 0) {
+      logQuda(QUDA_VERBOSE, "Retaining the eigensolver eigenvalues for the compressed deflation space\n");
+    } else {
+      // compute the eigenvalues with a demoted space promoted back to
+      // the operator precision, and demote it again afterwards
+      QudaPrecision prec = evecs[0].Precision();
+      bool promote = prec < param.precision_eigensolver;
+      if (promote) convertPrecision(evecs, param.precision_eigensolver);
+      eig_solve->computeEvals(evecs, evals);
+      if (svd) eig_solve->computeSVD(evecs, evals);
+      if (promote) convertPrecision(evecs, prec);
+    }
+    recompute_evals = false;
+  }
+
   void Solver::extendSVDDeflationSpace()
   {
     if (!deflate_init) errorQuda("Deflation space for this solver not computed");
@@ -267,6 +327,19 @@ namespace quda {
     }
   }
 
+  void Solver::solve_multi_src(cvector_ref<ColorSpinorField> &out, cvector_ref<ColorSpinorField> &in)
+  {
+    if (out.size() != in.size()) errorQuda("Mismatched number of solutions %lu and sources %lu", out.size(), in.size());
+    if (in.size() > QUDA_MAX_MULTI_SHIFT)
+      errorQuda("Number of sources %lu exceeds QUDA_MAX_MULTI_SHIFT %d", in.size(), QUDA_MAX_MULTI_SHIFT);
+
+    for (auto i = 0u; i < in.size(); i++) {
+      (*this)(out[i], in[i]);
+      param.true_res_offset[i] = param.true_res;
+      param.true_res_hq_offset[i] = param.true_res_hq;
+    }
+  }
+
   double Solver::stopping(double tol, double b2, QudaResidualType residual_type)
   {
     double stop=0.0;
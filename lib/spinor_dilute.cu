@@ -54,9 +54,123 @@ namespace quda {
     long long bytes() const { return v.size() * v[0].Bytes() + src.Bytes(); }
   };
 
-  void spinorDilute(std::vector<ColorSpinorField> &v, const ColorSpinorField &src, QudaDilutionType type)
+  static const char *dilution_type_str(QudaDilutionType type)
   {
-    instantiateSpinor<SpinorDilute>(src, v, type);
+    switch (type) {
+    case QUDA_DILUTION_SPIN: return "spin";
+    case QUDA_DILUTION_COLOR: return "color";
+    case QUDA_DILUTION_SPIN_COLOR: return "spin_color";
+    case QUDA_DILUTION_SPIN_COLOR_EVEN_ODD: return "spin_color_even_odd";
+    case QUDA_DILUTION_TIME_SLICE: return "time_slice";
+    case QUDA_DILUTION_BLOCK: return "block";
+    case QUDA_DILUTION_HADAMARD_PROBING: return "hadamard_probing";
+    default: errorQuda("Unsupported dilution type %d", type);
+    }
+    return nullptr;
+  }
+
+  template <typename real, int Ns, int Nc> class SpinorDiluteIndex : TunableKernel2D
+  {
+    ColorSpinorField &v;
+    const ColorSpinorField &src;
+    QudaDilutionType type;
+    int index;
+    const lat_dim_t &block_size;
+    int probe_size;
+    unsigned int minThreads() const { return src.VolumeCB(); }
+
+  public:
+    SpinorDiluteIndex(const ColorSpinorField &src, ColorSpinorField &v, QudaDilutionType type, int index,
+                      const lat_dim_t &block_size, int probe_size) :
+      TunableKernel2D(src, src.SiteSubset()),
+      v(v),
+      src(src),
+      type(type),
+      index(index),
+      block_size(block_size),
+      probe_size(probe_size)
+    {
+      strcat(aux, ",dilution_index,");
+      strcat(aux, dilution_type_str(type));
+      apply(device::get_default_stream());
+    }
+
+    void apply(const qudaStream_t &stream)
+    {
+      TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
+      launch<DiluteSpinorIndex>(tp, stream,
+                                SpinorDiluteIndexArg<real, Ns, Nc>(v, src, type, index, block_size, probe_size));
+    }
+
+    long long bytes() const { return v.Bytes() + src.Bytes(); }
+  };
+
+  int dilutionSize(const ColorSpinorField &src, QudaDilutionType type, const lat_dim_t &block_size, int probe_size)
+  {
+    switch (type) {
+    case QUDA_DILUTION_SPIN: return src.Nspin();
+    case QUDA_DILUTION_COLOR: return src.Ncolor();
+    case QUDA_DILUTION_SPIN_COLOR: return src.Nspin() * src.Ncolor();
+    case QUDA_DILUTION_SPIN_COLOR_EVEN_ODD: return src.Nspin() * src.Ncolor() * src.SiteSubset();
+    case QUDA_DILUTION_TIME_SLICE: return src.X(3) * comm_dim(3);
+    case QUDA_DILUTION_BLOCK: {
+      int size = 1;
+      for (int d = 0; d < 4; d++) {
+        int L = src.X(d) * (d == 0 && src.SiteSubset() == QUDA_PARITY_SITE_SUBSET ? 2 : 1) * comm_dim(d);
+        if (block_size[d] <= 0 || L % block_size[d] != 0)
+          errorQuda("Block size %d does not divide lattice dimension %d = %d", block_size[d], d, L);
+        size *= L / block_size[d];
+      }
+      // the block of a single-parity site must not depend on the parity
+      if (src.SiteSubset() == QUDA_PARITY_SITE_SUBSET && block_size[0] % 2 != 0)
+        errorQuda("Block dilution of a single-parity field requires an even x block size (%d)", block_size[0]);
+      return size;
+    }
+    case QUDA_DILUTION_HADAMARD_PROBING: {
+      if (probe_size <= 0 || (probe_size & (probe_size - 1)) != 0)
+        errorQuda("Number of probing vectors %d must be a power of two", probe_size);
+      int bits = 0;
+      while ((1 << bits) < probe_size) bits++;
+      // the coloring is only consistent across the boundary if it is periodic
+      const int period = 1 << ((bits + 3) / 4);
+      for (int d = 0; d < 4; d++) {
+        int L = src.X(d) * (d == 0 && src.SiteSubset() == QUDA_PARITY_SITE_SUBSET ? 2 : 1) * comm_dim(d);
+        if (L % period != 0)
+          errorQuda("Probing with %d vectors requires lattice dimension %d = %d to be divisible by %d", probe_size, d,
+                    L, period);
+      }
+      return probe_size;
+    }
+    default: errorQuda("Unsupported dilution type %d", type);
+    }
+    return 0;
+  }
+
+  void spinorDilute(std::vector<ColorSpinorField> &v, const ColorSpinorField &src, QudaDilutionType type,
+                    const lat_dim_t &block_size, int probe_size)
+  {
+    switch (type) {
+    case QUDA_DILUTION_SPIN:
+    case QUDA_DILUTION_COLOR:
+    case QUDA_DILUTION_SPIN_COLOR:
+    case QUDA_DILUTION_SPIN_COLOR_EVEN_ODD: instantiateSpinor<SpinorDilute>(src, v, type); break;
+    default: {
+      auto size = dilutionSize(src, type, block_size, probe_size);
+      if (v.size() != static_cast<size_t>(size))
+        errorQuda("Input container size %lu does not match expected size %d for dilution type", v.size(), size);
+      spinorDilute(v, src, type, 0, block_size, probe_size);
+    }
+    }
+  }
+
+  void spinorDilute(cvector_ref<ColorSpinorField> &v, const ColorSpinorField &src, QudaDilutionType type, int offset,
+                    const lat_dim_t &block_size, int probe_size)
+  {
+    auto size = dilutionSize(src, type, block_size, probe_size);
+    if (offset < 0 || offset + v.size() > static_cast<size_t>(size))
+      errorQuda("Dilution range [%d, %lu) exceeds the dilution set size %d", offset, offset + v.size(), size);
+    for (auto i = 0u; i < v.size(); i++)
+      instantiateSpinor<SpinorDiluteIndex>(src, v[i], type, offset + static_cast<int>(i), block_size, probe_size);
   }
 
 } // namespace quda
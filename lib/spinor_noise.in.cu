@@ -9,71 +9,81 @@ namespace quda {
   template <typename real, int Ns, int Nc>
   class SpinorNoise : TunableKernel2D {
     ColorSpinorField &v;
-    RNG &rng;
+    RNG *rng;
+    unsigned long long seed;
     QudaNoiseType type;
     unsigned int minThreads() const { return v.VolumeCB(); }
 
   public:
-    SpinorNoise(ColorSpinorField &v, RNG &rng, QudaNoiseType type) :
+    /**
+       @brief Generate noise with either the stateful generator rng,
+       or if rng is nullptr the counter-based generator keyed by seed
+     */
+    SpinorNoise(ColorSpinorField &v, RNG *rng, unsigned long long seed, QudaNoiseType type) :
       TunableKernel2D(v, v.SiteSubset()),
       v(v),
       rng(rng),
+      seed(seed),
       type(type)
     {
       strcat(aux, type == QUDA_NOISE_GAUSS ? ",gauss" : ",uniform");
+      if (!rng) strcat(aux, ",counter");
       apply(device::get_default_stream());
     }
 
+    template <QudaNoiseType noise> void launch_noise(const TuneParam &tp, const qudaStream_t &stream)
+    {
+      if (rng) launch<NoiseSpinor>(tp, stream, SpinorNoiseArg<real, Ns, Nc, noise>(v, rng->State()));
+      else launch<NoiseSpinor>(tp, stream, SpinorNoiseArg<real, Ns, Nc, noise, true>(v, nullptr, seed));
+    }
+
     void apply(const qudaStream_t &stream) {
       TuneParam tp = tuneLaunch(*this, getTuning(), getVerbosity());
       switch (type) {
-      case QUDA_NOISE_GAUSS:
-        launch<NoiseSpinor>(tp, stream, SpinorNoiseArg<real, Ns, Nc, QUDA_NOISE_GAUSS>(v, rng.State()));
-        break;
-      case QUDA_NOISE_UNIFORM:
-        launch<NoiseSpinor>(tp, stream, SpinorNoiseArg<real, Ns, Nc, QUDA_NOISE_UNIFORM>(v, rng.State()));
-        break;
+      case QUDA_NOISE_GAUSS: launch_noise<QUDA_NOISE_GAUSS>(tp, stream); break;
+      case QUDA_NOISE_UNIFORM: launch_noise<QUDA_NOISE_UNIFORM>(tp, stream); break;
       default: errorQuda("Noise type %d not implemented", type);
       }
     }
 
     long long bytes() const { return v.Bytes(); }
-    void preTune() { rng.backup(); }
-    void postTune(){ rng.restore(); }
+    void preTune() { if (rng) rng->backup(); }
+    void postTune(){ if (rng) rng->restore(); }
   };
 
   template <int...> struct IntList { };
 
   template <typename real, int Ns, int Nc, int...N>
-  void spinorNoise(ColorSpinorField &src, RNG& randstates, QudaNoiseType type, IntList<Nc, N...>)
+  void spinorNoise(ColorSpinorField &src, RNG *randstates, unsigned long long seed, QudaNoiseType type,
+                   IntList<Nc, N...>)
   {
     if (src.Ncolor() == Nc) {
-      SpinorNoise<real, Ns, Nc>(src, randstates, type);
+      SpinorNoise<real, Ns, Nc>(src, randstates, seed, type);
     } else {
-      if constexpr (sizeof...(N) > 0) spinorNoise<real, Ns>(src, randstates, type, IntList<N...>());
+      if constexpr (sizeof...(N) > 0) spinorNoise<real, Ns>(src, randstates, seed, type, IntList<N...>());
       else errorQuda("nColor = %d not implemented", src.Ncolor());
     }
   }
 
   template <typename real>
-  void spinorNoise(ColorSpinorField &src, RNG& randstates, QudaNoiseType type)
+  void spinorNoise(ColorSpinorField &src, RNG *randstates, unsigned long long seed, QudaNoiseType type)
   {
     checkNative(src);
     if (!is_enabled_spin(src.Nspin()))
       errorQuda("spinorNoise has not been built for nSpin=%d fields", src.Nspin());
 
     if (src.Nspin() == 4) {
-      if constexpr (is_enabled_spin(4)) spinorNoise<real, 4>(src, randstates, type, IntList<3>());
+      if constexpr (is_enabled_spin(4)) spinorNoise<real, 4>(src, randstates, seed, type, IntList<3>());
     } else if (src.Nspin() == 2) {
-      if constexpr (is_enabled_spin(2)) spinorNoise<real, 2>(src, randstates, type, IntList<3, @QUDA_MULTIGRID_NVEC_LIST@>());
+      if constexpr (is_enabled_spin(2)) spinorNoise<real, 2>(src, randstates, seed, type, IntList<3, @QUDA_MULTIGRID_NVEC_LIST@>());
     } else if (src.Nspin() == 1) {
-      if constexpr (is_enabled_spin(1)) spinorNoise<real, 1>(src, randstates, type, IntList<3>());
+      if constexpr (is_enabled_spin(1)) spinorNoise<real, 1>(src, randstates, seed, type, IntList<3>());
     } else {
       errorQuda("Nspin = %d not implemented", src.Nspin());
     }
   }
 
-  void spinorNoise(ColorSpinorField &src_, RNG &randstates, QudaNoiseType type)
+  static void spinorNoise(ColorSpinorField &src_, RNG *randstates, unsigned long long seed, QudaNoiseType type)
   {
     // if src is a CPU field then create GPU field
     ColorSpinorField src;
@@ -91,18 +101,22 @@ namespace quda {
     }
 
     switch (src.Precision()) {
-    case QUDA_DOUBLE_PRECISION: spinorNoise<double>(src, randstates, type); break;
-    case QUDA_SINGLE_PRECISION: spinorNoise<float>(src, randstates, type); break;
+    case QUDA_DOUBLE_PRECISION: spinorNoise<double>(src, randstates, seed, type); break;
+    case QUDA_SINGLE_PRECISION: spinorNoise<float>(src, randstates, seed, type); break;
     default: errorQuda("Precision %d not implemented", src.Precision());
     }
 
     if (copy_back) src_ = src; // copy back if needed
   }
 
+  void spinorNoise(ColorSpinorField &src, RNG &randstates, QudaNoiseType type)
+  {
+    spinorNoise(src, &randstates, 0, type);
+  }
+
   void spinorNoise(ColorSpinorField &src, unsigned long long seed, QudaNoiseType type)
   {
-    RNG randstates(src, seed);
-    spinorNoise(src, randstates, type);
+    spinorNoise(src, nullptr, seed, type);
   }
 
 } // namespace quda
@@ -1,37 +1,151 @@
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <thread>
+
 #include <color_spinor_field.h>
 #include <qio_field.h>
 #include <vector_io.h>
 #include <blas_quda.h>
+#include <timer.h>
+
+#if defined(MPI_COMMS)
+#include <mpi.h>
+#endif
 
 namespace quda
 {
 
-  VectorIO::VectorIO(const std::string &filename, bool parity_inflate) :
-    filename(filename),
-    parity_inflate(parity_inflate)
+  namespace
   {
-    if (strcmp(filename.c_str(), "") == 0)
-      errorQuda("No eigenspace input file defined (filename = %s, parity_inflate = %d", filename.c_str(), parity_inflate);
-  }
 
-  void VectorIO::load(cvector_ref<ColorSpinorField> &vecs)
-  {
-    const ColorSpinorField &v0 = vecs[0];
-    const int Nvec = vecs.size();
-    const QudaPrecision load_prec = v0.Precision() < QUDA_SINGLE_PRECISION ? QUDA_SINGLE_PRECISION : v0.Precision();
+    /**
+       @brief IOQueue is a FIFO of file I/O tasks that are executed in
+       order on a single dedicated host thread.  The thread is
+       launched on first use and joined at program exit.
+     */
+    class IOQueue
+    {
+      std::thread worker;
+      std::mutex mutex;
+      std::condition_variable cv;
+      std::deque<std::packaged_task<void()>> tasks;
+      bool shutdown = false;
 
-    auto spinor_parity = v0.SuggestedParity();
-    if (v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity_inflate &&
-        spinor_parity != QUDA_EVEN_PARITY && spinor_parity != QUDA_ODD_PARITY)
-      errorQuda("When loading single parity vectors, the suggested parity must be set.");
-    if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Start loading %04d vectors from %s\n", Nvec, filename.c_str());
+      void run()
+      {
+        while (true) {
+          std::packaged_task<void()> task;
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [this] { return shutdown || !tasks.empty(); });
+            if (tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+          }
+          task();
+        }
+      }
 
-    std::vector<ColorSpinorField> tmp(Nvec);
-    bool create_tmp = load_prec != v0.Precision() || (v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity_inflate) ||
-      v0.Location() == QUDA_CUDA_FIELD_LOCATION;
+    public:
+      ~IOQueue()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          shutdown = true;
+        }
+        cv.notify_one();
+        if (worker.joinable()) worker.join();
+      }
 
-    if (create_tmp) {
-      ColorSpinorParam csParam(vecs[0]);
+      /**
+         @brief Append a task to the queue
+         @param[in] f The task to execute on the I/O thread
+         @return Future that becomes ready once the task has completed
+       */
+      std::shared_future<void> push(std::function<void()> f)
+      {
+        std::packaged_task<void()> task(std::move(f));
+        auto done = task.get_future().share();
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          if (!worker.joinable()) worker = std::thread(&IOQueue::run, this);
+          tasks.push_back(std::move(task));
+        }
+        cv.notify_one();
+        return done;
+      }
+    };
+
+    IOQueue &io_queue()
+    {
+      static IOQueue queue;
+      return queue;
+    }
+
+    /**
+       Host staging buffer of an in-flight asynchronous save.  The
+       buffers are only ever created and destroyed on the calling
+       thread, the I/O thread just reads from them.
+     */
+    struct AsyncSave {
+      std::vector<ColorSpinorField> buffer;
+      std::shared_future<void> done;
+    };
+
+    /**
+       Host staging buffer of an in-flight or completed prefetch,
+       consumed by the first matching VectorIO::load
+     */
+    struct Prefetch {
+      std::string filename;
+      bool parity_inflate;
+      ColorSpinorParam param;
+      std::vector<ColorSpinorField> buffer;
+      std::shared_future<void> done;
+    };
+
+    /** Number of host staging buffers used for asynchronous saves (double buffering) */
+    constexpr size_t n_save_buffer = 2;
+
+    std::deque<AsyncSave> async_saves;
+    std::list<Prefetch> prefetches;
+
+    /** The most recently queued task: once complete all prior I/O has completed */
+    std::shared_future<void> last_task;
+
+    /** Files whose asynchronous save failed since the last flush, appended to by the I/O thread */
+    std::mutex failed_mutex;
+    std::vector<std::string> failed_saves;
+
+    /**
+       @brief Release the staging buffers of any completed saves.
+       If the number of outstanding saves is at least max_pending,
+       block on the oldest ones until this is no longer the case.
+     */
+    void retire_saves(size_t max_pending)
+    {
+      while (!async_saves.empty()) {
+        auto &front = async_saves.front();
+        if (async_saves.size() >= max_pending)
+          front.done.wait();
+        else if (front.done.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+          break;
+        async_saves.pop_front();
+      }
+    }
+
+    /**
+       @brief Create the host-side buffers used for loading into vecs
+     */
+    std::vector<ColorSpinorField> create_load_buffer(const ColorSpinorField &v0, int Nvec, QudaPrecision load_prec,
+                                                     bool parity_inflate)
+    {
+      ColorSpinorParam csParam(v0);
       csParam.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
       csParam.setPrecision(load_prec);
       csParam.location = QUDA_CPU_FIELD_LOCATION;
@@ -40,25 +154,161 @@ namespace quda
         csParam.x[0] *= 2;
         csParam.siteSubset = QUDA_FULL_SITE_SUBSET;
       }
+      std::vector<ColorSpinorField> tmp(Nvec);
       for (int i = 0; i < Nvec; i++) tmp[i] = ColorSpinorField(csParam);
+      return tmp;
     }
 
-    if (v0.Ndim() == 4 || v0.Ndim() == 5) {
+  } // namespace
+
+  VectorIO::VectorIO(const std::string &filename, bool parity_inflate, bool async) :
+    filename(filename),
+    parity_inflate(parity_inflate),
+    async(async && asyncEnabled())
+  {
+    if (strcmp(filename.c_str(), "") == 0)
+      errorQuda("No eigenspace input file defined (filename = %s, parity_inflate = %d", filename.c_str(), parity_inflate);
+  }
+
+  bool VectorIO::asyncEnabled()
+  {
+    static bool init = false;
+    static bool enabled = false;
+    if (!init) {
+      char *enable_async_io = getenv("QUDA_ENABLE_ASYNC_IO");
+      enabled = !(enable_async_io && strcmp(enable_async_io, "0") == 0);
+#if defined(QMP_COMMS)
+      // QIO and QUDA share the QMP default communicator
+      if (enabled && comm_size() > 1) {
+        warningQuda("Asynchronous vector I/O is not supported with QMP communications, using synchronous I/O");
+        enabled = false;
+      }
+#elif defined(MPI_COMMS)
+      // QIO runs collectives on the I/O thread concurrently with QUDA's own communication
+      int provided;
+      MPI_Query_thread(&provided);
+      if (enabled && provided != MPI_THREAD_MULTIPLE) {
+        warningQuda("Asynchronous vector I/O requires MPI_THREAD_MULTIPLE, using synchronous I/O");
+        enabled = false;
+      }
+#endif
+      init = true;
+    }
+    return enabled;
+  }
+
+  int VectorIO::flush(TimeProfile &profile)
+  {
+    if (last_task.valid() || !prefetches.empty()) {
+      bool is_running = profile.isRunning(QUDA_PROFILE_IO);
+      if (!is_running) profile.TPSTART(QUDA_PROFILE_IO);
+      // unconsumed prefetches must complete before their buffers are released
+      for (auto &p : prefetches) p.done.wait();
+      prefetches.clear();
+      if (last_task.valid()) last_task.wait();
+      retire_saves(0);
+      last_task = std::shared_future<void>();
+      if (!is_running) profile.TPSTOP(QUDA_PROFILE_IO);
+    }
+
+    std::lock_guard<std::mutex> lock(failed_mutex);
+    int n_failed = failed_saves.size();
+    for (auto &f : failed_saves) warningQuda("Asynchronous save of vectors to %s failed", f.c_str());
+    failed_saves.clear();
+    return n_failed;
+  }
+
+  void VectorIO::read(cvector_ref<ColorSpinorField> &buffer, const ColorSpinorParam &param) const
+  {
+    const int Nvec = buffer.size();
+
+    if (param.nDim == 4 || param.nDim == 5) {
       // since QIO routines presently assume we have 4-d fields, we need to convert to array of 4-d fields
-      auto Ls = v0.Ndim() == 5 ? v0.X(4) : 1;
-      auto V4 = v0.Volume() / Ls;
-      if (v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity_inflate) V4 *= 2;
-      auto stride = V4 * v0.Ncolor() * v0.Nspin() * 2 * v0.Precision();
+      auto Ls = param.nDim == 5 ? param.x[4] : 1;
+      size_t V4 = 1;
+      for (int d = 0; d < 4; d++) V4 *= param.x[d];
+      if (param.siteSubset == QUDA_PARITY_SITE_SUBSET && parity_inflate) V4 *= 2;
+      auto stride = V4 * param.nColor * param.nSpin * 2 * buffer[0].Precision();
       std::vector<void *> V(Nvec * Ls);
       for (int i = 0; i < Nvec; i++) {
-        auto &v = create_tmp ? tmp[i] : vecs[i];
-        for (int j = 0; j < Ls; j++) { V[i * Ls + j] = static_cast<char *>(v.V()) + j * stride; }
+        for (int j = 0; j < Ls; j++) { V[i * Ls + j] = static_cast<char *>(buffer[i].V()) + j * stride; }
       }
 
-      read_spinor_field(filename.c_str(), V.data(), v0.Precision(), v0.X(), v0.SiteSubset(),
-                        spinor_parity, v0.Ncolor(), v0.Nspin(), Nvec * Ls, 0, nullptr);
+      read_spinor_field(filename.c_str(), V.data(), buffer[0].Precision(), param.x.data, param.siteSubset,
+                        param.suggested_parity, param.nColor, param.nSpin, Nvec * Ls, 0, nullptr);
     } else {
-      errorQuda("Unexpected field dimension %d", v0.Ndim());
+      errorQuda("Unexpected field dimension %d", param.nDim);
+    }
+  }
+
+  void VectorIO::prefetch(cvector_ref<const ColorSpinorField> &vecs)
+  {
+    if (!async) return;
+
+    const ColorSpinorField &v0 = vecs[0];
+    const int Nvec = vecs.size();
+    const QudaPrecision load_prec = v0.Precision() < QUDA_SINGLE_PRECISION ? QUDA_SINGLE_PRECISION : v0.Precision();
+    auto spinor_parity = v0.SuggestedParity();
+    if (v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity_inflate &&
+        spinor_parity != QUDA_EVEN_PARITY && spinor_parity != QUDA_ODD_PARITY)
+      errorQuda("When loading single parity vectors, the suggested parity must be set.");
+
+    logQuda(QUDA_SUMMARIZE, "Start prefetching %04d vectors from %s\n", Nvec, filename.c_str());
+
+    prefetches.push_back({filename, parity_inflate, ColorSpinorParam(v0),
+                          create_load_buffer(v0, Nvec, load_prec, parity_inflate), std::shared_future<void>()});
+    auto &p = prefetches.back();
+    p.done = io_queue().push([io = *this, buffer = &p.buffer, param = p.param]() { io.read(*buffer, param); });
+    last_task = p.done;
+  }
+
+  void VectorIO::load(cvector_ref<ColorSpinorField> &vecs)
+  {
+    const ColorSpinorField &v0 = vecs[0];
+    const int Nvec = vecs.size();
+    const QudaPrecision load_prec = v0.Precision() < QUDA_SINGLE_PRECISION ? QUDA_SINGLE_PRECISION : v0.Precision();
+
+    auto spinor_parity = v0.SuggestedParity();
+    if (v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity_inflate &&
+        spinor_parity != QUDA_EVEN_PARITY && spinor_parity != QUDA_ODD_PARITY)
+      errorQuda("When loading single parity vectors, the suggested parity must be set.");
+
+    // check if these vectors have already been prefetched
+    auto match = [&](const Prefetch &p) {
+      if (p.filename != filename || p.parity_inflate != parity_inflate) return false;
+      if (static_cast<int>(p.buffer.size()) != Nvec || p.buffer[0].Precision() != load_prec) return false;
+      if (p.param.nSpin != v0.Nspin() || p.param.nColor != v0.Ncolor() || p.param.nDim != v0.Ndim()) return false;
+      if (p.param.siteSubset != v0.SiteSubset() || p.param.suggested_parity != spinor_parity) return false;
+      for (int d = 0; d < v0.Ndim(); d++)
+        if (p.param.x[d] != v0.X(d)) return false;
+      return true;
+    };
+    auto prefetched = std::find_if(prefetches.begin(), prefetches.end(), match);
+
+    std::vector<ColorSpinorField> tmp;
+    bool create_tmp = load_prec != v0.Precision() || (v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity_inflate) ||
+      v0.Location() == QUDA_CUDA_FIELD_LOCATION;
+
+    if (prefetched != prefetches.end()) {
+      logQuda(QUDA_SUMMARIZE, "Completing prefetch of %04d vectors from %s\n", Nvec, filename.c_str());
+      prefetched->done.wait();
+      tmp = std::move(prefetched->buffer);
+      prefetches.erase(prefetched);
+      create_tmp = true;
+    } else {
+      if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Start loading %04d vectors from %s\n", Nvec, filename.c_str());
+      // ensure that any outstanding writes have completed before reading,
+      // leaving the staging buffers of other prefetches in place
+      if (last_task.valid()) {
+        last_task.wait();
+        retire_saves(0);
+      }
+      if (create_tmp) {
+        tmp = create_load_buffer(v0, Nvec, load_prec, parity_inflate);
+        read(tmp, ColorSpinorParam(v0));
+      } else {
+        read(vecs, ColorSpinorParam(v0));
+      }
     }
 
     if (create_tmp) {
@@ -76,16 +326,23 @@ namespace quda
   {
     const ColorSpinorField &v0 = vecs[0];
     const int Nvec = (size != 0 && size < vecs.size()) ? size : vecs.size();
-    if (prec < QUDA_SINGLE_PRECISION && prec != QUDA_INVALID_PRECISION) errorQuda("Unsupported precision %d", prec);
-    const QudaPrecision save_prec = prec != QUDA_INVALID_PRECISION ? prec :
+    if (prec < QUDA_QUARTER_PRECISION && prec != QUDA_INVALID_PRECISION) errorQuda("Unsupported precision %d", prec);
+    const QudaPrecision file_prec = prec != QUDA_INVALID_PRECISION ? prec :
       v0.Precision() < QUDA_SINGLE_PRECISION ? QUDA_SINGLE_PRECISION : v0.Precision();
+    // half and quarter precision files are block-scaled encodings of a single-precision host field
+    const QudaPrecision save_prec = file_prec < QUDA_SINGLE_PRECISION ? QUDA_SINGLE_PRECISION : file_prec;
 
+    // asynchronous saves always stage, since the caller is free to modify vecs on return
     bool create_tmp = save_prec != v0.Precision() || (v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity_inflate) ||
-      v0.Location() == QUDA_CUDA_FIELD_LOCATION;
+      v0.Location() == QUDA_CUDA_FIELD_LOCATION || async;
     auto spinor_parity = v0.SuggestedParity();
     if (v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity_inflate &&
         spinor_parity != QUDA_EVEN_PARITY && spinor_parity != QUDA_ODD_PARITY)
       errorQuda("When loading single parity vectors, the suggested parity must be set.");
+
+    // wait for a staging buffer to become available
+    if (async) retire_saves(n_save_buffer);
+
     std::vector<ColorSpinorField> tmp(Nvec);
 
     if (create_tmp) {
@@ -114,22 +371,41 @@ namespace quda
       }
     }
 
-    if (getVerbosity() >= QUDA_SUMMARIZE) printfQuda("Start saving %d vectors to %s\n", Nvec, filename.c_str());
+    if (getVerbosity() >= QUDA_SUMMARIZE)
+      printfQuda("Start %ssaving %d vectors to %s\n", async ? "asynchronously " : "", Nvec, filename.c_str());
 
     if (v0.Ndim() == 4 || v0.Ndim() == 5) {
       // since QIO routines presently assume we have 4-d fields, we need to convert to array of 4-d fields
       auto Ls = v0.Ndim() == 5 ? v0.X(4) : 1;
       auto V4 = v0.Volume() / Ls;
       if (v0.SiteSubset() == QUDA_PARITY_SITE_SUBSET && parity_inflate) V4 *= 2;
-      auto stride = V4 * v0.Ncolor() * v0.Nspin() * 2 * v0.Precision();
+      auto stride = V4 * v0.Ncolor() * v0.Nspin() * 2 * save_prec;
       std::vector<const void *> V(Nvec * Ls);
       for (int i = 0; i < Nvec; i++) {
         auto &v = create_tmp ? tmp[i] : vecs[i];
         for (int j = 0; j < Ls; j++) { V[i * Ls + j] = static_cast<const char *>(v.V()) + j * stride; }
       }
 
-      write_spinor_field(filename.c_str(), V.data(), save_prec, v0.X(), v0.SiteSubset(),
-                         spinor_parity, v0.Ncolor(), v0.Nspin(), Nvec * Ls, 0, nullptr);
+      // the write captures everything by value so that it can outlive this call
+      auto write = [filename = filename, V = std::move(V), save_prec, X = std::vector<int>(v0.X(), v0.X() + v0.Ndim()),
+                    subset = v0.SiteSubset(), spinor_parity, nColor = v0.Ncolor(), nSpin = v0.Nspin(),
+                    n = Nvec * Ls, file_prec, async = async]() mutable {
+        // a failed asynchronous write is recorded and reported by flush
+        int status = write_spinor_field(filename.c_str(), V.data(), save_prec, X.data(), subset, spinor_parity, nColor,
+                                        nSpin, n, 0, nullptr, file_prec, !async);
+        if (status) {
+          std::lock_guard<std::mutex> lock(failed_mutex);
+          failed_saves.push_back(filename);
+        }
+      };
+
+      if (async) {
+        // the staging buffer is retained until the write has completed
+        async_saves.push_back({std::move(tmp), io_queue().push(write)});
+        last_task = async_saves.back().done;
+        return;
+      }
+      write();
     } else {
       errorQuda("Unexpected field dimension %d", v0.Ndim());
     }
@@ -1,5 +1,7 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <complex>
+#include <vector>
 #include <time.h>
 #include <math.h>
 #include <string.h>
@@ -17,6 +19,7 @@
 // In a typical application, quda.h is the only QUDA header required.
 #include <quda.h>
 #include <color_spinor_field.h>
+#include <comm_quda.h>
 
 // If you add a new contraction type, this must be updated++
 constexpr int NcontractType = 2;
@@ -166,6 +169,205 @@ int test(int contractionType, QudaPrecision test_prec)
   return faults;
 }
 
+// Compares the momentum-projected, time-slice summed contraction of a
+// batch of propagator pairs with the site-local contraction projected
+// on the host.  Returns the number of faults.
+int test_summed(int contractionType, QudaPrecision test_prec)
+{
+  int X[4] = {xdim, ydim, zdim, tdim};
+
+  QudaInvertParam inv_param = newQudaInvertParam();
+  setContractInvertParam(inv_param);
+  inv_param.cpu_prec = test_prec;
+  inv_param.cuda_prec = test_prec;
+  inv_param.cuda_prec_sloppy = test_prec;
+  inv_param.cuda_prec_precondition = test_prec;
+
+  QudaContractType cType = contractionType == 0 ? QUDA_CONTRACT_TYPE_OPEN : QUDA_CONTRACT_TYPE_DR;
+
+  constexpr int n_prop = 2;
+  const int mom[] = {0, 0, 0, 1, 0, 0, 0, 1, 1, -1, 2, 0};
+  constexpr int n_mom = sizeof(mom) / (3 * sizeof(int));
+  const int gamma[] = {0, 5, 10, 15};
+  constexpr int n_gamma = sizeof(gamma) / sizeof(int);
+  const int source_position[4] = {1, 0, 2, 0};
+
+  int L[4];
+  for (int d = 0; d < 4; d++) L[d] = X[d] * quda::comm_dim(d);
+  const int nt = L[3];
+
+  size_t data_size = (test_prec == QUDA_DOUBLE_PRECISION) ? sizeof(double) : sizeof(float);
+  void *spinorX[n_prop];
+  void *spinorY[n_prop];
+  for (int i = 0; i < n_prop; i++) {
+    spinorX[i] = safe_malloc(V * spinor_site_size * data_size);
+    spinorY[i] = safe_malloc(V * spinor_site_size * data_size);
+    for (auto j = 0lu; j < V * spinor_site_size; j++) {
+      if (test_prec == QUDA_SINGLE_PRECISION) {
+        ((float *)spinorX[i])[j] = rand() / (float)RAND_MAX;
+        ((float *)spinorY[i])[j] = rand() / (float)RAND_MAX;
+      } else {
+        ((double *)spinorX[i])[j] = rand() / (double)RAND_MAX;
+        ((double *)spinorY[i])[j] = rand() / (double)RAND_MAX;
+      }
+    }
+  }
+
+  std::vector<double> result(2 * nt * n_mom * n_gamma);
+  contractSummedQuda(spinorX, spinorY, n_prop, result.data(), cType, &inv_param, X, n_mom, mom, source_position,
+                     n_gamma, gamma);
+
+  // reference: site-local contraction projected and summed on the host
+  std::vector<std::complex<double>> ref(nt * n_mom * n_gamma, 0.0);
+  void *site_result = safe_malloc(2 * V * 16 * data_size);
+  for (int i = 0; i < n_prop; i++) {
+    contractQuda(spinorX[i], spinorY[i], site_result, cType, &inv_param, X);
+
+    for (int idx = 0; idx < V; idx++) {
+      // sites are even-odd ordered with time running slowest
+      int parity = idx / Vh;
+      int x_cb = idx % Vh;
+      int za = x_cb / (X[0] / 2);
+      int zb = za / X[1];
+      int x[4];
+      x[1] = za - zb * X[1];
+      x[3] = zb / X[2];
+      x[2] = zb - x[3] * X[2];
+      x[0] = 2 * (x_cb - za * (X[0] / 2)) + ((x[1] + x[2] + x[3] + parity) & 1);
+      for (int d = 0; d < 4; d++) x[d] += quda::comm_coord(d) * X[d];
+
+      for (int m = 0; m < n_mom; m++) {
+        double phase = 0.0;
+        for (int d = 0; d < 3; d++) phase += mom[3 * m + d] * (x[d] - source_position[d]) / (double)L[d];
+        std::complex<double> e = std::polar(1.0, -2.0 * M_PI * phase);
+        for (int g = 0; g < n_gamma; g++) {
+          int k = 2 * (idx * 16 + gamma[g]);
+          std::complex<double> c = test_prec == QUDA_DOUBLE_PRECISION ?
+            std::complex<double>(((double *)site_result)[k], ((double *)site_result)[k + 1]) :
+            std::complex<double>(((float *)site_result)[k], ((float *)site_result)[k + 1]);
+          ref[(x[3] * n_mom + m) * n_gamma + g] += e * c;
+        }
+      }
+    }
+  }
+  quda::comm_allreduce_sum(ref);
+
+  // tolerance is relative to the magnitude of the summed correlators
+  double norm = 0.0;
+  for (auto &r : ref) norm = std::max(norm, std::abs(r));
+  const double tol = (test_prec == QUDA_DOUBLE_PRECISION ? 1e-10 : 1e-4) * norm;
+
+  int faults = 0;
+  for (int i = 0; i < nt * n_mom * n_gamma; i++) {
+    std::complex<double> r(result[2 * i], result[2 * i + 1]);
+    if (std::abs(r - ref[i]) > tol) faults++;
+  }
+
+  printfQuda("Summed contraction comparison for contraction type %s complete with %d/%d faults\n",
+             get_contract_str(cType), faults, nt * n_mom * n_gamma);
+
+  host_free(site_result);
+  for (int i = 0; i < n_prop; i++) {
+    host_free(spinorX[i]);
+    host_free(spinorY[i]);
+  }
+
+  return faults;
+}
+
+// Compares the meson fields computed on the device against those
+// computed on the host, for distinct and identical vector sets, and
+// checks the first element against the summed contraction.  Returns
+// the number of faults.
+int test_meson_field(QudaPrecision test_prec)
+{
+  int X[4] = {xdim, ydim, zdim, tdim};
+
+  QudaInvertParam inv_param = newQudaInvertParam();
+  setContractInvertParam(inv_param);
+  inv_param.cpu_prec = test_prec;
+  inv_param.cuda_prec = test_prec;
+  inv_param.cuda_prec_sloppy = test_prec;
+  inv_param.cuda_prec_precondition = test_prec;
+
+  // set sizes are chosen to not be a multiple of the tile size
+  constexpr int n_w = 5;
+  constexpr int n_v = 6;
+  const int mom[] = {0, 0, 0, 1, 0, 0, 0, -1, 1};
+  constexpr int n_mom = sizeof(mom) / (3 * sizeof(int));
+  const int gamma[] = {0, 4, 5, 7, 15};
+  constexpr int n_gamma = sizeof(gamma) / sizeof(int);
+  const int nt = tdim * quda::comm_dim(3);
+
+  size_t data_size = (test_prec == QUDA_DOUBLE_PRECISION) ? sizeof(double) : sizeof(float);
+  void *spinorW[n_w];
+  void *spinorV[n_v];
+  for (auto set : {std::make_pair(spinorW, n_w), std::make_pair(spinorV, n_v)}) {
+    for (int i = 0; i < set.second; i++) {
+      set.first[i] = safe_malloc(V * spinor_site_size * data_size);
+      for (auto j = 0lu; j < V * spinor_site_size; j++) {
+        if (test_prec == QUDA_SINGLE_PRECISION)
+          ((float *)set.first[i])[j] = rand() / (float)RAND_MAX;
+        else
+          ((double *)set.first[i])[j] = rand() / (double)RAND_MAX;
+      }
+    }
+  }
+
+  auto compare = [&](const std::vector<double> &a, const std::vector<double> &b) {
+    double norm = 0.0;
+    for (auto &x : b) norm = std::max(norm, std::abs(x));
+    const double tol = (test_prec == QUDA_DOUBLE_PRECISION ? 1e-10 : 1e-4) * norm;
+    int faults = 0;
+    for (auto i = 0u; i < a.size(); i++)
+      if (std::abs(a[i] - b[i]) > tol) faults++;
+    return faults;
+  };
+
+  int faults = 0;
+
+  // distinct sets
+  {
+    std::vector<double> device(2 * nt * n_mom * n_gamma * n_w * n_v);
+    std::vector<double> host(device.size());
+    mesonFieldQuda(spinorW, n_w, spinorV, n_v, device.data(), &inv_param, X, n_mom, mom, n_gamma, gamma,
+                   QUDA_CUDA_FIELD_LOCATION);
+    mesonFieldQuda(spinorW, n_w, spinorV, n_v, host.data(), &inv_param, X, n_mom, mom, n_gamma, gamma,
+                   QUDA_CPU_FIELD_LOCATION);
+    faults += compare(device, host);
+
+    // the (0, 0) element is the summed contraction of the first pair
+    std::vector<double> summed(2 * nt * n_mom * n_gamma);
+    const int source_position[4] = {0, 0, 0, 0};
+    contractSummedQuda(spinorW, spinorV, 1, summed.data(), QUDA_CONTRACT_TYPE_DR, &inv_param, X, n_mom, mom,
+                       source_position, n_gamma, gamma);
+    std::vector<double> element(summed.size());
+    for (int k = 0; k < nt * n_mom * n_gamma; k++) {
+      element[2 * k + 0] = device[2 * k * n_w * n_v + 0];
+      element[2 * k + 1] = device[2 * k * n_w * n_v + 1];
+    }
+    faults += compare(element, summed);
+  }
+
+  // identical sets share a single copy on the device
+  {
+    std::vector<double> device(2 * nt * n_mom * n_gamma * n_w * n_w);
+    std::vector<double> host(device.size());
+    mesonFieldQuda(spinorW, n_w, spinorW, n_w, device.data(), &inv_param, X, n_mom, mom, n_gamma, gamma,
+                   QUDA_CUDA_FIELD_LOCATION);
+    mesonFieldQuda(spinorW, n_w, spinorW, n_w, host.data(), &inv_param, X, n_mom, mom, n_gamma, gamma,
+                   QUDA_CPU_FIELD_LOCATION);
+    faults += compare(device, host);
+  }
+
+  printfQuda("Meson field comparison complete with %d faults\n", faults);
+
+  for (int i = 0; i < n_w; i++) host_free(spinorW[i]);
+  for (int i = 0; i < n_v; i++) host_free(spinorV[i]);
+
+  return faults;
+}
+
 // The following tests gets each contraction type and precision using google testing framework
 using ::testing::Bool;
 using ::testing::Combine;
@@ -193,6 +395,27 @@ TEST_P(ContractionTest, verify)
   EXPECT_EQ(faults, 0) << "CPU and GPU implementations do not agree";
 }
 
+TEST_P(ContractionTest, summed)
+{
+  QudaPrecision prec = getPrecision(::testing::get<0>(GetParam()));
+  int contractionType = ::testing::get<1>(GetParam());
+  if ((QUDA_PRECISION & prec) == 0) GTEST_SKIP();
+  auto faults = test_summed(contractionType, prec);
+  EXPECT_EQ(faults, 0) << "Summed and site-local contractions do not agree";
+}
+
+class MesonFieldTest : public ::testing::TestWithParam<int>
+{
+};
+
+TEST_P(MesonFieldTest, verify)
+{
+  QudaPrecision prec = getPrecision(GetParam());
+  if ((QUDA_PRECISION & prec) == 0) GTEST_SKIP();
+  auto faults = test_meson_field(prec);
+  EXPECT_EQ(faults, 0) << "CPU and GPU meson fields do not agree";
+}
+
 // Helper function to construct the test name
 std::string getContractName(testing::TestParamInfo<::testing::tuple<int, int>> param)
 {
@@ -206,3 +429,5 @@ std::string getContractName(testing::TestParamInfo<::testing::tuple<int, int>> p
 
 // Instantiate all test cases
 INSTANTIATE_TEST_SUITE_P(QUDA, ContractionTest, Combine(Range(2, 4), Range(0, NcontractType)), getContractName);
+INSTANTIATE_TEST_SUITE_P(QUDA, MesonFieldTest, Range(2, 4),
+                         [](testing::TestParamInfo<int> param) { return std::string(prec_str[param.param]); });
@@ -0,0 +1,163 @@
+// QUDA headers
+#include <quda.h>
+#include <color_spinor_field.h>
+#include <counter_rng.h>
+#include <index_helper.cuh>
+#include <instantiate.h>
+
+// External headers
+#include <misc.h>
+#include <host_utils.h>
+#include <command_line_params.h>
+
+#include <gtest/gtest.h>
+
+void display_test_info()
+{
+  printfQuda("running the following test:\n");
+  printfQuda("prec    S_dimension T_dimension\n");
+  printfQuda("%6s   %3d/%3d/%3d     %3d\n", get_prec_str(prec), xdim, ydim, zdim, tdim);
+  printfQuda("Grid partition info:     X  Y  Z  T\n");
+  printfQuda("                         %d  %d  %d  %d\n", dimPartitioned(0), dimPartitioned(1), dimPartitioned(2),
+             dimPartitioned(3));
+}
+
+using test_t = ::testing::tuple<QudaParity, int>;
+
+/**
+   Fill a field with the counter-based generator and check every
+   element against a reference drawn directly from the global lattice
+   site.  Since the reference only depends on the global coordinate,
+   agreement for any --gridsize implies the noise is independent of
+   the partitioning, and single-parity fields must agree with the
+   matching sites of a full field.
+ */
+class CounterRNGTest : public ::testing::TestWithParam<test_t>
+{
+protected:
+  QudaParity parity; // QUDA_INVALID_PARITY denotes a full field
+  int nSpin;
+
+public:
+  CounterRNGTest() : parity(::testing::get<0>(GetParam())), nSpin(::testing::get<1>(GetParam())) { }
+};
+
+template <typename Float>
+int check_noise(const quda::ColorSpinorField &h, unsigned long long seed, QudaParity parity, int nSpin, int nColor)
+{
+  const int X[4] = {xdim, ydim, zdim, tdim};
+  const int X_global[4] = {xdim * quda::comm_dim(0), ydim * quda::comm_dim(1), zdim * quda::comm_dim(2),
+                           tdim * quda::comm_dim(3)};
+  const int offset[4] = {xdim * quda::comm_coord(0), ydim * quda::comm_coord(1), zdim * quda::comm_coord(2),
+                         tdim * quda::comm_coord(3)};
+  auto v = static_cast<const Float *>(h.V());
+
+  int faults = 0;
+  for (int p = 0; p < h.SiteSubset(); p++) {
+    int site_parity = h.SiteSubset() == QUDA_FULL_SITE_SUBSET ? p : (parity == QUDA_ODD_PARITY ? 1 : 0);
+    for (int x_cb = 0; x_cb < h.VolumeCB(); x_cb++) {
+      int x[4];
+      quda::getCoords(x, x_cb, X, site_parity);
+      uint64_t site = 0;
+      for (int i = 3; i >= 0; i--) site = site * X_global[i] + (x[i] + offset[i]);
+
+      quda::CounterRNG rng(seed, site, 0);
+      auto s = v + (p * h.VolumeCB() + x_cb) * nSpin * nColor * 2;
+      for (int i = 0; i < nSpin * nColor; i++) {
+        Float re = rng.uniform<Float>();
+        Float im = rng.uniform<Float>();
+        if (s[2 * i + 0] != re || s[2 * i + 1] != im) faults++;
+      }
+    }
+  }
+  return faults;
+}
+
+TEST_P(CounterRNGTest, verify)
+{
+  using namespace quda;
+
+  if (!is_enabled_spin(nSpin)) GTEST_SKIP();
+  if (prec < QUDA_SINGLE_PRECISION) GTEST_SKIP();
+
+  ColorSpinorParam param;
+  param.nColor = 3;
+  param.nSpin = nSpin;
+  param.nDim = 4;
+  for (int d = 0; d < 4; d++) param.x[d] = (d == 0 ? xdim : d == 1 ? ydim : d == 2 ? zdim : tdim);
+  param.pc_type = QUDA_4D_PC;
+  param.siteSubset = QUDA_FULL_SITE_SUBSET;
+  if (parity != QUDA_INVALID_PARITY) {
+    param.siteSubset = QUDA_PARITY_SITE_SUBSET;
+    param.x[0] /= 2;
+    param.suggested_parity = parity;
+  }
+  param.siteOrder = QUDA_EVEN_ODD_SITE_ORDER;
+  param.gammaBasis = QUDA_DEGRAND_ROSSI_GAMMA_BASIS;
+  param.setPrecision(prec, prec, true);
+  param.location = QUDA_CUDA_FIELD_LOCATION;
+  param.create = QUDA_NULL_FIELD_CREATE;
+  ColorSpinorField d(param);
+
+  const unsigned long long seed = 1234;
+  spinorNoise(d, seed, QUDA_NOISE_UNIFORM);
+
+  param.location = QUDA_CPU_FIELD_LOCATION;
+  param.setPrecision(prec);
+  param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+  ColorSpinorField h(param);
+  h = d;
+
+  int faults = prec == QUDA_DOUBLE_PRECISION ? check_noise<double>(h, seed, parity, nSpin, param.nColor) :
+                                               check_noise<float>(h, seed, parity, nSpin, param.nColor);
+  comm_allreduce_int(faults);
+  EXPECT_EQ(faults, 0);
+}
+
+using ::testing::Combine;
+using ::testing::Values;
+
+INSTANTIATE_TEST_SUITE_P(CounterRNG, CounterRNGTest,
+                         Combine(Values(QUDA_INVALID_PARITY, QUDA_EVEN_PARITY, QUDA_ODD_PARITY), Values(1, 4)),
+                         [](testing::TestParamInfo<test_t> param) {
+                           auto parity = ::testing::get<0>(param.param);
+                           std::string name = parity == QUDA_INVALID_PARITY ? "full" :
+                             parity == QUDA_EVEN_PARITY                     ? "even" :
+                                                                              "odd";
+                           return name + "_spin" + std::to_string(::testing::get<1>(param.param));
+                         });
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  // Parse command line options
+  auto app = make_app();
+  add_comms_option_group(app);
+  add_testing_option_group(app);
+  try {
+    app->parse(argc, argv);
+  } catch (const CLI::ParseError &e) {
+    return app->exit(e);
+  }
+
+  // Set values for precisions via the command line.
+  setQudaPrecisions();
+
+  // initialize QMP/MPI, QUDA comms grid and RNG (host_utils.cpp)
+  initComms(argc, argv, gridsize_from_cmdline);
+
+  // Initialize the QUDA library
+  initQuda(device_ordinal);
+
+  display_test_info();
+
+  ::testing::TestEventListeners &listeners = ::testing::UnitTest::GetInstance()->listeners();
+  if (quda::comm_rank() != 0) { delete listeners.Release(listeners.default_result_printer()); }
+  int result = RUN_ALL_TESTS();
+
+  // finalize the QUDA library
+  endQuda();
+  finalizeComms();
+
+  return result;
+}
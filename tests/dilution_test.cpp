@@ -65,6 +65,10 @@ TEST_P(DilutionTest, verify)
   param.create = QUDA_NULL_FIELD_CREATE;
   ColorSpinorField src(param);
 
+  // one block per half of the local lattice in the time direction
+  const lat_dim_t block_size = {xdim, ydim, zdim, tdim / 2};
+  const int probe_size = 16;
+
   RNG rng(src, 1234);
 
   for (int i = 0; i < Nsrc; i++) {
@@ -76,25 +80,91 @@ TEST_P(DilutionTest, verify)
     case QUDA_DILUTION_COLOR: size = src.Ncolor(); break;
     case QUDA_DILUTION_SPIN_COLOR: size = src.Nspin() * src.Ncolor(); break;
     case QUDA_DILUTION_SPIN_COLOR_EVEN_ODD: size = src.Nspin() * src.Ncolor() * src.SiteSubset(); break;
+    case QUDA_DILUTION_TIME_SLICE: size = tdim * comm_dim(3); break;
+    case QUDA_DILUTION_BLOCK: size = 2 * comm_size(); break;
+    case QUDA_DILUTION_HADAMARD_PROBING: size = probe_size; break;
     default: errorQuda("Invalid dilution type %d", dilution_type);
     }
+    EXPECT_EQ(dilutionSize(src, dilution_type, block_size, probe_size), static_cast<int>(size));
 
     std::vector<ColorSpinorField> v(size, param);
-    spinorDilute(v, src, dilution_type);
-
-    param.create = QUDA_ZERO_FIELD_CREATE;
-    ColorSpinorField sum(param);
-    blas::axpy(std::vector<double>(v.size(), 1.0), v, sum); // reassemble the vector
-
-    { // check its norm matches the original
+    spinorDilute(v, src, dilution_type, block_size, probe_size);
+
+    if (dilution_type != QUDA_DILUTION_HADAMARD_PROBING) {
+      param.create = QUDA_ZERO_FIELD_CREATE;
+      ColorSpinorField sum(param);
+      blas::axpy(std::vector<double>(v.size(), 1.0), v, sum); // reassemble the vector
+
+      { // check its norm matches the original
+        auto src2 = blas::norm2(src);
+        auto sum2 = blas::norm2(sum);
+        EXPECT_EQ(sum2, src2);
+      }
+
+      { // check for component-by-component matching
+        auto sum2 = blas::xmyNorm(src, sum);
+        EXPECT_EQ(sum2, 0.0);
+      }
+    } else {
+      // the first probing vector is the source and the rest only differ by sign
+      EXPECT_EQ(blas::xmyNorm(src, v[0]), 0.0);
       auto src2 = blas::norm2(src);
-      auto sum2 = blas::norm2(sum);
-      EXPECT_EQ(sum2, src2);
+      for (auto &vi : v) EXPECT_EQ(blas::norm2(vi), src2);
+
+      // probing a unit source gives the signs h_k(x) of each probing vector
+      ColorSpinorParam h_param(param);
+      h_param.location = QUDA_CPU_FIELD_LOCATION;
+      h_param.fieldOrder = QUDA_SPACE_SPIN_COLOR_FIELD_ORDER;
+      h_param.setPrecision(QUDA_DOUBLE_PRECISION);
+      h_param.create = QUDA_ZERO_FIELD_CREATE;
+      ColorSpinorField h_unit(h_param);
+      auto n_real = h_unit.Volume() * h_unit.Nspin() * h_unit.Ncolor() * 2;
+      auto unit_p = static_cast<double *>(h_unit.V());
+      for (auto j = 0lu; j < n_real; j += 2) unit_p[j] = 1.0;
+      ColorSpinorField unit(param);
+      unit = h_unit;
+      std::vector<ColorSpinorField> h(size, param);
+      spinorDilute(h, unit, dilution_type, block_size, probe_size);
+
+      { // the sign-weighted average (1/N) sum_k h_k(x) v_k(x) must reproduce the source
+        ColorSpinorField h_src(h_param);
+        h_src = src;
+        std::vector<ColorSpinorField> h_v(size, h_param);
+        std::vector<ColorSpinorField> h_h(size, h_param);
+        for (auto k = 0u; k < size; k++) {
+          h_v[k] = v[k];
+          h_h[k] = h[k];
+        }
+        double deviation = 0.0;
+        auto src_p = static_cast<const double *>(h_src.V());
+        for (auto j = 0lu; j < n_real; j++) {
+          double sum = 0.0;
+          for (auto k = 0u; k < size; k++) {
+            auto sign = static_cast<const double *>(h_h[k].V())[j & ~1lu];
+            sum += sign * static_cast<const double *>(h_v[k].V())[j];
+          }
+          deviation = std::max(deviation, std::abs(sum / size - src_p[j]));
+        }
+        comm_allreduce_max(deviation);
+        EXPECT_LE(deviation, 1e-12);
+      }
+
+      // the probing vectors are orthogonal when every color appears
+      // equally often, which holds for a full field, while a single
+      // parity only holds the colors of that parity
+      if (site_subset == QUDA_FULL_SITE_SUBSET) {
+        auto n_component = static_cast<double>(unit.Volume() * comm_size() * unit.Nspin() * unit.Ncolor());
+        for (auto j = 0u; j < size; j++)
+          for (auto k = 0u; k < size; k++) EXPECT_EQ(blas::reDotProduct(h[j], h[k]), j == k ? n_component : 0.0);
+      }
     }
 
-    { // check for component-by-component matching
-      auto sum2 = blas::xmyNorm(src, sum);
-      EXPECT_EQ(sum2, 0.0);
+    { // check that generating each member just in time matches the whole set
+      ColorSpinorField vi(param);
+      for (auto i = 0u; i < v.size(); i++) {
+        spinorDilute(vi, src, dilution_type, i, block_size, probe_size);
+        EXPECT_EQ(blas::xmyNorm(v[i], vi), 0.0);
+      }
     }
   }
 }
@@ -105,13 +175,17 @@ using ::testing::Values;
 INSTANTIATE_TEST_SUITE_P(
   WilsonFull, DilutionTest,
   Combine(Values(QUDA_FULL_SITE_SUBSET),
-          Values(QUDA_DILUTION_SPIN, QUDA_DILUTION_COLOR, QUDA_DILUTION_SPIN_COLOR, QUDA_DILUTION_SPIN_COLOR_EVEN_ODD),
+          Values(QUDA_DILUTION_SPIN, QUDA_DILUTION_COLOR, QUDA_DILUTION_SPIN_COLOR, QUDA_DILUTION_SPIN_COLOR_EVEN_ODD,
+                 QUDA_DILUTION_TIME_SLICE, QUDA_DILUTION_BLOCK, QUDA_DILUTION_HADAMARD_PROBING),
           Values(4)),
   [](testing::TestParamInfo<test_t> param) { return get_dilution_type_str(::testing::get<1>(param.param)); });
 
 INSTANTIATE_TEST_SUITE_P(WilsonParity, DilutionTest,
                          Combine(Values(QUDA_PARITY_SITE_SUBSET),
-                                 Values(QUDA_DILUTION_SPIN, QUDA_DILUTION_COLOR, QUDA_DILUTION_SPIN_COLOR), Values(4)),
+                                 Values(QUDA_DILUTION_SPIN, QUDA_DILUTION_COLOR, QUDA_DILUTION_SPIN_COLOR,
+                                        QUDA_DILUTION_TIME_SLICE, QUDA_DILUTION_BLOCK,
+                                        QUDA_DILUTION_HADAMARD_PROBING),
+                                 Values(4)),
                          [](testing::TestParamInfo<test_t> param) {
                            return get_dilution_type_str(::testing::get<1>(param.param));
                          });
@@ -119,13 +193,17 @@ INSTANTIATE_TEST_SUITE_P(WilsonParity, DilutionTest,
 INSTANTIATE_TEST_SUITE_P(
   StaggeredFull, DilutionTest,
   Combine(Values(QUDA_FULL_SITE_SUBSET),
-          Values(QUDA_DILUTION_SPIN, QUDA_DILUTION_COLOR, QUDA_DILUTION_SPIN_COLOR, QUDA_DILUTION_SPIN_COLOR_EVEN_ODD),
+          Values(QUDA_DILUTION_SPIN, QUDA_DILUTION_COLOR, QUDA_DILUTION_SPIN_COLOR, QUDA_DILUTION_SPIN_COLOR_EVEN_ODD,
+                 QUDA_DILUTION_TIME_SLICE, QUDA_DILUTION_BLOCK, QUDA_DILUTION_HADAMARD_PROBING),
           Values(1)),
   [](testing::TestParamInfo<test_t> param) { return get_dilution_type_str(::testing::get<1>(param.param)); });
 
 INSTANTIATE_TEST_SUITE_P(StaggeredParity, DilutionTest,
                          Combine(Values(QUDA_PARITY_SITE_SUBSET),
-                                 Values(QUDA_DILUTION_SPIN, QUDA_DILUTION_COLOR, QUDA_DILUTION_SPIN_COLOR), Values(1)),
+                                 Values(QUDA_DILUTION_SPIN, QUDA_DILUTION_COLOR, QUDA_DILUTION_SPIN_COLOR,
+                                        QUDA_DILUTION_TIME_SLICE, QUDA_DILUTION_BLOCK,
+                                        QUDA_DILUTION_HADAMARD_PROBING),
+                                 Values(1)),
                          [](testing::TestParamInfo<test_t> param) {
                            return get_dilution_type_str(::testing::get<1>(param.param));
                          });
@@ -36,7 +36,8 @@ void display_test_info(QudaEigParam &param)
   printfQuda("\n   Eigensolver parameters\n");
   printfQuda(" - solver mode %s\n", get_eig_type_str(param.eig_type));
   printfQuda(" - spectrum requested %s\n", get_eig_spectrum_str(param.spectrum));
-  if (param.eig_type == QUDA_EIG_BLK_TR_LANCZOS) printfQuda(" - eigenvector block size %d\n", param.block_size);
+  if (param.eig_type == QUDA_EIG_BLK_TR_LANCZOS || param.eig_type == QUDA_EIG_CHFSI)
+    printfQuda(" - eigenvector block size %d\n", param.block_size);
   printfQuda(" - number of eigenvectors requested %d\n", param.n_conv);
   printfQuda(" - size of eigenvector search space %d\n", param.n_ev);
   printfQuda(" - size of Krylov space %d\n", param.n_kr);
@@ -153,6 +154,13 @@ std::vector<double> eigensolve(test_t test_param)
     eig_param.use_poly_acc = QUDA_BOOLEAN_FALSE;
     eig_block_size != 4 ? eig_param.block_size = eig_block_size : eig_param.block_size = 4;
     eig_batched_rotate != 0 ? eig_param.batched_rotate = eig_batched_rotate : eig_param.batched_rotate = 4;
+    // ChFSI is built on the Chebyshev filter, so we let the solver
+    // estimate a_max and adapt a_min from the Ritz values
+    if (eig_param.eig_type == QUDA_EIG_CHFSI) {
+      eig_param.use_poly_acc = QUDA_BOOLEAN_TRUE;
+      eig_param.a_min = 0.0;
+      eig_param.a_max = 0.0;
+    }
   }
 
   logQuda(QUDA_SUMMARIZE, "Action = %s %s, Solver = %s, norm-op = %s, even-odd = %s, with SVD = %s, spectrum = %s\n",
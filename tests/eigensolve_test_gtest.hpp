@@ -26,6 +26,8 @@ bool skip_test(test_t param)
 {
   // dwf-style solves must use a normal solver
   if (is_chiral(dslash_type) && (::testing::get<1>(param) == QUDA_BOOLEAN_FALSE)) return true;
+  // ChFSI only computes the smallest real part of the spectrum
+  if (::testing::get<0>(param) == QUDA_EIG_CHFSI && ::testing::get<4>(param) != QUDA_SPECTRUM_SR_EIG) return true;
   return false;
 }
 
@@ -64,7 +66,7 @@ using ::testing::Combine;
 using ::testing::Values;
 
 // Can solve hermitian systems
-auto hermitian_solvers = Values(QUDA_EIG_TR_LANCZOS, QUDA_EIG_BLK_TR_LANCZOS, QUDA_EIG_IR_ARNOLDI);
+auto hermitian_solvers = Values(QUDA_EIG_TR_LANCZOS, QUDA_EIG_BLK_TR_LANCZOS, QUDA_EIG_IR_ARNOLDI, QUDA_EIG_CHFSI);
 
 // Can solve non-hermitian systems
 auto non_hermitian_solvers = Values(QUDA_EIG_IR_ARNOLDI);
@@ -47,6 +47,21 @@ int gf_reunit_interval = 10;
 double gf_tolerance = 1e-6;
 bool gf_theta_condition = false;
 bool gf_fft_autotune = false;
+bool gf_fft_cg = false;
+int gf_fft_host_steps = 20;
+double gf_fft_cg_time_ratio = 0.0;
+
+// Return the maximum deviation between two QDP ordered host gauge fields
+template <typename Float> double max_deviation(const quda::GaugeField &a, const quda::GaugeField &b)
+{
+  auto a_p = static_cast<Float *const *>(const_cast<void *>(a.Gauge_p()));
+  auto b_p = static_cast<Float *const *>(const_cast<void *>(b.Gauge_p()));
+  double deviation = 0.0;
+  for (int dir = 0; dir < 4; dir++)
+    for (auto i = 0lu; i < V * gauge_site_size; i++)
+      deviation = std::max(deviation, static_cast<double>(std::abs(a_p[dir][i] - b_p[dir][i])));
+  return deviation;
+}
 
 void display_test_info()
 {
@@ -269,9 +284,10 @@ protected:
   {
     if (execute) {
       if (!comm_partitioned()) {
-        printfQuda("Landau gauge fixing with steepest descent method with FFTs\n");
+        printfQuda("%s gauge fixing with %s method with FFTs\n", gf_gauge_dir == 3 ? "Coulomb" : "Landau",
+                   gf_fft_cg ? "conjugate gradient" : "steepest descent");
         gaugeFixingFFT(*U, gf_gauge_dir, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune, gf_tolerance,
-                       gf_theta_condition);
+                       gf_theta_condition, gf_fft_cg);
 
         auto plaq_gf = plaquette(*U);
         printfQuda("Plaq:    %.16e, %.16e, %.16e\n", plaq.x, plaq.y, plaq.z);
@@ -285,6 +301,93 @@ protected:
     }
   }
 
+  /**
+     Apply a fixed number of FFT gauge fixing steps to the device field
+     and to a QDP ordered host copy of it, and return the maximum
+     deviation between the two
+   */
+  double compare_fft_host(int gauge_dir, bool cg)
+  {
+    GaugeFieldParam hParam(*U);
+    hParam.location = QUDA_CPU_FIELD_LOCATION;
+    hParam.order = QUDA_QDP_GAUGE_ORDER;
+    hParam.reconstruct = QUDA_RECONSTRUCT_NO;
+    hParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    hParam.create = QUDA_NULL_FIELD_CREATE;
+    cpuGaugeField host(hParam);
+    cpuGaugeField check(hParam);
+    host.copy(*U);
+
+    // a zero tolerance runs the given number of steps
+    gaugeFixingFFT(*U, gauge_dir, gf_fft_host_steps, gf_verbosity_interval, gf_fft_alpha, false, 0.0,
+                   gf_theta_condition, cg);
+    gaugeFixingFFT(host, gauge_dir, gf_fft_host_steps, gf_verbosity_interval, gf_fft_alpha, false, 0.0,
+                   gf_theta_condition, cg);
+    check.copy(*U);
+
+    double deviation
+      = prec == QUDA_DOUBLE_PRECISION ? max_deviation<double>(host, check) : max_deviation<float>(host, check);
+    printfQuda("Host and device FFT gauge fixing: maximum deviation = %e\n", deviation);
+    return deviation;
+  }
+
+  /**
+     The outcome of a gauge fixing run: the iterations, the
+     functional and theta of the last step, and the wall time
+   */
+  struct fft_fix_result {
+    int iter;
+    double quality[2];
+    double secs;
+  };
+
+  /**
+     Gauge fix a copy of the device field with FFTs, stopping on the
+     theta criterion so that every method is required to reach the
+     same quality, and time it
+   */
+  fft_fix_result fft_fix(int gauge_dir, bool cg)
+  {
+    GaugeFieldParam gParam(*U);
+    gParam.create = QUDA_NULL_FIELD_CREATE;
+    cudaGaugeField fix(gParam);
+    fix.copy(*U);
+
+    fft_fix_result result;
+    host_timer_t timer;
+    timer.start();
+    result.iter = gaugeFixingFFT(fix, gauge_dir, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune,
+                                 gf_tolerance, true, cg, result.quality);
+    qudaDeviceSynchronize();
+    timer.stop();
+    result.secs = timer.last();
+    printfQuda("FFT gauge fixing with %s: %d iterations, functional = %.16e, theta = %e, %g secs\n",
+               cg ? "conjugate gradient" : "steepest descent", result.iter, result.quality[0], result.quality[1],
+               result.secs);
+    return result;
+  }
+
+  /**
+     Gauge fix with steepest descent and with conjugate gradient to
+     the same theta.  The iteration counts are not comparable, since
+     a conjugate gradient iteration does up to two gauge
+     transformations and quality measurements against one for
+     steepest descent, so the cost is compared by wall time, and only
+     when a maximum ratio has been set with --gf-fft-cg-time-ratio.
+   */
+  void compare_fft_cg_sd(int gauge_dir)
+  {
+    auto sd = fft_fix(gauge_dir, false);
+    auto cg = fft_fix(gauge_dir, true);
+    printfQuda("FFT gauge fixing time ratio conjugate gradient / steepest descent = %g\n", cg.secs / sd.secs);
+
+    for (auto &r : {sd, cg}) {
+      EXPECT_LT(r.iter, gf_maxiter);
+      EXPECT_LT(r.quality[1], gf_tolerance);
+    }
+    if (gf_fft_cg_time_ratio > 0.0) EXPECT_LE(cg.secs, gf_fft_cg_time_ratio * sd.secs);
+  }
+
   virtual void save_gauge()
   {
     printfQuda("Saving the gauge field to file %s\n", gauge_outfile.c_str());
@@ -381,6 +484,114 @@ TEST_F(GaugeAlgTest, Coulomb_FFT)
   }
 }
 
+TEST_F(GaugeAlgTest, Landau_FFT_CG)
+{
+  if (execute) {
+    if (!comm_partitioned()) {
+      printfQuda("Landau gauge fixing with conjugate gradient method with FFTs\n");
+      gaugeFixingFFT(*U, 4, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune, gf_tolerance,
+                     gf_theta_condition, true);
+      auto plaq_gf = plaquette(*U);
+      printfQuda("Plaq:    %.16e, %.16e, %.16e\n", plaq.x, plaq.y, plaq.z);
+      printfQuda("Plaq GF: %.16e, %.16e, %.16e\n", plaq_gf.x, plaq_gf.y, plaq_gf.z);
+      ASSERT_TRUE(comparePlaquette(plaq, plaq_gf));
+    }
+  }
+}
+
+TEST_F(GaugeAlgTest, Coulomb_FFT_CG)
+{
+  if (execute) {
+    if (!comm_partitioned()) {
+      printfQuda("Coulomb gauge fixing with conjugate gradient method with FFTs\n");
+      gaugeFixingFFT(*U, 3, gf_maxiter, gf_verbosity_interval, gf_fft_alpha, gf_fft_autotune, gf_tolerance,
+                     gf_theta_condition, true);
+      auto plaq_gf = plaquette(*U);
+      printfQuda("Plaq:    %.16e, %.16e, %.16e\n", plaq.x, plaq.y, plaq.z);
+      printfQuda("Plaq GF: %.16e, %.16e, %.16e\n", plaq_gf.x, plaq_gf.y, plaq_gf.z);
+      ASSERT_TRUE(comparePlaquette(plaq, plaq_gf));
+    }
+  }
+}
+
+TEST_F(GaugeAlgTest, Landau_FFT_Host)
+{
+  if (execute) {
+    if (!comm_partitioned() && prec >= QUDA_SINGLE_PRECISION) {
+      printfQuda("Landau gauge fixing with FFTs on the host and device\n");
+      double tol = prec == QUDA_DOUBLE_PRECISION ? 1e-9 : 1e-3;
+      ASSERT_LE(compare_fft_host(4, false), tol);
+    }
+  }
+}
+
+TEST_F(GaugeAlgTest, Landau_FFT_CG_vs_SD)
+{
+  if (execute) {
+    if (!comm_partitioned()) {
+      printfQuda("Landau gauge fixing with conjugate gradient and steepest descent methods with FFTs\n");
+      compare_fft_cg_sd(4);
+    }
+  }
+}
+
+TEST_F(GaugeAlgTest, Coulomb_FFT_CG_vs_SD)
+{
+  if (execute) {
+    if (!comm_partitioned()) {
+      printfQuda("Coulomb gauge fixing with conjugate gradient and steepest descent methods with FFTs\n");
+      compare_fft_cg_sd(3);
+    }
+  }
+}
+
+TEST_F(GaugeAlgTest, Landau_FFT_Host_CG)
+{
+  if (execute) {
+    if (!comm_partitioned() && prec >= QUDA_SINGLE_PRECISION) {
+      printfQuda("Landau gauge fixing with conjugate gradient method with FFTs on the host and device\n");
+      double tol = prec == QUDA_DOUBLE_PRECISION ? 1e-9 : 1e-3;
+      ASSERT_LE(compare_fft_host(4, true), tol);
+    }
+  }
+}
+
+TEST_F(GaugeAlgTest, Digest)
+{
+  if (execute) {
+    printfQuda("Gauge field digest\n");
+    // unextended copy of the field
+    GaugeFieldParam gParam(param);
+    gParam.location = QUDA_CUDA_FIELD_LOCATION;
+    gParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+    gParam.create = QUDA_NULL_FIELD_CREATE;
+    gParam.reconstruct = QUDA_RECONSTRUCT_NO;
+    gParam.setPrecision(QUDA_DOUBLE_PRECISION, true);
+    cudaGaugeField device(gParam);
+    copyExtendedGauge(device, *U, QUDA_CUDA_FIELD_LOCATION);
+
+    // host copies in different orders
+    GaugeFieldParam hParam(device);
+    hParam.location = QUDA_CPU_FIELD_LOCATION;
+    hParam.create = QUDA_NULL_FIELD_CREATE;
+    hParam.order = QUDA_QDP_GAUGE_ORDER;
+    cpuGaugeField qdp(hParam);
+    hParam.order = QUDA_MILC_GAUGE_ORDER;
+    cpuGaugeField milc(hParam);
+    qdp.copy(device);
+    milc.copy(device);
+
+    auto digest = device.digest();
+    printfQuda("Digest = %s\n", digest.c_str());
+    ASSERT_EQ(digest, qdp.digest());
+    ASSERT_EQ(digest, milc.digest());
+
+    // changing a single element must change the digest
+    if (comm_rank() == 0) static_cast<double *>(milc.Gauge_p())[0] += 1.0;
+    ASSERT_NE(digest, milc.digest());
+  }
+}
+
 void add_gaugefix_option_group(std::shared_ptr<QUDAApp> quda_app)
 {
   // Option group for gauge fixing related options
@@ -403,6 +614,14 @@ void add_gaugefix_option_group(std::shared_ptr<QUDAApp> quda_app)
   opgroup->add_option(
     "--gf-fft-autotune", gf_fft_autotune,
     "In the FFT method, automatically adjust the alpha parameter if the quality begins to diverge (default false)");
+  opgroup->add_option("--gf-fft-cg", gf_fft_cg,
+                      "In the FFT method, use conjugate gradient with an adaptive alpha instead of steepest descent "
+                      "(default false)");
+  opgroup->add_option("--gf-fft-host-steps", gf_fft_host_steps,
+                      "The number of FFT gauge fixing steps compared between the host and device (default 20)");
+  opgroup->add_option("--gf-fft-cg-time-ratio", gf_fft_cg_time_ratio,
+                      "The maximum ratio of the conjugate gradient to the steepest descent FFT gauge fixing time "
+                      "to the same theta, where 0 only reports the ratio (default 0)");
 }
 
 int main(int argc, char **argv)
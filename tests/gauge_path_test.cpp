@@ -354,6 +354,216 @@ void gauge_loop_test()
   delete[] trace_path_p;
 }
 
+// Path sets used to compare the path trie with the per-path
+// evaluation, given for the x direction and relabeled cyclically for
+// the others.  The "many" set holds the x-direction staples above with
+// every fourth coefficient zeroed; as loops (prefixed by a forward x
+// link) they span several loop trace batches.  The "deep" set branches
+// off a twice traversed plaquette after each of its first seven steps,
+// which needs more saved products than max_path_stack() = 6, so it is
+// evaluated path by path.
+struct trie_paths {
+  std::vector<std::vector<int>> path;
+  std::vector<double> coeff;
+};
+
+static trie_paths many_paths(bool loop)
+{
+  trie_paths p;
+  for (unsigned int i = 0; i < sizeof(path_dir_x) / sizeof(path_dir_x[0]); i++) {
+    std::vector<int> path;
+    if (loop) path.push_back(0);
+    path.insert(path.end(), path_dir_x[i], path_dir_x[i] + length[i]);
+    p.path.push_back(path);
+    p.coeff.push_back(i % 4 == 3 ? 0.0 : loop_coeff_f[i]);
+  }
+  return p;
+}
+
+static trie_paths deep_paths()
+{
+  const std::vector<int> base = {1, 0, 6, 7, 1, 0, 6, 7};
+  trie_paths p;
+  p.path.push_back(base);
+  p.coeff.push_back(1.0);
+  for (unsigned int k = 1; k < base.size(); k++) {
+    std::vector<int> path(base.begin(), base.begin() + k);
+    path.push_back(2);
+    p.path.push_back(path);
+    p.coeff.push_back(1.0 + 0.1 * k);
+  }
+  // zero coefficient paths are dropped, and must not change the result
+  p.path.push_back(base);
+  p.path.back().push_back(3);
+  p.coeff.push_back(0.0);
+  return p;
+}
+
+// relabel a step of an x-direction path for direction mu
+static int relabel(int step, int mu) { return step < 4 ? (step + mu) % 4 : 7 - (7 - step + mu) % 4; }
+
+// Compute the force (or path) with the path trie enabled and disabled,
+// and check both against the host reference
+static bool path_trie_force_test(const trie_paths &tp, bool compute_force)
+{
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  setGaugeParam(gauge_param);
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  setDims(gauge_param.X);
+
+  int num_paths = tp.path.size();
+  int max_length = 0;
+  std::vector<int> path_length(num_paths);
+  std::vector<float> coeff_f(num_paths);
+  std::vector<double> coeff_d(num_paths);
+  for (int i = 0; i < num_paths; i++) {
+    path_length[i] = tp.path[i].size();
+    max_length = std::max(max_length, path_length[i]);
+    coeff_f[i] = tp.coeff[i];
+    coeff_d[i] = coeff_f[i];
+  }
+  void *loop_coeff = gauge_param.cpu_prec == QUDA_SINGLE_PRECISION ? (void *)coeff_f.data() : (void *)coeff_d.data();
+
+  std::vector<std::vector<int>> path[4];
+  std::vector<int *> path_p[4];
+  int **input_path_buf[4];
+  for (int dir = 0; dir < 4; dir++) {
+    path[dir] = tp.path;
+    for (auto &p : path[dir]) {
+      for (auto &step : p) step = relabel(step, dir);
+      path_p[dir].push_back(p.data());
+    }
+    input_path_buf[dir] = path_p[dir].data();
+  }
+
+  quda::GaugeFieldParam param(gauge_param);
+  param.create = QUDA_NULL_FIELD_CREATE;
+  param.order = QUDA_QDP_GAUGE_ORDER;
+  param.location = QUDA_CPU_FIELD_LOCATION;
+  quda::cpuGaugeField U_qdp(param);
+  createSiteLinkCPU((void **)U_qdp.Gauge_p(), gauge_param.cpu_prec, 0);
+
+  if (compute_force) {
+    param.reconstruct = QUDA_RECONSTRUCT_10;
+    param.link_type = QUDA_ASQTAD_MOM_LINKS;
+  } else {
+    param.reconstruct = QUDA_RECONSTRUCT_NO;
+  }
+  param.create = QUDA_ZERO_FIELD_CREATE;
+  quda::cpuGaugeField Mom_qdp(param);
+  param.order = QUDA_MILC_GAUGE_ORDER;
+  quda::cpuGaugeField Mom_trie(param);
+  quda::cpuGaugeField Mom_path(param);
+  quda::cpuGaugeField Mom_ref(param);
+
+  double eb3 = 0.3;
+  auto compute = [&](quda::cpuGaugeField &out, bool trie) {
+    quda::setPathTrie(trie);
+    Mom_qdp.zero();
+    if (compute_force)
+      computeGaugeForceQuda(Mom_qdp.Gauge_p(), U_qdp.Gauge_p(), input_path_buf, path_length.data(), coeff_d.data(),
+                            num_paths, max_length, eb3, &gauge_param);
+    else
+      computeGaugePathQuda(Mom_qdp.Gauge_p(), U_qdp.Gauge_p(), input_path_buf, path_length.data(), coeff_d.data(),
+                           num_paths, max_length, eb3, &gauge_param);
+    out.copy(Mom_qdp);
+  };
+  compute(Mom_trie, true);
+  compute(Mom_path, false);
+  quda::setPathTrie(true);
+
+  gauge_force_reference(Mom_ref.Gauge_p(), eb3, (void **)U_qdp.Gauge_p(), gauge_param.cpu_prec, input_path_buf,
+                        path_length.data(), loop_coeff, num_paths, compute_force);
+
+  int len = 4 * V * (compute_force ? mom_site_size : gauge_site_size);
+  auto tol = getTolerance(cuda_prec);
+  int trie_check = compare_floats(Mom_trie.Gauge_p(), Mom_ref.Gauge_p(), len, tol, gauge_param.cpu_prec);
+  int path_check = compare_floats(Mom_path.Gauge_p(), Mom_ref.Gauge_p(), len, tol, gauge_param.cpu_prec);
+  int trie_path_check = compare_floats(Mom_trie.Gauge_p(), Mom_path.Gauge_p(), len, tol, gauge_param.cpu_prec);
+  return trie_check == 1 && path_check == 1 && trie_path_check == 1;
+}
+
+// Compute the loop traces with the path trie enabled and disabled, and
+// check both against the host reference
+static bool path_trie_loop_test(trie_paths tp)
+{
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  setWilsonGaugeParam(gauge_param);
+  gauge_param.gauge_order = QUDA_QDP_GAUGE_ORDER;
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  setDims(gauge_param.X);
+
+  int num_paths = tp.path.size();
+  int max_length = 0;
+  std::vector<int> path_length(num_paths);
+  std::vector<int *> path_p(num_paths);
+  for (int i = 0; i < num_paths; i++) {
+    path_length[i] = tp.path[i].size();
+    max_length = std::max(max_length, path_length[i]);
+    path_p[i] = tp.path[i].data();
+  }
+
+  quda::GaugeFieldParam param(gauge_param);
+  param.create = QUDA_NULL_FIELD_CREATE;
+  param.order = QUDA_QDP_GAUGE_ORDER;
+  param.location = QUDA_CPU_FIELD_LOCATION;
+  quda::cpuGaugeField U_qdp(param);
+  createSiteLinkCPU((void **)U_qdp.Gauge_p(), gauge_param.cpu_prec, 0);
+  loadGaugeQuda(U_qdp.Gauge_p(), &gauge_param);
+
+  using double_complex = double _Complex;
+  std::vector<double_complex> traces_trie(num_paths);
+  std::vector<double_complex> traces_path(num_paths);
+  double scale_factor = 2.0;
+
+  QudaGaugeObservableParam obsParam = newQudaGaugeObservableParam();
+  obsParam.compute_gauge_loop_trace = QUDA_BOOLEAN_TRUE;
+  obsParam.input_path_buff = path_p.data();
+  obsParam.path_length = path_length.data();
+  obsParam.loop_coeff = tp.coeff.data();
+  obsParam.num_paths = num_paths;
+  obsParam.max_length = max_length;
+  obsParam.factor = scale_factor;
+
+  quda::setPathTrie(true);
+  obsParam.traces = traces_trie.data();
+  gaugeObservablesQuda(&obsParam);
+  quda::setPathTrie(false);
+  obsParam.traces = traces_path.data();
+  gaugeObservablesQuda(&obsParam);
+  quda::setPathTrie(true);
+
+  std::vector<quda::Complex> traces_ref(num_paths);
+  gauge_loop_trace_reference((void **)U_qdp.Gauge_p(), gauge_param.cpu_prec, traces_ref, scale_factor, path_p.data(),
+                             path_length.data(), tp.coeff.data(), num_paths);
+  freeGaugeQuda();
+
+  bool zero_check = true;
+  double trie_deviation = 0.0;
+  double path_deviation = 0.0;
+  double trie_path_deviation = 0.0;
+  for (int i = 0; i < num_paths; i++) {
+    auto t_ptr = reinterpret_cast<double *>(&traces_trie[i]);
+    auto p_ptr = reinterpret_cast<double *>(&traces_path[i]);
+    std::complex<double> trie(t_ptr[0], t_ptr[1]);
+    std::complex<double> path(p_ptr[0], p_ptr[1]);
+    if (tp.coeff[i] == 0.0) {
+      zero_check = zero_check && trie == 0.0 && path == 0.0;
+      continue;
+    }
+    auto norm = std::abs(traces_ref[i]);
+    trie_deviation += std::abs(trie - traces_ref[i]) / norm;
+    path_deviation += std::abs(path - traces_ref[i]) / norm;
+    trie_path_deviation += std::abs(trie - path) / norm;
+    logQuda(QUDA_VERBOSE, "Loop %d trie trace %e + I %e per-path trace %e + I %e Reference trace %e + I %e\n", i,
+            trie.real(), trie.imag(), path.real(), path.imag(), traces_ref[i].real(), traces_ref[i].imag());
+  }
+
+  auto tol = getTolerance(cuda_prec);
+  return zero_check && trie_deviation <= tol && path_deviation <= tol && trie_path_deviation <= tol;
+}
+
 TEST(force, verify) { ASSERT_EQ(force_check, 1) << "CPU and QUDA force implementations do not agree"; }
 
 TEST(action, verify)
@@ -374,6 +584,36 @@ TEST(plaquette, verify)
     << "Plaquette from QUDA loop trace and QUDA dedicated plaquette function do not agree";
 }
 
+TEST(force, path_trie)
+{
+  ASSERT_TRUE(path_trie_force_test(many_paths(false), true)) << "Trie and per-path force implementations do not agree";
+}
+
+TEST(force, path_trie_deep)
+{
+  ASSERT_TRUE(path_trie_force_test(deep_paths(), true)) << "Deep path force implementations do not agree";
+}
+
+TEST(path, path_trie)
+{
+  ASSERT_TRUE(path_trie_force_test(many_paths(false), false)) << "Trie and per-path path implementations do not agree";
+}
+
+TEST(path, path_trie_deep)
+{
+  ASSERT_TRUE(path_trie_force_test(deep_paths(), false)) << "Deep path implementations do not agree";
+}
+
+TEST(loop_traces, path_trie)
+{
+  ASSERT_TRUE(path_trie_loop_test(many_paths(true))) << "Trie and per-path loop trace implementations do not agree";
+}
+
+TEST(loop_traces, path_trie_deep)
+{
+  ASSERT_TRUE(path_trie_loop_test(deep_paths())) << "Deep loop trace implementations do not agree";
+}
+
 static void display_test_info()
 {
   printfQuda("running the following test:\n");
@@ -14,6 +14,7 @@
 #include <pgauge_monte.h>
 #include <random_quda.h>
 #include <unitarization_links.h>
+#include <timer.h>
 
 #include <qio_field.h>
 
@@ -39,6 +40,17 @@ void setReunitarizationConsts()
   setUnitarizeLinksConstants(unitarize_eps, max_error, reunit_allow_svd, reunit_svd_only, svd_rel_error, svd_abs_error);
 }
 
+// Return the maximum deviation between two QDP ordered host gauge fields
+template <typename Float> double max_deviation(const quda::GaugeField &a, const quda::GaugeField &b)
+{
+  auto a_p = static_cast<Float *const *>(const_cast<void *>(a.Gauge_p()));
+  auto b_p = static_cast<Float *const *>(const_cast<void *>(b.Gauge_p()));
+  double deviation = 0.0;
+  for (int dir = 0; dir < 4; dir++)
+    for (auto i = 0lu; i < V * gauge_site_size; i++) deviation = MAX(deviation, DABS(a_p[dir][i] - b_p[dir][i]));
+  return deviation;
+}
+
 void display_test_info()
 {
   printfQuda("running the following test:\n");
@@ -136,10 +148,13 @@ int main(int argc, char **argv)
     int novrsteps = heatbath_num_overrelax_per_step;
     bool coldstart = heatbath_coldstart;
     double beta_value = heatbath_beta_value;
+    int nhits = heatbath_num_hits;
+    bool overlap = heatbath_overlap;
 
     printfQuda("Starting heatbath for beta = %f from a %s start\n", beta_value,
                latfile.size() > 0 ? "loaded" : (coldstart ? "cold" : "hot"));
     printfQuda("  %d Heatbath hits and %d overrelaxation hits per step\n", nhbsteps, novrsteps);
+    printfQuda("  %d Updates per link per hit, %s exchange\n", nhits, overlap ? "overlapped" : "blocking");
     printfQuda("  %d Warmup steps\n", nwarm);
     printfQuda("  %d Measurement steps\n", nsteps);
 
@@ -175,13 +190,78 @@ int main(int argc, char **argv)
     // Do a warmup if requested
     if (nwarm > 0) {
       for (int step = 1; step <= nwarm; ++step) {
-        Monte(*gaugeEx, *randstates, beta_value, nhbsteps, novrsteps);
+        Monte(*gaugeEx, *randstates, beta_value, nhbsteps, novrsteps, nhits, overlap);
 
         quda::unitarizeLinks(*gaugeEx, num_failures_d);
         if (*num_failures_h > 0) errorQuda("Error in the unitarization\n");
       }
     }
 
+    // Verify one device step against the host path, both using the counter-based generator.  The host path
+    // is unpartitioned only, so on a partitioned lattice instead verify the overlapped halo exchange against
+    // the blocking one, which must agree bit for bit.
+    if (heatbath_verify && comm_partitioned()) {
+      const unsigned long long seed = 1234;
+      cudaGaugeField blocking(gParamEx);
+      cudaGaugeField overlapped(gParamEx);
+      blocking.copy(*gaugeEx);
+      overlapped.copy(*gaugeEx);
+
+      Monte(blocking, seed, 0, beta_value, nhbsteps, novrsteps, nhits, false);
+      Monte(overlapped, seed, 0, beta_value, nhbsteps, novrsteps, nhits, true);
+
+      uint64_t blocking_sum = blocking.checksum();
+      uint64_t overlapped_sum = overlapped.checksum();
+      printfQuda("Overlap verification: blocking checksum = %016lx, overlapped checksum = %016lx\n", blocking_sum,
+                 overlapped_sum);
+      if (blocking_sum != overlapped_sum) errorQuda("Overlapped and blocking exchange updates differ");
+    } else if (heatbath_verify) {
+      if (prec < QUDA_SINGLE_PRECISION) {
+        warningQuda("Host verification requires single or double precision");
+      } else {
+        const unsigned long long seed = 1234;
+        cudaGaugeField device(gParamEx);
+        device.copy(*gaugeEx);
+
+        GaugeFieldParam hParam(gParamEx);
+        hParam.location = QUDA_CPU_FIELD_LOCATION;
+        hParam.order = QUDA_QDP_GAUGE_ORDER;
+        hParam.reconstruct = QUDA_RECONSTRUCT_NO;
+        hParam.ghostExchange = QUDA_GHOST_EXCHANGE_NO;
+        hParam.create = QUDA_NULL_FIELD_CREATE;
+        cpuGaugeField host(hParam);
+        cpuGaugeField check(hParam);
+        host.copy(device);
+
+        Monte(device, seed, 0, beta_value, 1, 1, nhits, overlap);
+        Monte(host, seed, 0, beta_value, 1, 1, nhits, overlap);
+        check.copy(device);
+
+        double deviation = prec == QUDA_DOUBLE_PRECISION ? max_deviation<double>(host, check) :
+                                                           max_deviation<float>(host, check);
+        double tol = prec == QUDA_DOUBLE_PRECISION ? 1e-10 : 1e-4;
+        printfQuda("Host verification: maximum deviation = %e (tolerance %e)\n", deviation, tol);
+        if (deviation > tol) errorQuda("Host and device updates differ");
+      }
+    }
+
+    // Time the updates alone if requested
+    if (heatbath_benchmark > 0) {
+      host_timer_t timer;
+      timer.start();
+      for (int step = 0; step < heatbath_benchmark; step++)
+        Monte(*gaugeEx, *randstates, beta_value, nhbsteps, novrsteps, nhits, overlap);
+      qudaDeviceSynchronize();
+      timer.stop();
+
+      double updates = 4.0 * V * comm_size() * (nhbsteps + novrsteps) * nhits * heatbath_benchmark;
+      printfQuda("Benchmark: %d steps in %g secs, %g secs per step, %g link updates per second\n", heatbath_benchmark,
+                 timer.last(), timer.last() / heatbath_benchmark, updates / timer.last());
+
+      quda::unitarizeLinks(*gaugeEx, num_failures_d);
+      if (*num_failures_h > 0) errorQuda("Error in the unitarization\n");
+    }
+
     // copy into regular field
     copyExtendedGauge(*gauge, *gaugeEx, QUDA_CUDA_FIELD_LOCATION);
 
@@ -196,7 +276,7 @@ int main(int argc, char **argv)
     freeGaugeQuda();
 
     for (int step = 1; step <= nsteps; ++step) {
-      Monte(*gaugeEx, *randstates, beta_value, nhbsteps, novrsteps);
+      Monte(*gaugeEx, *randstates, beta_value, nhbsteps, novrsteps, nhits, overlap);
 
       // Reunitarize gauge links...
       quda::unitarizeLinks(*gaugeEx, num_failures_d);
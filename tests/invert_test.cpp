@@ -7,6 +7,7 @@
 // QUDA headers
 #include <quda.h>
 #include <color_spinor_field.h> // convenient quark field container
+#include <blas_quda.h>
 
 // External headers
 #include <misc.h>
@@ -266,11 +267,17 @@ std::vector<double> solve(test_t param)
     out[i] = quda::ColorSpinorField(cs_param);
   }
 
-  if (!use_split_grid) {
+  // the block solver solves all the sources together through the multi-source interface
+  bool use_multi_src = use_split_grid || (inv_param.inv_type == QUDA_BLOCK_CG_INVERTER && multishift == 1);
+
+  if (!use_multi_src) {
 
     for (int i = 0; i < Nsrc; i++) {
-      // If deflating, preserve the deflation space between solves
-      if (inv_deflate) eig_param.preserve_deflation = i < Nsrc - 1 ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
+      // If deflating, preserve the deflation space between solves, and
+      // after the last solve if we are to benchmark the deflation
+      if (inv_deflate)
+        eig_param.preserve_deflation
+          = (i < Nsrc - 1 || eig_deflation_benchmark > 0) ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
       // Perform QUDA inversions
       if (multishift > 1) {
         invertMultiShiftQuda(_hp_multi_x[i].data(), in[i].V(), &inv_param);
@@ -284,6 +291,13 @@ std::vector<double> solve(test_t param)
       printfQuda("Done: %i iter / %g secs = %g Gflops\n", inv_param.iter, inv_param.secs,
                  inv_param.gflops / inv_param.secs);
     }
+
+    if (inv_deflate && eig_deflation_benchmark > 0) {
+      // release the deflation space once benchmarked
+      eig_param.preserve_deflation = QUDA_BOOLEAN_FALSE;
+      double gbs = deflationBenchmarkQuda(&inv_param, Nsrc, eig_deflation_benchmark);
+      printfQuda("Deflation benchmark: %d sources, %d iterations = %g GB/s\n", Nsrc, eig_deflation_benchmark, gbs);
+    }
   } else {
 
     inv_param.num_src = Nsrc;
@@ -295,7 +309,7 @@ std::vector<double> solve(test_t param)
       _hp_x[i] = out[i].V();
       _hp_b[i] = in[i].V();
     }
-    // Run split grid
+    // Run split grid, or the block solver
     if (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH
         || dslash_type == QUDA_CLOVER_HASENBUSCH_TWIST_DSLASH) {
       invertMultiSrcCloverQuda(_hp_x.data(), _hp_b.data(), &inv_param, gauge.data(), &gauge_param, clover.data(),
@@ -320,7 +334,7 @@ std::vector<double> solve(test_t param)
   if (inv_multigrid) destroyMultigridQuda(mg_preconditioner);
 
   // Compute performance statistics
-  if (Nsrc > 1 && !use_split_grid) performanceStats(time, gflops, iter);
+  if (Nsrc > 1 && !use_multi_src) performanceStats(time, gflops, iter);
 
   std::vector<double> res(Nsrc);
   // Perform host side verification of inversion if requested
@@ -333,6 +347,100 @@ std::vector<double> solve(test_t param)
   return res;
 }
 
+/**
+   Solve for the members of the dilution set of a single source in two
+   ways: streamed through invertMultiSrcQuda, which generates the
+   diluted sources on the device a batch at a time, and by
+   materializing each diluted source and solving it with invertQuda.
+   Returns the residual of each streamed solution against its
+   materialized source, followed by the relative deviation of each
+   streamed solution from the materialized one.
+ */
+std::vector<double> solve_diluted(QudaDilutionType type)
+{
+  inv_param.inv_type = QUDA_CG_INVERTER;
+  inv_param.solution_type = QUDA_MATPCDAG_MATPC_SOLUTION;
+  inv_param.solve_type = QUDA_NORMOP_PC_SOLVE;
+  inv_param.cuda_prec_sloppy = inv_param.cuda_prec;
+  inv_param.clover_cuda_prec_sloppy = inv_param.clover_cuda_prec;
+  inv_param.solution_accumulator_pipeline = 1;
+  inv_param.schwarz_type = QUDA_INVALID_SCHWARZ;
+  inv_param.num_offset = 0;
+  inv_param.use_init_guess = QUDA_USE_INIT_GUESS_NO;
+  for (int i = 0; i < 4; i++) inv_param.split_grid[i] = 1;
+  multishift = 1;
+
+  quda::ColorSpinorParam cs_param;
+  constructWilsonTestSpinorParam(&cs_param, &inv_param, &gauge_param);
+  quda::ColorSpinorField in(cs_param);
+  quda::ColorSpinorField check(cs_param);
+  quda::RNG rng(in, 1234);
+  spinorNoise(in, rng, QUDA_NOISE_GAUSS);
+
+  quda::ColorSpinorParam d_param(cs_param);
+  d_param.location = QUDA_CUDA_FIELD_LOCATION;
+  d_param.create = QUDA_NULL_FIELD_CREATE;
+  d_param.setPrecision(inv_param.cuda_prec, inv_param.cuda_prec, true);
+  quda::ColorSpinorField d_in(d_param);
+  d_in = in;
+
+  // one block per half of the local lattice in the time direction
+  const quda::lat_dim_t block = {xdim, ydim, zdim, tdim / 2};
+  const int probe_size = 16;
+  const int n_src = quda::dilutionSize(d_in, type, block, probe_size);
+
+  auto invert = [&](void **x, void **b) {
+    if (dslash_type == QUDA_CLOVER_WILSON_DSLASH || dslash_type == QUDA_TWISTED_CLOVER_DSLASH
+        || dslash_type == QUDA_CLOVER_HASENBUSCH_TWIST_DSLASH) {
+      invertMultiSrcCloverQuda(x, b, &inv_param, gauge.data(), &gauge_param, clover.data(), clover_inv.data());
+    } else {
+      invertMultiSrcQuda(x, b, &inv_param, gauge.data(), &gauge_param);
+    }
+  };
+
+  // materialize each diluted source and solve it
+  std::vector<quda::ColorSpinorField> b(n_src, cs_param);
+  std::vector<quda::ColorSpinorField> ref(n_src, cs_param);
+  {
+    inv_param.dilution_type = QUDA_DILUTION_INVALID;
+    quda::ColorSpinorField d_b(d_param);
+    for (int i = 0; i < n_src; i++) {
+      quda::spinorDilute(d_b, d_in, type, i, block, probe_size);
+      b[i] = d_b;
+      invertQuda(ref[i].V(), b[i].V(), &inv_param);
+    }
+  }
+
+  // stream the dilution set, in batches that do not divide the set size
+  std::vector<quda::ColorSpinorField> out(n_src, cs_param);
+  {
+    inv_param.dilution_type = type;
+    for (int d = 0; d < 4; d++) inv_param.dilution_block_size[d] = block[d];
+    inv_param.dilution_probe_size = probe_size;
+    inv_param.dilution_batch_size = 3;
+    inv_param.num_src = n_src;
+    inv_param.num_src_per_sub_partition = n_src;
+    std::vector<void *> _hp_x(n_src);
+    std::vector<void *> _hp_b(n_src, in.V());
+    for (int i = 0; i < n_src; i++) _hp_x[i] = out[i].V();
+    invert(_hp_x.data(), _hp_b.data());
+    inv_param.dilution_type = QUDA_DILUTION_INVALID;
+  }
+
+  std::vector<double> res(2 * n_src);
+  quda::ColorSpinorField d_x(d_param);
+  quda::ColorSpinorField d_ref(d_param);
+  for (int i = 0; i < n_src; i++) {
+    res[i] = verifyInversion(out[i].V(), b[i].V(), check.V(), gauge_param, inv_param, gauge.data(), clover.data(),
+                             clover_inv.data());
+    d_x = out[i];
+    d_ref = ref[i];
+    res[n_src + i] = sqrt(quda::blas::xmyNorm(d_ref, d_x) / quda::blas::norm2(d_ref));
+    printfQuda("Diluted source %d: streamed vs materialized solution deviation = %e\n", i, res[n_src + i]);
+  }
+  return res;
+}
+
 int main(int argc, char **argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
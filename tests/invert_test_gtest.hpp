@@ -128,6 +128,144 @@ TEST_P(InvertTest, verify)
   for (auto rsd : solve(GetParam())) EXPECT_LE(rsd, tol);
 }
 
+class InvertDilutionTest : public ::testing::TestWithParam<QudaDilutionType>
+{
+};
+
+std::vector<double> solve_diluted(QudaDilutionType type);
+
+TEST_P(InvertDilutionTest, verify)
+{
+  if (inv_multigrid || inv_deflate) GTEST_SKIP();
+  if (grid_partition[0] * grid_partition[1] * grid_partition[2] * grid_partition[3] > 1) GTEST_SKIP();
+  // dilution is only defined for 4-d fields
+  if (is_chiral(dslash_type) || inv_param.twist_flavor == QUDA_TWIST_NONDEG_DOUBLET) GTEST_SKIP();
+  auto res = solve_diluted(GetParam());
+  auto n_src = res.size() / 2;
+  // each streamed solution must solve the materialized diluted source
+  for (auto i = 0u; i < n_src; i++) EXPECT_LE(res[i], inv_param.tol);
+  // and agree with the materialized solution to within the conditioning of the solve
+  for (auto i = n_src; i < res.size(); i++) EXPECT_LE(res[i], 1e3 * inv_param.tol);
+}
+
+class InvertMultiShiftRefineTest : public ::testing::TestWithParam<QudaPrecision>
+{
+};
+
+TEST_P(InvertMultiShiftRefineTest, verify)
+{
+  auto prec_sloppy = GetParam();
+  if (prec_sloppy >= prec || !(QUDA_PRECISION & prec_sloppy)) GTEST_SKIP(); // no refinement to test
+  if (inv_multigrid || inv_deflate || is_chiral(dslash_type)) GTEST_SKIP();
+  if (grid_partition[0] * grid_partition[1] * grid_partition[2] * grid_partition[3] > 1) GTEST_SKIP();
+
+  test_t param {QUDA_CG_INVERTER,
+                QUDA_MATPCDAG_MATPC_SOLUTION,
+                QUDA_NORMOP_PC_SOLVE,
+                prec_sloppy,
+                10,
+                1,
+                schwarz_t {QUDA_INVALID_SCHWARZ, QUDA_INVALID_INVERTER, QUDA_INVALID_PRECISION}};
+
+  // refine the shifts sequentially, and then in batches with BatchedShiftCG
+  auto refine_batch = inv_param.multishift_refine_batch;
+  inv_param.multishift_refine_batch = 1;
+  auto res_ref = solve(param);
+  inv_param.multishift_refine_batch = 4;
+  auto res = solve(param);
+  inv_param.multishift_refine_batch = refine_batch;
+
+  for (auto rsd : res_ref) EXPECT_LE(rsd, inv_param.tol);
+  for (auto rsd : res) EXPECT_LE(rsd, inv_param.tol);
+}
+
+TEST(InvertRecycleTest, gcrodr)
+{
+  if (inv_multigrid || inv_deflate || is_chiral(dslash_type)) GTEST_SKIP();
+  if (grid_partition[0] * grid_partition[1] * grid_partition[2] * grid_partition[3] > 1) GTEST_SKIP();
+  if (inv_param.gcrNkrylov < 2) GTEST_SKIP(); // the recycle space must be smaller than the Krylov space
+
+  test_t param {QUDA_GCRODR_INVERTER,
+                QUDA_MATPC_SOLUTION,
+                QUDA_DIRECT_PC_SOLVE,
+                prec_sloppy,
+                1,
+                1,
+                schwarz_t {QUDA_INVALID_SCHWARZ, QUDA_INVALID_INVERTER, QUDA_INVALID_PRECISION}};
+
+  auto n_ev = inv_param.n_ev;
+  auto preserve_recycle = inv_param.preserve_recycle;
+  auto n_src = Nsrc;
+  inv_param.n_ev = std::min(gcrodr_n_recycle, inv_param.gcrNkrylov / 2);
+
+  // solve a sequence of right-hand sides, each adopting the recycle space preserved by the previous one
+  inv_param.preserve_recycle = QUDA_BOOLEAN_TRUE;
+  Nsrc = 2;
+  auto res = solve(param);
+  EXPECT_NE(inv_param.recycle_space, nullptr);
+
+  // a final solve adopts the recycle space and releases it
+  inv_param.preserve_recycle = QUDA_BOOLEAN_FALSE;
+  Nsrc = 1;
+  auto res_last = solve(param);
+  EXPECT_EQ(inv_param.recycle_space, nullptr);
+
+  inv_param.n_ev = n_ev;
+  inv_param.preserve_recycle = preserve_recycle;
+  Nsrc = n_src;
+
+  for (auto rsd : res) EXPECT_LE(rsd, inv_param.tol);
+  for (auto rsd : res_last) EXPECT_LE(rsd, inv_param.tol);
+}
+
+// preconditioned CG solve used to test deflation
+test_t deflated_cg_test()
+{
+  return test_t {QUDA_CG_INVERTER,
+                 QUDA_MATPCDAG_MATPC_SOLUTION,
+                 QUDA_NORMOP_PC_SOLVE,
+                 prec_sloppy,
+                 1,
+                 1,
+                 schwarz_t {QUDA_INVALID_SCHWARZ, QUDA_INVALID_INVERTER, QUDA_INVALID_PRECISION}};
+}
+
+TEST(InvertDeflationTest, compressed_recompute_evals)
+{
+  if (!inv_deflate || eig_compress_n_basis == 0) GTEST_SKIP();
+  // a compressed deflation space cannot be preserved between sources
+  if (Nsrc > 1) GTEST_SKIP();
+  // recompute the eigenvalues once the (compressed) space is computed
+  auto preserve_evals = eig_param.preserve_evals;
+  eig_param.preserve_evals = QUDA_BOOLEAN_FALSE;
+  auto res = solve(deflated_cg_test());
+  eig_param.preserve_evals = preserve_evals;
+  for (auto rsd : res) EXPECT_LE(rsd, inv_param.tol);
+}
+
+TEST(InvertDeflationTest, demoted)
+{
+  if (!inv_deflate || eig_compress_n_basis > 0) GTEST_SKIP();
+  if (eig_deflation_prec == QUDA_INVALID_PRECISION || eig_deflation_prec >= prec) GTEST_SKIP();
+
+  // undeflated reference solve
+  inv_param.eig_param = nullptr;
+  auto res_ref = solve(deflated_cg_test());
+  auto iter_ref = inv_param.iter;
+  inv_param.eig_param = &eig_param;
+
+  // solve with the demoted deflation space, recomputing the eigenvalues from it
+  auto preserve_evals = eig_param.preserve_evals;
+  eig_param.preserve_evals = QUDA_BOOLEAN_FALSE;
+  auto res = solve(deflated_cg_test());
+  auto iter = inv_param.iter;
+  eig_param.preserve_evals = preserve_evals;
+
+  for (auto rsd : res_ref) EXPECT_LE(rsd, inv_param.tol);
+  for (auto rsd : res) EXPECT_LE(rsd, inv_param.tol);
+  EXPECT_LE(iter, iter_ref);
+}
+
 std::string gettestname(::testing::TestParamInfo<test_t> param)
 {
   std::string name;
@@ -150,7 +288,8 @@ std::string gettestname(::testing::TestParamInfo<test_t> param)
 
 using ::testing::Combine;
 using ::testing::Values;
-auto normal_solvers = Values(QUDA_CG_INVERTER, QUDA_CA_CG_INVERTER, QUDA_PCG_INVERTER);
+auto normal_solvers = Values(QUDA_CG_INVERTER, QUDA_CA_CG_INVERTER, QUDA_PCG_INVERTER, QUDA_PIPELINED_CG_INVERTER,
+                             QUDA_BLOCK_CG_INVERTER);
 
 auto direct_solvers
   = Values(QUDA_CGNE_INVERTER, QUDA_CGNR_INVERTER, QUDA_CA_CGNE_INVERTER, QUDA_CA_CGNR_INVERTER, QUDA_GCR_INVERTER,
@@ -228,3 +367,14 @@ INSTANTIATE_TEST_SUITE_P(SchwarzEvenOdd, InvertTest,
                                          Values(QUDA_MR_INVERTER, QUDA_CA_GCR_INVERTER),
                                          Values(QUDA_HALF_PRECISION, QUDA_QUARTER_PRECISION))),
                          gettestname);
+
+// multi-shift solves comparing sequential and batched refinement
+INSTANTIATE_TEST_SUITE_P(MultiShiftRefine, InvertMultiShiftRefineTest, sloppy_precisions,
+                         [](::testing::TestParamInfo<QudaPrecision> param) { return get_prec_str(param.param); });
+
+// streamed solves of diluted sources
+INSTANTIATE_TEST_SUITE_P(Dilution, InvertDilutionTest,
+                         Values(QUDA_DILUTION_TIME_SLICE, QUDA_DILUTION_BLOCK, QUDA_DILUTION_HADAMARD_PROBING),
+                         [](::testing::TestParamInfo<QudaDilutionType> param) {
+                           return get_dilution_type_str(param.param);
+                         });
@@ -77,6 +77,55 @@ TEST_P(GaugeIOTest, verify)
   for (int dir = 0; dir < 4; dir++) { host_free(gauge[dir]); }
 }
 
+// test loading a memory-mapped gauge file yields an identical lattice
+TEST_P(GaugeIOTest, mmap)
+{
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  setWilsonGaugeParam(gauge_param);
+
+  gauge_param.cpu_prec = ::testing::get<0>(param);
+  gauge_param.cuda_prec = gauge_param.cpu_prec;
+  if (!quda::is_enabled(gauge_param.cpu_prec)) GTEST_SKIP();
+
+  gauge_param.t_boundary = QUDA_PERIODIC_T;
+  setDims(gauge_param.X);
+
+  void *gauge[4];
+  for (int dir = 0; dir < 4; dir++) gauge[dir] = safe_malloc(V * gauge_site_size * host_gauge_data_type_size);
+  constructHostGaugeField(gauge, gauge_param, 0, nullptr);
+
+  auto get_plaq = [&](void *h_gauge, QudaGaugeParam &param) {
+    loadGaugeQuda(h_gauge, &param);
+    std::array<double, 3> plaq;
+    plaqQuda(plaq.data());
+    freeGaugeQuda();
+    return plaq;
+  };
+
+  auto plaq_old = get_plaq((void *)gauge, gauge_param);
+
+  auto file = "dummy.lat";
+  write_gauge_field(file, gauge, gauge_param.cpu_prec, gauge_param.X, 0, nullptr);
+
+  // map the file twice to exercise reuse of the parsed mapping
+  QudaGaugeParam mmap_param = gauge_param;
+  void *mapped = mapGaugeQuda(file, &mmap_param);
+  EXPECT_EQ(mmap_param.cpu_prec, gauge_param.cpu_prec);
+  EXPECT_EQ(mmap_param.gauge_order, QUDA_ILDG_GAUGE_ORDER);
+  EXPECT_EQ(mapGaugeQuda(file, &mmap_param), mapped);
+  unmapGaugeQuda(mapped);
+
+  auto plaq_new = get_plaq(mapped, mmap_param);
+  unmapGaugeQuda(mapped);
+
+  for (int i = 0; i < 3; i++) EXPECT_EQ(plaq_old[i], plaq_new[i]);
+
+  ::quda::comm_barrier();
+  if (::quda::comm_rank() == 0 && remove(file) != 0) errorQuda("Error deleting file");
+
+  for (int dir = 0; dir < 4; dir++) { host_free(gauge[dir]); }
+}
+
 using cs_test_t = ::testing::tuple<QudaSiteSubset, bool, QudaPrecision, QudaPrecision, int, QudaFieldLocation>;
 
 class ColorSpinorIOTest : public ::testing::TestWithParam<cs_test_t>
@@ -109,6 +158,9 @@ constexpr double get_tolerance(QudaPrecision prec, QudaPrecision prec_io)
   switch (prec_io) {
   case QUDA_DOUBLE_PRECISION: return std::numeric_limits<double>::epsilon();
   case QUDA_SINGLE_PRECISION: return std::numeric_limits<float>::epsilon();
+  // block-scaled encodings are only accurate relative to the site norm
+  case QUDA_HALF_PRECISION: return 1e-3;
+  case QUDA_QUARTER_PRECISION: return 5e-2;
   default: return 0.0;
   }
 }
@@ -152,7 +204,7 @@ TEST_P(ColorSpinorIOTest, verify)
 
   for (auto i = 0u; i < v.size(); i++) {
     auto dev = blas::max_deviation(u[i], v[i]);
-    if (prec == prec_io)
+    if (prec == prec_io && prec_io >= QUDA_SINGLE_PRECISION)
       EXPECT_EQ(dev[0], 0.0);
     else
       EXPECT_LE(dev[0], get_tolerance(prec, prec_io));
@@ -162,6 +214,40 @@ TEST_P(ColorSpinorIOTest, verify)
   if (::quda::comm_rank() == 0 && remove(file) != 0) errorQuda("Error deleting file");
 }
 
+TEST(AsyncIO, flush)
+{
+  using namespace quda;
+  if (!VectorIO::asyncEnabled() || !is_enabled(QUDA_SINGLE_PRECISION)) GTEST_SKIP();
+
+  QudaGaugeParam gauge_param = newQudaGaugeParam();
+  QudaInvertParam inv_param = newQudaInvertParam();
+  ColorSpinorParam param;
+  setWilsonGaugeParam(gauge_param);
+  setInvertParam(inv_param);
+  constructWilsonTestSpinorParam(&param, &inv_param, &gauge_param);
+  param.setPrecision(QUDA_SINGLE_PRECISION, QUDA_SINGLE_PRECISION, true);
+  param.location = QUDA_CUDA_FIELD_LOCATION;
+  param.create = QUDA_NULL_FIELD_CREATE;
+
+  std::vector<ColorSpinorField> v(2, param);
+  std::vector<ColorSpinorField> u(2, param);
+  RNG rng(v[0], 1234);
+  for (auto &vi : v) spinorNoise(vi, rng, QUDA_NOISE_GAUSS);
+
+  // the file is complete once the flush has returned
+  auto file = "dummy_async.cs";
+  VectorIO(file, false, true).save({v.begin(), v.end()});
+  EXPECT_EQ(flushVectorIOQuda(), 0);
+  VectorIO(file).load(u);
+  for (auto i = 0u; i < v.size(); i++) EXPECT_EQ(blas::max_deviation(u[i], v[i])[0], 0.0);
+  if (::quda::comm_rank() == 0 && remove(file) != 0) errorQuda("Error deleting file");
+
+  // a failed background write is reported by the flush, and only once
+  VectorIO("nonexistent_directory/dummy_async.cs", false, true).save({v.begin(), v.end()});
+  EXPECT_EQ(flushVectorIOQuda(), 1);
+  EXPECT_EQ(flushVectorIOQuda(), 0);
+}
+
 int main(int argc, char **argv)
 {
   // initialize google test, includes command line options
@@ -208,7 +294,9 @@ INSTANTIATE_TEST_SUITE_P(Gauge, GaugeIOTest, Combine(Values(QUDA_DOUBLE_PRECISIO
 INSTANTIATE_TEST_SUITE_P(Full, ColorSpinorIOTest,
                          Combine(Values(QUDA_FULL_SITE_SUBSET), Values(false),
                                  Values(QUDA_DOUBLE_PRECISION, QUDA_SINGLE_PRECISION, QUDA_HALF_PRECISION),
-                                 Values(QUDA_DOUBLE_PRECISION, QUDA_SINGLE_PRECISION), Values(1, 2, 4),
+                                 Values(QUDA_DOUBLE_PRECISION, QUDA_SINGLE_PRECISION, QUDA_HALF_PRECISION,
+                                        QUDA_QUARTER_PRECISION),
+                                 Values(1, 2, 4),
                                  Values(QUDA_CUDA_FIELD_LOCATION, QUDA_CPU_FIELD_LOCATION)),
                          [](testing::TestParamInfo<cs_test_t> param) {
                            std::string name;
@@ -223,7 +311,9 @@ INSTANTIATE_TEST_SUITE_P(Full, ColorSpinorIOTest,
 INSTANTIATE_TEST_SUITE_P(Parity, ColorSpinorIOTest,
                          Combine(Values(QUDA_PARITY_SITE_SUBSET), Values(false, true),
                                  Values(QUDA_DOUBLE_PRECISION, QUDA_SINGLE_PRECISION, QUDA_HALF_PRECISION),
-                                 Values(QUDA_DOUBLE_PRECISION, QUDA_SINGLE_PRECISION), Values(1, 2, 4),
+                                 Values(QUDA_DOUBLE_PRECISION, QUDA_SINGLE_PRECISION, QUDA_HALF_PRECISION,
+                                        QUDA_QUARTER_PRECISION),
+                                 Values(1, 2, 4),
                                  Values(QUDA_CUDA_FIELD_LOCATION, QUDA_CPU_FIELD_LOCATION)),
                          [](testing::TestParamInfo<cs_test_t> param) {
                            std::string name;
@@ -3,6 +3,7 @@
 #include <time.h>
 #include <math.h>
 #include <string.h>
+#include <algorithm>
 
 #include <util_quda.h>
 #include <host_utils.h>
@@ -52,6 +53,34 @@ int main(int argc, char **argv)
   printfQuda("Computed plaquette gauge precise is %16.15e (spatial = %16.15e, temporal = %16.15e)\n", plaq[0], plaq[1],
              plaq[2]);
 
+  // compute the fused observables on the device and validate against the host
+  QudaGaugeObservableParam obs_param = newQudaGaugeObservableParam();
+  obs_param.compute_plaquette = QUDA_BOOLEAN_TRUE;
+  obs_param.compute_qcharge = QUDA_BOOLEAN_TRUE;
+  gaugeObservablesQuda(&obs_param);
+
+  printfQuda("Device plaquette = %16.15e, energy = %16.15e, Q = %16.15e\n", obs_param.plaquette[0],
+             obs_param.energy[0], obs_param.qcharge);
+
+  // the host computation is only supported on a single process
+  int result = 0;
+  if (gridsize_from_cmdline[0] * gridsize_from_cmdline[1] * gridsize_from_cmdline[2] * gridsize_from_cmdline[3] == 1) {
+    QudaGaugeObservableParam host_param = newQudaGaugeObservableParam();
+    host_param.compute_plaquette = QUDA_BOOLEAN_TRUE;
+    host_param.compute_qcharge = QUDA_BOOLEAN_TRUE;
+    gaugeObservablesHostQuda((void *)gauge, &gauge_param, &host_param);
+    printfQuda("Host   plaquette = %16.15e, energy = %16.15e, Q = %16.15e\n", host_param.plaquette[0],
+               host_param.energy[0], host_param.qcharge);
+
+    double tol = prec == QUDA_DOUBLE_PRECISION ? 1e-10 : 1e-4;
+    double dev = std::max({fabs(plaq[0] - host_param.plaquette[0]),
+                           fabs(obs_param.plaquette[0] - host_param.plaquette[0]),
+                           fabs(obs_param.energy[0] - host_param.energy[0]),
+                           fabs(obs_param.qcharge - host_param.qcharge)});
+    result = dev > tol ? 1 : 0;
+    printfQuda("Maximum deviation between device and host observables = %e (%s)\n", dev, result ? "FAILED" : "PASSED");
+  }
+
   freeGaugeQuda();
 
   // release memory
@@ -59,5 +88,5 @@ int main(int argc, char **argv)
 
   endQuda();
   finalizeComms();
-  return 0;
+  return result;
 }
@@ -26,6 +26,12 @@ int gauge_smear_steps = 50;
 QudaGaugeSmearType gauge_smear_type = QUDA_GAUGE_SMEAR_STOUT;
 int measurement_interval = 5;
 bool su_project = true;
+bool gauge_smear_adaptive = false;
+double gauge_smear_tol = 1e-5;
+std::string flow_record_file;
+double flow_t0_ref = 0.0;
+double flow_w0_ref = 0.0;
+bool flow_stop_at_scale = false;
 
 void display_test_info()
 {
@@ -46,7 +52,14 @@ void display_test_info()
     printfQuda(" - epsilon %f\n", gauge_smear_epsilon);
     break;
   case QUDA_GAUGE_SMEAR_WILSON_FLOW:
-  case QUDA_GAUGE_SMEAR_SYMANZIK_FLOW: printfQuda(" - epsilon %f\n", gauge_smear_epsilon); break;
+  case QUDA_GAUGE_SMEAR_SYMANZIK_FLOW:
+    printfQuda(" - epsilon %f\n", gauge_smear_epsilon);
+    if (gauge_smear_adaptive) printfQuda(" - adaptive step size, tolerance %e\n", gauge_smear_tol);
+    if (flow_t0_ref > 0.0) printfQuda(" - t0 scale at t^2 E = %f\n", flow_t0_ref);
+    if (flow_w0_ref > 0.0) printfQuda(" - w0 scale at t d/dt t^2 E = %f\n", flow_w0_ref);
+    if (flow_stop_at_scale) printfQuda(" - stopping once the scales are found\n");
+    if (!flow_record_file.empty()) printfQuda(" - recording observables to %s\n", flow_record_file.c_str());
+    break;
   default: errorQuda("Undefined test type %d given", test_type);
   }
   printfQuda(" - smearing steps %d\n", gauge_smear_steps);
@@ -88,6 +101,25 @@ void add_su3_option_group(std::shared_ptr<QUDAApp> quda_app)
   opgroup->add_option("--su3-measurement-interval", measurement_interval,
                       "Measure the field energy and/or topological charge every Nth step (default 5) ");
 
+  opgroup->add_option("--su3-smear-adaptive", gauge_smear_adaptive,
+                      "Use an adaptive step size for Wilson/Symanzik flow, with epsilon the initial step and "
+                      "steps * epsilon the final flow time (default false)");
+
+  opgroup->add_option("--su3-smear-tol", gauge_smear_tol,
+                      "Maximum local error per step for the adaptive Wilson/Symanzik flow (default 1e-5)");
+
+  opgroup->add_option("--su3-flow-record", flow_record_file,
+                      "Append the Wilson/Symanzik flow observables to this file as JSON lines (default none)");
+
+  opgroup->add_option("--su3-flow-t0", flow_t0_ref,
+                      "Extract the scale t0 where t^2 E(t) reaches this value (default 0, not computed)");
+
+  opgroup->add_option("--su3-flow-w0", flow_w0_ref,
+                      "Extract the scale w0 where t d/dt t^2 E(t) reaches this value (default 0, not computed)");
+
+  opgroup->add_option("--su3-flow-stop-at-scale", flow_stop_at_scale,
+                      "Stop the Wilson/Symanzik flow once the requested scales have been found (default false)");
+
   opgroup->add_option("--su3-project", su_project,
                       "Project smeared gauge onto su3 manifold at measurement interval (default true)");
 }
@@ -251,6 +283,14 @@ int main(int argc, char **argv)
   smear_param.alpha = gauge_smear_alpha;
   smear_param.rho = gauge_smear_rho;
   smear_param.epsilon = gauge_smear_epsilon;
+  smear_param.adaptive = gauge_smear_adaptive ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
+  smear_param.tolerance = gauge_smear_tol;
+  if (flow_record_file.size() >= sizeof(smear_param.flow_record_file))
+    errorQuda("Flow record file name %s too long", flow_record_file.c_str());
+  strcpy(smear_param.flow_record_file, flow_record_file.c_str());
+  smear_param.t0_ref = flow_t0_ref;
+  smear_param.w0_ref = flow_w0_ref;
+  smear_param.stop_at_scale = flow_stop_at_scale ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
 
   host_timer.start(); // start the timer
   switch (smear_param.smear_type) {
@@ -269,6 +309,8 @@ int main(int argc, char **argv)
       obs_param[i].compute_plaquette = QUDA_BOOLEAN_TRUE;
     }
     performWFlowQuda(&smear_param, obs_param);
+    if (flow_t0_ref > 0.0) printfQuda("t0/a^2 = %.12e\n", smear_param.t0);
+    if (flow_w0_ref > 0.0) printfQuda("w0/a = %.12e\n", smear_param.w0);
     break;
   }
   default: errorQuda("Undefined gauge smear type %d given", smear_param.smear_type);
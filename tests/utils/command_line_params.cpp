@@ -57,6 +57,9 @@ int gcrNkrylov = 8;
 QudaCABasis ca_basis = QUDA_CHEBYSHEV_BASIS;
 double ca_lambda_min = 0.0;
 double ca_lambda_max = -1.0;
+bool ca_adaptive = false;
+int gcrodr_n_recycle = 8;
+bool gcrodr_preserve = false;
 QudaCABasis ca_basis_precondition = QUDA_CHEBYSHEV_BASIS;
 double ca_lambda_min_precondition = 0.0;
 double ca_lambda_max_precondition = -1.0;
@@ -85,6 +88,7 @@ std::string madwf_param_outfile;
 
 int precon_schwarz_cycle = 1;
 int multishift = 1;
+int multishift_refine_batch = 1;
 bool verify_results = true;
 bool low_mode_check = false;
 bool oblique_proj_check = false;
@@ -207,6 +211,11 @@ int eig_n_ev = 16;
 int eig_n_kr = 32;
 int eig_n_conv = -1;        // If unchanged, will be set to n_ev
 int eig_n_ev_deflate = -1;  // If unchanged, will be set to n_conv
+int eig_compress_n_basis = 0; // If zero, the deflation space is not compressed
+std::array<int, 4> eig_compress_block_size = {4, 4, 4, 4};
+QudaPrecision eig_compress_prec = QUDA_SINGLE_PRECISION;
+QudaPrecision eig_deflation_prec = QUDA_INVALID_PRECISION; // If unset, the eigensolver precision is used
+int eig_deflation_benchmark = 0;
 int eig_batched_rotate = 0; // If unchanged, will be set to maximum
 bool eig_require_convergence = true;
 int eig_check_interval = 10;
@@ -267,6 +276,10 @@ int heatbath_num_steps = 10;
 int heatbath_num_heatbath_per_step = 5;
 int heatbath_num_overrelax_per_step = 5;
 bool heatbath_coldstart = false;
+int heatbath_num_hits = 1;
+bool heatbath_overlap = true;
+int heatbath_benchmark = 0;
+bool heatbath_verify = false;
 
 int eofa_pm = 1;
 double eofa_shift = -1.2345;
@@ -331,7 +344,10 @@ namespace
                                                            {"ca-cg", QUDA_CA_CG_INVERTER},
                                                            {"ca-cgne", QUDA_CA_CGNE_INVERTER},
                                                            {"ca-cgnr", QUDA_CA_CGNR_INVERTER},
-                                                           {"ca-gcr", QUDA_CA_GCR_INVERTER}};
+                                                           {"ca-gcr", QUDA_CA_GCR_INVERTER},
+                                                           {"pipelined-cg", QUDA_PIPELINED_CG_INVERTER},
+                                                           {"block-cg", QUDA_BLOCK_CG_INVERTER},
+                                                           {"gcrodr", QUDA_GCRODR_INVERTER}};
 
   CLI::TransformPairs<QudaPrecision> precision_map {{"double", QUDA_DOUBLE_PRECISION},
                                                     {"single", QUDA_SINGLE_PRECISION},
@@ -354,7 +370,8 @@ namespace
   CLI::TransformPairs<QudaEigType> eig_type_map {{"trlm", QUDA_EIG_TR_LANCZOS},
                                                  {"blktrlm", QUDA_EIG_BLK_TR_LANCZOS},
                                                  {"iram", QUDA_EIG_IR_ARNOLDI},
-                                                 {"blkiram", QUDA_EIG_BLK_IR_ARNOLDI}};
+                                                 {"blkiram", QUDA_EIG_BLK_IR_ARNOLDI},
+                                                 {"chfsi", QUDA_EIG_CHFSI}};
 
   CLI::TransformPairs<QudaTransferType> transfer_type_map {
     {"aggregate", QUDA_TRANSFER_AGGREGATE},
@@ -417,6 +434,13 @@ std::shared_ptr<QUDAApp> make_app(std::string app_description, std::string app_n
     ca_lambda_max, "Conservative estimate of largest eigenvalue for Chebyshev basis CA solvers (default is to guess with power iterations)");
   quda_app->add_option("--cheby-basis-eig-min", ca_lambda_min,
                        "Conservative estimate of smallest eigenvalue for Chebyshev basis CA solvers (default 0)");
+  quda_app->add_option("--ca-adaptive", ca_adaptive,
+                       "Adapt the CA basis length (up to ngcrkrylov) and type on the fly, estimating the Chebyshev "
+                       "bounds from the Ritz values (default false)");
+  quda_app->add_option("--gcrodr-recycle-dim", gcrodr_n_recycle,
+                       "Dimension of the GCRO-DR recycle space, must be less than ngcrkrylov (default 8)");
+  quda_app->add_option("--gcrodr-preserve", gcrodr_preserve,
+                       "Preserve the GCRO-DR recycle space between solves (default false)");
 
   quda_app
     ->add_option("--ca-basis-type-precondition", ca_basis_precondition,
@@ -495,6 +519,8 @@ std::shared_ptr<QUDAApp> make_app(std::string app_description, std::string app_n
     "--multishift", multishift,
     "Whether to do a multi-shift solver test or not. Default is 1 (single mass)"
     "If a value N > 1 is passed, heavier masses will be constructed and the multi-shift solver will be called");
+  quda_app->add_option("--multishift-refine-batch", multishift_refine_batch,
+                       "The maximum number of shifts refined concurrently after the multi-shift solver (default 1)");
   quda_app->add_option("--ngcrkrylov", gcrNkrylov,
                        "The number of inner iterations to use for GCR, BiCGstab-l, CA-CG, CA-GCR (default 8)");
   quda_app->add_option("--niter", niter, "The number of iterations to perform (default 100)");
@@ -682,6 +708,24 @@ void add_eigen_option_group(std::shared_ptr<QUDAApp> quda_app)
   opgroup->add_option(
     "--eig-n-ev-deflate", eig_n_ev_deflate,
     "The number of converged eigenpairs that will be used in the deflation routines (default eig_n_conv)");
+  opgroup->add_option("--eig-compress-n-basis", eig_compress_n_basis,
+                      "The number of eigenvectors forming the block-local basis of a compressed deflation space "
+                      "(default 0, no compression)");
+  opgroup
+    ->add_option("--eig-compress-block-size", eig_compress_block_size,
+                 "The geometric block size of the compressed deflation space (default 4 4 4 4)")
+    ->expected(4);
+  opgroup
+    ->add_option("--eig-compress-prec", eig_compress_prec,
+                 "The precision of the compressed deflation space coefficients (default single)")
+    ->transform(prec_transform);
+  opgroup
+    ->add_option("--eig-deflation-prec", eig_deflation_prec,
+                 "The precision in which the deflation space is stored (default eigensolver precision)")
+    ->transform(prec_transform);
+  opgroup->add_option("--eig-deflation-benchmark", eig_deflation_benchmark,
+                      "Benchmark the deflation of the sources for this many iterations after the deflated "
+                      "solves (default 0, no benchmark)");
   opgroup->add_option("--eig-n-conv", eig_n_conv, "The number of converged eigenvalues requested (default eig_n_ev)");
   opgroup->add_option("--eig-n-ev", eig_n_ev, "The size of eigenvector search space in the eigensolver");
   opgroup->add_option("--eig-n-kr", eig_n_kr, "The size of the Krylov subspace to use in the eigensolver");
@@ -697,7 +741,8 @@ void add_eigen_option_group(std::shared_ptr<QUDAApp> quda_app)
   opgroup
     ->add_option("--eig-save-prec", eig_save_prec,
                  "If saving eigenvectors, use this precision to save. No-op if eig-save-prec is greater than or equal "
-                 "to precision of eigensolver (default = double)")
+                 "to precision of eigensolver. Half and quarter use a block-scaled fixed-point file format (default = "
+                 "double)")
     ->transform(prec_transform);
 
   opgroup->add_option(
@@ -1018,6 +1063,15 @@ void add_heatbath_option_group(std::shared_ptr<QUDAApp> quda_app)
                       "Number of measurement steps in heatbath test (default 10)");
   opgroup->add_option("--heatbath-warmup-steps", heatbath_warmup_steps,
                       "Number of warmup steps in heatbath test (default 10)");
+  opgroup->add_option("--heatbath-num-hits", heatbath_num_hits,
+                      "Number of updates of each link with the same staple (default 1)");
+  opgroup->add_option("--heatbath-overlap", heatbath_overlap,
+                      "Whether to overlap the boundary exchange with the interior updates (default true)");
+  opgroup->add_option("--heatbath-benchmark", heatbath_benchmark,
+                      "Number of timed steps to run without measurements after the warmup (default 0)");
+  opgroup->add_option("--heatbath-verify", heatbath_verify,
+                      "Whether to verify the device update against the host update, or on a partitioned lattice the "
+                      "overlapped against the blocking exchange (default false)");
 }
 
 void add_comms_option_group(std::shared_ptr<QUDAApp> quda_app)
@@ -193,6 +193,9 @@ extern int gcrNkrylov;
 extern QudaCABasis ca_basis;
 extern double ca_lambda_min;
 extern double ca_lambda_max;
+extern bool ca_adaptive;
+extern int gcrodr_n_recycle;
+extern bool gcrodr_preserve;
 extern QudaCABasis ca_basis_precondition;
 extern double ca_lambda_min_precondition;
 extern double ca_lambda_max_precondition;
@@ -221,6 +224,7 @@ extern std::string madwf_param_outfile;
 
 extern int precon_schwarz_cycle;
 extern int multishift;
+extern int multishift_refine_batch;
 extern bool verify_results;
 extern bool low_mode_check;
 extern bool oblique_proj_check;
@@ -328,6 +332,11 @@ extern int eig_n_ev;
 extern int eig_n_kr;
 extern int eig_n_conv;         // If unchanged, will be set to n_ev
 extern int eig_n_ev_deflate;   // If unchanged, will be set to n_conv
+extern int eig_compress_n_basis;
+extern std::array<int, 4> eig_compress_block_size;
+extern QudaPrecision eig_compress_prec;
+extern QudaPrecision eig_deflation_prec;
+extern int eig_deflation_benchmark;
 extern int eig_batched_rotate; // If unchanged, will be set to maximum
 extern bool eig_require_convergence;
 extern int eig_check_interval;
@@ -388,6 +397,10 @@ extern int heatbath_num_steps;
 extern int heatbath_num_heatbath_per_step;
 extern int heatbath_num_overrelax_per_step;
 extern bool heatbath_coldstart;
+extern int heatbath_num_hits;
+extern bool heatbath_overlap;
+extern int heatbath_benchmark;
+extern bool heatbath_verify;
 
 extern int eofa_pm;
 extern double eofa_shift;
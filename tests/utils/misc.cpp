@@ -175,6 +175,7 @@ const char *get_eig_type_str(QudaEigType type)
   case QUDA_EIG_BLK_TR_LANCZOS: ret = "blktrlm"; break;
   case QUDA_EIG_IR_ARNOLDI: ret = "iram"; break;
   case QUDA_EIG_BLK_IR_ARNOLDI: ret = "blkiram"; break;
+  case QUDA_EIG_CHFSI: ret = "chfsi"; break;
   default: ret = "unknown eigensolver"; break;
   }
 
@@ -314,6 +315,9 @@ const char *get_solver_str(QudaInverterType type)
   case QUDA_CA_CGNE_INVERTER: ret = "ca_cgne"; break;
   case QUDA_CA_CGNR_INVERTER: ret = "ca_cgnr"; break;
   case QUDA_CA_GCR_INVERTER: ret = "ca_gcr"; break;
+  case QUDA_PIPELINED_CG_INVERTER: ret = "pipelined_cg"; break;
+  case QUDA_BLOCK_CG_INVERTER: ret = "block_cg"; break;
+  case QUDA_GCRODR_INVERTER: ret = "gcrodr"; break;
   default:
     ret = "unknown";
     errorQuda("Error: invalid solver type %d\n", type);
@@ -369,6 +373,9 @@ std::string get_dilution_type_str(QudaDilutionType type)
   case QUDA_DILUTION_COLOR: s = std::string("color"); break;
   case QUDA_DILUTION_SPIN_COLOR: s = std::string("spin_color"); break;
   case QUDA_DILUTION_SPIN_COLOR_EVEN_ODD: s = std::string("spin_color_even_odd"); break;
+  case QUDA_DILUTION_TIME_SLICE: s = std::string("time_slice"); break;
+  case QUDA_DILUTION_BLOCK: s = std::string("block"); break;
+  case QUDA_DILUTION_HADAMARD_PROBING: s = std::string("hadamard_probing"); break;
   default: fprintf(stderr, "Error: invalid dilution type\n"); exit(1);
   }
   return s;
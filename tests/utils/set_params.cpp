@@ -191,6 +191,11 @@ void setInvertParam(QudaInvertParam &inv_param)
   inv_param.ca_basis = ca_basis;
   inv_param.ca_lambda_min = ca_lambda_min;
   inv_param.ca_lambda_max = ca_lambda_max;
+  inv_param.ca_adaptive = ca_adaptive ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
+  if (inv_type == QUDA_GCRODR_INVERTER) {
+    inv_param.n_ev = gcrodr_n_recycle;
+    inv_param.preserve_recycle = gcrodr_preserve ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
+  }
   inv_param.tol = tol;
   inv_param.tol_restart = tol_restart;
   if (tol_hq == 0 && tol == 0) {
@@ -213,6 +218,7 @@ void setInvertParam(QudaInvertParam &inv_param)
   // These should be set in the application code. We set the them here by way of
   // example
   inv_param.num_offset = multishift;
+  inv_param.multishift_refine_batch = multishift_refine_batch;
   for (int i = 0; i < inv_param.num_offset; i++) inv_param.offset[i] = 0.06 + i * i * 0.1;
   // these can be set individually
   for (int i = 0; i < inv_param.num_offset; i++) {
@@ -307,6 +313,11 @@ void setEigParam(QudaEigParam &eig_param)
     eig_param.n_ev_deflate = eig_n_ev_deflate;
   }
 
+  eig_param.compress_n_basis = eig_compress_n_basis;
+  for (int i = 0; i < 4; i++) eig_param.compress_block_size[i] = eig_compress_block_size[i];
+  eig_param.compress_prec = eig_compress_prec;
+  eig_param.deflation_prec = eig_deflation_prec;
+
   eig_param.block_size
     = (eig_param.eig_type == QUDA_EIG_TR_LANCZOS || eig_param.eig_type == QUDA_EIG_IR_ARNOLDI) ? 1 : eig_block_size;
   eig_param.n_ev = eig_n_ev;
@@ -716,6 +727,7 @@ void setMultigridInvertParam(QudaInvertParam &inv_param)
   // Offsets used only by multi-shift solver
   // should be set in application
   inv_param.num_offset = multishift;
+  inv_param.multishift_refine_batch = multishift_refine_batch;
   for (int i = 0; i < inv_param.num_offset; i++) inv_param.offset[i] = 0.06 + i * i * 0.1;
   // these can be set individually
   for (int i = 0; i < inv_param.num_offset; i++) {
@@ -947,6 +959,11 @@ void setStaggeredInvertParam(QudaInvertParam &inv_param)
   inv_param.ca_basis = ca_basis;
   inv_param.ca_lambda_min = ca_lambda_min;
   inv_param.ca_lambda_max = ca_lambda_max;
+  inv_param.ca_adaptive = ca_adaptive ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
+  if (inv_type == QUDA_GCRODR_INVERTER) {
+    inv_param.n_ev = gcrodr_n_recycle;
+    inv_param.preserve_recycle = gcrodr_preserve ? QUDA_BOOLEAN_TRUE : QUDA_BOOLEAN_FALSE;
+  }
 
   inv_param.solution_type = solution_type;
   inv_param.solve_type = solve_type;
@@ -1322,6 +1339,7 @@ void setDeflatedInvertParam(QudaInvertParam &inv_param)
   // Offsets used only by multi-shift solver
   // should be set in application
   inv_param.num_offset = multishift;
+  inv_param.multishift_refine_batch = multishift_refine_batch;
   for (int i = 0; i < inv_param.num_offset; i++) inv_param.offset[i] = 0.06 + i * i * 0.1;
   // these can be set individually
   for (int i = 0; i < inv_param.num_offset; i++) {